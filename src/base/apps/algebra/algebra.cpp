@@ -28,6 +28,7 @@ void IsisMain() {
   p.SetInputCube("FROM1");
   if (ui.WasEntered ("FROM2")) p.SetInputCube("FROM2");
   p.SetOutputCube ("TO");
+  p.SetThreads(ui.GetInteger("THREADS"));
 
   // Get the coefficients
   Isisa = ui.GetDouble ("A");
@@ -2,6 +2,7 @@
 
 #include "Isis.h"
 #include "Camera.h"
+#include "CameraFactory.h"
 #include "ProjectionFactory.h"
 #include "ProcessRubberSheet.h"
 #include "iException.h"
@@ -229,6 +230,7 @@ void IsisMain() {
   int tileStart, tileEnd;
   incam->GetGeometricTilingHint(tileStart, tileEnd);
   p.SetTiling(tileStart, tileEnd);
+  p.SetGrid(ui.GetInteger("GRIDSPACING"), ui.GetDouble("GRIDTOLERANCE"));
 
   // Output the mapping group used to the Gui session log
   Application::GuiLog(userMap);
@@ -249,6 +251,26 @@ void IsisMain() {
                                             icube->Bands());
   ocube->PutGroup(userGrp);
 
+  // Each additional thread gets its own camera and projection, since they
+  // keep the state of the last point computed
+  vector<Transform *> transforms;
+  vector<Camera *> threadCams;
+  vector<Projection *> threadMaps;
+  transforms.push_back(transform);
+  if (incam->IsBandIndependent()) {
+    for (int i=1; i<ui.GetInteger("THREADS"); i++) {
+      threadCams.push_back(CameraFactory::Create(*icube->Label()));
+      threadMaps.push_back(ProjectionFactory::CreateFromCube(*ocube));
+      transforms.push_back(new cam2map (icube->Samples(),
+                                        icube->Lines(),
+                                        threadCams[i-1],
+                                        samples,
+                                        lines,
+                                        threadMaps[i-1],
+                                        trim));
+    }
+  }
+
   // Set up the interpolator
   Interpolator *interp = NULL;
   if (ui.GetString("INTERP") == "NEARESTNEIGHBOR") {
@@ -291,7 +313,7 @@ void IsisMain() {
   }
 
   // Warp the cube
-  p.StartProcess(*transform, *interp);
+  p.StartProcess(transforms, *interp);
   p.EndProcess();
 
   // add mapping to print.prt
@@ -299,6 +321,11 @@ void IsisMain() {
   Application::Log(mapping); 
 
   // Cleanup
+  for (unsigned int i=0; i<threadCams.size(); i++) {
+    delete transforms[i+1];
+    delete threadCams[i];
+    delete threadMaps[i];
+  }
   delete outmap;
   delete transform;
   delete interp;
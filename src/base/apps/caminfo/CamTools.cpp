@@ -171,6 +171,9 @@ void BandGeometry::collect(Camera &camera, Cube &cube, bool doGeometry,
   double centerLine = cLine / 2.0;
   double centerSamp = cSamp / 2.0;
 
+  // The ground range tests the poles again below, so keep its last points
+  camera.SetGeometryCache(100);
+
   // Check to determine if geometry is band independant
   _isBandIndependent = camera.IsBandIndependent();
   _hasCenterGeom = false;
@@ -249,24 +252,25 @@ void BandGeometry::collect(Camera &camera, Cube &cube, bool doGeometry,
     }
     //  OK...now get corner pixel geometry.  NOTE this resets image
     //  pixel location from center!!!
-    if ( camera.SetImage(1.0, 1.0) ) {
-      g.upperLeftLongitude = camera.UniversalLongitude();
-      g.upperLeftLatitude =  camera.UniversalLatitude();
+    Camera::Geometry corner;
+    if ( camera.ImageGeometry(1.0, 1.0, corner) ) {
+      g.upperLeftLongitude = corner.longitude;
+      g.upperLeftLatitude =  corner.latitude;
     }
 
-    if ( camera.SetImage(1.0, cLine) ) {
-      g.lowerLeftLongitude = camera.UniversalLongitude();
-      g.lowerLeftLatitude =  camera.UniversalLatitude();
+    if ( camera.ImageGeometry(1.0, cLine, corner) ) {
+      g.lowerLeftLongitude = corner.longitude;
+      g.lowerLeftLatitude =  corner.latitude;
     }
 
-    if ( camera.SetImage(cSamp, cLine) ) {
-      g.lowerRightLongitude = camera.UniversalLongitude();
-      g.lowerRightLatitude =  camera.UniversalLatitude();
+    if ( camera.ImageGeometry(cSamp, cLine, corner) ) {
+      g.lowerRightLongitude = corner.longitude;
+      g.lowerRightLatitude =  corner.latitude;
     }
 
-    if ( camera.SetImage(cSamp, 1.0) ) {
-      g.upperRightLongitude = camera.UniversalLongitude();
-      g.upperRightLatitude =  camera.UniversalLatitude();
+    if ( camera.ImageGeometry(cSamp, 1.0, corner) ) {
+      g.upperRightLongitude = corner.longitude;
+      g.upperRightLatitude =  corner.latitude;
     }
 
     double minRes = camera.LowestImageResolution();
@@ -282,13 +286,14 @@ void BandGeometry::collect(Camera &camera, Cube &cube, bool doGeometry,
     // Test for interesting intersections
     if (camera.IntersectsLongitudeDomain(camMap)) g.hasLongitudeBoundary = true;
     camera.SetBand(band+1);
-    if (camera.SetUniversalGround(90.0, 0.0)) {
-      if ( isPointValid(camera.Sample(), camera.Line(), &camera) ) {
+    Camera::Geometry pole;
+    if (camera.GroundGeometry(90.0, 0.0, pole)) {
+      if ( isPointValid(pole.sample, pole.line, &camera) ) {
         g.hasNorthPole = true;
       }
     }
-    if (camera.SetUniversalGround(-90.0, 0.0)) {
-      if ( isPointValid(camera.Sample(), camera.Line(), &camera) ) {
+    if (camera.GroundGeometry(-90.0, 0.0, pole)) {
+      if ( isPointValid(pole.sample, pole.line, &camera) ) {
         g.hasSouthPole = true;
       }
     }
@@ -126,6 +126,9 @@ struct DeleteObject {
    *          poles are not converted to 180 domain when projected
    * @history 2009-08-24 Kris Becker - Added ability to disable use of shape 
    *          model when creating polygons that contains a limb
+   * @history 2026-10-18 Unknown - The corners and poles use the camera's
+   *          geometry cache, so the poles the ground range already tested are
+   *          not computed again
    */
 class BandGeometry {
 
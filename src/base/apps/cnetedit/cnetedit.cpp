@@ -82,7 +82,7 @@ void IsisMain() {
     pvlLog.Write(sLogfile);
   }
   
-  cnet.Write( ui.GetFilename("ONET") );
+  cnet.Write( ui.GetFilename("ONET"), ui.GetString("FORMAT") == "BINARY" );
 }
 
 
@@ -185,7 +185,7 @@ void IsisMain() {
   }
 
   // Writes out the final Control Net
-  cnet.Write( outfile.Expanded() );
+  cnet.Write( outfile.Expanded(), ui.GetString("FORMAT") == "BINARY" );
 
 }
 
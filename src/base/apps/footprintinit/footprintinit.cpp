@@ -1,21 +1,208 @@
 #include "Isis.h"
 
+#include "FileList.h"
+#include "History.h"
 #include "iException.h"
 #include "ImagePolygon.h"
 #include "PolygonTools.h"
-#include "Process.h"
 #include "Progress.h"
+#include "Pvl.h"
 #include "PvlGroup.h"
 #include "SerialNumber.h"
 
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
 
-using namespace std; 
+using namespace std;
 using namespace Isis;
 
+// The parameters used to create every footprint
+struct FootprintOptions {
+  int sinc;
+  int linc;
+  bool precision;
+  bool emission;
+  double maxEmission;
+  bool incidence;
+  double maxIncidence;
+  bool ellipsoid;
+  double tolerance;
+  bool testxy;
+  string map;
+  PvlObject history;
+};
+
+// The footprint of one cube of a list, and what it adds to the log
+class FootprintResult {
+  public:
+    FootprintResult() : sinc(0), linc(0), failed(false) {}
+
+    int sinc, linc;
+    bool failed;
+    Pvl errors;    // Why the footprint failed, as iException::PvlErrors
+};
+
+void Footprint(const string &file, const FootprintOptions &opts,
+               FootprintResult &result);
+void WriteHistory(Cube &cube, PvlObject history);
+void LogResult(const string &file, const FootprintOptions &opts,
+               FootprintResult &result);
+
+class FootprintQueue;
+
+// One of the threads creating footprints.  Each thread opens its own cubes,
+// so each footprint is walked with its own cameras.
+class FootprintWorker : public QThread {
+  public:
+    FootprintWorker(FootprintQueue &queue) : p_queue(&queue) {}
+
+  protected:
+    void run();
+
+  private:
+    FootprintQueue *p_queue;
+};
+
+// The cubes shared by the footprint threads.  The threads take the cubes
+// in order and leave their results for the main thread, which logs them in
+// the order of the list.
+class FootprintQueue {
+  public:
+    FootprintQueue(FileList &list, const FootprintOptions &opts);
+    ~FootprintQueue();
+
+    FileList *list;
+    FootprintOptions opts;
+
+    QMutex mutex;                // Protects the members below
+    QWaitCondition done;         // Signaled when a cube is done
+    int next;                    // Next cube to create the footprint of
+    vector<FootprintResult *> results;  // Results not yet logged
+};
+
 void IsisMain() {
   UserInterface &ui = Application::GetUserInterface();
+
+  FootprintOptions opts;
+  opts.sinc = ui.GetInteger("SINC");
+  opts.linc = ui.GetInteger("LINC");
+  opts.precision = ui.GetBoolean("INCREASEPRECISION");
+  opts.emission = ui.WasEntered("MAXEMISSION");
+  opts.maxEmission = opts.emission ? ui.GetDouble("MAXEMISSION") : 180.0;
+  opts.incidence = ui.WasEntered("MAXINCIDENCE");
+  opts.maxIncidence = opts.incidence ? ui.GetDouble("MAXINCIDENCE") : 180.0;
+  opts.ellipsoid = (ui.GetString("LIMBTEST") == "ELLIPSOID");
+  opts.tolerance = ui.WasEntered("TOLERANCE") ? ui.GetDouble("TOLERANCE") : 0.0;
+  opts.testxy = ui.GetBoolean("TESTXY");
+  if (opts.testxy) opts.map = ui.GetFilename("MAP");
+  opts.history = iApp->History();
+
+  if (ui.WasEntered("FROM") == ui.WasEntered("FROMLIST")) {
+    string msg = "Enter either FROM or FROMLIST";
+    throw iException::Message(iException::User,msg,_FILEINFO_);
+  }
+
+  if (ui.WasEntered("FROM")) {
+    Progress prog;
+    prog.SetMaximumSteps(1);
+    prog.CheckStatus ();
+
+    FootprintResult result;
+    Footprint(ui.GetFilename("FROM"), opts, result);
+
+    if( opts.precision ) {
+      PvlGroup results("Results");
+      results.AddKeyword( PvlKeyword( "SINC", result.sinc ) );
+      results.AddKeyword( PvlKeyword( "LINC", result.linc ) );
+      Application::Log( results );
+    }
+
+    prog.CheckStatus ();
+    return;
+  }
+
+  FileList list(ui.GetFilename("FROMLIST"));
+  int threads = ui.GetInteger("THREADS");
+
+  Progress prog;
+  prog.SetMaximumSteps(list.size());
+  prog.CheckStatus ();
+
+  int failures = 0;
+  if (threads == 1) {
+    for (unsigned int i=0; i<list.size(); i++) {
+      FootprintResult result;
+      try {
+        Footprint(list[i], opts, result);
+      }
+      catch (iException &e) {
+        result.failed = true;
+        result.errors = e.PvlErrors();
+        e.Clear();
+      }
+      if (result.failed) failures++;
+      LogResult(list[i], opts, result);
+      prog.CheckStatus ();
+    }
+  }
+  else {
+    FootprintQueue queue(list, opts);
+    vector<FootprintWorker *> workers;
+    for (int t=0; t<threads; t++) {
+      workers.push_back(new FootprintWorker(queue));
+      workers[t]->start();
+    }
+
+    // Log the cubes as soon as they and all cubes before them are done
+    queue.mutex.lock();
+    unsigned int i = 0;
+    while (i < list.size()) {
+      if (queue.results[i] == NULL) {
+        queue.done.wait(&queue.mutex);
+        continue;
+      }
+      FootprintResult *result = queue.results[i];
+      queue.results[i] = NULL;
+      queue.mutex.unlock();
+
+      if (result->failed) failures++;
+      LogResult(list[i], opts, *result);
+      delete result;
+      prog.CheckStatus ();
+      i++;
+
+      queue.mutex.lock();
+    }
+    queue.mutex.unlock();
+
+    for (int t=0; t<threads; t++) {
+      workers[t]->wait();
+      delete workers[t];
+    }
+  }
+
+  if (failures > 0) {
+    string msg = "Unable to initialize the polygons of [" + iString(failures) +
+                 "] of the [" + iString((int)list.size()) + "] cubes in [" +
+                 ui.GetFilename("FROMLIST") + "]";
+    throw iException::Message(iException::User,msg,_FILEINFO_);
+  }
+}
+
+
+/**
+ * Creates the footprint of a cube and writes it to the cube
+ *
+ * @param file The cube
+ * @param opts The parameters of the footprint
+ * @param result Returns the increments used
+ */
+void Footprint(const string &file, const FootprintOptions &opts,
+               FootprintResult &result) {
   Cube cube;
-  cube.Open( ui.GetFilename("FROM"), "rw" );
+  cube.Open( file, "rw" );
 
   // Make sure cube has been run through spiceinit
   try {
@@ -25,27 +212,24 @@ void IsisMain() {
     throw iException::Message(iException::User,msg,_FILEINFO_);
   }
 
-  Progress prog;
-  prog.SetMaximumSteps(1);
-  prog.CheckStatus ();
-
   std::string sn = SerialNumber::Compose(cube);
 
   ImagePolygon poly;
-  if( ui.WasEntered("MAXEMISSION") ) {
-    poly.Emission( ui.GetDouble("MAXEMISSION") );
+  if( opts.emission ) {
+    poly.Emission( opts.maxEmission );
   }
-  if( ui.WasEntered("MAXINCIDENCE") ) {
-    poly.Incidence( ui.GetDouble("MAXINCIDENCE") );
+  if( opts.incidence ) {
+    poly.Incidence( opts.maxIncidence );
   }
-  if( ui.GetString("LIMBTEST") == "ELLIPSOID" ) {
+  if( opts.ellipsoid ) {
     poly.EllipsoidLimb( true );
   }
+  poly.RefinementTolerance( opts.tolerance );
 
   // Reduce the increment size to find a valid polygon
-  int sinc = ui.GetInteger("SINC");
-  int linc = ui.GetInteger("LINC"); 
-  bool precision = ui.GetBoolean("INCREASEPRECISION");
+  int sinc = opts.sinc;
+  int linc = opts.linc;
+  bool precision = opts.precision;
   while( true ) {
     try {
       poly.Create(cube, sinc, linc);
@@ -57,19 +241,19 @@ void IsisMain() {
         e.Clear();
       }
       else {
-        e.Report();
+        throw;
       }
     }
   }
 
 
-  if( ui.GetBoolean("TESTXY") ) {
-    Pvl cubeLab( ui.GetFilename("FROM") );
+  if( opts.testxy ) {
+    Pvl cubeLab( file );
     PvlGroup inst = cubeLab.FindGroup("Instrument", Pvl::Traverse);
     string target = inst["TargetName"];
     PvlGroup radii = Projection::TargetRadii(target);
 
-    Pvl map( ui.GetFilename("MAP") );
+    Pvl map( opts.map );
     PvlGroup & mapping = map.FindGroup("MAPPING");
 
     if( !mapping.HasKeyword("TargetName") )
@@ -108,7 +292,7 @@ void IsisMain() {
           e.Clear();
         }
         else {
-          e.Report();
+          throw;
         }
       }
     }
@@ -120,17 +304,119 @@ void IsisMain() {
   cube.BlobDelete("Polygon",sn);
   cube.Write(poly);
 
-  if( precision ) {
-    PvlGroup results("Results");
-    results.AddKeyword( PvlKeyword( "SINC", sinc ) ); 
-    results.AddKeyword( PvlKeyword( "LINC", linc ) );
-    Application::Log( results );
+  WriteHistory(cube, opts.history);
+
+  cube.Close();
+
+  result.sinc = sinc;
+  result.linc = linc;
+}
+
+
+/**
+ * Adds an entry to the history of a cube, as Process::WriteHistory does
+ *
+ * @param cube The cube
+ * @param history The entry for this run of footprintinit
+ */
+void WriteHistory(Cube &cube, PvlObject history) {
+  bool addedHist = false;
+  Pvl &lab = *cube.Label();
+  for (int i=0; i<lab.Objects(); i++) {
+    if (lab.Object(i).IsNamed("History")) {
+      History h((string)lab.Object(i)["Name"]);
+      cube.Read(h);
+      h.AddEntry(history);
+      cube.Write(h);
+      addedHist = true;
+    }
+  }
+
+  if (!addedHist) {
+    History h("IsisCube");
+    h.AddEntry(history);
+    cube.Write(h);
   }
+}
 
-  Process p;
-  p.SetInputCube("FROM");
-  p.WriteHistory(cube);
 
-  cube.Close();
-  prog.CheckStatus ();
+/**
+ * Logs the result for one cube of a list
+ *
+ * @param file The cube
+ * @param opts The parameters of the footprint
+ * @param result The result for the cube
+ */
+void LogResult(const string &file, const FootprintOptions &opts,
+               FootprintResult &result) {
+  PvlGroup results("Results");
+  results.AddKeyword( PvlKeyword( "From", file ) );
+  if (result.failed) {
+    PvlKeyword error("Error");
+    for (int e=0; e<result.errors.Groups(); e++) {
+      error.AddValue((string)result.errors.Group(e)["Message"]);
+    }
+    results.AddKeyword( error );
+  }
+  else if( opts.precision ) {
+    results.AddKeyword( PvlKeyword( "SINC", result.sinc ) );
+    results.AddKeyword( PvlKeyword( "LINC", result.linc ) );
+  }
+  Application::Log( results );
+}
+
+
+//! Creates footprints until there are no cubes left
+void FootprintWorker::run() {
+  while (true) {
+    p_queue->mutex.lock();
+    if (p_queue->next >= (int)p_queue->list->size()) {
+      p_queue->mutex.unlock();
+      break;
+    }
+    int i = p_queue->next++;
+    p_queue->mutex.unlock();
+
+    // The exception list is kept for each thread, so this thread's errors
+    // are the only ones captured and cleared
+    FootprintResult *result = new FootprintResult;
+    try {
+      Footprint((*p_queue->list)[i], p_queue->opts, *result);
+    }
+    catch (iException &e) {
+      QMutexLocker lock(&p_queue->mutex);
+      result->failed = true;
+      result->errors = e.PvlErrors();
+      e.Clear();
+    }
+    catch (std::exception &e) {
+      QMutexLocker lock(&p_queue->mutex);
+      result->failed = true;
+      result->errors = iException::Message(iException::Programmer, e.what(),
+                                           _FILEINFO_).PvlErrors();
+      iException::Clear();
+    }
+
+    p_queue->mutex.lock();
+    p_queue->results[i] = result;
+    p_queue->done.wakeAll();
+    p_queue->mutex.unlock();
+  }
+}
+
+
+//! Sets up the queue of cubes in a list
+FootprintQueue::FootprintQueue(FileList &list, const FootprintOptions &opts) {
+  this->list = &list;
+  this->opts = opts;
+  next = 0;
+  results.resize(list.size(), NULL);
+}
+
+
+//! Deletes the results which were not logged
+FootprintQueue::~FootprintQueue() {
+  for (unsigned int i=0; i<results.size(); i++) {
+    delete results[i];
+  }
 }
@@ -30,6 +30,7 @@ void IsisMain() {
   b->SetObservationMode(ui.GetBoolean("OBSERVATIONS"));
   b->SetSolutionMethod(ui.GetString("METHOD"));
   b->SetSolveRadii(ui.GetBoolean("RADIUS"));
+  b->SetThreads(ui.GetInteger("THREADS"));
 
   b->SetCkDegree(ui.GetInteger("CKDEGREE"));
   b->SetSolveCamDegree(ui.GetInteger("SOLVEDEGREE"));
@@ -78,7 +79,7 @@ void IsisMain() {
   // Bundle adjust the network
   try {
     b->Solve(tol,maxIterations);
-    b->ControlNet()->Write(ui.GetFilename("ONET"));
+    b->ControlNet()->Write(ui.GetFilename("ONET"), ui.GetString("FORMAT") == "BINARY");
     PvlGroup gp( "JigsawResults" );
 
     // Update the cube pointing if requested
@@ -123,7 +124,7 @@ void IsisMain() {
 
   catch (iException &e) {
 
-    b->ControlNet()->Write(ui.GetFilename("ONET"));
+    b->ControlNet()->Write(ui.GetFilename("ONET"), ui.GetString("FORMAT") == "BINARY");
     string msg = "Unable to bundle adjust network [" + cnetFile + "]";
     throw iException::Message(Isis::iException::User,msg,_FILEINFO_);
   }
@@ -332,6 +332,25 @@ void IsisMain() {
 
   ocube->PutGroup(cleanOutGrp);
 
+  // Each additional thread gets its own projections, since they keep the
+  // state of the last point computed
+  vector<Transform *> transforms;
+  vector<Projection *> threadProjs;
+  transforms.push_back(transform);
+  for (int i=1; i<ui.GetInteger("THREADS"); i++) {
+    Projection *inmap = ProjectionFactory::CreateFromCube(*icube);
+    Projection *outmap = ProjectionFactory::CreateFromCube(*ocube);
+    threadProjs.push_back(inmap);
+    threadProjs.push_back(outmap);
+    transforms.push_back(new map2map (icube->Samples(),
+                                      icube->Lines(),
+                                      inmap,
+                                      samples,
+                                      lines,
+                                      outmap,
+                                      ui.GetBoolean("TRIM")));
+  }
+
   // Set up the interpolator
   Interpolator *interp;
   if (ui.GetString("INTERP") == "NEARESTNEIGHBOR") {
@@ -349,12 +368,19 @@ void IsisMain() {
   }
 
   // Warp the cube
-  p.StartProcess(*transform, *interp);
+  p.SetGrid(ui.GetInteger("GRIDSPACING"), ui.GetDouble("GRIDTOLERANCE"));
+  p.StartProcess(transforms, *interp);
   p.EndProcess();
 
   Application::Log(cleanOutGrp);
 
   // Cleanup
+  for (unsigned int i=1; i<transforms.size(); i++) {
+    delete transforms[i];
+  }
+  for (unsigned int i=0; i<threadProjs.size(); i++) {
+    delete threadProjs[i];
+  }
   delete transform;
   delete interp;
 }
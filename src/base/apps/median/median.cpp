@@ -1,8 +1,7 @@
 #include "Isis.h"
+#include "OrderFilter.h"
 #include "ProcessByBoxcar.h"
 #include "SpecialPixel.h"
-#include <algorithm>
-#include <vector>
 
 using namespace std;
 using namespace Isis;
@@ -16,6 +15,7 @@ double low;
 double high;
 bool propagate;
 unsigned int  minimum;
+OrderFilter *filter;
 
 void FilterAll(Buffer &in, double &v);
 void FilterValid(Buffer &in, double &v);
@@ -63,6 +63,11 @@ void IsisMain(){
   //non-Special pixels
   propagate = (ui.GetString("REPLACEMENT") == "CENTER");
 
+  //Keep the valid pixels of the boxcar sorted
+  OrderFilter medianFilter(samples, lines);
+  medianFilter.SetMinMax(low, high);
+  filter = &medianFilter;
+
   //Check for filter style, and process accordingly
   if (ui.GetString("FILTER") == "ALL"){
     p.StartProcess(FilterAll);
@@ -113,21 +118,13 @@ void FilterValid(Buffer &in, double &v){
     return;
   }
 
-  //Build a vector containing the non-Special pixel values
-  //from the input buffer. If there are not enough to meet
-  //the minimum requirements, write a user-selected value
-  //to the center. If there are, sort the vector and write
+  //Load the boxcar into the filter, which keeps the valid
+  //pixels sorted as the boxcar slides. If there are not
+  //enough to meet the minimum requirements, write a
+  //user-selected value to the center. If there are, write
   //the median value to the center.
-  std::vector<double> boxdata(0);
-  for (int i=0; i<in.size(); i++){
-    if (!IsSpecial(in[i]) && in[i]>=low && in[i]<=high){
-      boxdata.push_back(in[i]);
-    }
-    else{
-      continue;
-    }
-  }
-  if (boxdata.size()<minimum){
+  filter->Load(in);
+  if ((unsigned int)filter->Count()<minimum){
     if (propagate){
       v = centerPixel;
       return;
@@ -137,8 +134,7 @@ void FilterValid(Buffer &in, double &v){
       return;
     }
   }
-  sort(boxdata.begin(), boxdata.end());
-  v = boxdata[(boxdata.size()-1)/2];
+  v = filter->Median();
 }
 
 //Function to loop through the boxcar and find and write
@@ -176,21 +172,12 @@ void FilterInvalid(Buffer &in, double &v){
       return;
   }
 
-  //Build a vector of non-Special pixel values from the
-  //input boxcar, then sort and find the median value.
-  //If there aren't enough to meet the minimum requirements,
-  //write a user-selected value to the center pixel.
-  std::vector<double> boxdata(0);
-
-  for (int i=0; i<in.size(); i++){
-    if (!IsSpecial(in[i]) && in[i]>=low && in[i]<=high){
-      boxdata.push_back(in[i]);
-    }
-    else{
-      continue;
-    }
-  }
-  if (boxdata.size()<minimum){
+  //Load the boxcar into the filter and find the median
+  //value. If there aren't enough valid pixels to meet the
+  //minimum requirements, write a user-selected value to the
+  //center pixel.
+  filter->Load(in);
+  if ((unsigned int)filter->Count()<minimum){
     if (propagate){
       v = centerPixel;
       return;
@@ -200,8 +187,7 @@ void FilterInvalid(Buffer &in, double &v){
       return;
     }
   }
-  sort(boxdata.begin(), boxdata.end());
-  v = boxdata[(boxdata.size()-1)/2];
+  v = filter->Median();
 }
 
 //Function to find the median value of the boxcar and 
@@ -235,21 +221,12 @@ void FilterAll(Buffer &in, double &v){
     }
   }
 
-  //Build a vector of non-Special pixel values from the
-  //input boxcar, then sort and find the median value.
-  //If there aren't enough to meet the minimum requirements,
-  //write a user-selected value to the center pixel.
-  std::vector<double> boxdata(0);
-
-  for (int i=0; i<in.size(); i++){
-    if (!IsSpecial(in[i]) && in[i]>=low && in[i]<=high){
-      boxdata.push_back(in[i]);
-    }
-    else{
-      continue;
-    }
-  }
-  if (boxdata.size()<minimum){
+  //Load the boxcar into the filter and find the median
+  //value. If there aren't enough valid pixels to meet the
+  //minimum requirements, write a user-selected value to the
+  //center pixel.
+  filter->Load(in);
+  if ((unsigned int)filter->Count()<minimum){
     if (propagate){
       v = centerPixel;
       return;
@@ -259,7 +236,6 @@ void FilterAll(Buffer &in, double &v){
       return;
     }
   }
-  sort(boxdata.begin(), boxdata.end());
-  v = boxdata[(boxdata.size()-1)/2];
+  v = filter->Median();
 }
 
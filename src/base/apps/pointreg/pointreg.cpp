@@ -12,14 +12,89 @@
 #include "CubeManager.h"
 #include "iTime.h"
 
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+
 using namespace std;
 using namespace Isis;
 
+// The parameters deciding which points are registered and which are kept
+struct RegisterOptions {
+  bool registerIgnored;
+  bool outputIgnored;
+  bool outputUnmeasured;
+};
+
+// The output point for one input point and what it adds to the log
+class PointResult {
+  public:
+    PointResult() : add(false), ignored(0), unmeasured(0), registered(0),
+                    unregistered(0), validated(0) {}
+
+    ControlPoint point;
+    bool add;
+    int ignored, unmeasured, registered, unregistered, validated;
+};
+
+void RegisterPoint(ControlPoint &inPoint, AutoReg *ar, CubeManager &cubeMgr,
+                   SerialNumberList &files, const RegisterOptions &opts,
+                   QMutex *cubeLock, PointResult &result);
+void AddResult(PointResult &result, ControlNet &outNet, PointResult &totals);
+Pvl RegistrationStatistics(vector<AutoReg *> &ars);
+
+class PointQueue;
+
+// One of the threads registering points.  Each thread has its own AutoReg
+// and CubeManager, so it loads chips from its own cubes and cameras.
+class PointWorker : public QThread {
+  public:
+    PointWorker(PointQueue &queue, AutoReg *ar);
+
+  protected:
+    void run();
+
+  private:
+    PointQueue *p_queue;
+    AutoReg *p_ar;
+    CubeManager p_cubeMgr;
+};
+
+// The points shared by the registration threads.  The threads take the
+// points in order and leave their results for the main thread, which adds
+// them to the output network in the order of the input network.
+class PointQueue {
+  public:
+    PointQueue(ControlNet &net, SerialNumberList &files,
+               const RegisterOptions &opts);
+    ~PointQueue();
+
+    ControlNet *net;
+    SerialNumberList *files;
+    RegisterOptions opts;
+
+    // Opening cubes and loading chips goes through the cameras and so
+    // NAIF, which is not reentrant, so only one thread at a time does it
+    QMutex cubeLock;
+
+    QMutex mutex;                 // Protects the members below
+    QWaitCondition done;          // Signaled when a point is done
+    int next;                     // Next point to register
+    vector<PointResult *> results;  // Results not yet added to the output
+    bool failed;                  // A thread ran into an error
+    Pvl errors;                   // PvlErrors of the first error
+};
+
 void IsisMain() {
   // Get user interface
   UserInterface &ui = Application::GetUserInterface();
 
-  bool register_ignored = ui.GetBoolean("REGISTERIGNOREDONLY");
+  RegisterOptions opts;
+  opts.registerIgnored = ui.GetBoolean("REGISTERIGNOREDONLY");
+  opts.outputIgnored = ui.GetBoolean("OUTPUTIGNORED");
+  opts.outputUnmeasured = ui.GetBoolean("OUTPUTUNMEASURED");
+  int threads = ui.GetInteger("THREADS");
 
   // Open the files list in a SerialNumberList for
   // reference by SerialNumber
@@ -28,9 +103,13 @@ void IsisMain() {
   // Create a ControlNet from the input file
   ControlNet inNet(ui.GetFilename("CNET"));
 
-  // Create an AutoReg from the template file
+  // Create an AutoReg from the template file for every thread
   Pvl pvl(ui.GetFilename("TEMPLATE"));
-  AutoReg *ar = AutoRegFactory::Create(pvl);
+  vector<AutoReg *> ars;
+  for (int t=0; t<threads; t++) {
+    ars.push_back(AutoRegFactory::Create(pvl));
+  }
+  AutoReg *ar = ars[0];
 
   // Create the output ControlNet
   ControlNet outNet;
@@ -45,195 +124,69 @@ void IsisMain() {
   progress.SetMaximumSteps(inNet.Size());
   progress.CheckStatus();
 
-  int ignored=0, unmeasured=0, registered=0, unregistered=0, validated=0;
-
-  CubeManager cubeMgr;
-  cubeMgr.SetNumOpenCubes(50);
+  PointResult totals;
 
   // Register the points and create a new
   // ControlNet containing the refined measurements
-  for (int i=0; i<inNet.Size(); i++) {
-    ControlPoint &inPoint = inNet[i];
-
-    ControlPoint outPoint;
-    outPoint.SetType(inPoint.Type());
-    outPoint.SetId(inPoint.Id());
-    outPoint.SetUniversalGround(inPoint.UniversalLatitude(), inPoint.UniversalLongitude(), inPoint.Radius());
-    outPoint.SetHeld(inPoint.Held());
-    outPoint.SetIgnore(inPoint.Ignore());
-
-    // CHECK TO SEE IF THE CONTROL POINT SHOULD BE REGISTERED
-
-    // "Ignore" point and we are not registering ignored
-    if (inPoint.Ignore() && !register_ignored){
-      ignored++;
-      // add "Ignored" to network only if indicated
-      if (ui.GetBoolean("OUTPUTIGNORED")) {
-        // only include appropriate control measures
-        for (int j = 0; j < inPoint.Size(); j++) {
-          if (inPoint[j].IsMeasured()){
-            outPoint.Add(inPoint[j]); 
-          } 
-          else{
-            unmeasured++;
-            if (ui.GetBoolean("OUTPUTUNMEASURED")){
-              outPoint.Add(inPoint[j]); 
-            } 
-          }
-        }
-        // only add this point if OUTPUTIGNORED
-        outNet.Add(outPoint);
-      }
-      // go to next control point
-      continue;
+  if (threads == 1) {
+    CubeManager cubeMgr;
+    cubeMgr.SetNumOpenCubes(50);
+
+    for (int i=0; i<inNet.Size(); i++) {
+      PointResult result;
+      RegisterPoint(inNet[i], ar, cubeMgr, files, opts, NULL, result);
+      AddResult(result, outNet, totals);
+      progress.CheckStatus();
     }
-    // Not "Ignore" point (i.e. "valid") and we are only registering "Ignored"
-    else if (!inPoint.Ignore() && register_ignored) {
-      // add all "valid" points to network
-      // only include appropriate control measures
-      for (int j = 0; j < inPoint.Size(); j++) {
-        if (inPoint[j].IsMeasured()){
-          outPoint.Add(inPoint[j]); 
-        } 
-        else{
-          unmeasured++;
-          if (ui.GetBoolean("OUTPUTUNMEASURED")) {
-            outPoint.Add(inPoint[j]);
-          } 
-        }
-      }
-      // add this point since it is not ignored
-      outNet.Add(outPoint);
-      // go to next control point
-      continue;
+  }
+  else {
+    PointQueue queue(inNet, files, opts);
+    vector<PointWorker *> workers;
+    for (int t=0; t<threads; t++) {
+      workers.push_back(new PointWorker(queue, ars[t]));
+      workers[t]->start();
     }
-    // "Ignore" point or "valid" point to be registered
-    else { // if ( (inPoint.Ignore() && register_ignored) || (!inPoint.Ignore() && !register_ignored ) ) {
-      if (inPoint.Ignore()) { outPoint.SetIgnore(false); }
-      
-      ControlMeasure &patternCM = inPoint[inPoint.ReferenceIndex()];
-      Cube &patternCube = *cubeMgr.OpenCube(files.Filename(patternCM.CubeSerialNumber()));
-      
-      ar->PatternChip()->TackCube(patternCM.Sample(), patternCM.Line());
-      ar->PatternChip()->Load(patternCube);
-      
-      if (patternCM.IsValidated()) validated++;
-      if (!patternCM.IsMeasured()) continue;
-      if(!patternCM.IsReference()) {
-        patternCM.SetReference(true);
-        patternCM.SetChooserName("Application pointreg");
-        patternCM.SetDateTime();
-      }
-      outPoint.Add(patternCM);
-      
-      // reset goodMeasureCount for this point before looping measures
-      int goodMeasureCount = 0; 
-      // Register all the unvalidated measurements
-      for (int j = 0; j < inPoint.Size(); j++) {
-        // don't register the reference, go to next measure
-        if (j == inPoint.ReferenceIndex()){
-          if (!inPoint[j].Ignore()) goodMeasureCount++;
-          continue;
-        }
-        // if the measurement is valid, keep it as is and go to next measure
-        if (inPoint[j].IsValidated()) {
-          validated++;
-          outPoint.Add(inPoint[j]);
-          if (!inPoint[j].Ignore()) goodMeasureCount++;
-          continue;
-        }
-        // if the point is unmeasured, add to output only if necessary and go to next measure
-        if (!inPoint[j].IsMeasured()) {
-          unmeasured++;
-          if (ui.GetBoolean("OUTPUTUNMEASURED")) {
-            outPoint.Add(inPoint[j]);
-          }
-          continue;
-        }
-      
-        ControlMeasure searchCM = inPoint[j];
-      
-        // refresh pattern cube pointer to ensure it stays valid
-        Cube &patternCube = *cubeMgr.OpenCube(files.Filename(patternCM.CubeSerialNumber()));
-        Cube &searchCube = *cubeMgr.OpenCube(files.Filename(searchCM.CubeSerialNumber()));
-
-        ar->SearchChip()->TackCube(searchCM.Sample(), searchCM.Line());
-      
-        try {
-          ar->SearchChip()->Load(searchCube,*(ar->PatternChip()),patternCube);
-      
-          // If the measurements were correctly registered
-          // Write them to the new ControlNet
-          AutoReg::RegisterStatus res = ar->Register();
-      
-          double score1, score2;
-          ar->ZScores(score1, score2);
-          searchCM.SetZScores(score1, score2);
-      
-          if(res == AutoReg::Success) {
-            registered++;
-            searchCM.SetType(ControlMeasure::Automatic);
-            searchCM.SetError(searchCM.Sample() - ar->CubeSample(), searchCM.Line() - ar->CubeLine());
-            searchCM.SetCoordinate(ar->CubeSample(),ar->CubeLine());
-            searchCM.SetGoodnessOfFit(ar->GoodnessOfFit());
-            searchCM.SetChooserName("Application pointreg");
-            searchCM.SetDateTime();
-            searchCM.SetIgnore(false);
-            outPoint.Add(searchCM);
-            goodMeasureCount++;
-          }
-          // Else use the original marked as "Estimated"
-          else {
-            unregistered++;
-            searchCM.SetType(ControlMeasure::Estimated);
-      
-            if(res == AutoReg::FitChipToleranceNotMet) {
-              searchCM.SetError(inPoint[j].Sample() - ar->CubeSample(), inPoint[j].Line() - ar->CubeLine());
-              searchCM.SetGoodnessOfFit(ar->GoodnessOfFit());
-            }
-            searchCM.SetChooserName("Application pointreg");
-            searchCM.SetDateTime();
-            searchCM.SetIgnore(true);
-            outPoint.Add(searchCM);
-          }
-        } catch (iException &e) {
-          e.Clear();
-          unregistered++;
-          searchCM.SetType(ControlMeasure::Estimated);
-          searchCM.SetChooserName("Application pointreg");
-          searchCM.SetDateTime();
-          searchCM.SetIgnore(true);
-          outPoint.Add(searchCM);
-        }
-      }
 
-      // Jeff Anderson put in this test (Dec 2, 2008) to allow for control 
-      // points to be good so long as at least two measure could be 
-      // registered. When a measure can't be registered to the reference then
-      // that measure is set to be ignored where in the past the whole point
-      // was ignored
-      if (goodMeasureCount < 2) {
-        if (!outPoint.Held() && outPoint.Type() != ControlPoint::Ground) {
-          outPoint.SetIgnore(true);
-        }
-      }
-      // Otherwise, ignore=false. This is already set at the beginning of the registration process
-
-      // Check to see if the control point has now been assigned
-      // to "ignore".  If not, add it to the network. If so, only 
-      // add it to the output if the OUTPUTIGNORED parameter is selected
-      // 2008-11-14 Jeannie Walldren
-      if (!outPoint.Ignore()) {                             
-        outNet.Add(outPoint);
+    // Add the points as soon as they and all points before them are done
+    queue.mutex.lock();
+    int i = 0;
+    while (i < inNet.Size() && !queue.failed) {
+      if (queue.results[i] == NULL) {
+        queue.done.wait(&queue.mutex);
+        continue;
       }
-      else{                                              
-        ignored++;                                   
-        if (ui.GetBoolean("OUTPUTIGNORED")) outNet.Add(outPoint);
+      PointResult *result = queue.results[i];
+      queue.results[i] = NULL;
+      queue.mutex.unlock();
+
+      AddResult(*result, outNet, totals);
+      delete result;
+      progress.CheckStatus();
+      i++;
+
+      queue.mutex.lock();
+    }
+    queue.mutex.unlock();
+
+    for (int t=0; t<threads; t++) {
+      workers[t]->wait();
+      delete workers[t];
+    }
+
+    if (queue.failed) {
+      for (int t=0; t<threads; t++) {
+        delete ars[t];
       }
+      throw iException::Message(queue.errors);
     }
-    progress.CheckStatus();
   }
 
+  int ignored = totals.ignored;
+  int unmeasured = totals.unmeasured;
+  int registered = totals.registered;
+  int unregistered = totals.unregistered;
+  int validated = totals.validated;
+
   // If flatfile was entered, create the flatfile
   // The flatfile is comma seperated and can be imported into an excel
   // spreadsheet
@@ -290,7 +243,7 @@ void IsisMain() {
   Application::Log(mLog);
 
   // Log Registration Statistics
-  Pvl arPvl = ar->RegistrationStatistics();
+  Pvl arPvl = RegistrationStatistics(ars);
 
   for(int i = 0; i < arPvl.Groups(); i++) {
     Application::Log(arPvl.Group(i));
@@ -302,5 +255,326 @@ void IsisMain() {
 
   outNet.Write(ui.GetFilename("TO"));
 
-  delete ar;
+  for (int t=0; t<threads; t++) {
+    delete ars[t];
+  }
+}
+
+
+/**
+ * Registers the measures of a control point against its reference measure.
+ * The chips are loaded under cubeLock when it is not NULL.
+ *
+ * @param inPoint  Point to register
+ * @param ar       AutoReg used to register the measures
+ * @param cubeMgr  Opens the cubes of the measures
+ * @param files    Cubes of the network by serial number
+ * @param opts     Points to register and keep
+ * @param cubeLock Lock held while opening cubes and loading chips
+ * @param result   Output point and log counts
+ */
+void RegisterPoint(ControlPoint &inPoint, AutoReg *ar, CubeManager &cubeMgr,
+                   SerialNumberList &files, const RegisterOptions &opts,
+                   QMutex *cubeLock, PointResult &result) {
+  ControlPoint &outPoint = result.point;
+  outPoint.SetType(inPoint.Type());
+  outPoint.SetId(inPoint.Id());
+  outPoint.SetUniversalGround(inPoint.UniversalLatitude(), inPoint.UniversalLongitude(), inPoint.Radius());
+  outPoint.SetHeld(inPoint.Held());
+  outPoint.SetIgnore(inPoint.Ignore());
+
+  // CHECK TO SEE IF THE CONTROL POINT SHOULD BE REGISTERED
+
+  // "Ignore" point and we are not registering ignored
+  if (inPoint.Ignore() && !opts.registerIgnored){
+    result.ignored++;
+    // add "Ignored" to network only if indicated
+    if (opts.outputIgnored) {
+      // only include appropriate control measures
+      for (int j = 0; j < inPoint.Size(); j++) {
+        if (inPoint[j].IsMeasured()){
+          outPoint.Add(inPoint[j]); 
+        } 
+        else{
+          result.unmeasured++;
+          if (opts.outputUnmeasured){
+            outPoint.Add(inPoint[j]); 
+          } 
+        }
+      }
+      // only add this point if OUTPUTIGNORED
+      result.add = true;
+    }
+    // go to next control point
+    return;
+  }
+  // Not "Ignore" point (i.e. "valid") and we are only registering "Ignored"
+  else if (!inPoint.Ignore() && opts.registerIgnored) {
+    // add all "valid" points to network
+    // only include appropriate control measures
+    for (int j = 0; j < inPoint.Size(); j++) {
+      if (inPoint[j].IsMeasured()){
+        outPoint.Add(inPoint[j]); 
+      } 
+      else{
+        result.unmeasured++;
+        if (opts.outputUnmeasured) {
+          outPoint.Add(inPoint[j]);
+        } 
+      }
+    }
+    // add this point since it is not ignored
+    result.add = true;
+    // go to next control point
+    return;
+  }
+  // "Ignore" point or "valid" point to be registered
+  else { // if ( (inPoint.Ignore() && opts.registerIgnored) || (!inPoint.Ignore() && !opts.registerIgnored ) ) {
+    if (inPoint.Ignore()) { outPoint.SetIgnore(false); }
+    
+    ControlMeasure &patternCM = inPoint[inPoint.ReferenceIndex()];
+    ar->PatternChip()->TackCube(patternCM.Sample(), patternCM.Line());
+    {
+      QMutexLocker locker(cubeLock);
+      Cube &patternCube = *cubeMgr.OpenCube(files.Filename(patternCM.CubeSerialNumber()));
+      ar->PatternChip()->Load(patternCube);
+    }
+    
+    if (patternCM.IsValidated()) result.validated++;
+    if (!patternCM.IsMeasured()) return;
+    if(!patternCM.IsReference()) {
+      patternCM.SetReference(true);
+      patternCM.SetChooserName("Application pointreg");
+      patternCM.SetDateTime();
+    }
+    outPoint.Add(patternCM);
+    
+    // reset goodMeasureCount for this point before looping measures
+    int goodMeasureCount = 0; 
+    // Register all the unvalidated measurements
+    for (int j = 0; j < inPoint.Size(); j++) {
+      // don't register the reference, go to next measure
+      if (j == inPoint.ReferenceIndex()){
+        if (!inPoint[j].Ignore()) goodMeasureCount++;
+        continue;
+      }
+      // if the measurement is valid, keep it as is and go to next measure
+      if (inPoint[j].IsValidated()) {
+        result.validated++;
+        outPoint.Add(inPoint[j]);
+        if (!inPoint[j].Ignore()) goodMeasureCount++;
+        continue;
+      }
+      // if the point is unmeasured, add to output only if necessary and go to next measure
+      if (!inPoint[j].IsMeasured()) {
+        result.unmeasured++;
+        if (opts.outputUnmeasured) {
+          outPoint.Add(inPoint[j]);
+        }
+        continue;
+      }
+    
+      ControlMeasure searchCM = inPoint[j];
+    
+      // refresh pattern cube pointer to ensure it stays valid
+      Cube *patternCube, *searchCube;
+      {
+        QMutexLocker locker(cubeLock);
+        patternCube = cubeMgr.OpenCube(files.Filename(patternCM.CubeSerialNumber()));
+        searchCube = cubeMgr.OpenCube(files.Filename(searchCM.CubeSerialNumber()));
+      }
+
+      ar->SearchChip()->TackCube(searchCM.Sample(), searchCM.Line());
+    
+      try {
+        {
+          QMutexLocker locker(cubeLock);
+          ar->SearchChip()->Load(*searchCube,*(ar->PatternChip()),*patternCube);
+        }
+    
+        // If the measurements were correctly registered
+        // Write them to the new ControlNet
+        AutoReg::RegisterStatus res = ar->Register();
+    
+        double score1, score2;
+        ar->ZScores(score1, score2);
+        searchCM.SetZScores(score1, score2);
+    
+        if(res == AutoReg::Success) {
+          result.registered++;
+          searchCM.SetType(ControlMeasure::Automatic);
+          searchCM.SetError(searchCM.Sample() - ar->CubeSample(), searchCM.Line() - ar->CubeLine());
+          searchCM.SetCoordinate(ar->CubeSample(),ar->CubeLine());
+          searchCM.SetGoodnessOfFit(ar->GoodnessOfFit());
+          searchCM.SetChooserName("Application pointreg");
+          searchCM.SetDateTime();
+          searchCM.SetIgnore(false);
+          outPoint.Add(searchCM);
+          goodMeasureCount++;
+        }
+        // Else use the original marked as "Estimated"
+        else {
+          result.unregistered++;
+          searchCM.SetType(ControlMeasure::Estimated);
+    
+          if(res == AutoReg::FitChipToleranceNotMet) {
+            searchCM.SetError(inPoint[j].Sample() - ar->CubeSample(), inPoint[j].Line() - ar->CubeLine());
+            searchCM.SetGoodnessOfFit(ar->GoodnessOfFit());
+          }
+          searchCM.SetChooserName("Application pointreg");
+          searchCM.SetDateTime();
+          searchCM.SetIgnore(true);
+          outPoint.Add(searchCM);
+        }
+      } catch (iException &e) {
+        // Each thread has its own messages, so this only clears the
+        // messages of this measure
+        e.Clear();
+        result.unregistered++;
+        searchCM.SetType(ControlMeasure::Estimated);
+        searchCM.SetChooserName("Application pointreg");
+        searchCM.SetDateTime();
+        searchCM.SetIgnore(true);
+        outPoint.Add(searchCM);
+      }
+    }
+
+    // Jeff Anderson put in this test (Dec 2, 2008) to allow for control 
+    // points to be good so long as at least two measure could be 
+    // registered. When a measure can't be registered to the reference then
+    // that measure is set to be ignored where in the past the whole point
+    // was ignored
+    if (goodMeasureCount < 2) {
+      if (!outPoint.Held() && outPoint.Type() != ControlPoint::Ground) {
+        outPoint.SetIgnore(true);
+      }
+    }
+    // Otherwise, ignore=false. This is already set at the beginning of the registration process
+
+    // Check to see if the control point has now been assigned
+    // to "ignore".  If not, add it to the network. If so, only 
+    // add it to the output if the OUTPUTIGNORED parameter is selected
+    // 2008-11-14 Jeannie Walldren
+    if (!outPoint.Ignore()) {                             
+      result.add = true;
+    }
+    else{                                              
+      result.ignored++;                                   
+      if (opts.outputIgnored) result.add = true;
+    }
+  }
+}
+
+
+// Adds the result of a point to the output network and the log counts
+void AddResult(PointResult &result, ControlNet &outNet, PointResult &totals) {
+  if (result.add) outNet.Add(result.point);
+  totals.ignored += result.ignored;
+  totals.unmeasured += result.unmeasured;
+  totals.registered += result.registered;
+  totals.unregistered += result.unregistered;
+  totals.validated += result.validated;
+}
+
+
+/**
+ * Returns the registration statistics of all threads.  The AutoReg counts
+ * are summed, the algorithm specific groups are those of the first thread.
+ *
+ * @param ars AutoReg of every thread
+ */
+Pvl RegistrationStatistics(vector<AutoReg *> &ars) {
+  Pvl stats = ars[0]->RegistrationStatistics();
+  const char *counts[] = { "AutoRegStatistics", "PatternChipFailures",
+                           "FitChipFailures", "SurfaceModelFailures" };
+  for (unsigned int t=1; t<ars.size(); t++) {
+    Pvl other = ars[t]->RegistrationStatistics();
+    for (int g=0; g<4; g++) {
+      PvlGroup &group = stats.FindGroup(counts[g]);
+      PvlGroup &otherGroup = other.FindGroup(counts[g]);
+      for (int k=0; k<group.Keywords(); k++) {
+        int sum = (int) group[k] + (int) otherGroup[k];
+        group[k].SetValue(iString(sum));
+      }
+    }
+  }
+  return stats;
+}
+
+
+//! Constructs a worker registering the points of queue with ar
+PointWorker::PointWorker(PointQueue &queue, AutoReg *ar) {
+  p_queue = &queue;
+  p_ar = ar;
+  p_cubeMgr.SetNumOpenCubes(50);
+}
+
+
+//! Registers points until there are none left or a thread failed
+void PointWorker::run() {
+  while (true) {
+    p_queue->mutex.lock();
+    if (p_queue->failed || p_queue->next >= p_queue->net->Size()) {
+      p_queue->mutex.unlock();
+      break;
+    }
+    int i = p_queue->next++;
+    p_queue->mutex.unlock();
+
+    ControlPoint &inPoint = (*p_queue->net)[i];
+    PointResult *result = new PointResult;
+    bool ok = true;
+    Pvl errors;
+    try {
+      RegisterPoint(inPoint, p_ar, p_cubeMgr, *p_queue->files,
+                    p_queue->opts, &p_queue->cubeLock, *result);
+    }
+    catch (iException &e) {
+      // The errors of this thread are passed on and cleared
+      ok = false;
+      string msg = "Unable to register control point [" + inPoint.Id() + "]";
+      errors = iException::Message(e.Type(), msg, _FILEINFO_).PvlErrors();
+      e.Clear();
+    }
+    catch (std::exception &e) {
+      ok = false;
+      errors = iException::Message(iException::Programmer, e.what(),
+                                   _FILEINFO_).PvlErrors();
+      iException::Clear();
+    }
+
+    p_queue->mutex.lock();
+    if (ok) {
+      p_queue->results[i] = result;
+    }
+    else {
+      delete result;
+      if (!p_queue->failed) {
+        p_queue->failed = true;
+        p_queue->errors = errors;
+      }
+    }
+    p_queue->done.wakeAll();
+    p_queue->mutex.unlock();
+  }
+}
+
+
+//! Constructs the queue of all points of net
+PointQueue::PointQueue(ControlNet &net, SerialNumberList &files,
+                       const RegisterOptions &opts) {
+  this->net = &net;
+  this->files = &files;
+  this->opts = opts;
+  next = 0;
+  results.resize(net.Size(), NULL);
+  failed = false;
+}
+
+
+//! Deletes the results which were not added to the output
+PointQueue::~PointQueue() {
+  for (unsigned int i=0; i<results.size(); i++) {
+    delete results[i];
+  }
 }
@@ -13,6 +13,9 @@ void IsisMain() {
   p.SetInputCube("NUMERATOR");
   p.SetInputCube("DENOMINATOR");
   p.SetOutputCube ("TO");
+
+  UserInterface &ui = Application::GetUserInterface();
+  p.SetThreads(ui.GetInteger("THREADS"));
   p.StartProcess(ratio);
   p.EndProcess();
 }
@@ -1,19 +1,62 @@
 #include "Isis.h"
 
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
+#include <map>
+#include <set>
 
 #include "Process.h"
+#include "FileList.h"
 #include "Filename.h"
 #include "PvlTranslationManager.h"
 #include "Camera.h"
 #include "CameraFactory.h"
 #include "iException.h"
 #include "KernelDb.h"
+#include "Progress.h"
+#include "Spice.h"
 #include "Table.h"
 
+#include <QProcess>
+#include <QStringList>
+
 using namespace std;
 using namespace Isis;
 
+// The kernels found for a cube
+struct CubeKernels {
+  Kernel lk, pck, targetSpk, fk, ik, sclk, spk, iak, dem, exk;
+  std::priority_queue< Kernel > ck;
+};
+
+// Finds the kernels of cubes.  The kernel databases of a mission are read
+// once, for the first cube of the mission.
+class KernelFinder {
+  public:
+    KernelFinder();
+    ~KernelFinder();
+
+    void Find(Pvl &lab, const string &file, CubeKernels &kernels);
+
+  private:
+    string p_transFile;
+    unsigned int p_allowedCK;
+    unsigned int p_allowedSPK;
+    map<string, KernelDb *> p_baseKernels;
+    map<string, KernelDb *> p_ckKernels;
+    map<string, KernelDb *> p_spkKernels;
+};
+
+void CheckCube(Cube *icube);
+void InitCube(Cube *icube, Process &p, const string &file,
+              CubeKernels kernels);
+string KernelSet(const CubeKernels &kernels);
+string ErrorMessage(iException &e);
+void InitList(FileList &list);
+void InitListProcesses(FileList &list, int processes);
+string CommandLineValue(const PvlKeyword &keyword);
+
 bool TryKernels(Cube *icube, Process &p,
                 Kernel lk, Kernel pck, 
                 Kernel targetSpk, Kernel ck,
@@ -25,11 +68,7 @@ bool TryKernels(Cube *icube, Process &p,
 void GetUserEnteredKernel(const string &param, Kernel &kernel);
 
 void IsisMain() {
-  // Open the input cube
-  Process p;
   UserInterface &ui = Application::GetUserInterface();
-  CubeAttributeInput cai;
-  Cube *icube = p.SetInputCube(ui.GetFilename("FROM"), cai, ReadWrite);
 
   // Make sure at least one CK & SPK quality was selected
   if (!ui.GetBoolean("CKPREDICTED") && !ui.GetBoolean("CKRECON") && !ui.GetBoolean("CKSMITHED") && !ui.GetBoolean("CKNADIR")) {
@@ -41,6 +80,45 @@ void IsisMain() {
     throw iException::Message(iException::User,msg,_FILEINFO_);
   }
 
+  if (ui.WasEntered("FROM") == ui.WasEntered("FROMLIST")) {
+    string msg = "Enter either FROM or FROMLIST";
+    throw iException::Message(iException::User,msg,_FILEINFO_);
+  }
+
+  if (ui.WasEntered("FROMLIST")) {
+    FileList list(ui.GetFilename("FROMLIST"));
+    if (ui.GetInteger("PROCESSES") > 1) {
+      InitListProcesses(list, ui.GetInteger("PROCESSES"));
+    }
+    else {
+      InitList(list);
+    }
+    return;
+  }
+
+  // Open the input cube
+  Process p;
+  CubeAttributeInput cai;
+  Cube *icube = p.SetInputCube(ui.GetFilename("FROM"), cai, ReadWrite);
+  CheckCube(icube);
+
+  Pvl lab = *icube->Label();
+  KernelFinder finder;
+  CubeKernels kernels;
+  finder.Find(lab, ui.GetFilename("FROM"), kernels);
+
+  InitCube(icube, p, ui.GetFilename("FROM"), kernels);
+
+  p.EndProcess();
+}
+
+
+/**
+ * Makes sure SPICE can be initialized for a cube
+ *
+ * @param icube The cube
+ */
+void CheckCube(Cube *icube) {
   // Make sure it is not projected
   Projection *proj = NULL;
   try {
@@ -54,109 +132,165 @@ void IsisMain() {
     string msg = "Can not initialize SPICE for a map projected cube";
     throw iException::Message(iException::User,msg,_FILEINFO_);
   }
+}
 
-  Pvl lab = *icube->Label();
 
-  // if cube has existing polygon delete it
-  if (icube->Label()->HasObject("Polygon")) {
-    icube->Label()->DeleteObject("Polygon");
-  }
+//! Gets the mission translation table and the kernel qualities allowed
+KernelFinder::KernelFinder() {
+  UserInterface &ui = Application::GetUserInterface();
 
   // Set up for getting the mission name
   // Get the directory where the system missions translation table is.
-  string transFile = p.MissionData("base", "translations/MissionName2DataDir.trn");
+  Process p;
+  p_transFile = p.MissionData("base", "translations/MissionName2DataDir.trn");
+
+  p_allowedCK = 0;
+  p_allowedSPK = 0;
+  if (ui.GetBoolean("CKPREDICTED"))  p_allowedCK |= spiceInit::kernelTypeEnum("PREDICTED");
+  if (ui.GetBoolean("CKRECON"))      p_allowedCK |= spiceInit::kernelTypeEnum("RECONSTRUCTED");
+  if (ui.GetBoolean("CKSMITHED"))    p_allowedCK |= spiceInit::kernelTypeEnum("SMITHED");
+  if (ui.GetBoolean("CKNADIR"))      p_allowedCK |= spiceInit::kernelTypeEnum("NADIR");
+  if (ui.GetBoolean("SPKPREDICTED")) p_allowedSPK |= spiceInit::kernelTypeEnum("PREDICTED");
+  if (ui.GetBoolean("SPKRECON"))     p_allowedSPK |= spiceInit::kernelTypeEnum("RECONSTRUCTED");
+  if (ui.GetBoolean("SPKSMITHED"))   p_allowedSPK |= spiceInit::kernelTypeEnum("SMITHED");
+}
+
+
+//! Deletes the kernel databases
+KernelFinder::~KernelFinder() {
+  map<string, KernelDb *>::iterator it;
+  for (it = p_baseKernels.begin(); it != p_baseKernels.end(); it++) {
+    delete it->second;
+  }
+  for (it = p_ckKernels.begin(); it != p_ckKernels.end(); it++) {
+    delete it->second;
+  }
+  for (it = p_spkKernels.begin(); it != p_spkKernels.end(); it++) {
+    delete it->second;
+  }
+}
+
+
+/**
+ * Finds the kernels of a cube in the system kernel databases of its mission,
+ * and replaces them with the kernels the user entered
+ *
+ * @param lab The labels of the cube
+ * @param file The cube, for error messages
+ * @param kernels Returns the kernels
+ */
+void KernelFinder::Find(Pvl &lab, const string &file, CubeKernels &kernels) {
+  UserInterface &ui = Application::GetUserInterface();
 
   // Get the mission translation manager ready
-  PvlTranslationManager missionXlater (lab, transFile);
+  PvlTranslationManager missionXlater (lab, p_transFile);
 
   // Get the mission name so we can search the correct DB's for kernels
   string mission = missionXlater.Translate ("MissionName");
 
   // Get system base kernels
-  unsigned int allowed = 0;
-  unsigned int allowedCK = 0;
-  unsigned int allowedSPK = 0;
-  if (ui.GetBoolean("CKPREDICTED"))  allowedCK |= spiceInit::kernelTypeEnum("PREDICTED");
-  if (ui.GetBoolean("CKRECON"))      allowedCK |= spiceInit::kernelTypeEnum("RECONSTRUCTED");
-  if (ui.GetBoolean("CKSMITHED"))    allowedCK |= spiceInit::kernelTypeEnum("SMITHED");
-  if (ui.GetBoolean("CKNADIR"))      allowedCK |= spiceInit::kernelTypeEnum("NADIR");
-  if (ui.GetBoolean("SPKPREDICTED")) allowedSPK |= spiceInit::kernelTypeEnum("PREDICTED");
-  if (ui.GetBoolean("SPKRECON"))     allowedSPK |= spiceInit::kernelTypeEnum("RECONSTRUCTED");
-  if (ui.GetBoolean("SPKSMITHED"))   allowedSPK |= spiceInit::kernelTypeEnum("SMITHED");
-  KernelDb baseKernels (allowed);
-  KernelDb ckKernels (allowedCK);
-  KernelDb spkKernels (allowedSPK);
-
-  baseKernels.LoadSystemDb(mission);
-  ckKernels.LoadSystemDb(mission);
-  spkKernels.LoadSystemDb(mission);
-
-  Kernel lk, pck, targetSpk, fk, ik, sclk, spk, iak, dem, exk;
-  std::priority_queue< Kernel > ck;
-  lk        = baseKernels.LeapSecond(lab);
-  pck       = baseKernels.TargetAttitudeShape(lab);
-  targetSpk = baseKernels.TargetPosition(lab);
-  ik        = baseKernels.Instrument(lab);
-  sclk      = baseKernels.SpacecraftClock(lab);
-  iak       = baseKernels.InstrumentAddendum(lab);
-  fk        = ckKernels.Frame(lab);
-  ck        = ckKernels.SpacecraftPointing(lab);
-  spk       = spkKernels.SpacecraftPosition(lab);
+  if (p_baseKernels.find(mission) == p_baseKernels.end()) {
+    KernelDb *baseKernels = new KernelDb(0);
+    KernelDb *ckKernels = new KernelDb(p_allowedCK);
+    KernelDb *spkKernels = new KernelDb(p_allowedSPK);
+    p_baseKernels[mission] = baseKernels;
+    p_ckKernels[mission] = ckKernels;
+    p_spkKernels[mission] = spkKernels;
+
+    baseKernels->LoadSystemDb(mission);
+    ckKernels->LoadSystemDb(mission);
+    spkKernels->LoadSystemDb(mission);
+  }
+  KernelDb &baseKernels = *p_baseKernels[mission];
+  KernelDb &ckKernels = *p_ckKernels[mission];
+  KernelDb &spkKernels = *p_spkKernels[mission];
+
+  kernels.lk        = baseKernels.LeapSecond(lab);
+  kernels.pck       = baseKernels.TargetAttitudeShape(lab);
+  kernels.targetSpk = baseKernels.TargetPosition(lab);
+  kernels.ik        = baseKernels.Instrument(lab);
+  kernels.sclk      = baseKernels.SpacecraftClock(lab);
+  kernels.iak       = baseKernels.InstrumentAddendum(lab);
+  kernels.fk        = ckKernels.Frame(lab);
+  kernels.ck        = ckKernels.SpacecraftPointing(lab);
+  kernels.spk       = spkKernels.SpacecraftPosition(lab);
 
   if (ui.GetBoolean("CKNADIR")) {
     // Only add nadir if no spacecraft pointing found
-    std::vector<std::string> kernels;
-    kernels.push_back("Nadir");
-    ck.push(Kernel((spiceInit::kernelTypes)0, kernels));
+    std::vector<std::string> nadir;
+    nadir.push_back("Nadir");
+    kernels.ck.push(Kernel((spiceInit::kernelTypes)0, nadir));
   }
 
   // Get user defined kernels and override ones already found
-  GetUserEnteredKernel("LS", lk);
-  GetUserEnteredKernel("PCK", pck);
-  GetUserEnteredKernel("TSPK", targetSpk);
-  GetUserEnteredKernel("FK", fk);
-  GetUserEnteredKernel("IK", ik);
-  GetUserEnteredKernel("SCLK", sclk);
-  GetUserEnteredKernel("SPK", spk);
-  GetUserEnteredKernel("IAK", iak);
-  GetUserEnteredKernel("EXTRA", exk);
+  GetUserEnteredKernel("LS", kernels.lk);
+  GetUserEnteredKernel("PCK", kernels.pck);
+  GetUserEnteredKernel("TSPK", kernels.targetSpk);
+  GetUserEnteredKernel("FK", kernels.fk);
+  GetUserEnteredKernel("IK", kernels.ik);
+  GetUserEnteredKernel("SCLK", kernels.sclk);
+  GetUserEnteredKernel("SPK", kernels.spk);
+  GetUserEnteredKernel("IAK", kernels.iak);
+  GetUserEnteredKernel("EXTRA", kernels.exk);
 
   // Get shape kernel
   if (ui.GetString ("SHAPE") == "USER") {
-    GetUserEnteredKernel("MODEL", dem);
+    GetUserEnteredKernel("MODEL", kernels.dem);
   } else if (ui.GetString("SHAPE") == "SYSTEM") {
-    dem = baseKernels.Dem(lab);
+    kernels.dem = baseKernels.Dem(lab);
   }
 
-  bool kernelSuccess = false;
-
-  if (ck.size() == 0 && !ui.WasEntered("CK")) {
+  if (kernels.ck.size() == 0 && !ui.WasEntered("CK")) {
     throw iException::Message(iException::Camera, 
-                              "No Camera Kernel found for the image ["+ui.GetFilename("FROM")
+                              "No Camera Kernel found for the image ["+file
                               +"]", 
                               _FILEINFO_);
   }
   else if(ui.WasEntered("CK")) {
     // ck needs to be array size 1 and empty kernel objects
-    while(ck.size()) ck.pop();
-    ck.push(Kernel());
+    while(kernels.ck.size()) kernels.ck.pop();
+    kernels.ck.push(Kernel());
+  }
+}
+
+
+/**
+ * Initializes the SPICE of a cube with the kernels found for it, trying each
+ * of its CKs in turn
+ *
+ * @param icube The cube
+ * @param p The process which opened the cube
+ * @param file The cube, for error messages
+ * @param kernels The kernels of the cube
+ */
+void InitCube(Cube *icube, Process &p, const string &file,
+              CubeKernels kernels) {
+  UserInterface &ui = Application::GetUserInterface();
+
+  // if cube has existing polygon delete it
+  if (icube->Label()->HasObject("Polygon")) {
+    icube->Label()->DeleteObject("Polygon");
   }
 
-  while(ck.size() != 0 && !kernelSuccess) {
-    Kernel realCkKernel = ck.top();
-    ck.pop();
+  bool kernelSuccess = false;
+
+  while(kernels.ck.size() != 0 && !kernelSuccess) {
+    Kernel realCkKernel = kernels.ck.top();
+    kernels.ck.pop();
 
     if (ui.WasEntered("CK")) {
       ui.GetAsString("CK", realCkKernel.kernels);
     }
 
     // Merge SpacecraftPointing and Frame into ck
-    for (int i = 0; i < fk.size(); i++) {
-      realCkKernel.push_back(fk[i]);
+    for (int i = 0; i < kernels.fk.size(); i++) {
+      realCkKernel.push_back(kernels.fk[i]);
     }
 
-    kernelSuccess = TryKernels(icube, p, lk, pck, targetSpk,
-                   realCkKernel, fk, ik, sclk, spk, iak, dem, exk);
+    kernelSuccess = TryKernels(icube, p, kernels.lk, kernels.pck,
+                               kernels.targetSpk, realCkKernel, kernels.fk,
+                               kernels.ik, kernels.sclk, kernels.spk,
+                               kernels.iak, kernels.dem, kernels.exk);
   }
 
   if(!kernelSuccess) {
@@ -164,8 +298,314 @@ void IsisMain() {
                               "Unable to initialize camera model", 
                               _FILEINFO_);
   }
+}
 
-  p.EndProcess();
+
+/**
+ * Returns the kernels a cube is first tried with, as one string.  Cubes with
+ * the same string load the same kernels.
+ *
+ * @param kernels The kernels of the cube
+ *
+ * @return string
+ */
+string KernelSet(const CubeKernels &kernels) {
+  vector<Kernel> set;
+  set.push_back(kernels.lk);
+  set.push_back(kernels.pck);
+  set.push_back(kernels.targetSpk);
+  set.push_back(kernels.ck.size() > 0 ? kernels.ck.top() : Kernel());
+  set.push_back(kernels.fk);
+  set.push_back(kernels.ik);
+  set.push_back(kernels.sclk);
+  set.push_back(kernels.spk);
+  set.push_back(kernels.iak);
+  set.push_back(kernels.dem);
+  set.push_back(kernels.exk);
+
+  string key;
+  for (unsigned int k=0; k<set.size(); k++) {
+    for (int i=0; i<set[k].size(); i++) {
+      key += set[k][i] + "\n";
+    }
+    key += "\n";
+  }
+  return key;
+}
+
+
+/**
+ * Returns the message of the last error of an exception, and clears it
+ *
+ * @param e The exception
+ *
+ * @return string
+ */
+string ErrorMessage(iException &e) {
+  string message = "Unable to initialize SPICE";
+  Pvl errPvl = e.PvlErrors();
+  if (errPvl.Groups() > 0) {
+    message = (string)errPvl.Group(errPvl.Groups()-1)["Message"];
+  }
+  e.Clear();
+  return message;
+}
+
+
+/**
+ * Initializes the SPICE of a list of cubes.  The cubes are grouped by the
+ * kernels they are first tried with and each group is initialized in turn,
+ * with the kernels kept loaded, so the kernels of a group are loaded once.
+ *
+ * @param list The cubes
+ */
+void InitList(FileList &list) {
+  UserInterface &ui = Application::GetUserInterface();
+
+  Progress prog;
+  prog.SetMaximumSteps(list.size() * 2);
+  prog.CheckStatus ();
+
+  // Find the kernels of every cube and group the cubes by them
+  KernelFinder finder;
+  vector<CubeKernels> kernels(list.size());
+  vector<string> errors(list.size());
+  map< string, vector<int> > groups;
+  vector<string> order;
+  for (unsigned int i=0; i<list.size(); i++) {
+    string set;
+    try {
+      Pvl lab(list[i]);
+      finder.Find(lab, list[i], kernels[i]);
+      set = KernelSet(kernels[i]);
+    }
+    catch (iException &e) {
+      errors[i] = ErrorMessage(e);
+    }
+
+    if (groups.find(set) == groups.end()) order.push_back(set);
+    groups[set].push_back(i);
+    prog.CheckStatus ();
+  }
+
+  Spice::KeepKernelsLoaded(true);
+
+  int failures = 0;
+  for (unsigned int g=0; g<order.size(); g++) {
+    vector<int> &group = groups[order[g]];
+    for (unsigned int c=0; c<group.size(); c++) {
+      int i = group[c];
+      if (errors[i].empty()) {
+        try {
+          Process p;
+          CubeAttributeInput cai;
+          Cube *icube = p.SetInputCube(list[i], cai, ReadWrite);
+          CheckCube(icube);
+          InitCube(icube, p, list[i], kernels[i]);
+          p.EndProcess();
+        }
+        catch (iException &e) {
+          errors[i] = ErrorMessage(e);
+        }
+      }
+
+      PvlGroup results("Results");
+      results += PvlKeyword("From", list[i]);
+      results += PvlKeyword("KernelSet", (int)g + 1);
+      if (!errors[i].empty()) {
+        results += PvlKeyword("Error", errors[i]);
+        failures++;
+      }
+      Application::Log(results);
+      prog.CheckStatus ();
+    }
+  }
+
+  Spice::KeepKernelsLoaded(false);
+
+  if (failures > 0) {
+    string msg = "Unable to initialize the SPICE of [" + iString(failures) +
+                 "] of the [" + iString((int)list.size()) + "] cubes in [" +
+                 ui.GetFilename("FROMLIST") + "]";
+    throw iException::Message(iException::User,msg,_FILEINFO_);
+  }
+}
+
+
+/**
+ * Initializes the SPICE of a list of cubes by running spiceinit on parts of
+ * the list at once.  The cubes are grouped by the kernels they are first
+ * tried with and the groups are split into parts of about the same number of
+ * cubes, so each process loads few kernel sets.  The Results groups the
+ * processes write to their logs are logged here, in the same order and with
+ * the same kernel set numbers as InitList gives them.
+ *
+ * @param list The cubes
+ * @param processes The number of processes
+ */
+void InitListProcesses(FileList &list, int processes) {
+  UserInterface &ui = Application::GetUserInterface();
+
+  // Find the kernels of every cube and group the cubes by them.  Cubes whose
+  // kernels can not be found are left to a process to report.
+  KernelFinder finder;
+  map< string, vector<int> > groups;
+  vector<string> order;
+  for (unsigned int i=0; i<list.size(); i++) {
+    string set;
+    try {
+      Pvl lab(list[i]);
+      CubeKernels kernels;
+      finder.Find(lab, list[i], kernels);
+      set = KernelSet(kernels);
+    }
+    catch (iException &e) {
+      e.Clear();
+    }
+
+    if (groups.find(set) == groups.end()) order.push_back(set);
+    groups[set].push_back(i);
+  }
+
+  // Split the grouped cubes into parts
+  int partSize = (list.size() + processes - 1) / processes;
+  vector<FileList> parts;
+  for (unsigned int g=0; g<order.size(); g++) {
+    vector<int> &group = groups[order[g]];
+    for (unsigned int c=0; c<group.size(); c++) {
+      if (parts.size() == 0 || (int)parts.back().size() == partSize) {
+        parts.push_back(FileList());
+      }
+      parts.back().push_back(list[group[c]]);
+    }
+  }
+
+  // Run spiceinit with the parameters the user entered on each part.  Each
+  // process writes its session log to a file of its own.
+  Pvl pvl;
+  ui.CommandLine(pvl);
+  PvlGroup &params = pvl.FindGroup("UserParameters");
+  QStringList args;
+  for (int k=0; k<params.Keywords(); k++) {
+    iString name = params[k].Name();
+    name.UpCase();
+    if (name == "FROMLIST" || name == "PROCESSES") continue;
+    if (!ui.WasEntered(name)) continue;
+    args << iString::ToQt(name + "=" + CommandLineValue(params[k]));
+  }
+  args << "PROCESSES=1";
+
+  Filename program("$ISISROOT/bin/spiceinit");
+  vector<Filename> partLists;
+  vector<Filename> partLogs;
+  vector<QProcess *> running;
+  for (unsigned int i=0; i<parts.size(); i++) {
+    Filename partList;
+    partList.Temporary("spiceinit", "lis");
+    parts[i].Write(partList.Expanded());
+    partLists.push_back(partList);
+
+    // Create the log now so the next part gets another temporary name
+    Filename partLog;
+    partLog.Temporary("spiceinit", "prt");
+    ofstream(partLog.Expanded().c_str());
+    partLogs.push_back(partLog);
+
+    QProcess *process = new QProcess;
+    process->setProcessChannelMode(QProcess::ForwardedChannels);
+    QStringList partArgs(args);
+    partArgs << iString::ToQt("FROMLIST=" + partList.Expanded());
+    partArgs << iString::ToQt("-log=" + partLog.Expanded());
+    process->start(iString::ToQt(program.Expanded()), partArgs);
+    running.push_back(process);
+  }
+
+  // The kernel set of each cube, numbered as InitList numbers them
+  map<string, int> kernelSets;
+  for (unsigned int g=0; g<order.size(); g++) {
+    vector<int> &group = groups[order[g]];
+    for (unsigned int c=0; c<group.size(); c++) {
+      kernelSets[list[group[c]]] = g + 1;
+    }
+  }
+
+  // Log the results of each part in the order of the parts, which is the
+  // order InitList logs them in
+  int failures = 0;
+  for (unsigned int i=0; i<running.size(); i++) {
+    running[i]->waitForFinished(-1);
+    delete running[i];
+    remove(partLists[i].Expanded().c_str());
+
+    Pvl log;
+    try {
+      log.Read(partLogs[i].Expanded());
+    }
+    catch (iException &e) {
+      e.Clear();
+    }
+    remove(partLogs[i].Expanded().c_str());
+
+    set<string> logged;
+    for (int o=0; o<log.Objects(); o++) {
+      PvlObject &run = log.Object(o);
+      for (int g=0; g<run.Groups(); g++) {
+        PvlGroup &results = run.Group(g);
+        if (!results.IsNamed("Results") || !results.HasKeyword("From")) {
+          continue;
+        }
+        string file = results["From"];
+        logged.insert(file);
+        results["KernelSet"] = kernelSets[file];
+        if (results.HasKeyword("Error")) failures++;
+        Application::Log(results);
+      }
+    }
+
+    // A process which ended without logging a cube did not initialize it
+    for (unsigned int c=0; c<parts[i].size(); c++) {
+      if (logged.find(parts[i][c]) != logged.end()) continue;
+      PvlGroup results("Results");
+      results += PvlKeyword("From", parts[i][c]);
+      results += PvlKeyword("KernelSet", kernelSets[parts[i][c]]);
+      results += PvlKeyword("Error", "The spiceinit process initializing "
+                            "this cube ended before reporting it");
+      Application::Log(results);
+      failures++;
+    }
+  }
+
+  if (failures > 0) {
+    string msg = "Unable to initialize the SPICE of [" + iString(failures) +
+                 "] of the [" + iString((int)list.size()) + "] cubes in [" +
+                 ui.GetFilename("FROMLIST") + "]";
+    throw iException::Message(iException::User,msg,_FILEINFO_);
+  }
+}
+
+
+/**
+ * Formats the values of a parameter for the command line of spiceinit.  A
+ * parameter with several values, such as a list of kernels, is given as
+ * (value1,value2,...).  Values with spaces, commas or parentheses are quoted.
+ *
+ * @param keyword The parameter, as UserInterface::CommandLine gives it
+ *
+ * @return string The value to put after the equal sign
+ */
+string CommandLineValue(const PvlKeyword &keyword) {
+  string value;
+  for (int v=0; v<keyword.Size(); v++) {
+    string item = keyword[v];
+    if (item.find_first_of(" ,()") != string::npos) {
+      item = "\"" + item + "\"";
+    }
+    if (v > 0) value += ",";
+    value += item;
+  }
+
+  if (keyword.Size() > 1) value = "(" + value + ")";
+  return value;
 }
 
 /**
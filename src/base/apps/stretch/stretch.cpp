@@ -65,6 +65,7 @@ void IsisMain() {
      str.SetHrs(StringToPixel(ui.GetString("HRS")));
 
   p.SetOutputCube ("TO");
+  p.SetThreads(ui.GetInteger("THREADS"));
 
   // Start the processing
   p.StartProcess(stretch);
@@ -699,13 +699,33 @@ namespace Isis {
       }
     }
 
+    // Let algorithms which compute the whole fit surface at once fill the
+    // fit chip, then pick the best fit from it
+    if (MatchSurface(sChip, pChip, fChip, ss, es, sl, el)) {
+      for (int line=sl; line<=el; line++) {
+        for (int samp=ss; samp<=es; samp++) {
+          double fit = fChip.GetValue(samp,line);
+          if (fit == Isis::Null) continue;
+          if ((p_bestFit == Isis::Null) || CompareFits(fit,p_bestFit)) {
+            p_bestFit = fit;
+            p_bestSamp = samp;
+            p_bestLine = line;
+          }
+        }
+      }
+      return;
+    }
+
     // Create a chip the same size as the pattern chip.
     Chip subsearch(pChip.Samples(), pChip.Lines());
 
     for (int line=sl; line<=el; line++) {
       for (int samp=ss; samp<=es; samp++) {
-        // Extract the sub search chip and make sure it has enough valid data
-        sChip.Extract(samp,line, subsearch);
+        // Extract the sub search chip and make sure it has enough valid data.
+        // Inside the search chip a view of it saves copying the pixels.
+        if (!sChip.View(samp,line, subsearch)) {
+          sChip.Extract(samp,line, subsearch);
+        }
 
         if (!subsearch.IsValid(p_patternValidPercent)) continue;
 
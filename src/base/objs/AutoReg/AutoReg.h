@@ -118,6 +118,11 @@ namespace Isis {
    *             eccentricity testing, and made it so that the
    *             eccentricity is assumed to be 0 when it cannot
    *             otherwise be computed.
+   *    @history 2026-10-17 Unknown - Added the MatchSurface virtual method so
+   *             algorithms can compute the goodness of fit at every search
+   *             position at once.
+   *    @history 2026-10-17 Unknown - Match uses views of the search chip
+   *             instead of extracting a copy at every search position.
    *
    */
   class Pvl;
@@ -312,6 +317,22 @@ namespace Isis {
        */
       virtual double MatchAlgorithm (Chip &pattern, Chip &subsearch) = 0;
 
+      /**
+       * Fills the fit chip with the goodness of fit of every sub-search
+       * chip centered from sample ss to es and line sl to el of the search
+       * chip in one pass.  Algorithms which can compute the whole surface
+       * faster than one MatchAlgorithm call per position override this and
+       * return true.  Positions without a fit must be left Null.  The
+       * default returns false and the search chip is walked with
+       * MatchAlgorithm.
+       *
+       * @return bool True if the fit chip was filled
+       */
+      virtual bool MatchSurface(Chip &sChip, Chip &pChip, Chip &fChip,
+                                int ss, int es, int sl, int el) {
+        return false;
+      }
+
       PvlObject p_template; //!<AutoRegistration object that created this projection
 
       /**
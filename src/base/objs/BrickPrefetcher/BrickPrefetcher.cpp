@@ -0,0 +1,108 @@
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QMutexLocker>
+
+#include "BrickPrefetcher.h"
+#include "Brick.h"
+#include "Cube.h"
+#include "iException.h"
+
+using namespace std;
+namespace Isis {
+
+  /**
+   * Constructs a BrickPrefetcher and starts reading ahead. The first brick
+   * is left to the caller.
+   *
+   * @param cube The cube to read ahead in
+   * @param ns Number of samples in the brick
+   * @param nl Number of lines in the brick
+   * @param nb Number of bands in the brick
+   * @param depth Maximum number of bricks to read ahead of the caller
+   */
+  BrickPrefetcher::BrickPrefetcher(Cube &cube, int ns, int nl, int nb,
+                                   int depth) {
+    p_cube = &cube;
+    p_samples = ns;
+    p_lines = nl;
+    p_bands = nb;
+    p_depth = depth;
+    p_current = 0;
+    p_stop = false;
+
+    if (p_depth > 0) start();
+  }
+
+
+  //! Stops reading ahead and waits for the thread to finish
+  BrickPrefetcher::~BrickPrefetcher() {
+    p_mutex.lock();
+    p_stop = true;
+    p_advanced.wakeAll();
+    p_mutex.unlock();
+
+    wait();
+  }
+
+
+  /**
+   * Tells the prefetcher the caller is done reading the current brick and
+   * has moved on to the next one.
+   */
+  void BrickPrefetcher::Advance() {
+    QMutexLocker lock(&p_mutex);
+    p_current++;
+    p_advanced.wakeAll();
+  }
+
+
+  /**
+   * Walks the brick through the cube, waiting whenever it gets depth bricks
+   * ahead of the caller.
+   */
+  void BrickPrefetcher::run() {
+    try {
+      Brick brick(*p_cube,p_samples,p_lines,p_bands);
+      brick.begin();
+
+      for (int next=1; brick.next(); next++) {
+        p_mutex.lock();
+        while (!p_stop && (next > p_current + p_depth)) {
+          p_advanced.wait(&p_mutex);
+        }
+        bool stop = p_stop;
+        bool behind = (next <= p_current);
+        p_mutex.unlock();
+
+        if (stop) break;
+
+        // Don't bother if the caller already caught up with us
+        if (!behind) p_cube->Prefetch(brick);
+      }
+    }
+    catch (iException &e) {
+      // The caller will run into the same problem when it reads.  Only the
+      // errors of this thread are cleared.
+      e.Clear();
+    }
+  }
+}
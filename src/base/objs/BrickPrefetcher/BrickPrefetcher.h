@@ -0,0 +1,84 @@
+#ifndef BrickPrefetcher_h
+#define BrickPrefetcher_h
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+namespace Isis {
+  class Cube;
+
+  /**
+   * @brief Reads ahead of a brick traversal in a separate thread
+   *
+   * A BrickPrefetcher walks a brick of the given shape through a cube in the
+   * same order as a Brick buffer manager, loading the data of upcoming bricks
+   * into the cube's cache (see Cube::Prefetch) while the caller processes the
+   * current brick. The caller reports its progress with Advance after reading
+   * each brick, and the prefetcher stays at most depth bricks ahead so the
+   * bricks it loads are not evicted before they are used.
+   *
+   * @code
+   *   Brick brick(cube,ns,nl,nb);
+   *   BrickPrefetcher prefetch(cube,ns,nl,nb,2);
+   *   for (brick.begin(); !brick.end(); brick++) {
+   *     cube.Read(brick);
+   *     prefetch.Advance();
+   *     ...
+   *   }
+   * @endcode
+   *
+   * Errors while prefetching stop the prefetcher quietly; the same error will
+   * be reported when the caller reads the brick.
+   *
+   * @ingroup LowLevelCubeIO
+   *
+   * @author 2026-10-17 Unknown
+   *
+   * @internal
+   */
+  class BrickPrefetcher : private QThread {
+    public:
+      BrickPrefetcher(Cube &cube, int ns, int nl, int nb, int depth);
+      ~BrickPrefetcher();
+
+      void Advance();
+
+    protected:
+      void run();
+
+    private:
+      Cube *p_cube;      //!< Cube being prefetched
+      int p_samples;     //!< Samples in the brick
+      int p_lines;       //!< Lines in the brick
+      int p_bands;       //!< Bands in the brick
+      int p_depth;       //!< Maximum number of bricks to read ahead
+
+      int p_current;     //!< Index of the brick being processed by the caller
+      bool p_stop;       //!< Tells the thread to quit
+      QMutex p_mutex;            //!< Protects p_current and p_stop
+      QWaitCondition p_advanced; //!< Signaled by Advance and the destructor
+  };
+};
+
+#endif
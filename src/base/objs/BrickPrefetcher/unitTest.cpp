@@ -0,0 +1,82 @@
+#include <iostream>
+#include "BrickPrefetcher.h"
+#include "Brick.h"
+#include "Cube.h"
+#include "LineManager.h"
+#include "iException.h"
+#include "Preference.h"
+
+using namespace std;
+
+void ReadCube(Isis::Cube &cube, int ns, int nl, int nb, int depth);
+
+int main (int argc, char *argv[])
+{
+  Isis::Preference::Preferences(true);
+  cout << "Isis::BrickPrefetcher Unit Test" << endl << endl;
+
+  try {
+    Isis::Cube cube;
+    cube.SetDimensions(126,155,5);
+    cube.SetPixelType(Isis::Real);
+    cube.Create("/tmp/IsisBrickPrefetcher_01");
+
+    Isis::LineManager line(cube);
+    for (line.begin(); !line.end(); line++) {
+      for (int i=0; i<line.size(); i++) {
+        line[i] = (double) (line.Sample(i) + 1000 * line.Line() +
+                            1000000 * line.Band());
+      }
+      cube.Write(line);
+    }
+    cube.Close();
+
+    cube.Open("/tmp/IsisBrickPrefetcher_01");
+    ReadCube(cube,126,1,1,2);
+    ReadCube(cube,10,13,2,4);
+    ReadCube(cube,126,155,5,2);
+    ReadCube(cube,5,5,1,0);
+
+    // Destroying the prefetcher before the traversal is done
+    cout << "Stopping early" << endl;
+    {
+      Isis::BrickPrefetcher prefetch(cube,7,7,1,3);
+      prefetch.Advance();
+    }
+    cout << endl;
+    cube.Close(true);
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+
+  return 0;
+}
+
+/**
+ * Reads the cube by brick with read ahead and verifies each pixel
+ */
+void ReadCube(Isis::Cube &cube, int ns, int nl, int nb, int depth) {
+  cout << "Reading " << ns << "x" << nl << "x" << nb
+       << " bricks " << depth << " ahead" << endl;
+
+  Isis::Brick brick(cube,ns,nl,nb);
+  Isis::BrickPrefetcher prefetch(cube,ns,nl,nb,depth);
+  int bricks = 0;
+  int problems = 0;
+  for (brick.begin(); !brick.end(); brick++) {
+    cube.Read(brick);
+    prefetch.Advance();
+    bricks++;
+    for (int i=0; i<brick.size(); i++) {
+      if (brick.Sample(i) > cube.Samples() || brick.Line(i) > cube.Lines() ||
+          brick.Band(i) > cube.Bands()) continue;
+      double expected = (double) (brick.Sample(i) + 1000 * brick.Line(i) +
+                                  1000000 * brick.Band(i));
+      if (brick[i] != expected) problems++;
+    }
+  }
+  cout << "Bricks:   " << bricks << endl;
+  if (problems > 0) cout << "Problem: " << problems << " bad pixels" << endl;
+  cout << endl;
+}
@@ -1,18 +1,84 @@
 #include "BundleAdjust.h"
 
+#include <algorithm>
 #include <iomanip>
 
+#include <QThread>
+
 #include "SpecialPixel.h"
 #include "BasisFunction.h"
 #include "LeastSquares.h"
+#include "SparseBlockCholesky.h"
 #include "CameraGroundMap.h"
 #include "CameraDetectorMap.h"
 #include "CameraDistortionMap.h"
 #include "ControlPoint.h"
 #include "SpicePosition.h"
 #include "Application.h"
+#include "CameraFactory.h"
+#include "naif/SpiceUsr.h"
 
 namespace Isis {
+
+  /**
+   * The partials of the measures of a range of control points, assembled by
+   * one thread of BundleAdjust::AssemblePartials.  For the SCHUR method only
+   * the reduced camera system of the points is kept.
+   */
+  class BundleAssembly {
+    public:
+      BundleAssembly() : reduce(false), reduced(NULL), knowns(0), failed(false) {};
+      ~BundleAssembly() { delete reduced; };
+
+      int first;                     //!< First point of the range
+      int last;                      //!< One past the last point of the range
+      std::vector<Camera *> cameras; //!< Camera to use for each image
+      bool reduce;                   //!< Eliminate the points (SCHUR only)
+      SparseBlockCholesky *reduced;  //!< Reduced camera system, NULL if there are no image unknowns
+      std::vector<double> imageRhs;  //!< Right hand side of the reduced system
+      std::vector<int> columns;      //!< Image and point (or -1) column of each measure
+      std::vector<double> partials;  //!< Image x, image y, point x and point y partials of each measure
+      std::vector<double> deltax;    //!< Focal plane x residual of each measure
+      std::vector<double> deltay;    //!< Focal plane y residual of each measure
+      int knowns;                    //!< Number of knowns (two per measure)
+      bool failed;                   //!< The thread ran into an error
+      Pvl errors;                    //!< PvlErrors of the error
+  };
+
+
+  //! One of the threads of a parallel BundleAdjust::AssemblePartials
+  class BundleWorker : public QThread {
+    public:
+      BundleWorker(BundleAdjust &bundle, BundleAssembly &part) :
+        p_bundle(bundle), p_part(part) {};
+
+    protected:
+      void run() {
+        try {
+          p_bundle.AssembleRange(p_part);
+        }
+        catch (iException &e) {
+          // The errors of this thread are passed on and cleared
+          std::string msg = "Unable to compute the partials of points [" +
+                            iString(p_part.first) + "] to [" +
+                            iString(p_part.last - 1) + "]";
+          p_part.failed = true;
+          p_part.errors = iException::Message(e.Type(),msg,_FILEINFO_).PvlErrors();
+          e.Clear();
+        }
+        catch (std::exception &e) {
+          p_part.failed = true;
+          p_part.errors = iException::Message(iException::Programmer,e.what(),
+                                              _FILEINFO_).PvlErrors();
+          iException::Clear();
+        }
+      }
+
+    private:
+      BundleAdjust &p_bundle;
+      BundleAssembly &p_part;
+  };
+
   BundleAdjust::BundleAdjust(const std::string &cnetFile,
                              const std::string &cubeList,
                              bool printSummary) {
@@ -82,6 +148,12 @@ namespace Isis {
   }
 
   BundleAdjust::~BundleAdjust() {
+    for (unsigned int t=0; t<p_threadCameras.size(); t++) {
+      for (unsigned int i=0; i<p_threadCameras[t].size(); i++) {
+        delete p_threadCameras[t][i];
+      }
+    }
+
     if (p_cleanUp) {
       delete p_cnet;
       delete p_snlist;
@@ -152,6 +224,7 @@ namespace Isis {
     p_ckDegree = 2;
     p_solveCamDegree = p_ckDegree;
     p_numberCameraCoefSolved = 1;
+    p_threads = 1;
 
     ComputeNumberPartials();
 
@@ -359,6 +432,87 @@ namespace Isis {
     ComputeNumberPartials();
   }
 
+  /**
+   * Sets the number of threads used to compute the partials in each
+   * iteration of Solve.  Each thread after the first has its own camera for
+   * every image, so more threads use more memory.  The threads only wait
+   * on each other for the NAIF routines the cameras call, which hold
+   * NaifStatus::Mutex.  The default is one thread.
+   *
+   * @param threads Number of threads, zero or less uses one per processor
+   */
+  void BundleAdjust::SetThreads(int threads) {
+    p_threads = threads;
+    if (p_threads <= 0) p_threads = QThread::idealThreadCount();
+    if (p_threads < 1) p_threads = 1;
+  }
+
+  /**
+   * Creates a camera for every image for each thread after the first, which
+   * uses the control net cameras.
+   */
+  void BundleAdjust::CreateThreadCameras() {
+    if ((int)p_threadCameras.size() >= p_threads - 1) return;
+
+    for (int t=p_threadCameras.size(); t<p_threads-1; t++) {
+      std::vector<Camera *> cameras;
+      for (int i=0; i<Images(); i++) {
+        try {
+          Pvl pvl(Filename(i));
+          cameras.push_back(CameraFactory::Create(pvl));
+        }
+        catch (iException &e) {
+          for (unsigned int j=0; j<cameras.size(); j++) delete cameras[j];
+          std::string msg = "Unable to create camera for cube file ";
+          msg += Filename(i);
+          throw iException::Message(iException::System,msg,_FILEINFO_);
+        }
+      }
+      p_threadCameras.push_back(cameras);
+    }
+
+    // Only the error messages of the Naif routines are reported, not their
+    // traceback, so turn it off to shorten the time the threads hold
+    // NaifStatus::Mutex.
+    trcoff_c();
+  }
+
+  /**
+   * Copies the adjusted pointing and position polynomials of every image
+   * from the control net cameras to the cameras of the other threads.
+   */
+  void BundleAdjust::SyncThreadCameras() {
+    for (int i=0; i<Images(); i++) {
+      if (p_heldImages > 0) {
+        if ((p_heldsnlist->HasSerialNumber(p_snlist->SerialNumber(i)))) continue;
+      }
+      Camera *cam = p_cnet->Camera(i);
+
+      for (unsigned int t=0; t<p_threadCameras.size(); t++) {
+        Camera *tcam = p_threadCameras[t][i];
+
+        if (p_cmatrixSolveType != None) {
+          SpiceRotation *rot = cam->InstrumentRotation();
+          SpiceRotation *trot = tcam->InstrumentRotation();
+          std::vector<double> coefRA,coefDEC,coefTWI;
+          rot->GetPolynomial(coefRA,coefDEC,coefTWI);
+          trot->SetPolynomialDegree(coefRA.size() - 1);
+          trot->SetOverrideBaseTime(rot->GetBaseTime(),rot->GetTimeScale());
+          trot->SetPolynomial(coefRA,coefDEC,coefTWI);
+        }
+
+        if (p_spacecraftPositionSolveType != Nothing) {
+          SpicePosition *pos = cam->InstrumentPosition();
+          SpicePosition *tpos = tcam->InstrumentPosition();
+          std::vector<double> abcX,abcY,abcZ;
+          pos->GetPolynomial(abcX,abcY,abcZ);
+          tpos->SetOverrideBaseTime(pos->GetBaseTime());
+          tpos->SetPolynomial(abcX,abcY,abcZ);
+        }
+      }
+    }
+  }
+
   /**
    * Determine the number of columns we will need for the least
    * squares. When we create a row of data we will store all the
@@ -477,6 +631,8 @@ namespace Isis {
       }
     }
 
+    if (p_threads > 1) CreateThreadCameras();
+
     // Compute the apriori lat/lons for each nonheld point
     p_error = DBL_MAX;
     p_cnet->ComputeApriori();
@@ -499,25 +655,38 @@ namespace Isis {
 
       if (p_error <= tol) return p_error;
 
+      // Compute the partials of every measure, in several threads if requested
+      bool reduce = (p_solutionMethod == "SCHUR");
+      std::vector<BundleAssembly *> parts = AssemblePartials(reduce);
+      int knowns = 0;
+      for (unsigned int i=0; i<parts.size(); i++) knowns += parts[i]->knowns;
+
       // Create the basis function and prep for a least squares solution
       BasisFunction basis("Bundle",BasisColumns(),BasisColumns());
-      LeastSquares *lsq;
+      LeastSquares *lsq = NULL;
       if (p_solutionMethod == "SPARSE") {
         lsq = new LeastSquares(basis,Isis::LeastSquares::SPARSE,
                                p_cnet->NumValidMeasures()*2,BasisColumns());
       }
-      else {
+      else if (!reduce) {
         lsq = new LeastSquares(basis);
       }
 
-      // Loop through the control net and add the partials for each point
-      for (int i=0; i<p_cnet->Size(); i++) {
-        AddPartials(*lsq,i);
+      // Add the partials of each thread's points, in point order
+      if (lsq != NULL) {
+        for (unsigned int i=0; i<parts.size(); i++) {
+          AddKnowns(*lsq,*parts[i]);
+          delete parts[i];
+          parts[i] = NULL;
+        }
       }
 
       // Try to solve the iteration
       try {
-        if (p_solutionMethod == "SVD") {
+        if (reduce) {
+          SolveReduced(*parts[0],basis);
+        }
+        else if (p_solutionMethod == "SVD") {
           lsq->Solve(Isis::LeastSquares::SVD);
 
         } else if (p_solutionMethod == "QRD") {
@@ -543,6 +712,8 @@ namespace Isis {
         }
       }
       catch (iException &e) {
+        for (unsigned int i=0; i<parts.size(); i++) delete parts[i];
+        if (lsq != NULL) delete lsq;
         std::string msg = "Unable to solve in BundleAdjust, ";
         msg += "Iteration " + Isis::iString(p_iteration) + " of ";
         msg += Isis::iString(maxIterations) + ", Tolerance = ";
@@ -550,14 +721,17 @@ namespace Isis {
         throw Isis::iException::Message(iException::Math,msg,_FILEINFO_);
       }
 
+      for (unsigned int i=0; i<parts.size(); i++) delete parts[i];
+      if (lsq != NULL) delete lsq;
+
       // Ok take the results and put them back into the camera blobs
       Update(basis);
 //      return p_error;
 
       //Compute sigmas
-      sigmaXY = sqrt((p_statx.SumSquare() + p_staty.SumSquare())/lsq->Knowns());
-      sigmaHat = (lsq->Knowns() - BasisColumns()) ? 
-        (sqrt((p_statx.SumSquare() + p_staty.SumSquare())/ (lsq->Knowns() - BasisColumns())))
+      sigmaXY = sqrt((p_statx.SumSquare() + p_staty.SumSquare())/knowns);
+      sigmaHat = (knowns - BasisColumns()) ?
+        (sqrt((p_statx.SumSquare() + p_staty.SumSquare())/ (knowns - BasisColumns())))
         : 0.;
       sigmaX = p_statx.TotalPixels() ? 
         sqrt(p_statx.SumSquare()/p_statx.TotalPixels()) : 0.;
@@ -572,224 +746,582 @@ namespace Isis {
   }
 
   /**
-   * Populate the least squares matrix with measures for a point
+   * Computes the partials of every measure for one iteration.  The points
+   * are split into one range per thread (see SetThreads), and each thread
+   * computes the partials of its points with its own set of cameras.  For
+   * the SCHUR method each thread also accumulates the reduced camera system
+   * of its points, and the systems of all the threads are summed into the
+   * first one.  The residuals are added to the iteration statistics in point
+   * order.
+   *
+   * @param reduce Accumulate the reduced camera system instead of keeping
+   *               the partials of each measure
+   *
+   * @return std::vector<BundleAssembly*> The partials of each thread, in
+   *         point order.  The caller must delete them.
    */
-  void BundleAdjust::AddPartials (LeastSquares &lsq,
-                                  int pointIndex) {
-    ControlPoint &point = (*p_cnet)[pointIndex];
-    if (point.Ignore()) return;  // Ignore entire point
-    std::vector<double> lookJ(3);
-    std::vector<double> lookC(3);
+  std::vector<BundleAssembly *> BundleAdjust::AssemblePartials (bool reduce) {
+    if (p_threads > 1) SyncThreadCameras();
+
+    if (reduce) {
+      p_pointObs.assign(p_cnet->Size(),std::vector<int>());
+      p_pointW.assign(p_cnet->Size(),std::vector<double>());
+      p_pointVinv.assign(p_cnet->Size(),std::vector<double>());
+      p_pointRhs.assign(p_cnet->Size(),std::vector<double>());
+    }
 
-    for (int i=0; i<point.Size(); i++) {
-      if (point[i].Ignore()) continue;  // Ignore this measure
+    int threads = p_threads;
+    if (threads > p_cnet->Size()) threads = p_cnet->Size();
+    if (threads < 1) threads = 1;
+    int pointsPerThread = (p_cnet->Size() + threads - 1) / threads;
+
+    std::vector<BundleAssembly *> parts;
+    for (int t=0; t<threads; t++) {
+      BundleAssembly *part = new BundleAssembly;
+      part->first = t * pointsPerThread;
+      part->last = std::min(part->first + pointsPerThread, p_cnet->Size());
+      if (t == 0) {
+        for (int i=0; i<Images(); i++) part->cameras.push_back(p_cnet->Camera(i));
+      }
+      else {
+        part->cameras = p_threadCameras[t-1];
+      }
+      part->reduce = reduce;
+      if (reduce && (Observations() > 0) && (p_numImagePartials > 0)) {
+        part->reduced = new SparseBlockCholesky(Observations(),p_numImagePartials);
+        part->imageRhs.assign(Observations()*p_numImagePartials,0.0);
+      }
+      parts.push_back(part);
+    }
 
-      if (p_heldImages) {
-        if (p_heldsnlist->HasSerialNumber(point[i].CubeSerialNumber())) continue;
+    try {
+      if (threads == 1) {
+        AssembleRange(*parts[0]);
+      }
+      else {
+        std::vector<BundleWorker *> workers;
+        for (int t=0; t<threads; t++) {
+          workers.push_back(new BundleWorker(*this,*parts[t]));
+          workers[t]->start();
+        }
+        for (int t=0; t<threads; t++) {
+          workers[t]->wait();
+          delete workers[t];
+        }
+        for (int t=0; t<threads; t++) {
+          if (parts[t]->failed) {
+            throw iException::Message(parts[t]->errors);
+          }
+        }
       }
+    }
+    catch (iException &e) {
+      for (int t=0; t<threads; t++) delete parts[t];
+      throw;
+    }
 
-      Camera *cam = point[i].Camera();
-      // Get focal length with direction
-      double fl = cam->DistortionMap()->UndistortedFocalPlaneZ();
-      // Map the control point lat/lon/radius into the camera through the Spice
-      // at the measured point to correctly compute the partials for line scan
-      // cameras.  The camera SetUniversalGround method computes a time based
-      // on the lat/lon/radius and uses the Spice for that time instead of the
-      // measured point's time.
-      cam->SetImage(point[i].Sample(),point[i].Line());  // Set the Spice to the measured point
-
-      // Compute the look vector in instrument coordinates based on time of observation and apriori lat/lon/radius
-      if (!(cam->GroundMap()->GetXY( point.UniversalLatitude(), point.UniversalLongitude(), point.Radius(), lookJ))) {
-        std::string msg = "Unable to map apriori surface point for measure ";
-        msg += iString(i) + " on point " + point.Id() + " into focal plane";
-        throw iException::Message(iException::User,msg,_FILEINFO_);
+    for (int t=0; t<threads; t++) {
+      BundleAssembly &part = *parts[t];
+      for (unsigned int i=0; i<part.deltax.size(); i++) {
+        p_statx.AddData(part.deltax[i]);
+        p_staty.AddData(part.deltay[i]);
+      }
+      if ((part.reduced != NULL) && t > 0) {
+        parts[0]->reduced->Add(*part.reduced);
+        for (unsigned int i=0; i<part.imageRhs.size(); i++) {
+          parts[0]->imageRhs[i] += part.imageRhs[i];
+        }
+        delete part.reduced;
+        part.reduced = NULL;
       }
-      SpiceRotation *instRot = cam->InstrumentRotation();
-      lookC = instRot->ReferenceVector( lookJ);
+    }
 
-      // Create the known array to put in the least squares
-      std::vector<double> xKnowns(BasisColumns(),0.0);
-      std::vector<double> yKnowns(BasisColumns(),0.0);
+    return parts;
+  }
 
-      // Determine the image index for nonheld images
-      bool useImage=false;
+  /**
+   * Computes the partials of the measures of a range of points.  This is run
+   * by each thread of AssemblePartials, and only uses the cameras of the
+   * range so threads never share a camera.
+   *
+   * @param part The range of points, its cameras, and where to put the
+   *             partials
+   */
+  void BundleAdjust::AssembleRange (BundleAssembly &part) {
+    int m = p_numImagePartials;
+    int p = p_numPointPartials;
+    bool reduce = part.reduce;
 
-      if ( p_heldImages == 0) { 
-        useImage = true;
-      }
-      else if (p_heldImages > 0) {
-        if ((!(p_heldsnlist->HasSerialNumber(point[i].CubeSerialNumber())))) 
-          useImage = true;
-      }
-      if (useImage) {
-        int index = p_snlist->SerialNumberIndex(point[i].CubeSerialNumber());
-        index = ImageIndex(index);
+    std::vector<double> xImage,yImage,xPoint,yPoint;
+    std::vector<double> u(m*m);
+    double deltax,deltay;
 
-        if (p_spacecraftPositionSolveType != Nothing) {
-          SpicePosition *instPos = cam->InstrumentPosition();
+    for (int ip=part.first; ip<part.last; ip++) {
+      ControlPoint &point = (*p_cnet)[ip];
+      if (point.Ignore()) continue;  // Ignore entire point
+      bool solvePoint = (!point.Held()) && (point.Type() != ControlPoint::Ground);
 
-          // Add the partial for the x coordinate of the position (differentiating
-          // point(x,y,z) - spacecraftPosition(x,y,z) in J2000
-          std::vector<double> d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_X, 0);
-          for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
-          std::vector<double> d_lookC_WRT_X0 =  instRot->ReferenceVector(d_lookJ);
-          xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_X0,0);
-          yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_X0,1);
-          index++;
-
-          if (p_spacecraftPositionSolveType > PositionOnly) {
-            d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_X, 1);
-            for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
-            std::vector<double> d_lookC_WRT_X1 =  instRot->ReferenceVector(d_lookJ);
-            xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_X1,0);
-            yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_X1,1); index++;
-
-            if (p_spacecraftPositionSolveType == PositionVelocityAcceleration) {
-              d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_X, 2);
-              for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
-              std::vector<double> d_lookC_WRT_X2 =  instRot->ReferenceVector(d_lookJ);
-              xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_X2,0);
-              yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_X2,1); index++;
-            }
-          }
+      std::vector<double> v(p*p,0.0);
+      std::vector<double> g(p,0.0);
 
-          // Add the partial for the y coordinate of the position
-          d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Y, 0);
-          for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
-          std::vector<double> d_lookC_WRT_Y0 =  instRot->ReferenceVector(d_lookJ);
-          xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y0,0);
-          yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y0,1);
-          index++;
-
-          if (p_spacecraftPositionSolveType > PositionOnly) {
-             d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Y, 1);
-             for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
-             std::vector<double> d_lookC_WRT_Y1 =  instRot->ReferenceVector(d_lookJ);
-             xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y1,0);
-             yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y1,1); index++;
-
-            if (p_spacecraftPositionSolveType == PositionVelocityAcceleration) {
-              d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Y, 2);
-              for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
-              std::vector<double> d_lookC_WRT_Y2 =  instRot->ReferenceVector(d_lookJ);
-              xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y2,0);
-              yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y2,1); index++;
+      for (int i=0; i<point.Size(); i++) {
+        if (point[i].Ignore()) continue;  // Ignore this measure
+
+        if (p_heldImages) {
+          if (p_heldsnlist->HasSerialNumber(point[i].CubeSerialNumber())) continue;
+        }
+
+        int image = p_snlist->SerialNumberIndex(point[i].CubeSerialNumber());
+        ComputePartials(point,i,part.cameras[image],
+                        xImage,yImage,xPoint,yPoint,deltax,deltay);
+
+        if (!reduce) {
+          part.columns.push_back(ImageIndex(image));
+          part.columns.push_back(solvePoint ? PointIndex(ip) : -1);
+          part.partials.insert(part.partials.end(),xImage.begin(),xImage.end());
+          part.partials.insert(part.partials.end(),yImage.begin(),yImage.end());
+          part.partials.insert(part.partials.end(),xPoint.begin(),xPoint.end());
+          part.partials.insert(part.partials.end(),yPoint.begin(),yPoint.end());
+        }
+        else {
+          int o = ObservationIndex(image);
+
+          // Add the image block of the normal equations
+          for (int r=0; r<m; r++) {
+            for (int c=0; c<m; c++) {
+              u[r*m+c] = xImage[r] * xImage[c] + yImage[r] * yImage[c];
             }
+            part.imageRhs[o*m+r] += xImage[r] * deltax + yImage[r] * deltay;
           }
-
-          // Add the partial for the z coordinate of the position
-          d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Z, 0);
-          for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
-          std::vector<double> d_lookC_WRT_Z0 =  instRot->ReferenceVector(d_lookJ);
-          xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z0,0);
-          yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z0,1);
-          index++;
-
-          if (p_spacecraftPositionSolveType > PositionOnly) {
-            d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Z, 1);
-            for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
-            std::vector<double> d_lookC_WRT_Z1 =  instRot->ReferenceVector(d_lookJ);
-            xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z1,0);
-            yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z1,1); index++;
-
-            if (p_spacecraftPositionSolveType == PositionVelocityAcceleration) {
-              d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Z, 2);
-              for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
-              std::vector<double> d_lookC_WRT_Z2 =  instRot->ReferenceVector(d_lookJ);
-              xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z2,0);
-              yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z1,1); index++;
+          if (part.reduced != NULL) part.reduced->Add(o,o,u);
+
+          // Add the point block and the image-point block
+          if (solvePoint) {
+            std::vector<int> &obs = p_pointObs[ip];
+            std::vector<double> &w = p_pointW[ip];
+            int k = std::find(obs.begin(),obs.end(),o) - obs.begin();
+            if (k == (int)obs.size()) {
+              obs.push_back(o);
+              w.resize(w.size() + m*p,0.0);
+            }
+            for (int r=0; r<p; r++) {
+              for (int c=0; c<p; c++) {
+                v[r*p+c] += xPoint[r] * xPoint[c] + yPoint[r] * yPoint[c];
+              }
+              g[r] += xPoint[r] * deltax + yPoint[r] * deltay;
+            }
+            for (int r=0; r<m; r++) {
+              for (int c=0; c<p; c++) {
+                w[(k*m+r)*p+c] += xImage[r] * xPoint[c] + yImage[r] * yPoint[c];
+              }
             }
           }
         }
-        if (p_cmatrixSolveType != None) {
-          std::vector<double> d_lookC;
 
-          // Add the partials for ra
-          for (int icoef=0; icoef<p_numberCameraCoefSolved; icoef++) {
-            d_lookC = instRot->ToReferencePartial(lookJ,SpiceRotation::WRT_RightAscension, icoef);
-            xKnowns[index] = fl * LowDHigh(lookC,d_lookC,0);
-            yKnowns[index] = fl * LowDHigh(lookC,d_lookC,1);
-            index++;
-          }
+        part.deltax.push_back(deltax);
+        part.deltay.push_back(deltay);
+        part.knowns += 2;
+      }
+      if (!reduce || !solvePoint || p_pointObs[ip].empty()) continue;
+
+      // Eliminate the point, subtracting W V^-1 W' from the reduced system
+      // and W V^-1 g from its right hand side
+      std::vector<int> &obs = p_pointObs[ip];
+      std::vector<double> &w = p_pointW[ip];
+      std::vector<double> &vinv = p_pointVinv[ip];
+      if (!InvertPointBlock(v,vinv)) {
+        std::string msg = "Unable to solve for control point [" + point.Id();
+        msg += "] which probably indicates a point with too few measures.  ";
+        msg += "Running the program, cnetcheck, before jigsaw should catch ";
+        msg += "these problems.";
+        throw iException::Message(iException::Math,msg,_FILEINFO_);
+      }
 
-          // Add the partials for dec
-          for (int icoef=0; icoef<p_numberCameraCoefSolved; icoef++) {
-            d_lookC = instRot->ToReferencePartial(lookJ,SpiceRotation::WRT_Declination, icoef);
-            xKnowns[index] = fl * LowDHigh(lookC,d_lookC,0);
-            yKnowns[index] = fl * LowDHigh(lookC,d_lookC,1);
-            index++;
-          }
+      int n = obs.size();
+      std::vector<double> wv(n*m*p,0.0);
+      for (int r=0; r<n*m; r++) {
+        for (int c=0; c<p; c++) {
+          for (int t=0; t<p; t++) wv[r*p+c] += w[r*p+t] * vinv[t*p+c];
+        }
+      }
 
-          // Add the partial for twist if necessary
-          if (p_solveTwist) {
-            for (int icoef=0; icoef<p_numberCameraCoefSolved; icoef++) {
-              d_lookC = instRot->ToReferencePartial(lookJ,SpiceRotation::WRT_Twist, icoef);
-              xKnowns[index] = fl * LowDHigh(lookC,d_lookC,0);
-              yKnowns[index] = fl * LowDHigh(lookC,d_lookC,1); index++;
+      for (int a=0; a<n; a++) {
+        for (int r=0; r<m; r++) {
+          for (int t=0; t<p; t++) part.imageRhs[obs[a]*m+r] -= wv[(a*m+r)*p+t] * g[t];
+        }
+        for (int b=0; b<=a; b++) {
+          for (int r=0; r<m; r++) {
+            for (int c=0; c<m; c++) {
+              double sum = 0.0;
+              for (int t=0; t<p; t++) sum += wv[(a*m+r)*p+t] * w[(b*m+c)*p+t];
+              u[r*m+c] = -sum;
             }
           }
+          if (part.reduced != NULL) part.reduced->Add(obs[a],obs[b],u);
+        }
+      }
+      p_pointRhs[ip].swap(g);
+    }
+  }
+
+  /**
+   * Populate the least squares matrix with the measures of a range of points
+   */
+  void BundleAdjust::AddKnowns (LeastSquares &lsq, BundleAssembly &part) {
+    int m = p_numImagePartials;
+    int p = p_numPointPartials;
+    int size = 2*m + 2*p;
+
+    for (unsigned int i=0; i<part.deltax.size(); i++) {
+      const double *xImage = &part.partials[i*size];
+      const double *yImage = xImage + m;
+      const double *xPoint = yImage + m;
+      const double *yPoint = xPoint + p;
+
+      // Create the known array to put in the least squares
+      std::vector<double> xKnowns(BasisColumns(),0.0);
+      std::vector<double> yKnowns(BasisColumns(),0.0);
+
+      int index = part.columns[2*i];
+      for (int j=0; j<m; j++) {
+        xKnowns[index+j] = xImage[j];
+        yKnowns[index+j] = yImage[j];
+      }
+
+      index = part.columns[2*i+1];
+      if (index >= 0) {
+        for (int j=0; j<p; j++) {
+          xKnowns[index+j] = xPoint[j];
+          yKnowns[index+j] = yPoint[j];
+        }
+      }
+
+      lsq.AddKnown(xKnowns,part.deltax[i]);
+      lsq.AddKnown(yKnowns,part.deltay[i]);
+    }
+  }
+
+  /**
+   * Computes the partial derivatives of the focal plane x and y of a measure
+   * with respect to the parameters of its image and of its point, and the
+   * measured minus computed focal plane x and y.  The measure must not be on
+   * a held image.
+   *
+   * @param point    The control point
+   * @param measure  Index of the measure in the point
+   * @param cam      The camera of the measure's image
+   * @param xImage   Returns the x partials for the image parameters, in the
+   *                 order they are stored in the solution
+   * @param yImage   Returns the y partials for the image parameters
+   * @param xPoint   Returns the x partials for the point parameters, which are
+   *                 zero for held and ground points
+   * @param yPoint   Returns the y partials for the point parameters
+   * @param deltax   Returns the measured minus computed focal plane x (mm)
+   * @param deltay   Returns the measured minus computed focal plane y (mm)
+   */
+  void BundleAdjust::ComputePartials (ControlPoint &point, int measure,
+                                      Camera *cam,
+                                      std::vector<double> &xImage,
+                                      std::vector<double> &yImage,
+                                      std::vector<double> &xPoint,
+                                      std::vector<double> &yPoint,
+                                      double &deltax, double &deltay) {
+    std::vector<double> lookJ(3);
+    std::vector<double> lookC(3);
+    ControlMeasure &m = point[measure];
+
+    // Get focal length with direction
+    double fl = cam->DistortionMap()->UndistortedFocalPlaneZ();
+    // Map the control point lat/lon/radius into the camera through the Spice
+    // at the measured point to correctly compute the partials for line scan
+    // cameras.  The camera SetUniversalGround method computes a time based
+    // on the lat/lon/radius and uses the Spice for that time instead of the
+    // measured point's time.
+    cam->SetImage(m.Sample(),m.Line());  // Set the Spice to the measured point
+
+    // Compute the look vector in instrument coordinates based on time of observation and apriori lat/lon/radius
+    if (!(cam->GroundMap()->GetXY( point.UniversalLatitude(), point.UniversalLongitude(), point.Radius(), lookJ))) {
+      std::string msg = "Unable to map apriori surface point for measure ";
+      msg += iString(measure) + " on point " + point.Id() + " into focal plane";
+      throw iException::Message(iException::User,msg,_FILEINFO_);
+    }
+    SpiceRotation *instRot = cam->InstrumentRotation();
+    lookC = instRot->ReferenceVector( lookJ);
+
+    xImage.assign(p_numImagePartials,0.0);
+    yImage.assign(p_numImagePartials,0.0);
+    xPoint.assign(p_numPointPartials,0.0);
+    yPoint.assign(p_numPointPartials,0.0);
+
+    int index = 0;
+    if (p_spacecraftPositionSolveType != Nothing) {
+      SpicePosition *instPos = cam->InstrumentPosition();
+
+      // Add the partial for the x coordinate of the position (differentiating
+      // point(x,y,z) - spacecraftPosition(x,y,z) in J2000
+      std::vector<double> d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_X, 0);
+      for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
+      std::vector<double> d_lookC_WRT_X0 =  instRot->ReferenceVector(d_lookJ);
+      xImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_X0,0);
+      yImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_X0,1);
+      index++;
+
+      if (p_spacecraftPositionSolveType > PositionOnly) {
+        d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_X, 1);
+        for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
+        std::vector<double> d_lookC_WRT_X1 =  instRot->ReferenceVector(d_lookJ);
+        xImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_X1,0);
+        yImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_X1,1); index++;
+
+        if (p_spacecraftPositionSolveType == PositionVelocityAcceleration) {
+          d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_X, 2);
+          for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
+          std::vector<double> d_lookC_WRT_X2 =  instRot->ReferenceVector(d_lookJ);
+          xImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_X2,0);
+          yImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_X2,1); index++;
+        }
+      }
+
+      // Add the partial for the y coordinate of the position
+      d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Y, 0);
+      for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
+      std::vector<double> d_lookC_WRT_Y0 =  instRot->ReferenceVector(d_lookJ);
+      xImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y0,0);
+      yImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y0,1);
+      index++;
+
+      if (p_spacecraftPositionSolveType > PositionOnly) {
+         d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Y, 1);
+         for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
+         std::vector<double> d_lookC_WRT_Y1 =  instRot->ReferenceVector(d_lookJ);
+         xImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y1,0);
+         yImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y1,1); index++;
+
+        if (p_spacecraftPositionSolveType == PositionVelocityAcceleration) {
+          d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Y, 2);
+          for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
+          std::vector<double> d_lookC_WRT_Y2 =  instRot->ReferenceVector(d_lookJ);
+          xImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y2,0);
+          yImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Y2,1); index++;
         }
       }
-      if ((!point.Held()) && (point.Type() != ControlPoint::Ground)) {
-        std::vector<double> d_lookB_WRT_LAT = PointPartial(point,WRT_Latitude);
-        std::vector<double> d_lookB_WRT_LON = PointPartial(point,WRT_Longitude);
-
-        SpiceRotation *bodyRot = cam->BodyRotation();
-        std::vector<double> d_lookJ_WRT_LAT = bodyRot->J2000Vector(d_lookB_WRT_LAT);
-        std::vector<double> d_lookJ_WRT_LON = bodyRot->J2000Vector(d_lookB_WRT_LON);
-        std::vector<double> d_lookC_WRT_LAT = instRot->ReferenceVector(d_lookJ_WRT_LAT);
-        std::vector<double> d_lookC_WRT_LON = instRot->ReferenceVector(d_lookJ_WRT_LON);
-
-        int index = PointIndex(pointIndex);
-        xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_LAT,0);
-        yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_LAT,1);
+
+      // Add the partial for the z coordinate of the position
+      d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Z, 0);
+      for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
+      std::vector<double> d_lookC_WRT_Z0 =  instRot->ReferenceVector(d_lookJ);
+      xImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z0,0);
+      yImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z0,1);
+      index++;
+
+      if (p_spacecraftPositionSolveType > PositionOnly) {
+        d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Z, 1);
+        for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
+        std::vector<double> d_lookC_WRT_Z1 =  instRot->ReferenceVector(d_lookJ);
+        xImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z1,0);
+        yImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z1,1); index++;
+
+        if (p_spacecraftPositionSolveType == PositionVelocityAcceleration) {
+          d_lookJ = instPos->CoordinatePartial (SpicePosition::WRT_Z, 2);
+          for (int j=0; j<3; j++) d_lookJ[j] *= -1.0;
+          std::vector<double> d_lookC_WRT_Z2 =  instRot->ReferenceVector(d_lookJ);
+          xImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z2,0);
+          yImage[index] = fl * LowDHigh(lookC,d_lookC_WRT_Z1,1); index++;
+        }
+      }
+    }
+    if (p_cmatrixSolveType != None) {
+      std::vector<double> d_lookC;
+
+      // Add the partials for ra
+      for (int icoef=0; icoef<p_numberCameraCoefSolved; icoef++) {
+        d_lookC = instRot->ToReferencePartial(lookJ,SpiceRotation::WRT_RightAscension, icoef);
+        xImage[index] = fl * LowDHigh(lookC,d_lookC,0);
+        yImage[index] = fl * LowDHigh(lookC,d_lookC,1);
         index++;
+      }
 
-        xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_LON,0);
-        yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_LON,1);
+      // Add the partials for dec
+      for (int icoef=0; icoef<p_numberCameraCoefSolved; icoef++) {
+        d_lookC = instRot->ToReferencePartial(lookJ,SpiceRotation::WRT_Declination, icoef);
+        xImage[index] = fl * LowDHigh(lookC,d_lookC,0);
+        yImage[index] = fl * LowDHigh(lookC,d_lookC,1);
         index++;
+      }
 
-        if (p_solveRadii) {
-          std::vector<double> d_lookB_WRT_RAD = PointPartial(point,WRT_Radius);
-          std::vector<double> d_lookJ_WRT_RAD = bodyRot->J2000Vector(d_lookB_WRT_RAD);
-          std::vector<double> d_lookC_WRT_RAD = instRot->ReferenceVector(d_lookJ_WRT_RAD);
-          xKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_RAD,0);
-          yKnowns[index] = fl * LowDHigh(lookC,d_lookC_WRT_RAD,1);
-          index++;
+      // Add the partial for twist if necessary
+      if (p_solveTwist) {
+        for (int icoef=0; icoef<p_numberCameraCoefSolved; icoef++) {
+          d_lookC = instRot->ToReferencePartial(lookJ,SpiceRotation::WRT_Twist, icoef);
+          xImage[index] = fl * LowDHigh(lookC,d_lookC,0);
+          yImage[index] = fl * LowDHigh(lookC,d_lookC,1); index++;
         }
       }
+    }
+
+    if ((!point.Held()) && (point.Type() != ControlPoint::Ground)) {
+      std::vector<double> d_lookB_WRT_LAT = PointPartial(point,WRT_Latitude);
+      std::vector<double> d_lookB_WRT_LON = PointPartial(point,WRT_Longitude);
+
+      SpiceRotation *bodyRot = cam->BodyRotation();
+      std::vector<double> d_lookJ_WRT_LAT = bodyRot->J2000Vector(d_lookB_WRT_LAT);
+      std::vector<double> d_lookJ_WRT_LON = bodyRot->J2000Vector(d_lookB_WRT_LON);
+      std::vector<double> d_lookC_WRT_LAT = instRot->ReferenceVector(d_lookJ_WRT_LAT);
+      std::vector<double> d_lookC_WRT_LON = instRot->ReferenceVector(d_lookJ_WRT_LON);
+
+      xPoint[0] = fl * LowDHigh(lookC,d_lookC_WRT_LAT,0);
+      yPoint[0] = fl * LowDHigh(lookC,d_lookC_WRT_LAT,1);
+
+      xPoint[1] = fl * LowDHigh(lookC,d_lookC_WRT_LON,0);
+      yPoint[1] = fl * LowDHigh(lookC,d_lookC_WRT_LON,1);
+
+      if (p_solveRadii) {
+        std::vector<double> d_lookB_WRT_RAD = PointPartial(point,WRT_Radius);
+        std::vector<double> d_lookJ_WRT_RAD = bodyRot->J2000Vector(d_lookB_WRT_RAD);
+        std::vector<double> d_lookC_WRT_RAD = instRot->ReferenceVector(d_lookJ_WRT_RAD);
+        xPoint[2] = fl * LowDHigh(lookC,d_lookC_WRT_RAD,0);
+        yPoint[2] = fl * LowDHigh(lookC,d_lookC_WRT_RAD,1);
+      }
+    }
+
+    double mudx = m.FocalPlaneMeasuredX();
+//    double cudx = m.FocalPlaneComputedX();
+    double cudx = lookC[0] * fl / lookC[2];
+    double mudy = m.FocalPlaneMeasuredY();
+//    double cudy = m.FocalPlaneComputedY();
+    double cudy = lookC[1] * fl / lookC[2];
+
+    deltax = mudx - cudx;
+    deltay = mudy - cudy;
+
+/*    if (cam->DetectorMap()->LineRate() != 0.0) {
+      if ( cam->DetectorMap()->IsYAxisTimeDependent() ) {
+        deltay = m.MeasuredEphemerisTime() - m.ComputedEphemerisTime();
+        deltay = deltay / cam->DetectorMap()->LineRate();    // Convert to pixels
+        deltay = deltay * cam->PixelPitch();  // convert to mm
+      }
+      if (cam->DetectorMap()->IsXAxisTimeDependent() ) {
+        deltax = m.MeasuredEphemerisTime() - m.ComputedEphemerisTime();
+        deltax = deltax / cam->DetectorMap()->LineRate();    // Convert to pixels
+        deltax = deltax * cam->PixelPitch();  // convert to mm
+      }
+    }
 
-      double mudx = point[i].FocalPlaneMeasuredX();
-//      double cudx = point[i].FocalPlaneComputedX();
-      double cudx = lookC[0] * fl / lookC[2];
-      double mudy = point[i].FocalPlaneMeasuredY();
-//      double cudy = point[i].FocalPlaneComputedY();
-      double cudy = lookC[1] * fl / lookC[2];
-
-      double deltax = mudx - cudx;
-      double deltay = mudy - cudy;
-
-/*      if (cam->DetectorMap()->LineRate() != 0.0) {
-        if ( cam->DetectorMap()->IsYAxisTimeDependent() ) {
-          deltay = point[i].MeasuredEphemerisTime() - point[i].ComputedEphemerisTime();
-          deltay = deltay / cam->DetectorMap()->LineRate();    // Convert to pixels
-          deltay = deltay * cam->PixelPitch();  // convert to mm
+//    deltay *= cam->DetectorMap()->YAxisDirection();
+//    deltax *= cam->DetectorMap()->XAxisDirection();*/
+  }
+
+  /**
+   * Solves one iteration through the reduced camera system.  As the normal
+   * equations of each point are completed in AssembleRange, its 2 or 3
+   * parameters are eliminated from them with the Schur complement.  What is
+   * left is a system in the image parameters only, with one block per image
+   * (or observation) which is nonzero only where images share points, so it
+   * is solved with a sparse Cholesky factorization.  The point corrections
+   * are then recovered by back substitution.  Neither the design matrix nor
+   * the full normal equations are ever formed.
+   *
+   * @param part  The reduced camera system of all the points
+   * @param basis Set to the corrections, in the same order as the least
+   *              squares solutions
+   */
+  void BundleAdjust::SolveReduced (BundleAssembly &part, BasisFunction &basis) {
+    int m = p_numImagePartials;
+    int p = p_numPointPartials;
+
+    // Solve the reduced camera system for the image corrections.  With no
+    // image unknowns (nothing solved for, or every image held) only the
+    // points are solved.
+    int failed = (part.reduced != NULL) ? part.reduced->Factor() : 0;
+    if (failed != 0) {
+      std::string msg = "Reduced camera system is singular for ";
+      for (int i=0; i<Images(); i++) {
+        if (p_heldImages > 0) {
+          if ((p_heldsnlist->HasSerialNumber(p_snlist->SerialNumber(i)))) continue;
+        }
+        if (ObservationIndex(i) == failed - 1) {
+          msg += "image [" + Filename(i) + "] ";
+          break;
         }
-        if (cam->DetectorMap()->IsXAxisTimeDependent() ) {
-          deltax = point[i].MeasuredEphemerisTime() - point[i].ComputedEphemerisTime();
-          deltax = deltax / cam->DetectorMap()->LineRate();    // Convert to pixels
-          deltax = deltax * cam->PixelPitch();  // convert to mm
+      }
+      msg += "which probably indicates an image with no points.  Running ";
+      msg += "the program, cnetcheck, before jigsaw should catch these problems.";
+      throw iException::Message(iException::Math,msg,_FILEINFO_);
+    }
+    std::vector<double> &imageRhs = part.imageRhs;
+    if (part.reduced != NULL) part.reduced->Solve(imageRhs);
+
+    std::vector<double> corrections(BasisColumns(),0.0);
+    for (int i=0; i<(int)imageRhs.size(); i++) corrections[i] = imageRhs[i];
+
+    // Back substitute for the point corrections, V^-1 (g - W' dx)
+    for (int ip=0; ip<p_cnet->Size(); ip++) {
+      if (p_pointVinv[ip].empty()) continue;
+      std::vector<int> &obs = p_pointObs[ip];
+      std::vector<double> &w = p_pointW[ip];
+      std::vector<double> &g = p_pointRhs[ip];
+      for (int a=0; a<(int)obs.size(); a++) {
+        for (int r=0; r<m; r++) {
+          for (int t=0; t<p; t++) g[t] -= w[(a*m+r)*p+t] * imageRhs[obs[a]*m+r];
         }
       }
+      int index = PointIndex(ip);
+      for (int r=0; r<p; r++) {
+        for (int c=0; c<p; c++) corrections[index+r] += p_pointVinv[ip][r*p+c] * g[c];
+      }
+    }
+
+    p_pointObs.clear();
+    p_pointW.clear();
+    p_pointVinv.clear();
+    p_pointRhs.clear();
 
-//      deltay *= cam->DetectorMap()->YAxisDirection();
-//      deltax *= cam->DetectorMap()->XAxisDirection();*/
+    basis.SetCoefficients(corrections);
+  }
 
-      lsq.AddKnown(xKnowns,deltax);
-      lsq.AddKnown(yKnowns,deltay);
-      p_statx.AddData(deltax);
-      p_staty.AddData(deltay);
+  /**
+   * Inverts the symmetric block of normal equations of a point
+   *
+   * @param v    The p_numPointPartials square block, stored row by row
+   * @param vinv Returns the inverse of v
+   *
+   * @return bool False if the block is singular
+   */
+  bool BundleAdjust::InvertPointBlock (const std::vector<double> &v,
+                                       std::vector<double> &vinv) {
+    int p = p_numPointPartials;
+
+    // Cholesky factor, v = L L'
+    std::vector<double> l(p*p,0.0);
+    for (int c=0; c<p; c++) {
+      double sum = v[c*p+c];
+      for (int t=0; t<c; t++) sum -= l[c*p+t] * l[c*p+t];
+      if (sum <= 1.0e-12 * fabs(v[c*p+c])) return false;
+      l[c*p+c] = sqrt(sum);
+      for (int r=c+1; r<p; r++) {
+        double s = v[r*p+c];
+        for (int t=0; t<c; t++) s -= l[r*p+t] * l[c*p+t];
+        l[r*p+c] = s / l[c*p+c];
+      }
     }
+
+    // Solve L L' x = e for each column of the identity
+    vinv.assign(p*p,0.0);
+    std::vector<double> x(p);
+    for (int col=0; col<p; col++) {
+      for (int r=0; r<p; r++) {
+        double s = (r == col) ? 1.0 : 0.0;
+        for (int t=0; t<r; t++) s -= l[r*p+t] * x[t];
+        x[r] = s / l[r*p+r];
+      }
+      for (int r=p-1; r>=0; r--) {
+        double s = x[r];
+        for (int t=r+1; t<p; t++) s -= l[t*p+r] * x[t];
+        x[r] = s / l[r*p+r];
+      }
+      for (int r=0; r<p; r++) vinv[r*p+col] = x[r];
+    }
+    return true;
   }
 
   /**
@@ -939,11 +1471,16 @@ namespace Isis {
 
   //! Return index to basis function for ith image
   int BundleAdjust::ImageIndex (int i) const {
+    return ObservationIndex(i) * p_numImagePartials;
+  }
+
+  //! Return index of the ith image's block in the reduced camera system
+  int BundleAdjust::ObservationIndex (int i) const {
     if (!p_observationMode) {
-      return p_imageIndexMap[i] * p_numImagePartials;
+      return p_imageIndexMap[i];
     }
     else {
-      return p_onlist->ObservationNumberMapIndex(i) * p_numImagePartials;
+      return p_onlist->ObservationNumberMapIndex(i);
     }
   }
 
@@ -58,6 +58,18 @@
  *   @history 2009-10-14 Debbie A. Cook Modified AddPartials method to use new CameraGroundMap method, GetXY 
  *   @history 2009-10-30 Debbie A. Cook Improved error message in AddPartials 
  *   @history 2009-12-14 Debbie A. Cook Updated SpicePosition enumerated partial type constants
+ *   @history 2026-10-17 Unknown - Added the SCHUR solution method, which
+ *                          eliminates the point parameters and solves the
+ *                          reduced camera system with SparseBlockCholesky.
+ *                          Moved the partial derivative computation from
+ *                          AddPartials to ComputePartials so both solutions
+ *                          share it, and fixed the LeastSquares leak in Solve.
+ *   @history 2026-10-17 Unknown - Added SetThreads to compute the partials of
+ *                          the points in several threads, each with its own
+ *                          cameras and its own reduced camera system.
+ *   @history 2026-10-18 Unknown - ComputePartials no longer holds
+ *                          NaifStatus::Mutex, so the threads evaluate their
+ *                          cameras together.
  */
 
 #include "ControlNet.h"
@@ -71,6 +83,7 @@
 namespace Isis {
   class LeastSquares;
   class BasisFunction;
+  class BundleAssembly;
 
   class BundleAdjust {
     public:
@@ -135,22 +148,45 @@ namespace Isis {
       //! Set the solution method to use for solving the matrix
       void SetSolutionMethod ( std::string solutionMethod ) { p_solutionMethod = solutionMethod;};
 
+      void SetThreads(int threads);
+
+      //! Return the number of threads used to compute the partials
+      int Threads() const { return p_threads; };
+
     private:
+      friend class BundleWorker;
+
       void Init(Progress *progress=0);
 
       void ComputeNumberPartials();
 
-      void AddPartials (LeastSquares &lsq,
-                        int point);
+      std::vector<BundleAssembly *> AssemblePartials (bool reduce);
+      void AssembleRange (BundleAssembly &part);
+      void AddKnowns (LeastSquares &lsq, BundleAssembly &part);
+      void ComputePartials (Isis::ControlPoint &point, int measure,
+                            Isis::Camera *cam,
+                            std::vector<double> &xImage,
+                            std::vector<double> &yImage,
+                            std::vector<double> &xPoint,
+                            std::vector<double> &yPoint,
+                            double &deltax, double &deltay);
+      void SolveReduced (BundleAssembly &part, BasisFunction &basis);
+      bool InvertPointBlock (const std::vector<double> &v,
+                             std::vector<double> &vinv);
       void Update (BasisFunction &basis);
 
       int PointIndex (int i) const;
 
       int ImageIndex (int i) const;
 
+      int ObservationIndex (int i) const;
+
       void CheckHeldList();
       void ApplyHeldList();
 
+      void CreateThreadCameras();
+      void SyncThreadCameras();
+
       Isis::ControlNet *p_cnet;
       Isis::SerialNumberList *p_snlist;
       Isis::SerialNumberList *p_heldsnlist;
@@ -198,6 +234,19 @@ namespace Isis {
       int p_ckDegree;
       int p_solveCamDegree;
       int p_numberCameraCoefSolved;  //!< The number of camera angle coefficients in the solution
+
+      int p_threads;  //!< Number of threads computing the partials
+      //! Cameras of every image for each thread after the first
+      std::vector< std::vector<Isis::Camera *> > p_threadCameras;
+
+      //! Observations of each point being solved, for the SCHUR method
+      std::vector< std::vector<int> > p_pointObs;
+      //! Image-point normal equation blocks of each point
+      std::vector< std::vector<double> > p_pointW;
+      //! Inverse of the point normal equation block of each point
+      std::vector< std::vector<double> > p_pointVinv;
+      //! Point right hand side of each point
+      std::vector< std::vector<double> > p_pointRhs;
   };
 };
 
@@ -20,18 +20,22 @@
  *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
  *   http://www.usgs.gov/privacy.html.
  */
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include <vector>
 #include "Camera.h"
 #include "Projection.h"
 #include "Constants.h"
 #include "CameraDetectorMap.h"
+#include "LineScanCameraDetectorMap.h"
 #include "CameraFocalPlaneMap.h"
 #include "CameraDistortionMap.h"
 #include "CameraGroundMap.h"
 #include "CameraSkyMap.h"
 #include "ProjectionFactory.h"
 #include "NaifStatus.h"
+#include "SpecialPixel.h"
 
 using namespace std;
 namespace Isis {
@@ -82,8 +86,14 @@ namespace Isis {
     }
 
     p_groundRangeComputed = false;
+    p_groundRangeIncrement = 0;
     p_raDecRangeComputed = false;
     p_pointComputed = false;
+
+    p_geometryCacheSize = 0;
+    p_geometryHits = 0;
+    p_geometryMisses = 0;
+    p_geometryChanges = 0;
   }
 
   //! Destroys the Camera Object
@@ -397,72 +407,23 @@ namespace Isis {
     for (int band=1; band<=eband; band++) {
       SetBand(band);
 
-      // Loop for each line testing the left and right sides of the image
-      for (int line=1; line<=p_lines+1; line++) {
-        // Look for the first good lat/lon on the left edge of the image
-        // If it is the first or last line then test the whole line
-        int samp;
-        for (samp=1; samp<=p_samples+1; samp++) {
-
-          if (SetImage((double)samp-0.5,(double)line-0.5)) {
-            double lat = UniversalLatitude();
-            double lon = UniversalLongitude();
-            if (lat < p_minlat) p_minlat = lat;
-            if (lat > p_maxlat) p_maxlat = lat;
-            if (lon < p_minlon) p_minlon = lon;
-            if (lon > p_maxlon) p_maxlon = lon;
-
-            if (lon > 180.0) lon -= 360.0;
-            if (lon < p_minlon180) p_minlon180 = lon;
-            if (lon > p_maxlon180) p_maxlon180 = lon;
-
-            double res = PixelResolution();
-            if (res > 0.0) {
-              if (res < p_minres) p_minres = res;
-              if (res > p_maxres) p_maxres = res;
-            }
-            if ((line != 1) && (line != p_lines+1)) break;
-          }
-        }
-
-        //We've already checked the first and last lines.
-        if(line == 1) continue;
-        if(line == p_lines+1) continue;
-
-        // Look for the first good lat/lon on the right edge of the image
-        if (samp < p_samples+1) {
-          for (samp=p_samples+1; samp>=1; samp--) {
-            if (SetImage((double)samp-0.5,(double)line-0.5)) {
-              double lat = UniversalLatitude();
-              double lon = UniversalLongitude();
-              if (lat < p_minlat) p_minlat = lat;
-              if (lat > p_maxlat) p_maxlat = lat;
-              if (lon < p_minlon) p_minlon = lon;
-              if (lon > p_maxlon) p_maxlon = lon;
-
-              if (lon > 180.0) lon -= 360.0;
-              if (lon < p_minlon180) p_minlon180 = lon;
-              if (lon > p_maxlon180) p_maxlon180 = lon;
-
-              double res = PixelResolution();
-              if (res > 0.0) {
-                if (res < p_minres) p_minres = res;
-                if (res > p_maxres) p_maxres = res;
-              }
-              break;
-            }
-          }
-        }
-      }
+      // Test the whole of the first and last lines, then the first good
+      // lat/lon from the left and from the right of the lines in between
+      int increment = GroundRangeIncrement();
+      ScanGroundRange(1, 1, p_samples+1, increment);
+      ScanGroundRange(p_lines+1, 1, p_samples+1, increment);
+      ScanGroundRange(0, 2, p_lines, increment);
 
       // Test at the sub-spacecraft point to see if we have a
       // better resolution
       double lat,lon;
+      Geometry geometry;
       SubSpacecraftPoint(lat,lon);
-      if (SetUniversalGround(lat,lon)) {
-        if (Sample() >= 0.5 && Line() >= 0.5 &&
-            Sample() <= p_samples + 0.5 && Line() <= p_lines + 0.5) {
-          double res = PixelResolution();
+      if (GroundGeometry(lat,lon,geometry,false)) {
+        if (geometry.sample >= 0.5 && geometry.line >= 0.5 &&
+            geometry.sample <= p_samples + 0.5 &&
+            geometry.line <= p_lines + 0.5) {
+          double res = geometry.resolution;
           if (res > 0.0) {
             if (res < p_minres) p_minres = res;
             if (res > p_maxres) p_maxres = res;
@@ -471,9 +432,10 @@ namespace Isis {
       }
 
       // Special test for ground range to see if either pole is in the image
-      if (SetUniversalGround(90.0,0.0)) {
-        if (Sample() >= 0.5 && Line() >= 0.5 &&
-            Sample() <= p_samples + 0.5 && Line() <= p_lines + 0.5) {
+      if (GroundGeometry(90.0,0.0,geometry,false)) {
+        if (geometry.sample >= 0.5 && geometry.line >= 0.5 &&
+            geometry.sample <= p_samples + 0.5 &&
+            geometry.line <= p_lines + 0.5) {
           p_maxlat = 90.0;
           p_minlon = 0.0;
           p_maxlon = 360.0;
@@ -482,9 +444,10 @@ namespace Isis {
         }
       }
 
-      if (SetUniversalGround(-90.0,0.0)) {
-        if (Sample() >= 0.5 && Line() >= 0.5 &&
-            Sample() <= p_samples + 0.5 && Line() <= p_lines + 0.5) {
+      if (GroundGeometry(-90.0,0.0,geometry,false)) {
+        if (geometry.sample >= 0.5 && geometry.line >= 0.5 &&
+            geometry.sample <= p_samples + 0.5 &&
+            geometry.line <= p_lines + 0.5) {
           p_minlat = -90.0;
           p_minlon = 0.0;
           p_maxlon = 360.0;
@@ -497,9 +460,10 @@ namespace Isis {
       // 0-360 seam running right through the image so
       // test it as well (the increment may not be fine enough !!!)
       for (double lat=p_minlat; lat<=p_maxlat; lat+=(p_maxlat-p_minlat)/10.0) {
-        if (SetUniversalGround(lat,0.0)) {
-          if (Sample() >= 0.5 && Line() >= 0.5 &&
-              Sample() <= p_samples + 0.5 && Line() <= p_lines + 0.5) {
+        if (GroundGeometry(lat,0.0,geometry,false)) {
+          if (geometry.sample >= 0.5 && geometry.line >= 0.5 &&
+              geometry.sample <= p_samples + 0.5 &&
+              geometry.line <= p_lines + 0.5) {
             p_minlon = 0.0;
             p_maxlon = 360.0;
             break;
@@ -511,9 +475,10 @@ namespace Isis {
       // -180-180 seam running right through the image so
       // test it as well (the increment may not be fine enough !!!)
       for (double lat=p_minlat; lat<=p_maxlat; lat+=(p_maxlat-p_minlat)/10.0) {
-        if (SetUniversalGround(lat,180.0)) {
-          if (Sample() >= 0.5 && Line() >= 0.5 &&
-              Sample() <= p_samples + 0.5 && Line() <= p_lines + 0.5) {
+        if (GroundGeometry(lat,180.0,geometry,false)) {
+          if (geometry.sample >= 0.5 && geometry.line >= 0.5 &&
+              geometry.sample <= p_samples + 0.5 &&
+              geometry.line <= p_lines + 0.5) {
             p_minlon180 = -180.0;
             p_maxlon180 = 180.0;
             break;
@@ -538,6 +503,200 @@ namespace Isis {
     }
   }
 
+ /**
+  * Tests the points along one edge of the image for the ground range.  The
+  * edge is either the top or bottom line of the image, or the left and right
+  * edges of the lines from first to last.
+  *
+  * Only every increment'th point of the edge (and the last) is tested at
+  * first.  The edge is assumed to change smoothly between two of these, so
+  * every point is then tested only between those where the extremes of the
+  * latitude, longitude or resolution can be: on either side of a tested
+  * point that is a local minimum or maximum, where the longitude wraps
+  * around a seam and where the edge moves, as it does where the limb or a
+  * missed pixel is. With an increment of 1 every point is tested.
+  *
+  * @param line The top or bottom line of the image, or 0 for the left and
+  *             right edges
+  * @param first The first sample or line of the edge
+  * @param last The last sample or line of the edge
+  * @param increment Pixels between the points tested first
+  */
+  void Camera::ScanGroundRange (int line, int first, int last, int increment) {
+    if (last < first) return;
+
+    vector<int> index;
+    for (int i=first; i<last; i+=increment) index.push_back(i);
+    index.push_back(last);
+
+    int points = (int)index.size();
+    vector<GroundRangeSample> samples(points);
+    for (int i=0; i<points; i++) {
+      GroundRangeEdge(line, index[i], samples[i]);
+    }
+    if (increment <= 1) return;
+
+    // Find the gaps between tested points that need every point tested
+    vector<bool> fill(points-1, false);
+    for (int i=0; i<points-1; i++) {
+      const GroundRangeSample &a = samples[i];
+      const GroundRangeSample &b = samples[i+1];
+      if (a.points != b.points) {
+        fill[i] = true;
+        continue;
+      }
+
+      for (int p=0; p<a.points; p++) {
+        if (a.position[p] != b.position[p]) fill[i] = true;
+        if (fabs(a.value[4*p+1] - b.value[4*p+1]) > 180.0) fill[i] = true;
+        if (fabs(a.value[4*p+2] - b.value[4*p+2]) > 180.0) fill[i] = true;
+      }
+    }
+
+    for (int i=0; i<points; i++) {
+      const GroundRangeSample &s = samples[i];
+      for (int v=0; v<4*s.points; v++) {
+        // Resolutions that are not positive are not used
+        bool resolution = (v % 4 == 3);
+        if (resolution && s.value[v] <= 0.0) continue;
+
+        bool minimum = true;
+        bool maximum = true;
+        for (int j=i-1; j<=i+1; j+=2) {
+          if (j < 0 || j >= points) continue;
+          const GroundRangeSample &neighbor = samples[j];
+          if (neighbor.points != s.points) continue;
+          if (resolution && neighbor.value[v] <= 0.0) continue;
+          if (neighbor.value[v] < s.value[v]) minimum = false;
+          if (neighbor.value[v] > s.value[v]) maximum = false;
+        }
+
+        if (minimum || maximum) {
+          if (i > 0) fill[i-1] = true;
+          if (i < points-1) fill[i] = true;
+        }
+      }
+    }
+
+    GroundRangeSample sample;
+    for (int i=0; i<points-1; i++) {
+      if (!fill[i]) continue;
+      for (int j=index[i]+1; j<index[i+1]; j++) {
+        GroundRangeEdge(line, j, sample);
+      }
+    }
+  }
+
+ /**
+  * Tests one point of the top or bottom line of the image, or the first good
+  * lat/lon from the left and from the right of a line, for the ground range
+  *
+  * @param line The top or bottom line of the image, or 0 for the left and
+  *             right edges
+  * @param index The sample of the top or bottom line, or the line of the left
+  *              and right edges
+  * @param sample Returns the points found
+  */
+  void Camera::GroundRangeEdge (int line, int index,
+                                GroundRangeSample &sample) {
+    sample.points = 0;
+    Geometry geometry;
+    if (line != 0) {
+      if (ImageGeometry((double)index-0.5,(double)line-0.5,geometry,false)) {
+        AddGroundRangePoint(0, geometry, sample);
+      }
+      return;
+    }
+
+    line = index;
+    int samp;
+    for (samp=1; samp<=p_samples+1; samp++) {
+      if (ImageGeometry((double)samp-0.5,(double)line-0.5,geometry,false)) {
+        AddGroundRangePoint(samp, geometry, sample);
+        break;
+      }
+    }
+
+    if (samp < p_samples+1) {
+      for (samp=p_samples+1; samp>=1; samp--) {
+        if (ImageGeometry((double)samp-0.5,(double)line-0.5,geometry,false)) {
+          AddGroundRangePoint(samp, geometry, sample);
+          break;
+        }
+      }
+    }
+  }
+
+ /**
+  * Adds a point to the ground range and resolution
+  *
+  * @param position The sample of a left or right edge point, otherwise 0
+  * @param geometry The geometry of the point
+  * @param sample The points found so far, which the point is added to
+  */
+  void Camera::AddGroundRangePoint (int position, const Geometry &geometry,
+                                    GroundRangeSample &sample) {
+    double lat = geometry.latitude;
+    double lon = geometry.longitude;
+    if (lat < p_minlat) p_minlat = lat;
+    if (lat > p_maxlat) p_maxlat = lat;
+    if (lon < p_minlon) p_minlon = lon;
+    if (lon > p_maxlon) p_maxlon = lon;
+
+    double lon180 = lon;
+    if (lon180 > 180.0) lon180 -= 360.0;
+    if (lon180 < p_minlon180) p_minlon180 = lon180;
+    if (lon180 > p_maxlon180) p_maxlon180 = lon180;
+
+    double res = geometry.resolution;
+    if (res > 0.0) {
+      if (res < p_minres) p_minres = res;
+      if (res > p_maxres) p_maxres = res;
+    }
+
+    int p = sample.points++;
+    sample.position[p] = position;
+    sample.value[4*p] = lat;
+    sample.value[4*p+1] = lon;
+    sample.value[4*p+2] = lon180;
+    sample.value[4*p+3] = res;
+  }
+
+ /**
+  * Sets how many pixels apart the edges of the image are sampled when the
+  * ground range and resolution are computed, see ScanGroundRange.  The
+  * extremes found are exact as long as the geometry along the edges has no
+  * more than one minimum or maximum within two increments, so a smaller
+  * increment is more robust and a larger one faster.  An increment of 1 tests
+  * every pixel of the edges.  An increment of 0, the default, uses one
+  * thousandth of the largest image dimension, so images up to 1000 pixels
+  * are tested at every pixel.  The ground range is computed again the next
+  * time it is needed.
+  *
+  * @param increment Pixels between the points tested first
+  */
+  void Camera::SetGroundRangeIncrement (int increment) {
+    if (increment < 0) {
+      string msg = "The ground range increment [" + iString(increment) +
+                   "] can not be negative";
+      throw iException::Message(iException::Programmer, msg, _FILEINFO_);
+    }
+
+    p_groundRangeIncrement = increment;
+    p_groundRangeComputed = false;
+  }
+
+ /**
+  * Returns how many pixels apart the edges of the image are sampled when the
+  * ground range and resolution are computed
+  *
+  * @return int Pixels between the points tested first
+  */
+  int Camera::GroundRangeIncrement () const {
+    if (p_groundRangeIncrement > 0) return p_groundRangeIncrement;
+    return max(1, max(p_samples, p_lines) / 1000);
+  }
+
  /**
   * Checks whether the ground range intersects the longitude domain or not
   *
@@ -1267,7 +1426,9 @@ namespace Isis {
   /**
    * This loads the spice cache big enough for this image. The default cache size 
    *   is the number of lines in the cube if the ephemeris time changes in the
-   *   image, one otherwise.
+   *   image, one otherwise. Line scan cameras also tabulate the instrument
+   *   position and pointing at every line so setting the time within the
+   *   image is a table lookup.
    *  
    * @param cacheSize The size of the spice cache. Should be >1 or not entered.
    *   
@@ -1329,6 +1490,20 @@ namespace Isis {
 
     Spice::CreateCache(etStart, etEnd, cacheSize, tol);
 
+    if (GetCameraType() == LineScan) {
+      LineScanCameraDetectorMap *detectorMap =
+        (LineScanCameraDetectorMap *) DetectorMap();
+      double lineRate = detectorMap->LineRate();
+
+      // Very long images would need too much memory for the tables
+      // (about 144 bytes a line), these keep interpolating the cache
+      if (lineRate > 0.0 && (etEnd - etStart) / lineRate < 250000.0) {
+        int lines = (int) ((etEnd - etStart) / lineRate) + 2;
+        Spice::InstrumentPosition()->LoadLineTable(etStart, lineRate, lines);
+        Spice::InstrumentRotation()->LoadLineTable(etStart, lineRate, lines);
+      }
+    }
+
     SetEphemerisTime(etStart);
 
     // Reset to band 1
@@ -1426,4 +1601,239 @@ namespace Isis {
 
     return true;
   }
+
+
+  /**
+   * Sets the number of points ImageGeometry and GroundGeometry keep in the
+   * geometry cache.  When the cache is full the oldest point is replaced.
+   * The cache is cleared, and the hit and miss counts are reset.  The cache
+   * is also cleared whenever the instrument or sun position or the
+   * instrument or body rotation change, as they do while jigsaw updates the
+   * pointing.
+   *
+   * @param points Maximum number of points to keep; 0 disables the cache
+   */
+  void Camera::SetGeometryCache(int points) {
+    if (points < 0) {
+      string msg = "The geometry cache size [" + iString(points) +
+                   "] can not be negative";
+      throw iException::Message(iException::Programmer, msg, _FILEINFO_);
+    }
+
+    p_geometryCacheSize = points;
+    p_geometryCache.clear();
+    p_geometryOrder.clear();
+    p_geometryHits = 0;
+    p_geometryMisses = 0;
+  }
+
+
+  /**
+   * Returns the geometry of an image point.  This gives the same values as
+   * calling SetImage and then UniversalLatitude, UniversalLongitude,
+   * LocalRadius, PixelResolution and, if angles is true, PhaseAngle,
+   * EmissionAngle and IncidenceAngle.  Without angles they are Null.  If the
+   * point is in the geometry cache the values are returned without computing
+   * them, and the camera is not set to the point; otherwise SetImage is
+   * called.  Points are cached separately for each band of band dependent
+   * cameras.
+   *
+   * @param sample Sample coordinate of the cube
+   * @param line Line coordinate of the cube
+   * @param geometry Returns the geometry of the point
+   * @param angles Compute the phase, emission and incidence angles
+   *
+   * @return bool Returns true if the point intersects the target
+   */
+  bool Camera::ImageGeometry(const double sample, const double line,
+                             Geometry &geometry, bool angles) {
+    GeometryKey key = MakeGeometryKey(false, sample, line, Null);
+    if (FindGeometry(key, angles, geometry)) return geometry.valid;
+
+    bool valid = SetImage(sample, line);
+    StoreGeometry(key, valid, angles, geometry);
+    return geometry.valid;
+  }
+
+
+  /**
+   * Returns the geometry of a ground point on the surface, in the same way as
+   * ImageGeometry does for an image point.  The sample and line are those
+   * SetUniversalGround computes.
+   *
+   * @param latitude Universal latitude of the point
+   * @param longitude Universal longitude of the point
+   * @param geometry Returns the geometry of the point
+   * @param angles Compute the phase, emission and incidence angles
+   *
+   * @return bool Returns true if the point is seen by the camera
+   */
+  bool Camera::GroundGeometry(const double latitude, const double longitude,
+                              Geometry &geometry, bool angles) {
+    GeometryKey key = MakeGeometryKey(true, latitude, longitude, Null);
+    if (FindGeometry(key, angles, geometry)) return geometry.valid;
+
+    bool valid = SetUniversalGround(latitude, longitude);
+    StoreGeometry(key, valid, angles, geometry);
+    return geometry.valid;
+  }
+
+
+  /**
+   * Returns the geometry of a ground point at a given radius, in the same way
+   * as ImageGeometry does for an image point.
+   *
+   * @param latitude Universal latitude of the point
+   * @param longitude Universal longitude of the point
+   * @param radius Radius of the point, as given to SetUniversalGround
+   * @param geometry Returns the geometry of the point
+   * @param angles Compute the phase, emission and incidence angles
+   *
+   * @return bool Returns true if the point is seen by the camera
+   */
+  bool Camera::GroundGeometry(const double latitude, const double longitude,
+                              const double radius, Geometry &geometry,
+                              bool angles) {
+    GeometryKey key = MakeGeometryKey(true, latitude, longitude, radius);
+    if (FindGeometry(key, angles, geometry)) return geometry.valid;
+
+    bool valid = SetUniversalGround(latitude, longitude, radius);
+    StoreGeometry(key, valid, angles, geometry);
+    return geometry.valid;
+  }
+
+
+  /**
+   * Makes the geometry cache key of a point.  The key includes whether the
+   * projection and elevation model are in use, so changing either does not
+   * return points computed the other way.
+   *
+   * @param ground Is this a ground point
+   * @param x Sample or latitude of the point
+   * @param y Line or longitude of the point
+   * @param z Radius of the point, or Null
+   *
+   * @return GeometryKey The key
+   */
+  Camera::GeometryKey Camera::MakeGeometryKey(bool ground, double x, double y,
+                                              double z) {
+    GeometryKey key;
+    key.kind = (ground ? 1 : 0) + (p_ignoreProjection ? 2 : 0) +
+               (HasElevationModel() ? 4 : 0);
+    key.band = IsBandIndependent() ? 1 : Band();
+    key.x = x;
+    key.y = y;
+    key.z = z;
+    return key;
+  }
+
+
+  /**
+   * Looks for a point in the geometry cache.  A point cached without its
+   * angles is not found when the angles are asked for.
+   *
+   * @param key Key of the point
+   * @param angles Are the angles needed
+   * @param geometry Returns the geometry of the point if it was found
+   *
+   * @return bool Returns true if the point was found
+   */
+  bool Camera::FindGeometry(const GeometryKey &key, bool angles,
+                            Geometry &geometry) {
+    if (p_geometryCacheSize > 0) {
+      DropStaleGeometry();
+      map<GeometryKey, Geometry>::const_iterator cached =
+          p_geometryCache.find(key);
+      if (cached != p_geometryCache.end() &&
+          (cached->second.angles || !angles || !cached->second.valid)) {
+        geometry = cached->second;
+        p_geometryHits++;
+        return true;
+      }
+    }
+
+    p_geometryMisses++;
+    return false;
+  }
+
+
+  /**
+   * Copies the geometry of the point the camera is set to, and adds it to the
+   * geometry cache.  A point already cached without its angles is replaced.
+   *
+   * @param key Key of the point
+   * @param valid Whether setting the camera to the point succeeded
+   * @param angles Compute the phase, emission and incidence angles
+   * @param geometry Returns the geometry of the point
+   */
+  void Camera::StoreGeometry(const GeometryKey &key, bool valid, bool angles,
+                             Geometry &geometry) {
+    // A ground point which is not seen has no sample and line
+    bool ground = (key.kind & 1) != 0;
+    geometry.valid = valid;
+    geometry.sample = (geometry.valid || !ground) ? Sample() : Null;
+    geometry.line = (geometry.valid || !ground) ? Line() : Null;
+    geometry.angles = angles;
+    geometry.latitude = Null;
+    geometry.longitude = Null;
+    geometry.radius = Null;
+    geometry.resolution = Null;
+    geometry.phase = Null;
+    geometry.emission = Null;
+    geometry.incidence = Null;
+    if (geometry.valid) {
+      geometry.latitude = UniversalLatitude();
+      geometry.longitude = UniversalLongitude();
+      geometry.radius = LocalRadius();
+      geometry.resolution = PixelResolution();
+      if (angles) {
+        geometry.phase = PhaseAngle();
+        geometry.emission = EmissionAngle();
+        geometry.incidence = IncidenceAngle();
+      }
+    }
+
+    if (p_geometryCacheSize == 0) return;
+
+    DropStaleGeometry();
+    map<GeometryKey, Geometry>::iterator cached = p_geometryCache.find(key);
+    if (cached != p_geometryCache.end()) {
+      cached->second = geometry;
+      return;
+    }
+
+    if ((int)p_geometryOrder.size() == p_geometryCacheSize) {
+      p_geometryCache.erase(p_geometryOrder.front());
+      p_geometryOrder.pop_front();
+    }
+    p_geometryCache[key] = geometry;
+    p_geometryOrder.push_back(key);
+  }
+
+
+  /**
+   * Returns the sum of the change counts of the instrument and sun positions
+   * and of the instrument and body rotations.  The counts only grow, so the
+   * sum changes whenever any of them is changed.
+   *
+   * @return int The number of changes
+   */
+  int Camera::SpiceChanges() const {
+    return InstrumentPosition()->Changes() + SunPosition()->Changes() +
+           InstrumentRotation()->Changes() + BodyRotation()->Changes();
+  }
+
+
+  /**
+   * Clears the geometry cache if the positions or rotations were changed
+   * after its points were computed
+   */
+  void Camera::DropStaleGeometry() {
+    int changes = SpiceChanges();
+    if (changes == p_geometryChanges) return;
+
+    p_geometryCache.clear();
+    p_geometryOrder.clear();
+    p_geometryChanges = changes;
+  }
 } // end namespace isis
@@ -23,6 +23,9 @@
  *   http://www.usgs.gov/privacy.html.                                    
  */                                                                       
 
+#include <deque>
+#include <map>
+
 #include "Sensor.h"
 #include "AlphaCube.h"
 
@@ -119,6 +122,22 @@ namespace Isis {
  *            out of reclat when computing azimuths.
  *   @history 2009-12-14  Steven Lambright - BasicMapping(...) will now populate
  *            the map Pvl parameter with a valid Pvl
+ *   @history 2026-10-17 Unknown - LoadCache tabulates the instrument position
+ *            and pointing at every line for line scan cameras
+ *   @history 2026-10-18 Unknown - Added ImageGeometry and GroundGeometry, which
+ *            keep the geometry of recent points in a cache set up with
+ *            SetGeometryCache
+ *   @history 2026-10-18 Unknown - GroundRangeResolution samples the edges of
+ *            large images every few pixels and only tests every pixel near the
+ *            extremes, seams and limbs it finds.  Added
+ *            SetGroundRangeIncrement.
+ *   @history 2026-10-18 Unknown - The geometry cache is cleared when the
+ *            pointing or positions change, and keeps the pixel resolution.
+ *            GroundRangeResolution uses ImageGeometry and GroundGeometry.
+ *   @history 2026-10-18 Unknown - ImageGeometry and GroundGeometry only compute
+ *            the phase, emission and incidence angles when asked for them.
+ *            GroundRangeResolution does not ask, as before it did not compute
+ *            them.
  */
 
   class Camera : public Isis::Sensor {
@@ -213,6 +232,9 @@ namespace Isis {
 
       double LowestImageResolution ();
       double HighestImageResolution ();
+
+      void SetGroundRangeIncrement (int increment);
+      int GroundRangeIncrement () const;
   
       void BasicMapping (Isis::Pvl &map);
 
@@ -363,6 +385,39 @@ namespace Isis {
 
       bool InCube();
 
+      /**
+       * The geometry of an image or ground point, as returned by
+       * ImageGeometry and GroundGeometry
+       */
+      struct Geometry {
+        bool valid;        //!< Does the point intersect the target
+        double sample;     //!< Sample of the point
+        double line;       //!< Line of the point
+        double latitude;   //!< Universal latitude of the point
+        double longitude;  //!< Universal longitude of the point
+        double radius;     //!< Local radius of the point in meters
+        double resolution; //!< Pixel resolution at the point in meters
+        bool angles;       //!< Were the angles below computed
+        double phase;      //!< Phase angle at the point, if angles
+        double emission;   //!< Emission angle at the point, if angles
+        double incidence;  //!< Incidence angle at the point, if angles
+      };
+
+      void SetGeometryCache(int points);
+      bool ImageGeometry(const double sample, const double line,
+                         Geometry &geometry, bool angles = true);
+      bool GroundGeometry(const double latitude, const double longitude,
+                          Geometry &geometry, bool angles = true);
+      bool GroundGeometry(const double latitude, const double longitude,
+                          const double radius, Geometry &geometry,
+                          bool angles = true);
+
+      //! Returns the number of points found in the geometry cache
+      int GeometryCacheHits() const { return p_geometryHits; };
+
+      //! Returns the number of points computed by ImageGeometry and GroundGeometry
+      int GeometryCacheMisses() const { return p_geometryMisses; };
+
       enum CameraType {
         Framing, 
         PushFrame, 
@@ -421,6 +476,25 @@ namespace Isis {
       double p_maxlon180;                 //!<The maximum longitude in the 180 domain
       bool p_groundRangeComputed;         /**<Flag showing if the ground range 
                                               was computed successfully.*/
+      int p_groundRangeIncrement;         /**<Pixels between the edge points
+                                              GroundRangeResolution samples,
+                                              0 to pick it from the image size*/
+
+      /**
+       * Points found at one sample of the top or bottom edge, or one line of
+       * the left and right edges, while computing the ground range
+       */
+      struct GroundRangeSample {
+        int points;         //!< Number of points found, at most 2
+        int position[2];    //!< Sample of each left or right edge point
+        //! Latitude, longitude, -180/180 longitude and resolution of each point
+        double value[8];
+      };
+
+      void ScanGroundRange (int line, int first, int last, int increment);
+      void GroundRangeEdge (int line, int index, GroundRangeSample &sample);
+      void AddGroundRangePoint (int position, const Geometry &geometry,
+                                GroundRangeSample &sample);
 
       bool p_pointComputed;               //!<Flag showing if Sample/Line has been computed
                          
@@ -459,6 +533,42 @@ namespace Isis {
 
       int p_geometricTilingStartSize; //!< The ideal geometric tile size to start with when projecting
       int p_geometricTilingEndSize; //!< The ideal geometric tile size to end with when projecting
+
+      /**
+       * Key of the geometry cache: the kind of point and how it was computed,
+       * the band, and the image or ground coordinate
+       */
+      struct GeometryKey {
+        int kind;     //!< Image or ground point, projection and DEM use
+        int band;     //!< Band, or 1 for band independent cameras
+        double x;     //!< Sample or latitude
+        double y;     //!< Line or longitude
+        double z;     //!< Radius of a ground point, otherwise Null
+
+        //! Orders keys for std::map
+        bool operator<(const GeometryKey &other) const {
+          if (kind != other.kind) return kind < other.kind;
+          if (band != other.band) return band < other.band;
+          if (x != other.x) return x < other.x;
+          if (y != other.y) return y < other.y;
+          return z < other.z;
+        }
+      };
+
+      GeometryKey MakeGeometryKey(bool ground, double x, double y, double z);
+      bool FindGeometry(const GeometryKey &key, bool angles,
+                        Geometry &geometry);
+      void StoreGeometry(const GeometryKey &key, bool valid, bool angles,
+                         Geometry &geometry);
+      int SpiceChanges() const;
+      void DropStaleGeometry();
+
+      int p_geometryCacheSize; //!< Maximum points in the geometry cache
+      std::map<GeometryKey, Geometry> p_geometryCache; //!< Recent points
+      std::deque<GeometryKey> p_geometryOrder; //!< Cached points, oldest first
+      int p_geometryHits;      //!< Points found in the geometry cache
+      int p_geometryMisses;    //!< Points computed for the geometry cache
+      int p_geometryChanges;   //!< SpiceChanges when the cache was filled
   };
 };
 
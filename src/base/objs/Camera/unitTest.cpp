@@ -1,6 +1,7 @@
 #include "Camera.h"
 #include "Preference.h"
 #include "CameraFactory.h"
+#include "SpecialPixel.h"
 
 using namespace std;
 using namespace Isis;
@@ -132,6 +133,84 @@ int main() {
   c->Coordinate(p);
   cout << "Point = " << p[0] <<" "<< p[1] <<" "<<p[2]<<endl;
 
+  cout << endl << "Testing the geometry cache..." << endl;
+  c->SetGeometryCache(2);
+  Camera::Geometry geom;
+  c->ImageGeometry(sample, line, geom);
+  c->SetImage(sample, line);
+  cout << "Matches SetImage: "
+       << (geom.valid == c->HasSurfaceIntersection() &&
+           geom.latitude == c->UniversalLatitude() &&
+           geom.longitude == c->UniversalLongitude() &&
+           geom.radius == c->LocalRadius() &&
+           geom.phase == c->PhaseAngle() &&
+           geom.emission == c->EmissionAngle() &&
+           geom.incidence == c->IncidenceAngle() &&
+           geom.resolution == c->PixelResolution()) << endl;
+  Camera::Geometry cached;
+  c->ImageGeometry(sample, line, cached);
+  cout << "Cached: " << (cached.latitude == geom.latitude &&
+                         cached.incidence == geom.incidence) << endl;
+  c->GroundGeometry(lat, lon, cached);
+  c->GroundGeometry(lat, lon, radius, cached);
+  c->ImageGeometry(sample, line, cached);
+  cout << "Hits: " << c->GeometryCacheHits() << endl;
+  cout << "Misses: " << c->GeometryCacheMisses() << endl;
+  c->InstrumentRotation()->SetTimeBias(0.0);
+  c->ImageGeometry(sample, line, cached);
+  cout << "Misses after the pointing changed: "
+       << c->GeometryCacheMisses() << endl;
+  c->GroundGeometry(lat, lon, cached, false);
+  cout << "Angles skipped: "
+       << (!cached.angles && cached.emission == Null) << endl;
+  c->GroundGeometry(lat, lon, cached);
+  c->GroundGeometry(lat, lon, cached, false);
+  cout << "Angles computed when asked: "
+       << (cached.angles && cached.emission != Null) << endl;
+  cout << "Hits with and without the angles: "
+       << c->GeometryCacheHits() << endl;
+  cout << "Misses with and without the angles: "
+       << c->GeometryCacheMisses() << endl;
+  c->SetGeometryCache(0);
+  c->ImageGeometry(sample, line, cached);
+  c->ImageGeometry(sample, line, cached);
+  cout << "Hits without a cache: " << c->GeometryCacheHits() << endl;
+  cout << "Misses without a cache: " << c->GeometryCacheMisses() << endl;
+  try {
+    c->SetGeometryCache(-1);
+  }
+  catch(iException &e) {
+    e.Report(false);
+    e.Clear();
+  }
+
+  cout << endl << "Testing the ground range increment..." << endl;
+  cout << "Default increment: " << c->GroundRangeIncrement() << endl;
+  Pvl everyPixel;
+  c->SetGroundRangeIncrement(1);
+  c->BasicMapping(everyPixel);
+  Pvl sampled;
+  c->SetGroundRangeIncrement(25);
+  c->BasicMapping(sampled);
+  cout << "Increment: " << c->GroundRangeIncrement() << endl;
+  PvlGroup &everyGroup = everyPixel.FindGroup("Mapping");
+  PvlGroup &sampledGroup = sampled.FindGroup("Mapping");
+  cout << "Same ground range and resolution: "
+       << (everyGroup["MinimumLatitude"][0] == sampledGroup["MinimumLatitude"][0] &&
+           everyGroup["MaximumLatitude"][0] == sampledGroup["MaximumLatitude"][0] &&
+           everyGroup["MinimumLongitude"][0] == sampledGroup["MinimumLongitude"][0] &&
+           everyGroup["MaximumLongitude"][0] == sampledGroup["MaximumLongitude"][0] &&
+           everyGroup["PixelResolution"][0] == sampledGroup["PixelResolution"][0])
+       << endl;
+  c->SetGroundRangeIncrement(0);
+  try {
+    c->SetGroundRangeIncrement(-1);
+  }
+  catch(iException &e) {
+    e.Report(false);
+    e.Clear();
+  }
+
   std::cout << std::endl;
   std::cout << "Test Polar Boundary Conditions" << std::endl;
   inputFile = "$clementine1/testData/lub5992r.292.lev1.phot.cub";
@@ -20,8 +20,11 @@
  *   http://www.usgs.gov/privacy.html.                                    
  */                                                                       
 
+#include <QMutexLocker>
+
 #include "CameraFactory.h"
 #include "Camera.h"
+#include "NaifStatus.h"
 #include "Plugin.h"
 #include "iException.h"
 #include "Filename.h"
@@ -40,6 +43,9 @@ namespace Isis {
   * @throws Isis::iException::Camera - Unable to initialize camera model
   */
   Camera *CameraFactory::Create(Isis::Pvl &lab) {
+    // Cameras load and read NAIF kernels while they are constructed
+    QMutexLocker lock(NaifStatus::Mutex());
+
     // Try to load a plugin file in the current working directory and then
     // load the system file
     Plugin p;
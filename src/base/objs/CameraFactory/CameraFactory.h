@@ -51,6 +51,8 @@ namespace Isis {
  *                                         Camera.plugin
  *  @history 2009-05-12 Steven Lambright - Added CameraVersion(...) and version
  *           checking.
+ *  @history 2026-10-18 Unknown - Create holds NaifStatus::Mutex so cameras can
+ *           be created in several threads.
  */                                                                       
 
   class CameraFactory {
@@ -57,8 +57,9 @@ namespace Isis {
    * @return Chip& Reference to this chip
    */
   void Chip::SetAllValues(const double &d) {
-    for (unsigned int i = 0 ; i < p_buf.size() ; i++) {
-       fill(p_buf[i].begin(), p_buf[i].end(), d);
+    for (int line=1; line<=p_chipLines; line++) {
+      double *buf = LineBuffer(line);
+      std::fill(buf, buf + p_chipSamples, d);
     }
   }
 
@@ -73,12 +74,68 @@ namespace Isis {
   }
 
 
+  /**
+   * Construct a copy of a Chip.  The copy has its own pixels even if the
+   * original is a view of another chip.
+   *
+   * @param other     Chip to copy
+   */
+  Chip::Chip (const Chip &other) {
+    p_clipPolygon = NULL;
+    *this = other;
+  }
+
+
   //! Destroys the Chip object
   Chip::~Chip() {
     if (p_clipPolygon != NULL) delete p_clipPolygon;
   }
 
 
+  /**
+   * Copy a Chip.  The pixels and the clipping polygon are copied, so this
+   * chip has its own pixels even if the other chip is a view.
+   *
+   * @param other     Chip to copy
+   *
+   * @return Chip& Reference to this chip
+   */
+  Chip &Chip::operator=(const Chip &other) {
+    if (this == &other) return *this;
+
+    p_chipSamples = other.p_chipSamples;
+    p_chipLines = other.p_chipLines;
+    p_buf.resize(p_chipSamples * p_chipLines);
+    p_data = &p_buf[0];
+    p_stride = p_chipSamples;
+    for (int line=1; line<=p_chipLines; line++) {
+      const double *buf = other.LineBuffer(line);
+      std::copy(buf, buf + p_chipSamples, LineBuffer(line));
+    }
+
+    p_tackSample = other.p_tackSample;
+    p_tackLine = other.p_tackLine;
+    p_cubeTackSample = other.p_cubeTackSample;
+    p_cubeTackLine = other.p_cubeTackLine;
+    p_validMinimum = other.p_validMinimum;
+    p_validMaximum = other.p_validMaximum;
+    p_chipSample = other.p_chipSample;
+    p_chipLine = other.p_chipLine;
+    p_cubeSample = other.p_cubeSample;
+    p_cubeLine = other.p_cubeLine;
+    p_affine = other.p_affine;
+    p_filename = other.p_filename;
+
+    if (p_clipPolygon != NULL) delete p_clipPolygon;
+    p_clipPolygon = NULL;
+    if (other.p_clipPolygon != NULL) {
+      p_clipPolygon = PolygonTools::CopyMultiPolygon(*other.p_clipPolygon);
+    }
+
+    return *this;
+  }
+
+
   //! Common initialization used by constructors
   void Chip::Init (const int samples, const int lines) {
     SetSize(samples,lines);
@@ -101,10 +158,9 @@ namespace Isis {
     p_chipSamples = samples;
     p_chipLines = lines;
     p_buf.clear();
-    p_buf.resize(lines);
-    for (int i=0; i<lines; i++) {
-      p_buf[i].resize(samples);
-    }
+    p_buf.resize(samples * lines);
+    p_data = &p_buf[0];
+    p_stride = samples;
     p_affine.Identity();
     p_tackSample = ((samples - 1) / 2) + 1;
     p_tackLine = ((lines - 1) / 2) + 1;
@@ -459,9 +515,12 @@ namespace Isis {
    */
   bool Chip::IsValid(double percentage) {
     int validCount = 0;
-    for (int samp=1; samp<=Samples(); samp++) {
-      for (int line=1; line<=Lines(); line++) {
-        if (IsValid(samp,line)) validCount++;
+    for (int line=1; line<=Lines(); line++) {
+      const double *buf = LineBuffer(line);
+      for (int samp=0; samp<Samples(); samp++) {
+        if (buf[samp] < p_validMinimum) continue;
+        if (buf[samp] > p_validMaximum) continue;
+        validCount++;
       }
     }
     double validPercentage = 100.0 * (double) validCount / 
@@ -528,6 +587,7 @@ namespace Isis {
     int samples = chipped.Samples(); 
     int lines = chipped.Lines();
     //chipped.Init(samples, lines);
+    chipped.OwnBuffer();
     chipped.p_tackSample = ((samples - 1) / 2) + 1;
     chipped.p_tackLine = ((lines - 1) / 2) + 1;
 
@@ -555,6 +615,67 @@ namespace Isis {
   }
 
 
+  /**
+   *  @brief Make a chip a view of the subchip centered at the designated
+   *         coordinate
+   *
+   *  This method does what Extract(samp, line, view) does without copying the
+   *  pixels.  The view refers to the pixels of this chip, so changing one
+   *  changes the other, and it is only usable while this chip is neither
+   *  resized nor destroyed.  The size of the view is kept.  Setting its size
+   *  or extracting into it gives it its own pixels again.
+   *
+   *  A view can not extend outside of this chip.  If the subchip is not
+   *  entirely inside this chip the view is left unchanged, false is returned
+   *  and Extract must be used to get the Null padded subchip.
+   *
+   * @param samp Center (tack) sample chip coordinate of the subchip
+   * @param line Center (tack) line chip coordinate of the subchip
+   * @param view Chip to make a view of the subchip
+   *
+   * @return bool True if view is now a view of the subchip
+   */
+  bool Chip::View (int samp, int line, Chip &view) {
+    int samples = view.Samples();
+    int lines = view.Lines();
+    int tackSample = ((samples - 1) / 2) + 1;
+    int tackLine = ((lines - 1) / 2) + 1;
+    int startSamp = samp + 1 - tackSample;
+    int startLine = line + 1 - tackLine;
+    if ((startSamp < 1) || (startLine < 1) ||
+        (startSamp + samples - 1 > Samples()) ||
+        (startLine + lines - 1 > Lines())) {
+      return false;
+    }
+
+    // Release the pixels of the view before pointing it at ours
+    std::vector<double>().swap(view.p_buf);
+    view.p_data = LineBuffer(startLine) + startSamp - 1;
+    view.p_stride = p_stride;
+
+    view.p_affine = p_affine;
+    view.p_validMinimum = p_validMinimum;
+    view.p_validMaximum = p_validMaximum;
+    view.p_tackSample = tackSample + TackSample() - samp;
+    view.p_tackLine = tackLine + TackLine() - line;
+
+    return true;
+  }
+
+
+  /**
+   * Gives a chip which is a view of another chip its own pixels, so they
+   * can be written without changing the viewed chip.  The pixels are not
+   * copied.
+   */
+  void Chip::OwnBuffer () {
+    if (!p_buf.empty()) return;
+    p_buf.resize(p_chipSamples * p_chipLines);
+    p_data = &p_buf[0];
+    p_stride = p_chipSamples;
+  }
+
+
   /**
    * @brief Extract a subchip of this chip using an Affine transform 
    *  
@@ -608,6 +729,7 @@ namespace Isis {
 
     int samples = chipped.Samples(); 
     int lines = chipped.Lines();
+    chipped.OwnBuffer();
 
     for (int oline=1; oline<=lines; oline++) {
       int thisLine = TackLine() + (oline - chipped.TackLine());
@@ -658,8 +780,8 @@ namespace Isis {
 
     stats->SetValidRange(p_validMinimum, p_validMaximum);
     
-    for (int i = 0; i < p_chipSamples; i++) {
-      stats->AddData(&p_buf[i][0], p_chipLines);
+    for (int line = 1; line <= p_chipLines; line++) {
+      stats->AddData(LineBuffer(line), p_chipSamples);
     }
 
     return stats;
@@ -680,6 +802,8 @@ namespace Isis {
    * run a bit faster.
    */
   void Chip::Read(Cube &cube, const int band) {
+    OwnBuffer();
+
     // Create an interpolator and portal for geoming
     Interpolator interp(Interpolator::CubicConvolutionType);
     Portal port(interp.Samples(),interp.Lines(),cube.PixelType(),
@@ -691,13 +815,13 @@ namespace Isis {
         if ((CubeSample() < 0.5) || (CubeLine() < 0.5) ||
             (CubeSample() > cube.Samples()+0.5) ||
             (CubeLine() > cube.Lines()+0.5)) {
-          p_buf[line-1][samp-1] = Isis::NULL8;
+          SetValue(samp,line,Isis::NULL8);
         }
         else if (p_clipPolygon == NULL) {
           port.SetPosition (CubeSample(),CubeLine(), band);
           cube.Read(port);
-          p_buf[line-1][samp-1] = 
-          interp.Interpolate (CubeSample(), CubeLine(), port.DoubleBuffer());
+          SetValue(samp,line,
+            interp.Interpolate (CubeSample(), CubeLine(), port.DoubleBuffer()));
         }
         else {
           geos::geom::Point *pnt = globalFactory.createPoint(
@@ -705,11 +829,11 @@ namespace Isis {
           if (pnt->within(p_clipPolygon)) {
             port.SetPosition (CubeSample(),CubeLine(), band);
             cube.Read(port);
-            p_buf[line-1][samp-1] = 
-            interp.Interpolate (CubeSample(), CubeLine(), port.DoubleBuffer());
+            SetValue(samp,line,
+              interp.Interpolate (CubeSample(), CubeLine(), port.DoubleBuffer()));
           }
           else {
-            p_buf[line-1][samp-1] = Isis::NULL8;
+            SetValue(samp,line,Isis::NULL8);
           }
           delete pnt;
         }
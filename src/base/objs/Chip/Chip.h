@@ -80,6 +80,14 @@ namespace Isis {
    *            a linc to move into the center of the chip in a non-linear fashion
    *            to prevent control points that fall in a line and cause the matrix
    *            inversion to fail.
+   *   @history 2026-10-17 Unknown - Store the pixels in a single line ordered
+   *            buffer instead of a vector per line.  Added the View method,
+   *            which makes a chip a window onto another chip without copying
+   *            the pixels, and LineBuffer for direct access to a line of
+   *            pixels. Added a copy constructor and assignment operator, which
+   *            copy the clipping polygon instead of sharing it.  Fixed
+   *            Statistics for chips with different numbers of samples and
+   *            lines.
    * 
    * @see AutoReg
    * @see AutoRegFactory
@@ -88,8 +96,11 @@ namespace Isis {
     public:
       Chip ();
       Chip (const int samples, const int lines);
+      Chip (const Chip &other);
       virtual ~Chip();
 
+      Chip &operator=(const Chip &other);
+
       void SetSize (const int samples, const int lines);
 
       bool IsInsideChip(double sample, double line);
@@ -114,7 +125,7 @@ namespace Isis {
        * @param value   Value to set
        */
       void SetValue(int sample, int line, const double &value) {
-        p_buf[line-1][sample-1] = value;
+        p_data[(line-1)*p_stride + sample-1] = value;
       }
 
       /**
@@ -129,7 +140,7 @@ namespace Isis {
        * @param line      Line position to load (1-based)
        */
       inline double GetValue(int sample,int line) {
-        return p_buf[line-1][sample-1];
+        return p_data[(line-1)*p_stride + sample-1];
       }
 
      /** Get a value from a Chip.  For example, 
@@ -142,7 +153,27 @@ namespace Isis {
        * @param line      Line position to get (1-based)
        */
       inline const double GetValue(int sample,int line) const {
-        return p_buf[line-1][sample-1];
+        return p_data[(line-1)*p_stride + sample-1];
+      }
+
+      /**
+       * Returns the pixels of a line.  The samples of a line are contiguous,
+       * so the pointer can be used to walk the line without going through
+       * GetValue for each pixel.
+       *
+       * @param line    Line to get (1-based)
+       */
+      inline double *LineBuffer(int line) {
+        return p_data + (line-1)*p_stride;
+      }
+
+      /**
+       * Returns the pixels of a line.  The samples of a line are contiguous.
+       *
+       * @param line    Line to get (1-based)
+       */
+      inline const double *LineBuffer(int line) const {
+        return p_data + (line-1)*p_stride;
       }
 
       void TackCube (const double cubeSample, const double cubeLine);
@@ -200,6 +231,7 @@ namespace Isis {
 
       Chip Extract (int samples, int lines, int samp, int line);
       void Extract (int samp, int line, Chip &output);
+      bool View (int samp, int line, Chip &view);
       Isis::Statistics *Statistics();
       void Extract (Chip &output, Affine &affine);
       void Write (const std::string &filename);
@@ -243,10 +275,13 @@ namespace Isis {
     private:
       void Init (const int samples, const int lines);
       void Read (Cube &cube, const int band);
+      void OwnBuffer ();
 
       int p_chipSamples;          //!< Number of samples in the chip
       int p_chipLines;            //!< Number of lines in the chip
-      std::vector<std::vector <double> > p_buf;  //!< Chip buffer
+      std::vector<double> p_buf;  //!< Chip buffer, empty for a view
+      double *p_data;             //!< First pixel, in p_buf or a viewed chip
+      int p_stride;               //!< Distance between lines in p_data
       int p_tackSample;           //!< Middle sample of the chip
       int p_tackLine;             //!< Middle line of the chip
 
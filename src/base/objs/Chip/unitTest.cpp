@@ -14,6 +14,7 @@
 
 #include "Affine.h"
 #include "SpecialPixel.h"
+#include "Statistics.h"
 
 int main () {
   Isis::Preference::Preferences(true);
@@ -86,6 +87,32 @@ int main () {
     std::cout << std::endl;
   }
 
+  std::cout << "View test" << std::endl;
+  Isis::Chip view(4,3);
+  std::cout << chip.View(chip.TackSample(),chip.TackLine(),view) << std::endl;
+  for (int i=1; i<=view.Lines(); i++) {
+    for (int j=1; j<=view.Samples(); j++) {
+      std::cout << view.GetValue(j,i) << " ";
+    }
+    std::cout << std::endl;
+  }
+  std::cout << (view.TackSample() == sub.TackSample() &&
+                view.TackLine() == sub.TackLine()) << std::endl;
+  view.SetValue(1,1,-1.0);
+  std::cout << chip.GetValue(25,24) << std::endl;
+  chip.SetValue(25,24,2425.0);
+  Isis::Chip viewCopy = view;
+  viewCopy.SetValue(1,1,-1.0);
+  std::cout << chip.GetValue(25,24) << std::endl;
+  std::cout << chip.View(1,1,view) << std::endl;
+  std::cout << chip.View(chip.Samples()-2,chip.Lines()-2,view) << std::endl;
+  std::cout << view.GetValue(view.Samples(),view.Lines()) << std::endl;
+
+  std::cout << "Statistics test" << std::endl;
+  Isis::Statistics *stats = chip.Statistics();
+  std::cout << stats->ValidPixels() << " " << stats->TotalPixels() << std::endl;
+  delete stats;
+
   std::cout << "Test writing chip" << std::endl;
   chip.Write("junk.cub");
 
@@ -1,4 +1,5 @@
 #include "ControlNet.h"
+#include "ControlNetFile.h"
 #include "SpecialPixel.h"
 #include "iException.h"
 #include "CameraFactory.h"
@@ -117,7 +118,8 @@ namespace Isis {
 
 
  /**
-  * Reads in the control points from the given file
+  * Reads in the control points from the given file, which may be a Pvl or a
+  * binary control network
   *
   * @param ptfile Name of file containing a Pvl list of control points 
   * @param progress A pointer to the progress of reading in the control points 
@@ -133,6 +135,55 @@ namespace Isis {
   *  
   */
   void ControlNet::ReadControl(const std::string &ptfile, Progress *progress, bool forceBuild) {
+    ReadNetwork(ptfile, NULL, progress, forceBuild);
+  }
+
+
+ /**
+  * Reads in the control points from the given file which have a measure on
+  * any of the given images.  Reading a binary control network reads only
+  * these points from the file.
+  *
+  * @param ptfile Name of file containing a Pvl list of control points 
+  * @param serialNumbers Serial numbers of the images
+  * @param progress A pointer to the progress of reading in the control points 
+  * @param forceBuild Forces invalid Control Points to be added to this Control 
+  *                   Network
+  */
+  void ControlNet::ReadControl(const std::string &ptfile,
+                               const std::vector<std::string> &serialNumbers,
+                               Progress *progress, bool forceBuild) {
+    ReadNetwork(ptfile, &serialNumbers, progress, forceBuild);
+  }
+
+
+  //! Returns true if a point has a measure on one of the images
+  static bool HasImage(ControlPoint &point,
+                       const std::vector<std::string> &serialNumbers) {
+    for (int m=0; m<point.Size(); m++) {
+      for (unsigned int s=0; s<serialNumbers.size(); s++) {
+        if (point[m].CubeSerialNumber() == serialNumbers[s]) return true;
+      }
+    }
+    return false;
+  }
+
+
+ /**
+  * Reads the network from a file for ReadControl
+  *
+  * @param ptfile Name of file containing a Pvl list of control points 
+  * @param serialNumbers If not NULL, only read the points with a measure on
+  *                      one of these images
+  * @param progress A pointer to the progress of reading in the control points 
+  * @param forceBuild Forces invalid Control Points to be added to this Control 
+  *                   Network
+  */
+  void ControlNet::ReadNetwork(const std::string &ptfile,
+                               const std::vector<std::string> *serialNumbers,
+                               Progress *progress, bool forceBuild) {
+    // A binary network file begins with a label without the points, so this
+    // reads only the label
     Pvl p(ptfile);
     try {
       PvlObject cn = p.FindObject("ControlNetwork");
@@ -157,6 +208,18 @@ namespace Isis {
       p_modified = (std::string)cn["LastModified"];
       p_description = (std::string)cn["Description"];
 
+      if (cn.HasKeyword("Format") &&
+          iString((std::string)cn["Format"]).UpCase() == "BINARY") {
+        ControlNetFile file(ptfile);
+        if (serialNumbers == NULL) {
+          file.ReadPoints(*this, progress, forceBuild);
+        }
+        else {
+          file.ReadPoints(*this, *serialNumbers, progress, forceBuild);
+        }
+        return;
+      }
+
       // Prep for reporting progress
       if (progress != NULL) {
         progress->SetText("Loading Control Points...");
@@ -168,7 +231,9 @@ namespace Isis {
           if (cn.Object(i).IsNamed("ControlPoint")) {
             ControlPoint cp;
             cp.Load(cn.Object(i),forceBuild);
-            Add(cp,forceBuild);
+            if (serialNumbers == NULL || HasImage(cp, *serialNumbers)) {
+              Add(cp,forceBuild);
+            }
           }
         }
         catch (iException &e) {
@@ -190,12 +255,14 @@ namespace Isis {
   * Writes out the ControlPoints
   *
   * @param ptfile Name of file containing a Pvl list of control points 
+  * @param binary Write a binary control network (see ControlNetFile) instead
+  *               of a Pvl
   * @throws Isis::iException::Programmer - "Invalid Net 
   *             Enumeration"
   * @throws Isis::iException::Io - "Unable to write PVL
   *             infomation to file"
   */
-  void ControlNet::Write(const std::string &ptfile) {
+  void ControlNet::Write(const std::string &ptfile, bool binary) {
     Pvl p;
     PvlObject net("ControlNetwork");
     net += PvlKeyword("NetworkId", p_networkId);
@@ -227,6 +294,11 @@ namespace Isis {
     net += PvlKeyword("LastModified", p_modified);
     net += PvlKeyword("Description", p_description);
 
+    if (binary) {
+      ControlNetFile::Write(*this, net, ptfile);
+      return;
+    }
+
     for (int i=0; i<(int)p_pointsHash.size(); i++) {
       PvlObject cp = p_pointsHash[p_pointIds[i]].CreatePvlObject();
       net.AddObject(cp);
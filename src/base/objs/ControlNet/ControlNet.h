@@ -78,6 +78,9 @@ namespace Isis {
    *            network to compute those values at the time the
    *            method is called, not when the control network is
    *            first initialized
+   *   @history 2026-10-17 Unknown - Added reading and writing of binary control
+   *            networks (see ControlNetFile), and ReadControl of only the
+   *            points measured on a list of images.
    *                              
    */
   class ControlNet {
@@ -192,7 +195,10 @@ namespace Isis {
       void Delete (const std::string &id);
 
       void ReadControl(const std::string &ptfile, Progress *progress=0, bool forceBuild=false);
-      void Write(const std::string &ptfile);
+      void ReadControl(const std::string &ptfile,
+                       const std::vector<std::string> &serialNumbers,
+                       Progress *progress=0, bool forceBuild=false);
+      void Write(const std::string &ptfile, bool binary=false);
 
       ControlPoint *Find(const std::string &id);
 
@@ -220,6 +226,10 @@ namespace Isis {
       Isis::Camera *Camera(int index) { return p_cameraList[index]; };
 
     private:
+      void ReadNetwork(const std::string &ptfile,
+                       const std::vector<std::string> *serialNumbers,
+                       Progress *progress, bool forceBuild);
+
       QVector<QString> p_pointIds;  //!< QVector of ControlPoint Ids
       QHash <QString, ControlPoint> p_pointsHash; //!< Hash table of Control Points.
       std::string p_targetName;            //!< Name of the target
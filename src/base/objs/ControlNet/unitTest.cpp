@@ -5,6 +5,7 @@
 #include "Preference.h"
 
 #include <string>
+#include <vector>
 #include <iostream>
 using namespace std;
 
@@ -157,8 +158,46 @@ int main () {
 
   Isis::Pvl p1("temp.txt");
   cout << p1 << endl;
+  cout << endl;
+
+  cout << "Test writing and reading a binary control network ..." << endl;
+  cn1.Write("temp.bin", true);
+  Isis::ControlNet cn3("temp.bin");
+  cn3.Write("temp3.txt");
+
+  Isis::TextFile t3;
+  Isis::TextFile t4;
+  t3.Open(f1);
+  t4.Open("temp3.txt");
+  if (t3.LineCount() != t4.LineCount()) {
+    cout << "ERROR: Text Files are not the same!" << endl;
+  }
+  else {
+    for (int l=0; l<t3.LineCount(); l++) {
+      string line1, line2;
+      t3.GetLine(line1);
+      t4.GetLine(line2);
+      if (!(line1 == line2)) {
+        cout <<  "ERROR: Text Files are not the same!" << endl;
+      }
+    }
+  }
+  cout << "Points: " << cn3.Size() << endl;
+  cout << endl;
+
+  cout << "Test reading the points on one image ..." << endl;
+  vector<string> serialNumbers;
+  serialNumbers.push_back("Id3");
+  Isis::ControlNet cn4;
+  cn4.ReadControl("temp.txt", serialNumbers);
+  cout << "Pvl:    " << cn4.Size() << " " << cn4[0].Id() << endl;
+  Isis::ControlNet cn5;
+  cn5.ReadControl("temp.bin", serialNumbers);
+  cout << "Binary: " << cn5.Size() << " " << cn5[0].Id() << endl;
 
   remove("temp.txt");
   remove("temp2.txt");
+  remove("temp3.txt");
+  remove("temp.bin");
 
 }
@@ -0,0 +1,630 @@
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <set>
+#include <sstream>
+
+#include "ControlNetFile.h"
+#include "ControlNet.h"
+#include "ControlMeasure.h"
+#include "Endian.h"
+#include "EndianSwapper.h"
+#include "Filename.h"
+#include "Message.h"
+#include "Progress.h"
+#include "Pvl.h"
+#include "iException.h"
+#include "iString.h"
+
+namespace Isis {
+  //! Bytes in a point record: id, type, flags, measures, lat, lon, radius
+  static const int pointRecordBytes = 4 * sizeof(int) + 3 * sizeof(double);
+
+  /**
+   * Bytes in a measure record: serial number, type, flags, date, chooser,
+   * sample, line, sample error, line error, diameter, minimum and maximum
+   * z scores and goodness of fit
+   */
+  static const int measureRecordBytes = 5 * sizeof(int) + 8 * sizeof(double);
+
+  //! Bit in the point flags of a held point
+  static const int heldFlag = 1;
+
+  //! Bit in the point and measure flags of an ignored point or measure
+  static const int ignoreFlag = 2;
+
+  //! Bit in the measure flags of a reference measure
+  static const int referenceFlag = 4;
+
+  //! Appends the bytes of an integer to a buffer
+  static void PutInt(std::vector<char> &buffer, int value) {
+    const char *bytes = (const char *) &value;
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(int));
+  }
+
+  //! Appends the bytes of a double to a buffer
+  static void PutDouble(std::vector<char> &buffer, double value) {
+    const char *bytes = (const char *) &value;
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(double));
+  }
+
+  //! Appends the bytes of a big integer to a buffer
+  static void PutBigInt(std::vector<char> &buffer, BigInt value) {
+    long long int big = value;
+    const char *bytes = (const char *) &big;
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(long long int));
+  }
+
+  //! Returns the number of a string in the string table, adding it if needed
+  static int StringNumber(const std::string &value,
+                          std::vector<std::string> &strings,
+                          std::map<std::string,int> &numbers) {
+    std::map<std::string,int>::iterator it = numbers.find(value);
+    if (it != numbers.end()) return it->second;
+    numbers[value] = strings.size();
+    strings.push_back(value);
+    return strings.size() - 1;
+  }
+
+
+  /**
+   * Opens a binary control network file and reads its strings and index.
+   * No control points are read.
+   *
+   * @param file Name of the binary control network file
+   *
+   * @throws Isis::iException::User - The file is not a binary control network
+   * @throws Isis::iException::Io - Unable to open the file
+   */
+  ControlNetFile::ControlNetFile(const std::string &file) {
+    p_swapper = NULL;
+    p_filename = file;
+
+    Pvl label(file);
+    PvlObject &net = label.FindObject("ControlNetwork");
+    if (!net.HasKeyword("Format") ||
+        iString((std::string)net["Format"]).UpCase() != "BINARY") {
+      std::string msg = "[" + file + "] is not a binary control network";
+      throw iException::Message(iException::User,msg,_FILEINFO_);
+    }
+    p_swapper = new EndianSwapper(iString((std::string)net["ByteOrder"]).UpCase());
+
+    try {
+      ReadIndex(net);
+    }
+    catch (iException &e) {
+      delete p_swapper;
+      p_swapper = NULL;
+      throw;
+    }
+  }
+
+
+  /**
+   * Opens the file and reads the string table and the index for the
+   * constructor
+   *
+   * @param net The ControlNetwork object of the file label
+   */
+  void ControlNetFile::ReadIndex(PvlObject &net) {
+    Filename temp(p_filename);
+    p_stream.open(temp.Expanded().c_str(),std::ios::in | std::ios::binary);
+    if (!p_stream) {
+      std::string msg = Message::FileOpen(temp.Expanded());
+      throw iException::Message(iException::Io,msg,_FILEINFO_);
+    }
+
+    // The string table
+    PvlGroup &strings = net.FindGroup("Strings");
+    std::vector<char> data;
+    ReadSection(strings["StartByte"],strings["Bytes"],data);
+    int nstrings = strings["Records"];
+    p_strings.resize(nstrings);
+    unsigned int pos = 0;
+    for (int i=0; i<nstrings; i++) {
+      int length = (pos + sizeof(int) <= data.size()) ?
+                   p_swapper->Int(&data[pos]) : -1;
+      pos += sizeof(int);
+      if (length < 0 || pos + length > data.size()) {
+        std::string msg = "The string table of [" + p_filename + "] is corrupt";
+        throw iException::Message(iException::Io,msg,_FILEINFO_);
+      }
+      p_strings[i].assign(data.begin() + pos,data.begin() + pos + length);
+      pos += length;
+    }
+
+    // The point offsets followed by the images and the points on each image
+    PvlGroup &points = net.FindGroup("Points");
+    p_pointsStart = (BigInt) points["StartByte"] - 1;
+    int npoints = points["Records"];
+
+    PvlGroup &index = net.FindGroup("Index");
+    ReadSection(index["StartByte"],index["Bytes"],data);
+    int nimages = index["Images"];
+    BigInt offsetBytes = (BigInt) npoints * sizeof(long long int);
+    BigInt imageBytes = (BigInt) nimages * 3 * sizeof(int);
+    if ((BigInt) data.size() < offsetBytes + imageBytes) {
+      std::string msg = "The index of [" + p_filename + "] is corrupt";
+      throw iException::Message(iException::Io,msg,_FILEINFO_);
+    }
+
+    p_offsets.resize(npoints);
+    for (int i=0; i<npoints; i++) {
+      p_offsets[i] = p_swapper->LongLongInt(&data[i*sizeof(long long int)]);
+    }
+
+    p_images.resize(nimages);
+    p_imageStart.resize(nimages+1,0);
+    std::vector<int> counts(nimages);
+    for (int i=0; i<nimages; i++) {
+      const char *image = &data[offsetBytes + i*3*sizeof(int)];
+      p_images[i] = p_swapper->Int((void *) image);
+      p_imageStart[i] = p_swapper->Int((void *) (image + sizeof(int)));
+      counts[i] = p_swapper->Int((void *) (image + 2*sizeof(int)));
+      p_imageIndex[String(p_images[i])] = i;
+    }
+
+    // The entries of each image end where those of the next image begin
+    int entries = (data.size() - offsetBytes - imageBytes) / sizeof(int);
+    p_imageStart[nimages] = entries;
+    for (int i=0; i<nimages; i++) {
+      if (p_imageStart[i] < 0 || counts[i] < 0 ||
+          p_imageStart[i] + counts[i] != p_imageStart[i+1]) {
+        std::string msg = "The index of [" + p_filename + "] is corrupt";
+        throw iException::Message(iException::Io,msg,_FILEINFO_);
+      }
+    }
+    p_imagePoints.resize(entries);
+    for (int i=0; i<entries; i++) {
+      p_imagePoints[i] = p_swapper->Int(&data[offsetBytes + imageBytes +
+                                             i*sizeof(int)]);
+    }
+  }
+
+
+  //! Closes the file
+  ControlNetFile::~ControlNetFile() {
+    p_stream.close();
+    if (p_swapper != NULL) delete p_swapper;
+  }
+
+
+  /**
+   * Returns the serial number of an image
+   *
+   * @param image Image number, from 0 to Images()-1
+   */
+  std::string ControlNetFile::SerialNumber(int image) const {
+    if (image < 0 || image >= Images()) {
+      std::string msg = "There is no image [" + iString(image) + "] in [" +
+                        p_filename + "]";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+    return String(p_images[image]);
+  }
+
+
+  /**
+   * Returns the numbers of the control points with a measure on an image, in
+   * the order of the points in the file
+   *
+   * @param image Image number, from 0 to Images()-1
+   */
+  std::vector<int> ControlNetFile::ImagePoints(int image) const {
+    if (image < 0 || image >= Images()) {
+      std::string msg = "There is no image [" + iString(image) + "] in [" +
+                        p_filename + "]";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+    return std::vector<int>(p_imagePoints.begin() + p_imageStart[image],
+                            p_imagePoints.begin() + p_imageStart[image+1]);
+  }
+
+
+  /**
+   * Reads one control point from the file
+   *
+   * @param index Point number, from 0 to Points()-1
+   * @param forceBuild Forces invalid Control Measures to be added to the
+   *                   Control Point
+   */
+  ControlPoint ControlNetFile::Point(int index, bool forceBuild) {
+    if (index < 0 || index >= Points()) {
+      std::string msg = "There is no control point [" + iString(index) +
+                        "] in [" + p_filename + "]";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+    p_stream.clear();
+    p_stream.seekg(p_pointsStart + p_offsets[index],std::ios::beg);
+    return ReadPoint(forceBuild);
+  }
+
+
+  /**
+   * Reads all the control points in the file and adds them to a control
+   * network
+   *
+   * @param net The control network to add the points to
+   * @param progress A pointer to the progress of reading in the control points
+   * @param forceBuild Forces invalid Control Points to be added to the
+   *                   Control Network
+   */
+  void ControlNetFile::ReadPoints(ControlNet &net, Progress *progress,
+                                  bool forceBuild) {
+    if (progress != NULL) {
+      progress->SetText("Loading Control Points...");
+      progress->SetMaximumSteps(Points());
+      progress->CheckStatus();
+    }
+
+    // The points are stored one after the other so read them in one pass
+    p_stream.clear();
+    p_stream.seekg(p_pointsStart,std::ios::beg);
+    for (int i=0; i<Points(); i++) {
+      try {
+        net.Add(ReadPoint(forceBuild),forceBuild);
+      }
+      catch (iException &e) {
+        std::string msg = "Invalid Control Point at position [" + iString(i)
+           + "]";
+        throw iException::Message(iException::User,msg,_FILEINFO_);
+      }
+      if (progress != NULL) progress->CheckStatus();
+    }
+  }
+
+
+  /**
+   * Reads the control points with a measure on any of a list of images and
+   * adds them to a control network, in the order of the points in the file.
+   * Serial numbers which are not in the file are ignored.
+   *
+   * @param net The control network to add the points to
+   * @param serialNumbers Serial numbers of the images
+   * @param progress A pointer to the progress of reading in the control points
+   * @param forceBuild Forces invalid Control Points to be added to the
+   *                   Control Network
+   */
+  void ControlNetFile::ReadPoints(ControlNet &net,
+                                  const std::vector<std::string> &serialNumbers,
+                                  Progress *progress, bool forceBuild) {
+    std::set<int> points;
+    for (unsigned int s=0; s<serialNumbers.size(); s++) {
+      std::map<std::string,int>::const_iterator it =
+        p_imageIndex.find(serialNumbers[s]);
+      if (it == p_imageIndex.end()) continue;
+      int image = it->second;
+      points.insert(p_imagePoints.begin() + p_imageStart[image],
+                    p_imagePoints.begin() + p_imageStart[image+1]);
+    }
+
+    if (progress != NULL) {
+      progress->SetText("Loading Control Points...");
+      progress->SetMaximumSteps(points.size());
+      progress->CheckStatus();
+    }
+
+    std::set<int>::iterator it;
+    for (it = points.begin(); it != points.end(); it++) {
+      try {
+        net.Add(Point(*it,forceBuild),forceBuild);
+      }
+      catch (iException &e) {
+        std::string msg = "Invalid Control Point at position [" +
+                          iString(*it) + "]";
+        throw iException::Message(iException::User,msg,_FILEINFO_);
+      }
+      if (progress != NULL) progress->CheckStatus();
+    }
+  }
+
+
+  /**
+   * Reads the control point at the current position of the stream
+   *
+   * @param forceBuild Forces invalid Control Measures to be added to the
+   *                   Control Point
+   *
+   * @throws Isis::iException::Io - Error reading the point
+   * @throws Isis::iException::User - Invalid Point Type
+   * @throws Isis::iException::User - Invalid Measure Type
+   */
+  ControlPoint ControlNetFile::ReadPoint(bool forceBuild) {
+    char record[pointRecordBytes];
+    p_stream.read(record,pointRecordBytes);
+    if (!p_stream.good()) {
+      std::string msg = "Error reading a control point from [" +
+                        p_filename + "]";
+      throw iException::Message(iException::Io,msg,_FILEINFO_);
+    }
+
+    ControlPoint point(String(p_swapper->Int(record)));
+    int type = p_swapper->Int(record + sizeof(int));
+    if (type != ControlPoint::Ground && type != ControlPoint::Tie) {
+      std::string msg = "Invalid Point Type, [" + iString(type) + "]";
+      throw iException::Message(iException::User,msg,_FILEINFO_);
+    }
+    point.SetType((ControlPoint::PointType) type);
+    int flags = p_swapper->Int(record + 2*sizeof(int));
+    point.SetHeld((flags & heldFlag) != 0);
+    point.SetIgnore((flags & ignoreFlag) != 0);
+    int measures = p_swapper->Int(record + 3*sizeof(int));
+    char *ground = record + 4*sizeof(int);
+    double lat = p_swapper->Double(ground);
+    double lon = p_swapper->Double(ground + sizeof(double));
+    double radius = p_swapper->Double(ground + 2*sizeof(double));
+    point.SetUniversalGround(lat,lon,radius);
+
+    if (measures < 0) {
+      std::string msg = "Error reading control point [" + point.Id() +
+                        "] from [" + p_filename + "]";
+      throw iException::Message(iException::Io,msg,_FILEINFO_);
+    }
+    std::vector<char> data(measures * measureRecordBytes);
+    if (measures > 0) p_stream.read(&data[0],data.size());
+    if (!p_stream.good()) {
+      std::string msg = "Error reading control point [" + point.Id() +
+                        "] from [" + p_filename + "]";
+      throw iException::Message(iException::Io,msg,_FILEINFO_);
+    }
+
+    for (int m=0; m<measures; m++) {
+      char *measure = &data[m * measureRecordBytes];
+      ControlMeasure cm;
+      cm.SetCubeSerialNumber(String(p_swapper->Int(measure)));
+      int mtype = p_swapper->Int(measure + sizeof(int));
+      if (mtype < ControlMeasure::Unmeasured ||
+          mtype > ControlMeasure::ValidatedAutomatic) {
+        std::string msg = "Invalid Measure Type, [" + iString(mtype) + "]";
+        throw iException::Message(iException::User,msg,_FILEINFO_);
+      }
+      cm.SetType((ControlMeasure::MeasureType) mtype);
+      int mflags = p_swapper->Int(measure + 2*sizeof(int));
+      cm.SetIgnore((mflags & ignoreFlag) != 0);
+      cm.SetReference((mflags & referenceFlag) != 0);
+      cm.SetDateTime(String(p_swapper->Int(measure + 3*sizeof(int))));
+      cm.SetChooserName(String(p_swapper->Int(measure + 4*sizeof(int))));
+
+      char *values = measure + 5*sizeof(int);
+      double v[8];
+      for (int i=0; i<8; i++) v[i] = p_swapper->Double(values + i*sizeof(double));
+      cm.SetCoordinate(v[0],v[1]);
+      cm.SetError(v[2],v[3]);
+      cm.SetDiameter(v[4]);
+      cm.SetZScores(v[5],v[6]);
+      cm.SetGoodnessOfFit(v[7]);
+
+      point.Add(cm,forceBuild);
+    }
+
+    return point;
+  }
+
+
+  /**
+   * Reads a section of the file
+   *
+   * @param start First byte of the section, starting at 1
+   * @param bytes Size of the section
+   * @param data Returns the bytes of the section
+   */
+  void ControlNetFile::ReadSection(BigInt start, BigInt bytes,
+                                   std::vector<char> &data) {
+    data.resize(bytes);
+    p_stream.clear();
+    p_stream.seekg(start - 1,std::ios::beg);
+    if (bytes > 0) p_stream.read(&data[0],bytes);
+    if (!p_stream.good()) {
+      std::string msg = "Error reading data from [" + p_filename + "]";
+      throw iException::Message(iException::Io,msg,_FILEINFO_);
+    }
+  }
+
+
+  //! Returns a string from the string table
+  const std::string &ControlNetFile::String(int index) const {
+    if (index < 0 || index >= (int)p_strings.size()) {
+      std::string msg = "String [" + iString(index) + "] is not in the " +
+                        "string table of [" + p_filename + "]";
+      throw iException::Message(iException::Io,msg,_FILEINFO_);
+    }
+    return p_strings[index];
+  }
+
+
+  /**
+   * Writes a control network to a binary control network file
+   *
+   * @param net The control network to write
+   * @param header The ControlNetwork object of the network, without control
+   *               points, which becomes the label of the file
+   * @param file Name of the file to create
+   *
+   * @throws Isis::iException::Programmer - Invalid Point Enumeration
+   * @throws Isis::iException::Programmer - Invalid Measure Enumeration
+   * @throws Isis::iException::Io - Unable to create the file
+   */
+  void ControlNetFile::Write(ControlNet &net, PvlObject &header,
+                             const std::string &file) {
+    // Number the strings and index the points on each image
+    std::vector<std::string> strings;
+    std::map<std::string,int> numbers;
+    std::map<int, std::vector<int> > imagePoints;
+    std::vector<BigInt> offsets(net.Size());
+    BigInt pointBytes = 0;
+    int measures = 0;
+    int entries = 0;
+    for (int i=0; i<net.Size(); i++) {
+      ControlPoint &point = net[i];
+      if (point.Type() != ControlPoint::Ground &&
+          point.Type() != ControlPoint::Tie) {
+        std::string msg = "Invalid Point Enumeration, [" +
+                          iString(point.Type()) + "] for ControlPoint [" +
+                          point.Id() + "].";
+        throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+      }
+      StringNumber(point.Id(),strings,numbers);
+      for (int m=0; m<point.Size(); m++) {
+        const ControlMeasure &cm = point[m];
+        if (cm.Type() < ControlMeasure::Unmeasured ||
+            cm.Type() > ControlMeasure::ValidatedAutomatic) {
+          std::string msg = "Invalid Measure Enumeration, [" +
+                            iString(cm.Type()) + "]";
+          throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+        }
+        int sn = StringNumber(cm.CubeSerialNumber(),strings,numbers);
+        std::vector<int> &points = imagePoints[sn];
+        if (points.size() == 0 || points.back() != i) {
+          points.push_back(i);
+          entries++;
+        }
+        StringNumber(cm.DateTime(),strings,numbers);
+        StringNumber(cm.ChooserName(),strings,numbers);
+      }
+      offsets[i] = pointBytes;
+      pointBytes += pointRecordBytes + point.Size() * measureRecordBytes;
+      measures += point.Size();
+    }
+
+    BigInt stringBytes = 0;
+    for (unsigned int i=0; i<strings.size(); i++) {
+      stringBytes += sizeof(int) + strings[i].size();
+    }
+    BigInt indexBytes = (BigInt) net.Size() * sizeof(long long int) +
+                        (BigInt) imagePoints.size() * 3 * sizeof(int) +
+                        (BigInt) entries * sizeof(int);
+
+    // Size the label as Blob does, then place the sections after it
+    Pvl pvl;
+    PvlObject label = header;
+    label += PvlKeyword("Format","Binary");
+    label += PvlKeyword("ByteOrder",ByteOrderName(IsLsb() ? Lsb : Msb));
+    PvlGroup stringGroup("Strings");
+    stringGroup += PvlKeyword("StartByte",0);
+    stringGroup += PvlKeyword("Bytes",stringBytes);
+    stringGroup += PvlKeyword("Records",(int)strings.size());
+    label.AddGroup(stringGroup);
+    PvlGroup pointGroup("Points");
+    pointGroup += PvlKeyword("StartByte",0);
+    pointGroup += PvlKeyword("Bytes",pointBytes);
+    pointGroup += PvlKeyword("Records",net.Size());
+    pointGroup += PvlKeyword("Measures",measures);
+    label.AddGroup(pointGroup);
+    PvlGroup indexGroup("Index");
+    indexGroup += PvlKeyword("StartByte",0);
+    indexGroup += PvlKeyword("Bytes",indexBytes);
+    indexGroup += PvlKeyword("Images",(int)imagePoints.size());
+    label.AddGroup(indexGroup);
+    pvl.AddObject(label);
+
+    std::ostringstream os;
+    os << pvl << std::endl;
+    os.seekp(0,std::ios::end);
+    BigInt startByte = (BigInt) os.tellp() + (BigInt) 64 + 1;
+    PvlObject &written = pvl.FindObject("ControlNetwork");
+    written.FindGroup("Strings")["StartByte"] = startByte;
+    written.FindGroup("Points")["StartByte"] = startByte + stringBytes;
+    written.FindGroup("Index")["StartByte"] = startByte + stringBytes +
+                                               pointBytes;
+
+    try {
+      pvl.Write(file);
+
+      Filename temp(file);
+      std::fstream stream;
+      std::ios::openmode flags = std::ios::in | std::ios::binary | std::ios::out;
+      stream.open(temp.Expanded().c_str(),flags);
+      if (!stream) {
+        std::string msg = "Unable to open [" + file + "]";
+        throw iException::Message(iException::Io,msg,_FILEINFO_);
+      }
+      stream.seekp(startByte - 1,std::ios::beg);
+
+      std::vector<char> buffer;
+      for (unsigned int i=0; i<strings.size(); i++) {
+        buffer.clear();
+        PutInt(buffer,strings[i].size());
+        buffer.insert(buffer.end(),strings[i].begin(),strings[i].end());
+        stream.write(&buffer[0],buffer.size());
+      }
+
+      for (int i=0; i<net.Size(); i++) {
+        ControlPoint &point = net[i];
+        buffer.clear();
+        PutInt(buffer,numbers[point.Id()]);
+        PutInt(buffer,point.Type());
+        PutInt(buffer,(point.Held() ? heldFlag : 0) |
+                      (point.Ignore() ? ignoreFlag : 0));
+        PutInt(buffer,point.Size());
+        PutDouble(buffer,point.UniversalLatitude());
+        PutDouble(buffer,point.UniversalLongitude());
+        PutDouble(buffer,point.Radius());
+        for (int m=0; m<point.Size(); m++) {
+          const ControlMeasure &cm = point[m];
+          PutInt(buffer,numbers[cm.CubeSerialNumber()]);
+          PutInt(buffer,cm.Type());
+          PutInt(buffer,(cm.Ignore() ? ignoreFlag : 0) |
+                        (cm.IsReference() ? referenceFlag : 0));
+          PutInt(buffer,numbers[cm.DateTime()]);
+          PutInt(buffer,numbers[cm.ChooserName()]);
+          PutDouble(buffer,cm.Sample());
+          PutDouble(buffer,cm.Line());
+          PutDouble(buffer,cm.SampleError());
+          PutDouble(buffer,cm.LineError());
+          PutDouble(buffer,cm.Diameter());
+          PutDouble(buffer,cm.GetZScoreMin());
+          PutDouble(buffer,cm.GetZScoreMax());
+          PutDouble(buffer,cm.GoodnessOfFit());
+        }
+        stream.write(&buffer[0],buffer.size());
+      }
+
+      buffer.clear();
+      for (int i=0; i<net.Size(); i++) PutBigInt(buffer,offsets[i]);
+      int first = 0;
+      std::map<int, std::vector<int> >::iterator it;
+      for (it = imagePoints.begin(); it != imagePoints.end(); it++) {
+        PutInt(buffer,it->first);
+        PutInt(buffer,first);
+        PutInt(buffer,it->second.size());
+        first += it->second.size();
+      }
+      for (it = imagePoints.begin(); it != imagePoints.end(); it++) {
+        for (unsigned int p=0; p<it->second.size(); p++) {
+          PutInt(buffer,it->second[p]);
+        }
+      }
+      if (buffer.size() > 0) stream.write(&buffer[0],buffer.size());
+
+      if (!stream.good()) {
+        stream.close();
+        std::string msg = "Error writing data to [" + file + "]";
+        throw iException::Message(iException::Io,msg,_FILEINFO_);
+      }
+      stream.close();
+    }
+    catch (iException &e) {
+      std::string msg = "Unable to create binary control network file [" +
+                        file + "]";
+      throw iException::Message(iException::Io,msg,_FILEINFO_);
+    }
+  }
+}
@@ -0,0 +1,136 @@
+#ifndef ControlNetFile_h
+#define ControlNetFile_h
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Constants.h"
+#include "ControlPoint.h"
+
+namespace Isis {
+  class ControlNet;
+  class EndianSwapper;
+  class Progress;
+  class PvlObject;
+
+  /**
+   * @brief Binary control network file
+   *
+   * This class reads and writes control networks in a binary format, which
+   * is much faster to read and much smaller than the Pvl format.  The file
+   * starts with the same ControlNetwork object as a Pvl network, without the
+   * control points and with keywords describing the binary sections which
+   * follow it, in the way a cube label describes its data:
+   * @code
+   *   Object = ControlNetwork
+   *     NetworkId    = ...
+   *     ...
+   *     Format       = Binary
+   *     ByteOrder    = Lsb
+   *     Group = Strings
+   *       StartByte = ...
+   *       Bytes     = ...
+   *       Records   = ...
+   *     End_Group
+   *     Group = Points
+   *       ...
+   *       Measures  = ...
+   *     End_Group
+   *     Group = Index
+   *       ...
+   *       Images    = ...
+   *     End_Group
+   *   End_Object
+   *   End
+   * @endcode
+   * The Strings section holds every point id, serial number, date and
+   * chooser name once, each as a 4 byte length followed by the characters.
+   * The records refer to strings by their number in this table.  The Points
+   * section holds each point as a fixed 40 byte record followed by a fixed
+   * 84 byte record for each of its measures.  The Index section holds the
+   * byte offset of every point in the Points section, then for every image
+   * its serial number and the numbers of the points which have a measure on
+   * it.
+   *
+   * Opening a file reads only the label, the strings and the index.  Points
+   * are then read when asked for, either one at a time, all of them, or only
+   * those measured on a set of images.  Every value of the Pvl format is
+   * stored, so a network converted from one format to the other and back is
+   * unchanged.  ControlNet reads either format and writes this one when
+   * asked to.
+   *
+   * @ingroup ControlNetwork
+   *
+   * @see ControlNet
+   *
+   * @author 2026-10-17 Unknown
+   *
+   * @internal
+   */
+  class ControlNetFile {
+    public:
+      ControlNetFile(const std::string &file);
+      ~ControlNetFile();
+
+      static void Write(ControlNet &net, PvlObject &header,
+                        const std::string &file);
+
+      //! Returns the number of control points in the file
+      int Points() const { return p_offsets.size(); };
+
+      //! Returns the number of images measured by the control points
+      int Images() const { return p_images.size(); };
+
+      std::string SerialNumber(int image) const;
+      std::vector<int> ImagePoints(int image) const;
+
+      ControlPoint Point(int index, bool forceBuild=false);
+
+      void ReadPoints(ControlNet &net, Progress *progress=0,
+                      bool forceBuild=false);
+      void ReadPoints(ControlNet &net,
+                      const std::vector<std::string> &serialNumbers,
+                      Progress *progress=0, bool forceBuild=false);
+
+    private:
+      void ReadIndex(PvlObject &net);
+      ControlPoint ReadPoint(bool forceBuild);
+      void ReadSection(BigInt start, BigInt bytes, std::vector<char> &data);
+      const std::string &String(int index) const;
+
+      std::string p_filename;         //!< Name of the file, as given
+      std::ifstream p_stream;         //!< Stream the points are read from
+      EndianSwapper *p_swapper;       //!< Swaps the bytes of the file values
+      BigInt p_pointsStart;           //!< Offset of the Points section
+      std::vector<std::string> p_strings; //!< The string table
+      std::vector<BigInt> p_offsets;  //!< Offset of each point from p_pointsStart
+      std::vector<int> p_images;      //!< Serial number string of each image
+      std::vector<int> p_imageStart;  //!< First entry of each image in p_imagePoints
+      std::vector<int> p_imagePoints; //!< Point numbers measured on each image
+      std::map<std::string,int> p_imageIndex; //!< Image of each serial number
+  };
+};
+
+#endif
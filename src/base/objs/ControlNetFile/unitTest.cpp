@@ -0,0 +1,135 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ControlNetFile.h"
+#include "ControlNet.h"
+#include "iException.h"
+#include "Preference.h"
+
+using namespace std;
+
+void PrintPoint(Isis::ControlPoint &point) {
+  cout << "  " << point.Id() << " " << point.PointTypeToString(point.Type())
+       << " Held=" << point.Held() << " Ignore=" << point.Ignore() << endl;
+  for (int m=0; m<point.Size(); m++) {
+    cout << "    " << point[m].CubeSerialNumber() << " " << point[m].Type()
+         << " " << point[m].Sample() << " " << point[m].Line()
+         << " Ignore=" << point[m].Ignore() << " Reference="
+         << point[m].IsReference() << " [" << point[m].ChooserName() << "]"
+         << endl;
+  }
+}
+
+int main () {
+  Isis::Preference::Preferences(true);
+  cout << "Unit test for ControlNetFile" << endl << endl;
+
+  Isis::ControlNet net;
+  net.SetType(Isis::ControlNet::ImageToImage);
+  net.SetTarget("Mars");
+  net.SetNetworkId("Test");
+  net.SetUserName("jdoe");
+  net.SetCreatedDate("2026-10-17T10:00:00");
+  net.SetModifiedDate("2026-10-17T10:00:00");
+  net.SetDescription("UnitTest of ControlNetFile");
+
+  Isis::ControlMeasure cm;
+  Isis::ControlPoint p1("P1");
+  cm.SetCoordinate(10.5, 20.25, Isis::ControlMeasure::Manual);
+  cm.SetCubeSerialNumber("A");
+  cm.SetChooserName("janeDoe");
+  cm.SetReference(true);
+  p1.Add(cm);
+  cm.SetCoordinate(12.0, 22.75, Isis::ControlMeasure::Automatic);
+  cm.SetCubeSerialNumber("B");
+  cm.SetChooserName("pointreg");
+  cm.SetReference(false);
+  p1.Add(cm);
+  net.Add(p1);
+
+  Isis::ControlPoint p2("P2");
+  p2.SetType(Isis::ControlPoint::Ground);
+  p2.SetHeld(true);
+  p2.SetUniversalGround(10.0, 20.0, 3396190.0);
+  cm.SetCoordinate(100.0, 200.0, Isis::ControlMeasure::ValidatedManual);
+  cm.SetCubeSerialNumber("B");
+  p2.Add(cm);
+  cm.SetCubeSerialNumber("C");
+  cm.SetIgnore(true);
+  p2.Add(cm);
+  net.Add(p2);
+
+  Isis::ControlPoint p3("P3");
+  p3.SetIgnore(true);
+  Isis::ControlMeasure unmeasured;
+  unmeasured.SetCubeSerialNumber("A");
+  p3.Add(unmeasured);
+  net.Add(p3);
+
+  net.Write("temp.bin", true);
+
+  Isis::ControlNetFile file("temp.bin");
+  cout << "Points: " << file.Points() << endl;
+  cout << "Images: " << file.Images() << endl;
+  for (int i=0; i<file.Images(); i++) {
+    vector<int> points = file.ImagePoints(i);
+    cout << "  " << file.SerialNumber(i) << ":";
+    for (unsigned int p=0; p<points.size(); p++) cout << " " << points[p];
+    cout << endl;
+  }
+  cout << endl;
+
+  cout << "Reading the points out of order ..." << endl;
+  for (int i=file.Points()-1; i>=0; i--) {
+    Isis::ControlPoint point = file.Point(i);
+    PrintPoint(point);
+  }
+  Isis::ControlPoint ground = file.Point(1);
+  cout << "  " << ground.UniversalLatitude() << " "
+       << ground.UniversalLongitude() << " " << ground.Radius() << endl;
+  cout << endl;
+
+  cout << "Reading the points on images C and D ..." << endl;
+  vector<string> serialNumbers;
+  serialNumbers.push_back("C");
+  serialNumbers.push_back("D");
+  Isis::ControlNet part;
+  file.ReadPoints(part, serialNumbers);
+  cout << "Points: " << part.Size() << endl;
+  PrintPoint(part[0]);
+  cout << endl;
+
+  cout << "Reading all the points ..." << endl;
+  Isis::ControlNet all;
+  file.ReadPoints(all);
+  cout << "Points: " << all.Size() << endl;
+  for (int i=0; i<all.Size(); i++) PrintPoint(all[i]);
+  cout << endl;
+
+  cout << "Testing errors ..." << endl;
+  try {
+    file.Point(3);
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+
+  try {
+    file.ImagePoints(-1);
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+
+  net.Write("temp.net");
+  try {
+    Isis::ControlNetFile pvl("temp.net");
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+
+  remove("temp.bin");
+  remove("temp.net");
+  return 0;
+}
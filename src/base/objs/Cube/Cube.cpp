@@ -22,12 +22,17 @@
  */                                                                       
 
 #include <sstream>
+
+#include <QMutex>
+#include <QMutexLocker>
+
 #include "Cube.h"
 #include "Preference.h"
 #include "Filename.h"
 #include "iException.h"
 #include "CubeBsqHandler.h"
 #include "CubeTileHandler.h"
+#include "CubeMappedTileHandler.h"
 #include "Endian.h"
 #include "SpecialPixel.h"
 #include "Message.h"
@@ -64,9 +69,25 @@ namespace Isis {
     // convert max size from gigabytes to bytes for later comparison
     p_maxSizePreference = pref["MaximumSize"];
     p_maxSizePreference *= 1073741824;
+
+    // Memory mapping is optional in the preferences
+    p_memoryMapped = false;
+    if (pref.HasKeyword("MemoryMapping")) {
+      temp = (string) pref["MemoryMapping"];
+      p_memoryMapped = temp.UpCase() == "ON";
+    }
+
+    // Tile cache budget in megabytes, zero uses the handler default
+    p_cacheSize = 0;
+    if (pref.HasKeyword("CacheSize")) {
+      p_cacheSize = pref["CacheSize"];
+      p_cacheSize *= 1048576;
+    }
   
     // Init the i/o handler pointer
     p_ioHandler = NULL;
+    p_ioMapped = false;
+    p_ioMutex = new QMutex;
   
     // Init the cube def 
     p_cube.labelFile = "";
@@ -100,6 +121,7 @@ namespace Isis {
     Close();
     if(p_camera != NULL) delete p_camera;
     if(p_projection != NULL) delete p_projection;
+    delete p_ioMutex;
   }
   
 /**                                                                       
@@ -232,12 +254,11 @@ namespace Isis {
     // Now examine the format to see which type of handler to create
     if ((string) core["Format"] == "BandSequential") {
       p_cube.cubeFormat = Isis::Bsq;
-      p_ioHandler = new Isis::CubeBsqHandler (p_cube);
     }
     else {
       p_cube.cubeFormat = Isis::Tile;
-      p_ioHandler = new Isis::CubeTileHandler (p_cube);
     }
+    CreateIoHandler();
   
     // Open the file
     p_ioHandler->Open();
@@ -316,12 +337,7 @@ namespace Isis {
     SetVirtualBands();
   
     // Now examine the format to see which type of handler to create
-    if (p_cube.cubeFormat == Isis::Bsq) {
-      p_ioHandler = new Isis::CubeBsqHandler (p_cube);
-    }
-    else {
-      p_ioHandler = new Isis::CubeTileHandler (p_cube);
-    }
+    CreateIoHandler();
   
     // Open the file
     try {
@@ -452,12 +468,7 @@ namespace Isis {
     p_cube.label.AddObject(lbl);
   
     // Create the appropriate handler 
-    if (p_cube.cubeFormat == Isis::Bsq) {
-      p_ioHandler = new Isis::CubeBsqHandler (p_cube);
-    }
-    else {
-      p_ioHandler = new Isis::CubeTileHandler (p_cube);
-    }
+    CreateIoHandler();
   
     // Set up the virtual band list (all bands always for output)
     for (int i=0; i<p_cube.bands; i++) {
@@ -484,10 +495,34 @@ namespace Isis {
       throw Isis::iException::Message(Isis::iException::Programmer,msg,_FILEINFO_);
     }
   
-    p_ioHandler->Read(rbuf);
+    // Only the cube i/o is serialized, the conversion works on the buffer
+    {
+      QMutexLocker lock(p_ioMutex);
+      p_ioHandler->Read(rbuf);
+    }
+
     p_ioHandler->ToDouble(rbuf);
   }
 
+/**
+ * This method will load the data covered by a buffer into the cache of the
+ * cube without converting it, so a later Read of the same area does not
+ * have to wait on the disk. It is safe to call from a thread other than the
+ * one reading and writing the cube (see BrickPrefetcher). Only the raw
+ * buffer is used, the pixel values of the buffer are not changed.
+ *
+ * @param buf Buffer describing the area to be loaded
+ */
+  void Cube::Prefetch(Isis::Buffer &buf) {
+    if (!IsOpen()) {
+      string msg = "Cube::Prefetch - Try opening a file before you read it";
+      throw Isis::iException::Message(Isis::iException::Programmer,msg,_FILEINFO_);
+    }
+
+    QMutexLocker lock(p_ioMutex);
+    p_ioHandler->Read(buf);
+  }
+
 /**                                                                       
  * This method will write a buffer of data from the cube as specified by the
  * contents of the Buffer object.
@@ -506,6 +541,8 @@ namespace Isis {
       throw Isis::iException::Message(Isis::iException::Programmer,msg,_FILEINFO_);
     }
     p_ioHandler->ToRaw(wbuf);
+
+    QMutexLocker lock(p_ioMutex);
     p_ioHandler->Write(wbuf);
   }
   
@@ -540,8 +577,64 @@ namespace Isis {
     delete p_ioHandler;
     p_cube.virtualBandList.clear();
     p_ioHandler = NULL;
+    p_ioMapped = false;
   }
   
+/**
+ * Creates the i/o handler appropriate for the cube format. Tiled cubes are
+ * memory mapped if requested by the user preferences or SetMemoryMapped.
+ */
+  void Cube::CreateIoHandler () {
+    if (p_cube.cubeFormat == Isis::Bsq) {
+      p_ioHandler = new Isis::CubeBsqHandler (p_cube);
+    }
+    else if (p_memoryMapped) {
+      p_ioHandler = new Isis::CubeMappedTileHandler (p_cube);
+      p_ioMapped = true;
+    }
+    else {
+      p_ioHandler = new Isis::CubeTileHandler (p_cube);
+    }
+    p_ioHandler->SetCacheSize(p_cacheSize);
+  }
+
+/**
+ * Sets the maximum number of bytes of cube data kept in memory by the tile
+ * cache. When the cache is full the least recently used tile is written (if
+ * needed) and reused. This may be called before or after the cube is
+ * opened. If not invoked, the CacheSize keyword (megabytes) in the
+ * CubeCustomization preference group is used. A value of zero or less uses
+ * enough memory for six rows, columns or bands of tiles.
+ *
+ * @param bytes Memory budget of the tile cache in bytes
+ */
+  void Cube::SetCacheSize (BigInt bytes) {
+    p_cacheSize = bytes;
+    if (p_ioHandler != NULL) p_ioHandler->SetCacheSize(p_cacheSize);
+  }
+
+/**
+ * Returns the number of tile accesses satisfied by the cache since the cube
+ * was opened or created.
+ *
+ * @return BigInt Number of cache hits
+ */
+  BigInt Cube::CacheHits () const {
+    if (p_ioHandler == NULL) return 0;
+    return p_ioHandler->CacheHits();
+  }
+
+/**
+ * Returns the number of tile accesses which had to read (or initialize) a
+ * tile since the cube was opened or created.
+ *
+ * @return BigInt Number of cache misses
+ */
+  BigInt Cube::CacheMisses () const {
+    if (p_ioHandler == NULL) return 0;
+    return p_ioHandler->CacheMisses();
+  }
+
   void Cube::ReformatOldIsisLabel(const std::string &oldCube) {
     string parameters = "from="+oldCube;
     Isis::Filename oldName(oldCube);
@@ -750,6 +843,20 @@ namespace Isis {
     p_cube.attached = false;
   }
 
+/**
+ * Used prior to the Open or Create methods, this will specify whether tiled
+ * cube data is accessed through a memory map of the data file rather than
+ * read and written one tile at a time through the file stream. If not
+ * invoked, the MemoryMapping keyword in the CubeCustomization preference
+ * group is used (default is Off). BandSequential cubes are never mapped.
+ *
+ * @param mapped True to memory map the cube data
+ */
+  void Cube::SetMemoryMapped (bool mapped) {
+    OpenCheck();
+    p_memoryMapped = mapped;
+  }
+
 /**                                                                       
  * Returns the number of bands in the cube. Note that this is the number of
  * virtual bands if the Open method was used.
@@ -1092,6 +1199,9 @@ namespace Isis {
    * @param msg The message to display with the percent process while gathering
    *            histogram data
    * 
+   * When either end of the range is open, a real cube is read twice: once to
+   * find the bin range and once to fill the bins.
+   *
    * @return (Isis::Histogram) A pointer to a Histogram object.
    * 
    * @throws ProgrammerError Band was less than zero or more than the number
@@ -1113,8 +1223,16 @@ namespace Isis {
       maxSteps = Lines() * Bands();
     }
 
+    // When both ends of the range are given there is no need for a pass
+    // through the cube to find the bin range
     Isis::Progress progress;
-    Isis::Histogram *hist = new Isis::Histogram(*this,band,&progress);
+    Isis::Histogram *hist;
+    if (validMin != Isis::ValidMinimum && validMax != Isis::ValidMaximum) {
+      hist = new Isis::Histogram(*this,band,validMin,validMax);
+    }
+    else {
+      hist = new Isis::Histogram(*this,band,&progress);
+    }
     Isis::LineManager line(*this);
 
     // This range is for throwing out data; the default parameters are OK always
@@ -26,6 +26,8 @@
 #include "CubeIoHandler.h"
 #include "Blob.h"
 
+class QMutex;
+
 namespace Isis {
   class Camera;
   class Projection;
@@ -104,6 +106,16 @@ namespace Isis {
  *   @history 2008-12-17 Steven Koechle - BlobDelete method was broken, fixed
  *   @history 2009-06-30 Steven Lambright - Added "HasProjection" for uniform
  *            projection existance test
+ *   @history 2026-10-17 Unknown - Added SetMemoryMapped and the MemoryMapping
+ *            preference to read and write tiled cubes through a memory map
+ *   @history 2026-10-17 Unknown - Added SetCacheSize, CacheHits, CacheMisses
+ *            and the CacheSize preference for the tile cache
+ *   @history 2026-10-17 Unknown - Added Prefetch. Reads and writes are now
+ *            serialized so the cube can be prefetched from another thread.
+ *   @history 2026-10-17 Unknown - Pixel conversion in Read and Write is done
+ *            outside of the i/o lock so several threads may use a cube at once.
+ *   @history 2026-10-18 Unknown - Histogram no longer reads the cube to find
+ *            the bin range when both ends of the valid range are given.
  * 
 */
   class Cube {
@@ -139,6 +151,7 @@ namespace Isis {
       void Close(const bool remove=false);
       void Read(Isis::Buffer &rbuf);
       void Write(Isis::Buffer &wbuf);
+      void Prefetch(Isis::Buffer &buf);
       void Read(Isis::Blob &blob);
       void Write(Isis::Blob &blob);
       bool BlobDelete(std::string BlobType, std::string BlobName);
@@ -170,6 +183,21 @@ namespace Isis {
       void SetBaseMultiplier (double base, double mult);
       void SetAttached ();
       void SetDetached ();
+      void SetMemoryMapped (bool mapped = true);
+
+     /**
+      * Returns if the cube data is accessed through a memory map. This is
+      * false until the cube is opened or created, and for BandSequential
+      * cubes even if SetMemoryMapped was invoked.
+      *
+      * @return bool True if the cube data is memory mapped, false if it is
+      *              read and written through the file stream.
+      */
+      inline bool IsMemoryMapped () const { return p_ioMapped; };
+
+      void SetCacheSize (BigInt bytes);
+      BigInt CacheHits () const;
+      BigInt CacheMisses () const;
 
      /**                                                                       
       * Returns the number of bytes reserved for the label.
@@ -291,7 +319,15 @@ namespace Isis {
       bool p_attachedPreference;
       BigInt p_maxSizePreference;
 
+      bool p_memoryMapped;
+      bool p_ioMapped;        //!< Is p_ioHandler a CubeMappedTileHandler
+      BigInt p_cacheSize;
+
+      //! Serializes access to the i/o handler (see Prefetch)
+      QMutex *p_ioMutex;
+
       void WriteLabels ();
+      void CreateIoHandler ();
       void ReformatOldIsisLabel (const std::string &oldCube);
       void OpenCheck();
 
@@ -391,27 +391,8 @@ namespace Isis {
     if ((p_native) || (nbytes == 1) || (!p_native && (src == p_nullCache.buf))) {
       memmove(&dest[dindex*nbytes],&src[sindex*nbytes],nelements*nbytes);
     }
-    else if (nbytes == 2) {
-      int d = dindex*nbytes;
-      int s = sindex*nbytes;
-      for (int i=0; i<nelements; i++) {
-        dest[d] = src[s+1];
-        dest[d+1] = src[s];
-        d+=2;
-        s+=2;
-      }
-    }
     else {
-      int d = dindex*nbytes;
-      int s = sindex*nbytes;
-      for (int i=0; i<nelements; i++) {
-        dest[d] = src[s+3];
-        dest[d+1] = src[s+2];
-        dest[d+2] = src[s+1];
-        dest[d+3] = src[s];
-        d+=4;
-        s+=4;
-      }
+      SwapBytes(&dest[dindex*nbytes],&src[sindex*nbytes],nelements,nbytes);
     }
   }
 
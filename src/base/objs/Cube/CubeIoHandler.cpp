@@ -29,16 +29,25 @@
 #include "SpecialPixel.h"
 #include "Endian.h"
 
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 namespace Isis {
   CubeIoHandler::CubeIoHandler(IsisCubeDef &cube) {
     p_cube = &cube;
+    p_cacheHits = 0;
+    p_cacheMisses = 0;
     if (p_cube->byteOrder == Isis::Msb) {
       p_native = Isis::IsBigEndian();
     }
     else {
       p_native = Isis::IsLittleEndian();
     }
+    MakeByteTable();
   }
   
   CubeIoHandler::~CubeIoHandler() {
@@ -93,54 +102,231 @@ namespace Isis {
     }
   }
   
+  // Scalar conversions of a single pixel. The vector loops below fall back
+  // to these whenever a group of pixels contains special or out of range
+  // values, so both must give identical results.
+
+  static inline double ShortToDouble(short s, double multiplier,
+                                     double base) {
+    if (s < Isis::VALID_MIN2) {
+      if (s == Isis::NULL2) return Isis::NULL8;
+      else if (s == Isis::LOW_INSTR_SAT2) return Isis::LOW_INSTR_SAT8;
+      else if (s == Isis::LOW_REPR_SAT2) return Isis::LOW_REPR_SAT8;
+      else if (s == Isis::HIGH_INSTR_SAT2) return Isis::HIGH_INSTR_SAT8;
+      else if (s == Isis::HIGH_REPR_SAT2) return Isis::HIGH_REPR_SAT8;
+      else return Isis::LOW_REPR_SAT8;
+    }
+    return (double) s * multiplier + base;
+  }
+
+  static inline double FloatToDouble(float f) {
+    if (f < Isis::VALID_MIN4) {
+      if (f == Isis::NULL4) return Isis::NULL8;
+      else if (f == Isis::LOW_INSTR_SAT4) return Isis::LOW_INSTR_SAT8;
+      else if (f == Isis::LOW_REPR_SAT4) return Isis::LOW_REPR_SAT8;
+      else if (f == Isis::HIGH_INSTR_SAT4) return Isis::HIGH_INSTR_SAT8;
+      else if (f == Isis::HIGH_REPR_SAT4) return Isis::HIGH_REPR_SAT8;
+      else return Isis::LOW_REPR_SAT8;
+    }
+    return (double) f;
+  }
+
+  static inline unsigned char DoubleToByte(double d, double multiplier,
+                                           double base) {
+    if (d < Isis::VALID_MIN8) {
+      if      (d == Isis::NULL8)           return Isis::NULL1;
+      else if (d == Isis::LOW_INSTR_SAT8)  return Isis::LOW_INSTR_SAT1;
+      else if (d == Isis::LOW_REPR_SAT8)   return Isis::LOW_REPR_SAT1;
+      else if (d == Isis::HIGH_INSTR_SAT8) return Isis::HIGH_INSTR_SAT1;
+      else if (d == Isis::HIGH_REPR_SAT8)  return Isis::HIGH_REPR_SAT1;
+      else                                 return Isis::LOW_REPR_SAT1;
+    }
+
+    double temp = (d - base) / multiplier;
+    if (temp < Isis::VALID_MIN1 - 0.5) return Isis::LOW_REPR_SAT1;
+    if (temp > Isis::VALID_MAX1 + 0.5) return Isis::HIGH_REPR_SAT1;
+
+    int itemp = (int) (temp + 0.5);
+    if (itemp < Isis::VALID_MIN1) return Isis::LOW_REPR_SAT1;
+    if (itemp > Isis::VALID_MAX1) return Isis::HIGH_REPR_SAT1;
+    return (unsigned char) (temp + 0.5);
+  }
+
+  static inline short DoubleToShort(double d, double multiplier,
+                                    double base) {
+    if (d < Isis::VALID_MIN8) {
+      if      (d == Isis::NULL8)           return Isis::NULL2;
+      else if (d == Isis::LOW_INSTR_SAT8)  return Isis::LOW_INSTR_SAT2;
+      else if (d == Isis::LOW_REPR_SAT8)   return Isis::LOW_REPR_SAT2;
+      else if (d == Isis::HIGH_INSTR_SAT8) return Isis::HIGH_INSTR_SAT2;
+      else if (d == Isis::HIGH_REPR_SAT8)  return Isis::HIGH_REPR_SAT2;
+      else                                 return Isis::LOW_REPR_SAT2;
+    }
+
+    double temp = (d - base) / multiplier;
+    if (temp > Isis::VALID_MAX2 + 0.5) return Isis::HIGH_REPR_SAT2;
+
+    int itemp;
+    if (temp < 0.0) {
+      itemp = (int) (temp - 0.5);
+    }
+    else {
+      itemp = (int) (temp + 0.5);
+    }
+
+    if (itemp < Isis::VALID_MIN2) return Isis::LOW_REPR_SAT2;
+    if (itemp > Isis::VALID_MAX2) return Isis::HIGH_REPR_SAT2;
+    if (temp < 0.0) return (short) (temp - 0.5);
+    return (short) (temp + 0.5);
+  }
+
+  static inline float DoubleToFloat(double d, double multiplier,
+                                    double base) {
+    if (d < Isis::VALID_MIN8) {
+      if      (d == Isis::NULL8)           return Isis::NULL4;
+      else if (d == Isis::LOW_INSTR_SAT8)  return Isis::LOW_INSTR_SAT4;
+      else if (d == Isis::LOW_REPR_SAT8)   return Isis::LOW_REPR_SAT4;
+      else if (d == Isis::HIGH_INSTR_SAT8) return Isis::HIGH_INSTR_SAT4;
+      else if (d == Isis::HIGH_REPR_SAT8)  return Isis::HIGH_REPR_SAT4;
+      else                                 return Isis::LOW_REPR_SAT4;
+    }
+
+    double temp = (d - base) / multiplier;
+    if (temp < (double) Isis::VALID_MIN4) return Isis::LOW_REPR_SAT4;
+    if (temp > (double) Isis::VALID_MAX4) return Isis::HIGH_REPR_SAT4;
+    return (float) temp;
+  }
+
+#if defined(__SSE2__)
+  /**
+   * Scales four valid pixels to the integer pixel range and rounds them the
+   * same way DoubleToByte and DoubleToShort do.
+   *
+   * @param d The four pixels
+   * @param base Base of the cube
+   * @param multiplier Multiplier of the cube
+   * @param signedRound Round negative values away from zero
+   * @param min Minimum valid integer pixel
+   * @param max Maximum valid integer pixel
+   * @param out The rounded pixels as 32 bit integers
+   *
+   * @return bool False if any pixel is special or out of range
+   */
+  static inline bool ScaleFour(const double *d, __m128d base,
+                               __m128d multiplier, bool signedRound,
+                               __m128i min, __m128i max, __m128i &out) {
+    const __m128d validMin = _mm_set1_pd(Isis::VALID_MIN8);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d zero = _mm_setzero_pd();
+
+    __m128d d0 = _mm_loadu_pd(&d[0]);
+    __m128d d1 = _mm_loadu_pd(&d[2]);
+    __m128d special = _mm_or_pd(_mm_cmplt_pd(d0,validMin),
+                                _mm_cmplt_pd(d1,validMin));
+    if (_mm_movemask_pd(special) != 0) return false;
+
+    __m128d t0 = _mm_div_pd(_mm_sub_pd(d0,base),multiplier);
+    __m128d t1 = _mm_div_pd(_mm_sub_pd(d1,base),multiplier);
+    __m128d h0 = half;
+    __m128d h1 = half;
+    if (signedRound) {
+      // -0.5 for negative values, keeping 0.5 for zero and NaN
+      __m128d sign = _mm_set1_pd(-0.0);
+      h0 = _mm_or_pd(half,_mm_and_pd(_mm_cmplt_pd(t0,zero),sign));
+      h1 = _mm_or_pd(half,_mm_and_pd(_mm_cmplt_pd(t1,zero),sign));
+    }
+
+    out = _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_add_pd(t0,h0)),
+                             _mm_cvttpd_epi32(_mm_add_pd(t1,h1)));
+    __m128i range = _mm_or_si128(_mm_cmplt_epi32(out,min),
+                                 _mm_cmpgt_epi32(out,max));
+    return (_mm_movemask_epi8(range) == 0);
+  }
+#endif
+
   void CubeIoHandler::ToDouble(Isis::Buffer &rbuf) {
+    double *dbuf = rbuf.DoubleBuffer();
+    int n = rbuf.size();
+    double multiplier = p_cube->multiplier;
+    double base = p_cube->base;
+    int i = 0;
+
     if (rbuf.PixelType() == Isis::UnsignedByte) {
-      double *dbuf = rbuf.DoubleBuffer();
+      // There are only 256 possible values so look them up. The table is
+      // never changed after construction so several threads may convert
+      // at once
       unsigned char *cbuf = (unsigned char *) rbuf.RawBuffer();
-      for (int i=0; i<rbuf.size(); i++) {
-        if (cbuf[i] == Isis::NULL1) {
-          dbuf[i] = Isis::NULL8;
-        }
-        else if (cbuf[i] == Isis::HIGH_REPR_SAT1) {
-          dbuf[i] = Isis::HIGH_REPR_SAT8;
+      if ((p_byteTableBase == base) && (p_byteTableMultiplier == multiplier)) {
+        for (i=0; i<n; i++) {
+          dbuf[i] = p_byteTable[cbuf[i]];
         }
-        else {
-          dbuf[i] = (double) cbuf[i] * p_cube->multiplier + p_cube->base;
+      }
+      else {
+        for (i=0; i<n; i++) {
+          if (cbuf[i] == Isis::NULL1) {
+            dbuf[i] = Isis::NULL8;
+          }
+          else if (cbuf[i] == Isis::HIGH_REPR_SAT1) {
+            dbuf[i] = Isis::HIGH_REPR_SAT8;
+          }
+          else {
+            dbuf[i] = (double) cbuf[i] * multiplier + base;
+          }
         }
       }
     }
     else if (rbuf.PixelType() == Isis::SignedWord) {
-      double *dbuf = rbuf.DoubleBuffer();
       short int *sbuf = (short *) rbuf.RawBuffer();
-      for (int i=0; i<rbuf.size(); i++) {
-        if (sbuf[i] < Isis::VALID_MIN2) {
-          if (sbuf[i] == Isis::NULL2) dbuf[i] = Isis::NULL8;
-          else if (sbuf[i] == Isis::LOW_INSTR_SAT2) dbuf[i] = Isis::LOW_INSTR_SAT8;
-          else if (sbuf[i] == Isis::LOW_REPR_SAT2) dbuf[i] = Isis::LOW_REPR_SAT8;
-          else if (sbuf[i] == Isis::HIGH_INSTR_SAT2) dbuf[i] = Isis::HIGH_INSTR_SAT8;
-          else if (sbuf[i] == Isis::HIGH_REPR_SAT2) dbuf[i] = Isis::HIGH_REPR_SAT8;
-          else dbuf[i] = Isis::LOW_REPR_SAT8;
+#if defined(__SSE2__)
+      const __m128i validMin = _mm_set1_epi16(Isis::VALID_MIN2);
+      const __m128d vmult = _mm_set1_pd(multiplier);
+      const __m128d vbase = _mm_set1_pd(base);
+      for (; i+8<=n; i+=8) {
+        __m128i s = _mm_loadu_si128((const __m128i *) &sbuf[i]);
+        if (_mm_movemask_epi8(_mm_cmplt_epi16(s,validMin)) != 0) {
+          for (int j=i; j<i+8; j++) {
+            dbuf[j] = ShortToDouble(sbuf[j],multiplier,base);
+          }
+          continue;
         }
-        else {
-          dbuf[i] = (double) sbuf[i] * p_cube->multiplier + p_cube->base;
+
+        // Sign extend to 32 bits then convert two at a time
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s,s),16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s,s),16);
+        __m128i ints[2] = {lo, hi};
+        for (int k=0; k<2; k++) {
+          __m128d d0 = _mm_cvtepi32_pd(ints[k]);
+          __m128d d1 = _mm_cvtepi32_pd(_mm_shuffle_epi32(ints[k],
+                                                         _MM_SHUFFLE(1,0,3,2)));
+          _mm_storeu_pd(&dbuf[i+4*k],
+                        _mm_add_pd(_mm_mul_pd(d0,vmult),vbase));
+          _mm_storeu_pd(&dbuf[i+4*k+2],
+                        _mm_add_pd(_mm_mul_pd(d1,vmult),vbase));
         }
       }
+#endif
+      for (; i<n; i++) {
+        dbuf[i] = ShortToDouble(sbuf[i],multiplier,base);
+      }
     }
     else {
-      double *dbuf = rbuf.DoubleBuffer();
       float *fbuf = (float *) rbuf.RawBuffer();
-      for (int i=0; i<rbuf.size(); i++) {
-        if (fbuf[i] < Isis::VALID_MIN4) {
-          if (fbuf[i] == Isis::NULL4) dbuf[i] = Isis::NULL8;
-          else if (fbuf[i] == Isis::LOW_INSTR_SAT4) dbuf[i] = Isis::LOW_INSTR_SAT8;
-          else if (fbuf[i] == Isis::LOW_REPR_SAT4) dbuf[i] = Isis::LOW_REPR_SAT8;
-          else if (fbuf[i] == Isis::HIGH_INSTR_SAT4) dbuf[i] = Isis::HIGH_INSTR_SAT8;
-          else if (fbuf[i] == Isis::HIGH_REPR_SAT4) dbuf[i] = Isis::HIGH_REPR_SAT8;
-          else dbuf[i] = Isis::LOW_REPR_SAT8;
-        }
-        else {
-          dbuf[i] = (double) fbuf[i];
+#if defined(__SSE2__)
+      const __m128 validMin = _mm_set1_ps(Isis::VALID_MIN4);
+      for (; i+4<=n; i+=4) {
+        __m128 f = _mm_loadu_ps(&fbuf[i]);
+        if (_mm_movemask_ps(_mm_cmplt_ps(f,validMin)) != 0) {
+          for (int j=i; j<i+4; j++) {
+            dbuf[j] = FloatToDouble(fbuf[j]);
+          }
+          continue;
         }
+        _mm_storeu_pd(&dbuf[i],_mm_cvtps_pd(f));
+        _mm_storeu_pd(&dbuf[i+2],_mm_cvtps_pd(_mm_movehl_ps(f,f)));
+      }
+#endif
+      for (; i<n; i++) {
+        dbuf[i] = FloatToDouble(fbuf[i]);
       }
     }
   }
@@ -148,113 +334,151 @@ namespace Isis {
   
   
   void CubeIoHandler::ToRaw(Isis::Buffer &rbuf) {
+    double *dbuf = rbuf.DoubleBuffer();
+    int n = rbuf.size();
+    double multiplier = p_cube->multiplier;
+    double base = p_cube->base;
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128d vmult = _mm_set1_pd(multiplier);
+    const __m128d vbase = _mm_set1_pd(base);
+#endif
+
     if (rbuf.PixelType() == Isis::UnsignedByte) {
-      double *dbuf = rbuf.DoubleBuffer();
       unsigned char *cbuf = (unsigned char *) rbuf.RawBuffer();
-      double temp;
-      for (int i=0; i<rbuf.size(); i++) {
-        if (dbuf[i] < Isis::VALID_MIN8) {
-          if      (dbuf[i] == Isis::NULL8)           cbuf[i] = Isis::NULL1;
-          else if (dbuf[i] == Isis::LOW_INSTR_SAT8)  cbuf[i] = Isis::LOW_INSTR_SAT1;
-          else if (dbuf[i] == Isis::LOW_REPR_SAT8)   cbuf[i] = Isis::LOW_REPR_SAT1;
-          else if (dbuf[i] == Isis::HIGH_INSTR_SAT8) cbuf[i] = Isis::HIGH_INSTR_SAT1;
-          else if (dbuf[i] == Isis::HIGH_REPR_SAT8)  cbuf[i] = Isis::HIGH_REPR_SAT1;
-          else                                       cbuf[i] = Isis::LOW_REPR_SAT1;
-        }
-        else {
-          temp = (dbuf[i] - p_cube->base) / p_cube->multiplier;
-          if (temp < Isis::VALID_MIN1 - 0.5) {
-            cbuf[i] = Isis::LOW_REPR_SAT1;
-          }
-          else if (temp > Isis::VALID_MAX1 + 0.5) {
-            cbuf[i] = Isis::HIGH_REPR_SAT1;
-          }
-          else {
-            int itemp = (int) (temp + 0.5);
-            if (itemp < Isis::VALID_MIN1) {
-              cbuf[i] = Isis::LOW_REPR_SAT1;
-            }
-            else if (itemp > Isis::VALID_MAX1) {
-              cbuf[i] = Isis::HIGH_REPR_SAT1;
-            }
-            else {
-              cbuf[i] = (unsigned char) (temp + 0.5);
-            }
+#if defined(__SSE2__)
+      const __m128i validMin = _mm_set1_epi32(Isis::VALID_MIN1);
+      const __m128i validMax = _mm_set1_epi32(Isis::VALID_MAX1);
+      for (; i+4<=n; i+=4) {
+        __m128i ints;
+        if (!ScaleFour(&dbuf[i],vbase,vmult,false,validMin,validMax,ints)) {
+          for (int j=i; j<i+4; j++) {
+            cbuf[j] = DoubleToByte(dbuf[j],multiplier,base);
           }
+          continue;
         }
+        __m128i words = _mm_packs_epi32(ints,ints);
+        int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words,words));
+        memcpy(&cbuf[i],&bytes,4);
+      }
+#endif
+      for (; i<n; i++) {
+        cbuf[i] = DoubleToByte(dbuf[i],multiplier,base);
       }
     }
     else if (rbuf.PixelType() == Isis::SignedWord) {
-      double *dbuf = rbuf.DoubleBuffer();
       short *sbuf = (short *) rbuf.RawBuffer();
-      double temp;
-      for (int i=0; i<rbuf.size(); i++) {
-        if (dbuf[i] < Isis::VALID_MIN8) {
-          if      (dbuf[i] == Isis::NULL8)           sbuf[i] = Isis::NULL2;
-          else if (dbuf[i] == Isis::LOW_INSTR_SAT8)  sbuf[i] = Isis::LOW_INSTR_SAT2;
-          else if (dbuf[i] == Isis::LOW_REPR_SAT8)   sbuf[i] = Isis::LOW_REPR_SAT2;
-          else if (dbuf[i] == Isis::HIGH_INSTR_SAT8) sbuf[i] = Isis::HIGH_INSTR_SAT2;
-          else if (dbuf[i] == Isis::HIGH_REPR_SAT8)  sbuf[i] = Isis::HIGH_REPR_SAT2;
-          else                                       sbuf[i] = Isis::LOW_REPR_SAT2;
-        }
-        else {
-          temp = (dbuf[i] - p_cube->base) / p_cube->multiplier;
-          if (temp < Isis::VALID_MIN2 - 0.5) {
-            sbuf[i] = Isis::LOW_REPR_SAT2;
-          }
-          if (temp > Isis::VALID_MAX2 + 0.5) {
-            sbuf[i] = Isis::HIGH_REPR_SAT2;
-          }
-          else {
-            int itemp;
-            if (temp < 0.0) {
-              itemp = (int) (temp - 0.5);
-            }
-            else {
-              itemp = (int) (temp + 0.5);
-            }
-  
-            if (itemp < Isis::VALID_MIN2) {
-              sbuf[i] = Isis::LOW_REPR_SAT2;
-            }
-            else if (itemp > Isis::VALID_MAX2) {
-              sbuf[i] = Isis::HIGH_REPR_SAT2;
-            }
-            else if (temp < 0.0) {
-              sbuf[i] = (short) (temp - 0.5);
-            }
-            else {
-              sbuf[i] = (short) (temp + 0.5);
-            }
+#if defined(__SSE2__)
+      const __m128i validMin = _mm_set1_epi32(Isis::VALID_MIN2);
+      const __m128i validMax = _mm_set1_epi32(Isis::VALID_MAX2);
+      for (; i+4<=n; i+=4) {
+        __m128i ints;
+        if (!ScaleFour(&dbuf[i],vbase,vmult,true,validMin,validMax,ints)) {
+          for (int j=i; j<i+4; j++) {
+            sbuf[j] = DoubleToShort(dbuf[j],multiplier,base);
           }
+          continue;
         }
+        _mm_storel_epi64((__m128i *) &sbuf[i],_mm_packs_epi32(ints,ints));
+      }
+#endif
+      for (; i<n; i++) {
+        sbuf[i] = DoubleToShort(dbuf[i],multiplier,base);
       }
     }
     else {
-      double *dbuf = rbuf.DoubleBuffer();
       float *fbuf = (float *) rbuf.RawBuffer();
-      double temp;
-      for (int i=0; i<rbuf.size(); i++) {
-        if (dbuf[i] < Isis::VALID_MIN8) {
-          if      (dbuf[i] == Isis::NULL8)           fbuf[i] = Isis::NULL4;
-          else if (dbuf[i] == Isis::LOW_INSTR_SAT8)  fbuf[i] = Isis::LOW_INSTR_SAT4;
-          else if (dbuf[i] == Isis::LOW_REPR_SAT8)   fbuf[i] = Isis::LOW_REPR_SAT4;
-          else if (dbuf[i] == Isis::HIGH_INSTR_SAT8) fbuf[i] = Isis::HIGH_INSTR_SAT4;
-          else if (dbuf[i] == Isis::HIGH_REPR_SAT8)  fbuf[i] = Isis::HIGH_REPR_SAT4;
-          else                                       fbuf[i] = Isis::LOW_REPR_SAT4;
-        }
-        else {
-          temp = (dbuf[i] - p_cube->base) / p_cube->multiplier;
-          if (temp < (double) Isis::VALID_MIN4) {
-            fbuf[i] = Isis::LOW_REPR_SAT4;
-          }
-          else if (temp > (double) Isis::VALID_MAX4) {
-            fbuf[i] = Isis::HIGH_REPR_SAT4;
-          }
-          else {
-            fbuf[i] = (float) temp;
+#if defined(__SSE2__)
+      const __m128d validMin = _mm_set1_pd(Isis::VALID_MIN8);
+      const __m128d floatMin = _mm_set1_pd((double) Isis::VALID_MIN4);
+      const __m128d floatMax = _mm_set1_pd((double) Isis::VALID_MAX4);
+      for (; i+4<=n; i+=4) {
+        __m128d d0 = _mm_loadu_pd(&dbuf[i]);
+        __m128d d1 = _mm_loadu_pd(&dbuf[i+2]);
+        __m128d t0 = _mm_div_pd(_mm_sub_pd(d0,vbase),vmult);
+        __m128d t1 = _mm_div_pd(_mm_sub_pd(d1,vbase),vmult);
+        __m128d bad = _mm_or_pd(_mm_cmplt_pd(d0,validMin),
+                                _mm_cmplt_pd(d1,validMin));
+        bad = _mm_or_pd(bad,_mm_or_pd(_mm_cmplt_pd(t0,floatMin),
+                                      _mm_cmpgt_pd(t0,floatMax)));
+        bad = _mm_or_pd(bad,_mm_or_pd(_mm_cmplt_pd(t1,floatMin),
+                                      _mm_cmpgt_pd(t1,floatMax)));
+        if (_mm_movemask_pd(bad) != 0) {
+          for (int j=i; j<i+4; j++) {
+            fbuf[j] = DoubleToFloat(dbuf[j],multiplier,base);
           }
+          continue;
         }
+        _mm_storeu_ps(&fbuf[i],_mm_movelh_ps(_mm_cvtpd_ps(t0),
+                                             _mm_cvtpd_ps(t1)));
+      }
+#endif
+      for (; i<n; i++) {
+        fbuf[i] = DoubleToFloat(dbuf[i],multiplier,base);
+      }
+    }
+  }
+
+  //! Fills the lookup table used to convert 8-bit pixels to doubles
+  void CubeIoHandler::MakeByteTable() {
+    double multiplier = p_cube->multiplier;
+    double base = p_cube->base;
+    for (int i=0; i<256; i++) {
+      if (i == Isis::NULL1) {
+        p_byteTable[i] = Isis::NULL8;
+      }
+      else if (i == Isis::HIGH_REPR_SAT1) {
+        p_byteTable[i] = Isis::HIGH_REPR_SAT8;
+      }
+      else {
+        p_byteTable[i] = (double) i * multiplier + base;
+      }
+    }
+    p_byteTableBase = base;
+    p_byteTableMultiplier = multiplier;
+  }
+
+  /**
+   * Copies pixels while reversing the byte order of each one. The buffers
+   * must not overlap.
+   *
+   * @param dest Buffer to copy to
+   * @param src Buffer to copy from
+   * @param nelements Number of pixels to copy
+   * @param nbytes Size of a pixel, 2 or 4 bytes
+   */
+  void CubeIoHandler::SwapBytes(char *dest, const char *src,
+                                int nelements, int nbytes) {
+    int i = 0;
+    if (nbytes == 2) {
+#if defined(__SSE2__)
+      for (; i+8<=nelements; i+=8) {
+        __m128i v = _mm_loadu_si128((const __m128i *) &src[i*2]);
+        v = _mm_or_si128(_mm_slli_epi16(v,8),_mm_srli_epi16(v,8));
+        _mm_storeu_si128((__m128i *) &dest[i*2],v);
+      }
+#endif
+      for (; i<nelements; i++) {
+        dest[i*2] = src[i*2+1];
+        dest[i*2+1] = src[i*2];
+      }
+    }
+    else {
+#if defined(__SSE2__)
+      for (; i+4<=nelements; i+=4) {
+        // Swap the 16 bit halves of each pixel, then the bytes of each half
+        __m128i v = _mm_loadu_si128((const __m128i *) &src[i*4]);
+        v = _mm_shufflelo_epi16(v,_MM_SHUFFLE(2,3,0,1));
+        v = _mm_shufflehi_epi16(v,_MM_SHUFFLE(2,3,0,1));
+        v = _mm_or_si128(_mm_slli_epi16(v,8),_mm_srli_epi16(v,8));
+        _mm_storeu_si128((__m128i *) &dest[i*4],v);
+      }
+#endif
+      for (; i<nelements; i++) {
+        dest[i*4] = src[i*4+3];
+        dest[i*4+1] = src[i*4+2];
+        dest[i*4+2] = src[i*4+1];
+        dest[i*4+3] = src[i*4];
       }
     }
   }
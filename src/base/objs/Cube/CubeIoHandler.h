@@ -53,22 +53,68 @@ namespace Isis {
  * @internal
  *  @history 2006-06-12 Tracie Sucharski - Clear stream bits before opening
  *                             cube.
+ *  @history 2026-10-17 Unknown - Made Open virtual so handlers can set up
+ *                             additional resources such as memory maps.
+ *  @history 2026-10-17 Unknown - Added SetCacheSize and cache hit/miss counts.
+ *  @history 2026-10-17 Unknown - ToDouble and ToRaw convert groups of pixels
+ *                             with SSE2 when available, falling back to the
+ *                             scalar code for groups with special pixels. 8-bit
+ *                             pixels are converted with a lookup table. Added
+ *                             SwapBytes for the handlers.
+ *  @history 2026-10-17 Unknown - ToDouble and ToRaw no longer change the
+ *                             handler so they may run in several threads at
+ *                             once.
  */
   class CubeIoHandler {
     public:
       CubeIoHandler(IsisCubeDef &cube);
       virtual ~CubeIoHandler();
-      void Open();
+      virtual void Open();
       virtual void Create(bool overwrite);
       virtual void Close(const bool remove=false) = 0;
       virtual void Read(Isis::Buffer &rbuf) = 0;
       virtual void Write(Isis::Buffer &wbuf) = 0;
       void ToDouble(Isis::Buffer &buf);
       void ToRaw(Isis::Buffer &buf);
+
+      /**
+       * Sets the maximum number of bytes of cube data the handler may keep
+       * in memory. Handlers without a cache ignore this.
+       *
+       * @param bytes Memory budget in bytes
+       */
+      virtual void SetCacheSize(Isis::BigInt bytes) {};
+
+      /**
+       * Returns the number of reads and writes satisfied from the cache.
+       *
+       * @return Isis::BigInt Number of cache hits
+       */
+      Isis::BigInt CacheHits() const { return p_cacheHits; };
+
+      /**
+       * Returns the number of reads and writes which had to load data into
+       * the cache.
+       *
+       * @return Isis::BigInt Number of cache misses
+       */
+      Isis::BigInt CacheMisses() const { return p_cacheMisses; };
   
     protected:
       IsisCubeDef *p_cube;
       bool p_native;
+      Isis::BigInt p_cacheHits;
+      Isis::BigInt p_cacheMisses;
+
+      static void SwapBytes(char *dest, const char *src,
+                            int nelements, int nbytes);
+
+    private:
+      double p_byteTable[256];        //!< 8-bit pixel values as doubles
+      double p_byteTableBase;         //!< Base used for p_byteTable
+      double p_byteTableMultiplier;   //!< Multiplier used for p_byteTable
+
+      void MakeByteTable();
   };
 };
 
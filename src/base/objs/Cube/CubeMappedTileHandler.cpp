@@ -0,0 +1,386 @@
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "CubeMappedTileHandler.h"
+#include "iException.h"
+#include "SpecialPixel.h"
+
+using namespace std;
+namespace Isis {
+  CubeMappedTileHandler::CubeMappedTileHandler(IsisCubeDef &cube) :
+                       Isis::CubeIoHandler(cube) {
+
+    Isis::PvlObject &core = p_cube->label.FindObject("IsisCube").FindObject("Core");
+
+    if (core.HasKeyword("Format")) {
+      p_tileSamples = core["TileSamples"];
+      p_tileLines = core["TileLines"];
+    }
+    else {
+      core += Isis::PvlKeyword("Format","Tile");
+      p_tileSamples = 128;
+      p_tileLines = 128;
+      core += Isis::PvlKeyword("TileSamples",p_tileSamples);
+      core += Isis::PvlKeyword("TileLines",p_tileLines);
+    }
+
+    p_bytesPerTile = p_tileLines * p_tileSamples * Isis::SizeOf(p_cube->pixelType);
+    p_sampleTiles = (p_cube->samples - 1) / p_tileSamples + 1;
+    p_lineTiles = (p_cube->lines - 1) / p_tileLines + 1;
+
+    p_cube->dataBytes = (streampos) p_sampleTiles *
+                        (streampos) p_lineTiles *
+                        (streampos) p_cube->bands *
+                        (streampos) p_bytesPerTile;
+
+    p_fd = -1;
+    p_map = NULL;
+    p_mapBytes = 0;
+    p_data = NULL;
+    p_nullTile = NULL;
+    p_fillTile = NULL;
+    p_tileAllocated.clear();
+  }
+
+  CubeMappedTileHandler::~CubeMappedTileHandler() {
+    Close();
+    Unmap();
+  }
+
+  void CubeMappedTileHandler::Open() {
+    Isis::CubeIoHandler::Open();
+    MakeNullTile();
+    Map();
+  }
+
+  void CubeMappedTileHandler::Create(bool overwrite) {
+    Isis::CubeIoHandler::Create(overwrite);
+
+    // Make sure the label area is on disk before the data region is mapped
+    p_cube->stream.flush();
+
+    p_tileAllocated.resize(p_sampleTiles*p_lineTiles*p_cube->bands);
+    unsigned int ntiles = p_tileAllocated.size();
+    for (unsigned int i=0; i<ntiles; i++) {
+      p_tileAllocated[i] = false;
+    }
+
+    MakeNullTile();
+    Map();
+  }
+
+  void CubeMappedTileHandler::Close(const bool removeFile) {
+    // Don't do much if the file wasn't opened
+    if (!p_cube->stream.is_open()) return;
+
+    // Fill any tiles which were never touched with NULLs
+    if (!removeFile && (p_data != NULL)) {
+      unsigned int ntiles = p_tileAllocated.size();
+      for (unsigned int i=0; i<ntiles; i++) {
+        if (!p_tileAllocated[i]) {
+          memcpy(p_data + (Isis::BigInt) i * p_bytesPerTile,
+                 p_fillTile,p_bytesPerTile);
+        }
+      }
+    }
+    p_tileAllocated.clear();
+
+    Unmap();
+    if (p_fillTile != p_nullTile) delete [] p_fillTile;
+    delete [] p_nullTile;
+    p_nullTile = NULL;
+    p_fillTile = NULL;
+
+    // Close the stream and possible remove
+    p_cube->stream.close();
+    if (removeFile) remove (p_cube->dataFile.c_str());
+  }
+
+  void CubeMappedTileHandler::Read(Isis::Buffer &rbuf) {
+    // Starting corner in the Isis::Buffer
+    int ssamp = rbuf.Sample();
+    int sline = rbuf.Line();
+    int sband = rbuf.Band();
+
+    // Ending corner in the Isis::Buffer
+    int esamp = rbuf.Sample(rbuf.size()-1);
+    int eline = rbuf.Line(rbuf.size()-1);
+    int eband = rbuf.Band(rbuf.size()-1);
+
+    int sample = ssamp;
+    int line = sline;
+    int band = sband;
+
+    char *rawbuf = (char *) rbuf.RawBuffer();
+    int tileSamp,tileLine;
+    int ss,es,sl,el;
+
+    while (band <= eband) {
+      char *tile = FindTile(sample,line,p_cube->virtualBandList[band-1],
+                            tileSamp,tileLine);
+
+      ss = (sample > tileSamp) ? sample : tileSamp;
+      es = (esamp < tileSamp + p_tileSamples - 1) ?
+           esamp : tileSamp + p_tileSamples - 1;
+      sl = (line > tileLine) ? line : tileLine;
+      el = (eline < tileLine + p_tileLines - 1) ?
+           eline : tileLine + p_tileLines - 1;
+
+      int tileIndex = (sl - tileLine) * p_tileSamples + ss - tileSamp;
+      int rawIndex = rbuf.Index(ss,sl,band);
+      int rawAdd = rbuf.SampleDimension();
+      int ns = es - ss + 1;
+
+      for (int l = sl; l<=el; l++) {
+        Move(rawbuf,rawIndex,tile,tileIndex,ns);
+        tileIndex += p_tileSamples;
+        rawIndex += rawAdd;
+      }
+
+      sample = tileSamp + p_tileSamples;
+      if (sample > esamp) {
+        sample = ssamp;
+        line = tileLine + p_tileLines;
+        if (line > eline) {
+          line = sline;
+          band++;
+        }
+      }
+    }
+  }
+
+  void CubeMappedTileHandler::Write(Isis::Buffer &wbuf) {
+    // We don't care about pixels outside the cube
+    int ssamp = (wbuf.Sample() < 1) ? 1 : wbuf.Sample();
+    int sline = (wbuf.Line() < 1) ? 1 : wbuf.Line();
+    int sband = (wbuf.Band() < 1) ? 1 : wbuf.Band();
+
+    int esamp = (wbuf.Sample(wbuf.size()-1) > p_cube->samples) ? p_cube->samples : wbuf.Sample(wbuf.size()-1);
+    int eline = (wbuf.Line(wbuf.size()-1) > p_cube->lines) ? p_cube->lines : wbuf.Line(wbuf.size()-1);
+    int eband = (wbuf.Band(wbuf.size()-1) > p_cube->bands) ? p_cube->bands : wbuf.Band(wbuf.size()-1);
+
+    int sample = ssamp;
+    int line = sline;
+    int band = sband;
+
+    char *rawbuf = (char *) wbuf.RawBuffer();
+    int tileSamp,tileLine;
+    int ss,es,sl,el;
+
+    while (band <= eband) {
+      char *tile = FindTile(sample,line,band,tileSamp,tileLine);
+
+      ss = (sample > tileSamp) ? sample : tileSamp;
+      es = (esamp < tileSamp + p_tileSamples - 1) ?
+           esamp : tileSamp + p_tileSamples - 1;
+      sl = (line > tileLine) ? line : tileLine;
+      el = (eline < tileLine + p_tileLines - 1) ?
+           eline : tileLine + p_tileLines - 1;
+
+      int tileIndex = (sl - tileLine) * p_tileSamples + ss - tileSamp;
+      int rawIndex = wbuf.Index(ss,sl,band);
+      int rawAdd = wbuf.SampleDimension();
+      int ns = es - ss + 1;
+
+      for (int l = sl; l<=el; l++) {
+        Move(tile,tileIndex,rawbuf,rawIndex,ns);
+        tileIndex += p_tileSamples;
+        rawIndex += rawAdd;
+      }
+
+      sample = tileSamp + p_tileSamples;
+      if (sample > esamp) {
+        sample = ssamp;
+        line = tileLine + p_tileLines;
+        if (line > eline) {
+          line = sline;
+          band++;
+        }
+      }
+    }
+  }
+
+  /**
+   * Maps the cube data region of the data file into memory. The file is
+   * grown to its full size first if it is being created. The start of the
+   * map must be page aligned so the label bytes in front of the cube data
+   * may be mapped as well.
+   */
+  void CubeMappedTileHandler::Map() {
+    bool readWrite = (p_cube->access == IsisCubeDef::ReadWrite);
+    p_fd = ::open(p_cube->dataFile.c_str(), readWrite ? O_RDWR : O_RDONLY);
+    if (p_fd < 0) {
+      string msg = "Unable to open cube data file [" + p_cube->dataFile +
+                   "] for memory mapping";
+      throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
+    }
+
+    Isis::BigInt dataStart = p_cube->startByte - 1;
+    Isis::BigInt dataEnd = dataStart + (Isis::BigInt) p_cube->dataBytes;
+
+    struct stat info;
+    if (fstat(p_fd,&info) != 0) {
+      Unmap();
+      string msg = "Unable to determine the size of cube data file [" +
+                   p_cube->dataFile + "]";
+      throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
+    }
+
+    if ((Isis::BigInt) info.st_size < dataEnd) {
+      if (!readWrite || (ftruncate(p_fd,(off_t) dataEnd) != 0)) {
+        Unmap();
+        string msg = "Cube data file [" + p_cube->dataFile + "] is smaller "
+                     "than the cube dimensions require";
+        throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
+      }
+    }
+
+    Isis::BigInt pageSize = sysconf(_SC_PAGESIZE);
+    Isis::BigInt mapStart = dataStart / pageSize * pageSize;
+    p_mapBytes = dataEnd - mapStart;
+
+    int prot = readWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void *map = mmap(NULL,(size_t) p_mapBytes,prot,MAP_SHARED,p_fd,
+                     (off_t) mapStart);
+    if (map == MAP_FAILED) {
+      Unmap();
+      string msg = "Unable to memory map cube data file [" +
+                   p_cube->dataFile + "]";
+      throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
+    }
+
+    p_map = (char *) map;
+    p_data = p_map + (dataStart - mapStart);
+  }
+
+  //! Releases the memory map and its file descriptor
+  void CubeMappedTileHandler::Unmap() {
+    if (p_map != NULL) {
+      munmap(p_map,(size_t) p_mapBytes);
+    }
+    p_map = NULL;
+    p_data = NULL;
+    p_mapBytes = 0;
+
+    if (p_fd >= 0) ::close(p_fd);
+    p_fd = -1;
+  }
+
+  /**
+   * Returns a pointer to the mapped tile containing the given pixel. Pixels
+   * outside of the cube return the NULL tile. The upper left corner of the
+   * tile is returned in startSamp and startLine.
+   */
+  char *CubeMappedTileHandler::FindTile(int sample, int line, int band,
+                                        int &startSamp, int &startLine) {
+    if (sample <= 0) {
+      startSamp = (sample - p_tileSamples) / p_tileSamples * p_tileSamples + 1;
+    }
+    else {
+      startSamp = (sample - 1) / p_tileSamples * p_tileSamples + 1;
+    }
+
+    if (line <= 0) {
+      startLine = (line - p_tileLines) / p_tileLines * p_tileLines + 1;
+    }
+    else {
+      startLine = (line - 1) / p_tileLines * p_tileLines + 1;
+    }
+
+    // See if its outside the image
+    if ((sample < 1) || (line < 1) || (band < 1) ||
+        (sample > p_cube->samples) || (line > p_cube->lines) ||
+        (band > p_cube->bands)) {
+      return p_nullTile;
+    }
+
+    int tile = (band - 1) * p_sampleTiles * p_lineTiles +
+               (startLine - 1) / p_tileLines * p_sampleTiles +
+               (startSamp - 1) / p_tileSamples;
+    char *buf = p_data + (Isis::BigInt) tile * p_bytesPerTile;
+
+    // If this cube is being created the tile may not exist yet
+    if (p_tileAllocated.size() > 0) {
+      if (!p_tileAllocated[tile]) {
+        memcpy(buf,p_fillTile,p_bytesPerTile);
+        p_tileAllocated[tile] = true;
+      }
+    }
+
+    return buf;
+  }
+
+  void CubeMappedTileHandler::Move(char *dest, int dindex,
+                                   char *src, int sindex,
+                                   int nelements) {
+    // Don't change the null tile
+    if (dest == p_nullTile) return;
+
+    int nbytes = Isis::SizeOf(p_cube->pixelType);
+    if ((p_native) || (nbytes == 1) || (!p_native && (src == p_nullTile))) {
+      memmove(&dest[dindex*nbytes],&src[sindex*nbytes],nelements*nbytes);
+    }
+    else {
+      SwapBytes(&dest[dindex*nbytes],&src[sindex*nbytes],nelements,nbytes);
+    }
+  }
+
+  void CubeMappedTileHandler::MakeNullTile() {
+    if (p_nullTile != NULL) return;
+    p_nullTile = new char[p_bytesPerTile];
+
+    for (int i=0; i<p_tileSamples*p_tileLines; i++) {
+      if (p_cube->pixelType == Isis::UnsignedByte) {
+        ((unsigned char *)p_nullTile)[i] = Isis::NULL1;
+      }
+      else if (p_cube->pixelType == Isis::SignedWord) {
+        ((short *)p_nullTile)[i] = Isis::NULL2;
+      }
+      else if (p_cube->pixelType == Isis::Real) {
+        ((float *)p_nullTile)[i] = Isis::NULL4;
+      }
+      else {
+        string msg = "Unsupported pixel type";
+        throw Isis::iException::Message(Isis::iException::Programmer,msg,_FILEINFO_);
+      }
+    }
+
+    // Tiles filled in the map must be in the byte order of the file
+    if (p_native || (Isis::SizeOf(p_cube->pixelType) == 1)) {
+      p_fillTile = p_nullTile;
+    }
+    else {
+      p_fillTile = new char[p_bytesPerTile];
+      char *nullTile = p_nullTile;
+      p_nullTile = NULL;
+      Move(p_fillTile,0,nullTile,0,p_tileSamples*p_tileLines);
+      p_nullTile = nullTile;
+    }
+  }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#ifndef CubeMappedTileHandler_h
+#define CubeMappedTileHandler_h
+
+#include "CubeIoHandler.h"
+
+namespace Isis {
+
+/**
+ * @brief Memory mapped I/O Handler for Isis Cubes using the tile format.
+ *
+ * This class reads and writes tiled Isis cubes through a memory map of the
+ * cube data region instead of seeking and reading each tile through the
+ * file stream. Tiles are accessed in place in the map, so there is no
+ * per-tile system call, no tile cache to allocate and no dirty tiles to
+ * write back. Pixels are only copied once, between the mapped tile and the
+ * raw buffer of the Isis::Buffer (swapping bytes on the way for non-native
+ * cubes).
+ *
+ * Tiles of a newly created cube which have not been touched are filled with
+ * NULL pixels in the map the first time they are referenced or when the
+ * cube is closed.
+ *
+ * The handler is selected by the Cube class when memory mapping is
+ * requested with Cube::SetMemoryMapped or the MemoryMapping keyword in the
+ * CubeCustomization preference group.
+ *
+ * @ingroup LowLevelCubeIO
+ *
+ * @author 2026-10-17 Unknown
+ *
+ * @internal
+ */
+  class CubeMappedTileHandler : public Isis::CubeIoHandler {
+    public:
+      CubeMappedTileHandler(IsisCubeDef &cube);
+      ~CubeMappedTileHandler();
+      void Open();
+      void Close(const bool remove=false);
+      void Read(Isis::Buffer &rbuf);
+      void Write(Isis::Buffer &wbuf);
+      void Create(bool overwrite);
+
+    private:
+      int p_tileSamples;
+      int p_tileLines;
+      std::vector<bool> p_tileAllocated;
+
+      int p_bytesPerTile;
+      int p_sampleTiles;
+      int p_lineTiles;
+
+      int p_fd;               //!< File descriptor used for the map
+      char *p_map;            //!< Start of the mapped (page aligned) region
+      Isis::BigInt p_mapBytes;  //!< Number of bytes mapped
+      char *p_data;           //!< Start of the cube data within the map
+      char *p_nullTile;       //!< A tile filled with NULL pixels
+      char *p_fillTile;       //!< The NULL tile in the byte order of the file
+
+      void Map();
+      void Unmap();
+      char *FindTile(int sample, int line, int band, int &startSamp,
+                     int &startLine);
+      void Move(char *dest, int dindex,
+                char *src, int sindex, int nelements);
+      void MakeNullTile();
+  };
+};
+
+#endif
@@ -22,9 +22,11 @@
  */
 
 #include "CubeTileHandler.h"
+#include "CubeTileWriter.h"
 #include "iException.h"
 #include "SpecialPixel.h"
 #include <cstdio>
+#include <cstring>
 
 using namespace std;
 namespace Isis {
@@ -59,10 +61,15 @@ namespace Isis {
                         (streampos) p_cube->bands *
                         (streampos) p_bytesPerTile;
 
-    p_bufList.clear();
-    p_cacheList.clear();
-    p_lastCache = -1;
+    // The default budget is six tile sets worth of caches. Six was used
+    // to ensure large highpass filters don't thrash
+    p_maxCacheBytes = 6 * (Isis::BigInt) p_maxTiles * p_bytesPerTile;
+    p_cacheBytes = 0;
+    p_cacheMap.clear();
+    p_mostRecent = NULL;
+    p_leastRecent = NULL;
     p_nullCache.buf = NULL;
+    p_writer = NULL;
     p_tileAllocated.clear();
   }
 
@@ -85,28 +92,23 @@ namespace Isis {
     if (!p_cube->stream.is_open()) return;
 
     // Empty the cache
-    unsigned int listSize = p_cacheList.size();
-    for (unsigned int i=0; i<listSize; i++) {
-      if (p_cacheList[i]->buf != NULL) {
-        InternalCache *cache = p_cacheList[i];
-        WriteCache(cache);
-        delete [] cache->buf;
-        cache->buf = NULL;
-      }
-      delete p_cacheList[i];
-      p_cacheList[i] = NULL;
+    while (p_leastRecent != NULL) {
+      Evict(p_leastRecent);
     }
-    p_cacheList.clear();
-    p_bufList.clear();
+    p_cacheMap.clear();
 
-    // Write any tiles which where never allocated
-    if (p_nullCache.buf == NULL) MakeNullCache();
-    unsigned int ntiles = p_tileAllocated.size();
-    for (unsigned int i=0; i<ntiles; i++) {
-      if (!p_tileAllocated[i]) {
-        WriteTile(p_nullCache.buf,i+1);
-      }
+    // Wait for the dirty tiles to be written, then write any tiles which
+    // where never allocated
+    if (p_tileAllocated.size() > 0) {
+      if (p_nullCache.buf == NULL) MakeNullCache();
+      p_cube->stream.flush();
+      Writer()->Fill(p_tileAllocated,p_nullCache.buf);
+    }
+    else if (p_writer != NULL) {
+      p_writer->Flush();
     }
+    delete p_writer;
+    p_writer = NULL;
 
     p_tileAllocated.clear();
     delete [] p_nullCache.buf;
@@ -118,8 +120,7 @@ namespace Isis {
   }
 
   void CubeTileHandler::Read(Isis::Buffer &rbuf) {
-    // See if the cache needs to get bigger
-    GrowCache(rbuf);
+    if (p_nullCache.buf == NULL) MakeNullCache();
 
     // Starting corner in the Isis::Buffer
     int ssamp = rbuf.Sample();
@@ -178,8 +179,7 @@ namespace Isis {
   void CubeTileHandler::Write(Isis::Buffer &wbuf) {
     // Put an error check here if the access is ReadOnly
 
-    // See if the cache needs to get bigger
-    GrowCache(wbuf);
+    if (p_nullCache.buf == NULL) MakeNullCache();
 
     // Starting corner in the Isis::Buffer
     // We don't care about pixels outside the cube 
@@ -237,34 +237,22 @@ namespace Isis {
     }
   }
 
-  void CubeTileHandler::GrowCache(const Isis::Buffer &buf) {
-    // The old method created a new cache for every new buffer used
-    // on a cube
-#if 0
-    if (p_nullCache.buf == NULL) MakeNullCache();
-
-    for (unsigned int i=0; i<p_bufList.size(); i++) {
-      if (&buf == p_bufList[i]) return;
+  /**
+   * Sets the memory budget of the tile cache. Least recently used tiles are
+   * written (if dirty) and released until the cache fits the new budget. The
+   * cache always holds at least one tile.
+   *
+   * @param bytes Maximum bytes of tile data to keep in memory. Zero or less
+   *              restores the default of six tile sets.
+   */
+  void CubeTileHandler::SetCacheSize(Isis::BigInt bytes) {
+    if (bytes <= 0) {
+      bytes = 6 * (Isis::BigInt) p_maxTiles * p_bytesPerTile;
     }
-    p_bufList.push_back(&buf);
+    p_maxCacheBytes = bytes;
 
-    for (int i=0; i<p_maxTiles; i++) {
-      InternalCache *cache = new InternalCache;
-      cache->buf = NULL;
-      p_cacheList.push_back(cache);
-    }
-#endif
-
-    // The new method makes six tiles sets worth of caches total.
-    // Six was used to ensure large highpass filters don't thrash
-    if (p_nullCache.buf != NULL) return;
-    MakeNullCache();
-    for (int j=0; j<6; j++) {
-      for (int i=0; i<p_maxTiles; i++) {
-        InternalCache *cache = new InternalCache;
-        cache->buf = NULL;
-        p_cacheList.push_back(cache);
-      }
+    while ((p_cacheBytes > p_maxCacheBytes) && (p_leastRecent != NULL)) {
+      Evict(p_leastRecent);
     }
   }
 
@@ -295,61 +283,56 @@ namespace Isis {
       return &p_nullCache;
     }
 
-    // Look through the cache list to see if we already have the cache
-    // but check the last cache first
-    if (p_lastCache >= 0) {
-      InternalCache *cache;
-      int next = p_lastCache;
-      int count = p_cacheList.size();
-      for (int i=0; i<count; i++) {
-        cache = p_cacheList[next];
-        if (cache->buf != NULL) {
-          if ((p_sample >= cache->startSamp) && (p_sample <= cache->endSamp) &&
-              (p_line >= cache->startLine)   && (p_line <= cache->endLine)   &&
-              (p_band == cache->band)) {
-           p_lastCache = next;
-           return cache;
-          }
-        }
-        next++;
-        if (next >= count) next = 0;
-      }
+    // Look up the tile, checking the most recently used one first
+    int tile = (p_band - 1) * p_sampleTiles * p_lineTiles +
+               (p_line - 1) / p_tileLines * p_sampleTiles +
+               (p_sample - 1) / p_tileSamples;
+
+    InternalCache *cache = p_mostRecent;
+    if ((cache == NULL) || (cache->tile != tile)) {
+      cache = p_cacheMap.value(tile,NULL);
     }
 
-    // Ok its not in the cache see if there is an open slot
-    InternalCache *cache = NULL;
-    unsigned int listSize = p_cacheList.size();
-    for (unsigned int i=0; i<listSize; i++) {
-      if (p_cacheList[i]->buf == NULL) {
-        cache = p_cacheList[i];
-        cache->buf = new char [p_bytesPerTile];
-        cache->dirty = false;
-        p_lastCache = i;
-        break;
+    if (cache != NULL) {
+      p_cacheHits++;
+      Touch(cache);
+      return cache;
+    }
+    p_cacheMisses++;
+
+    // Ok its not in the cache so reuse the least recently used tile if the
+    // cache is full or make a new one
+    if ((p_leastRecent != NULL) &&
+        (p_cacheBytes + p_bytesPerTile > p_maxCacheBytes)) {
+      cache = p_leastRecent;
+      if (cache->dirty) {
+        WriteCache(cache);
+        cache->buf = p_writer->Buffer();
       }
+      Unlink(cache);
+      p_cacheMap.remove(cache->tile);
     }
-
-    // If there are no open slots so chose one to get rid of
-    if (cache == NULL) {
-      p_lastCache++;
-      if (p_lastCache >= (int)p_cacheList.size()) p_lastCache = 0;
-      cache = p_cacheList[p_lastCache];
+    else {
+      cache = new InternalCache;
+      cache->buf = new char [p_bytesPerTile];
+      cache->prev = NULL;
+      cache->next = NULL;
+      p_cacheBytes += p_bytesPerTile;
     }
 
-    // Write out the tile
-    WriteCache(cache);
-
     // Set up for reading the  tile
     cache->startSamp = (p_sample - 1) / p_tileSamples * p_tileSamples + 1;
     cache->startLine = (p_line - 1)   / p_tileLines   * p_tileLines   + 1;
     cache->endSamp = cache->startSamp + p_tileSamples - 1;
     cache->endLine = cache->startLine + p_tileLines - 1;
     cache->band = p_band;
+    cache->tile = tile;
     cache->dirty = false;
 
-    int startTile = (cache->band - 1) * p_sampleTiles * p_lineTiles +
-                    (cache->startLine - 1) / p_tileLines * p_sampleTiles +
-                    (cache->startSamp - 1) / p_tileSamples + 1;
+    p_cacheMap.insert(tile,cache);
+    Touch(cache);
+
+    int startTile = tile + 1;
 
     // If this cube is being created the tile may not exist so we
     // shouldn't try to read it
@@ -362,6 +345,12 @@ namespace Isis {
       }
     }
 
+    // The tile may still be waiting to be written
+    if ((p_writer != NULL) && p_writer->Take(tile,cache->buf)) {
+      cache->dirty = true;
+      return cache;
+    }
+
     // Ok looks like we need to read the tile
     streampos sbyte = (streampos) (p_cube->startByte - 1) +
                       (streampos) (startTile - 1) * (streampos) p_bytesPerTile;
@@ -382,6 +371,42 @@ namespace Isis {
     return cache;
   }
 
+  //! Moves a cached tile to the front of the least recently used list
+  void CubeTileHandler::Touch(CubeTileHandler::InternalCache *cache) {
+    if (cache == p_mostRecent) return;
+    Unlink(cache);
+
+    cache->prev = NULL;
+    cache->next = p_mostRecent;
+    if (p_mostRecent != NULL) p_mostRecent->prev = cache;
+    p_mostRecent = cache;
+    if (p_leastRecent == NULL) p_leastRecent = cache;
+  }
+
+  //! Removes a cached tile from the least recently used list
+  void CubeTileHandler::Unlink(CubeTileHandler::InternalCache *cache) {
+    if (cache->prev != NULL) cache->prev->next = cache->next;
+    if (cache->next != NULL) cache->next->prev = cache->prev;
+    if (p_mostRecent == cache) p_mostRecent = cache->next;
+    if (p_leastRecent == cache) p_leastRecent = cache->prev;
+    cache->prev = NULL;
+    cache->next = NULL;
+  }
+
+  //! Queues a cached tile for writing if it is dirty and releases it
+  void CubeTileHandler::Evict(CubeTileHandler::InternalCache *cache) {
+    if (cache->dirty) {
+      WriteCache(cache);
+    }
+    else {
+      delete [] cache->buf;
+    }
+    Unlink(cache);
+    p_cacheMap.remove(cache->tile);
+    p_cacheBytes -= p_bytesPerTile;
+    delete cache;
+  }
+
   void CubeTileHandler::Move(char *dest, int dindex,
                              char *src, int sindex,
                              int nelements) {
@@ -392,27 +417,8 @@ namespace Isis {
     if ((p_native) || (nbytes == 1) || (!p_native && (src == p_nullCache.buf))) {
       memmove(&dest[dindex*nbytes],&src[sindex*nbytes],nelements*nbytes);
     }
-    else if (nbytes == 2) {
-      int d = dindex*nbytes;
-      int s = sindex*nbytes;
-      for (int i=0; i<nelements; i++) {
-        dest[d] = src[s+1];
-        dest[d+1] = src[s];
-        d+=2;
-        s+=2;
-      }
-    }
     else {
-      int d = dindex*nbytes;
-      int s = sindex*nbytes;
-      for (int i=0; i<nelements; i++) {
-        dest[d] = src[s+3];
-        dest[d+1] = src[s+2];
-        dest[d+2] = src[s+1];
-        dest[d+3] = src[s];
-        d+=4;
-        s+=4;
-      }
+      SwapBytes(&dest[dindex*nbytes],&src[sindex*nbytes],nelements,nbytes);
     }
   }
 
@@ -437,31 +443,33 @@ namespace Isis {
 
   }
 
+  /**
+   * Hands a dirty cached tile to the writer thread. The writer owns the
+   * tile buffer afterwards, so the cache needs a new one before it is used
+   * again.
+   *
+   * @param cache The tile to write
+   */
   void CubeTileHandler::WriteCache (CubeTileHandler::InternalCache *cache) {
     // Do nothing if the cache isn't dirty
     if (!cache->dirty) return;
 
-    // Otherwise compute tile number and write it
-    int tile = (cache->band - 1) * p_sampleTiles * p_lineTiles +
-               (cache->startLine - 1) / p_tileLines * p_sampleTiles +
-               (cache->startSamp - 1) / p_tileSamples + 1;
-    WriteTile(cache->buf,tile);
+    Writer()->Enqueue(cache->tile,cache->buf);
+    cache->buf = NULL;
+    cache->dirty = false;
   }
 
-  void CubeTileHandler::WriteTile (char *buf, int tile) {
-    streampos sbyte = (streampos)(p_cube->startByte - 1) +
-                      (streampos)(tile - 1) * (streampos)p_bytesPerTile;
-    p_cube->stream.seekp(sbyte,std::ios::beg);
-    if (!p_cube->stream.good()) {
-      string msg = "Error preparing to write data to cube";
-      throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
-    }
-
-    int bytes = p_bytesPerTile;
-    p_cube->stream.write(buf,bytes);
-    if (!p_cube->stream.good()) {
-      string msg = "Error writing data to cube";
-      throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
+  /**
+   * Returns the tile writer, creating it on first use. Up to a tile set of
+   * dirty tiles may be waiting to be written.
+   *
+   * @return CubeTileWriter*
+   */
+  CubeTileWriter *CubeTileHandler::Writer () {
+    if (p_writer == NULL) {
+      p_writer = new CubeTileWriter(p_cube->dataFile,p_cube->startByte,
+                                    p_bytesPerTile,p_maxTiles);
     }
+    return p_writer;
   }
 }
@@ -24,9 +24,12 @@
 #ifndef CubeTileHandler_h
 #define CubeTileHandler_h
 
+#include <QHash>
+
 #include "CubeIoHandler.h"
 
 namespace Isis {
+  class CubeTileWriter;
 
 /**                                                                       
  * @brief I/O Handler for Isis Cubes using the tile format.
@@ -42,6 +45,12 @@ namespace Isis {
  *   @history 2007-09-14 Stuart Sides - Fixed bug where pixels
  *            from a buffer outside the ns/nl were being
  *            transfered to the right most and bottom most tiles
+ *   @history 2026-10-17 Unknown - Replaced the round robin tile cache with a
+ *            least recently used cache indexed by tile number and limited by a
+ *            memory budget in bytes. Added cache hit/miss counts.
+ *   @history 2026-10-17 Unknown - Dirty tiles are written in the background by
+ *            a CubeTileWriter. Never allocated tiles are written in runs, or
+ *            left as holes in the file when a NULL tile is all zero bytes.
  */
 
 
@@ -53,6 +62,7 @@ namespace Isis {
       void Read(Isis::Buffer &rbuf);
       void Write(Isis::Buffer &wbuf);
       void Create(bool overwrite);
+      void SetCacheSize(Isis::BigInt bytes);
   
     private:
       class InternalCache {
@@ -61,7 +71,10 @@ namespace Isis {
           int startLine,startSamp;
           int endLine,endSamp;
           int band;
+          int tile;
           char *buf;
+          InternalCache *prev;  //!< More recently used tile
+          InternalCache *next;  //!< Less recently used tile
       };
     
       int p_tileSamples;
@@ -72,21 +85,28 @@ namespace Isis {
       int p_sampleTiles;
       int p_lineTiles;
       int p_maxTiles;
-      std::vector<const Isis::Buffer *> p_bufList;
-      std::vector<InternalCache *> p_cacheList;
+
+      //! Cached tiles keyed by their zero based tile index
+      QHash<int, InternalCache *> p_cacheMap;
+      InternalCache *p_mostRecent;   //!< Head of the LRU list
+      InternalCache *p_leastRecent;  //!< Tail of the LRU list
       InternalCache p_nullCache;
-      int p_lastCache;
+      Isis::BigInt p_cacheBytes;     //!< Bytes of tile data in the cache
+      Isis::BigInt p_maxCacheBytes;  //!< Memory budget for tile data
+      CubeTileWriter *p_writer;      //!< Writes dirty tiles in the background
     
       int p_sample;
       int p_line;
       int p_band;
     
-      void GrowCache (const Isis::Buffer &buf);
       InternalCache *FindCache();
+      void Touch(InternalCache *cache);
+      void Unlink(InternalCache *cache);
+      void Evict(InternalCache *cache);
       void Move(char *dest, int dindex, 
                 char *src, int sindex, int nelements);
       void WriteCache (InternalCache *cache);
-      void WriteTile (char *buf, int tile);
+      CubeTileWriter *Writer ();
       void MakeNullCache ();
   
   };
@@ -0,0 +1,341 @@
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <QMutexLocker>
+
+#include "CubeTileWriter.h"
+#include "iException.h"
+
+using namespace std;
+namespace Isis {
+
+  /**
+   * Opens the data file for writing. The thread is started with the first
+   * queued tile.
+   *
+   * @param dataFile Name of the cube data file
+   * @param startByte One based file position of the first tile
+   * @param bytesPerTile Size of a tile in bytes
+   * @param maxQueued Maximum number of tiles waiting to be written
+   */
+  CubeTileWriter::CubeTileWriter(const std::string &dataFile,
+                                 Isis::BigInt startByte,
+                                 int bytesPerTile, int maxQueued) {
+    p_dataFile = dataFile;
+    p_startByte = startByte - 1;
+    p_bytesPerTile = bytesPerTile;
+    p_maxQueued = (maxQueued < 1) ? 1 : maxQueued;
+
+    // Write at most about 4MB at a time
+    p_maxRun = 4194304 / p_bytesPerTile;
+    if (p_maxRun < 1) p_maxRun = 1;
+
+    p_stop = false;
+
+    p_fd = ::open(p_dataFile.c_str(), O_WRONLY);
+    if (p_fd < 0) {
+      string msg = "Unable to open data file [" + p_dataFile +
+                   "] for writing";
+      throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Writes whatever is still queued, stops the thread and closes the file.
+   * Errors are not reported here, call Flush first to see them.
+   */
+  CubeTileWriter::~CubeTileWriter() {
+    p_mutex.lock();
+    p_stop = true;
+    p_queued.wakeAll();
+    p_mutex.unlock();
+
+    wait();
+
+    map<int, char *>::iterator it;
+    for (it = p_queue.begin(); it != p_queue.end(); it++) {
+      delete [] it->second;
+    }
+    for (unsigned int i=0; i<p_free.size(); i++) {
+      delete [] p_free[i];
+    }
+
+    ::close(p_fd);
+  }
+
+
+  /**
+   * Returns a tile buffer for the caller to own, reusing one which has been
+   * written if possible.
+   *
+   * @return char* Buffer of bytesPerTile bytes
+   */
+  char *CubeTileWriter::Buffer() {
+    QMutexLocker lock(&p_mutex);
+    if (p_free.empty()) return new char[p_bytesPerTile];
+
+    char *buf = p_free.back();
+    p_free.pop_back();
+    return buf;
+  }
+
+
+  /**
+   * Queues a tile to be written. The writer takes ownership of the buffer
+   * unless an exception is thrown. Blocks while the queue is full.
+   *
+   * @param tile Zero based tile index
+   * @param buf The tile data in file byte order
+   */
+  void CubeTileWriter::Enqueue(int tile, char *buf) {
+    QMutexLocker lock(&p_mutex);
+    while (((int) p_queue.size() >= p_maxQueued) && p_error.empty()) {
+      p_written.wait(&p_mutex);
+    }
+
+    // Leave the buffer with the caller if the file can't be written
+    CheckError();
+
+    // A tile is only queued again after it was taken back, but don't leak
+    // if that ever changes
+    map<int, char *>::iterator it = p_queue.find(tile);
+    if (it != p_queue.end()) {
+      p_free.push_back(it->second);
+      p_queue.erase(it);
+    }
+
+    p_queue[tile] = buf;
+    if (!isRunning()) start();
+    p_queued.wakeAll();
+  }
+
+
+  /**
+   * Gives a tile which has not been written yet back to the caller. If the
+   * tile is being written the call waits until it is in the file.
+   *
+   * @param tile Zero based tile index
+   * @param buf Buffer the queued data is copied to
+   *
+   * @return bool True if the tile was queued and copied to buf, false if it
+   *              must be read from the file
+   */
+  bool CubeTileWriter::Take(int tile, char *buf) {
+    QMutexLocker lock(&p_mutex);
+    while (p_writing.find(tile) != p_writing.end()) {
+      p_written.wait(&p_mutex);
+    }
+    CheckError();
+
+    map<int, char *>::iterator it = p_queue.find(tile);
+    if (it == p_queue.end()) return false;
+
+    memcpy(buf,it->second,p_bytesPerTile);
+    p_free.push_back(it->second);
+    p_queue.erase(it);
+    p_written.wakeAll();
+    return true;
+  }
+
+
+  //! Waits until all queued tiles are in the file
+  void CubeTileWriter::Flush() {
+    QMutexLocker lock(&p_mutex);
+    while ((!p_queue.empty() || !p_writing.empty()) && p_error.empty()) {
+      p_written.wait(&p_mutex);
+    }
+    CheckError();
+  }
+
+
+  /**
+   * Writes NULL tiles for the tiles of a new cube which were never
+   * allocated. Runs of adjacent tiles are written together. If the NULL
+   * tile is all zero bytes, the tiles are left as holes in the file instead
+   * and the file is only extended to the end of the cube data.
+   *
+   * @param allocated Tells which tiles have been written
+   * @param nullTile A tile of NULL pixels in file byte order
+   */
+  void CubeTileWriter::Fill(const std::vector<bool> &allocated,
+                            const char *nullTile) {
+    Flush();
+
+    bool sparse = true;
+    for (int i=0; sparse && (i<p_bytesPerTile); i++) {
+      if (nullTile[i] != 0) sparse = false;
+    }
+
+    if (sparse) {
+      Isis::BigInt dataEnd = p_startByte +
+                             (Isis::BigInt) allocated.size() * p_bytesPerTile;
+      struct stat info;
+      if ((fstat(p_fd,&info) != 0) ||
+          (((Isis::BigInt) info.st_size < dataEnd) &&
+           (ftruncate(p_fd,(off_t) dataEnd) != 0))) {
+        string msg = "Unable to extend data file [" + p_dataFile + "]";
+        throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
+      }
+      return;
+    }
+
+    char *run = NULL;
+    int ntiles = allocated.size();
+    for (int tile=0; tile<ntiles; ) {
+      if (allocated[tile]) {
+        tile++;
+        continue;
+      }
+
+      int count = 1;
+      while ((tile + count < ntiles) && !allocated[tile+count] &&
+             (count < p_maxRun)) count++;
+
+      if (run == NULL) {
+        int runTiles = 1;
+        while ((tile + runTiles < ntiles) && (runTiles < p_maxRun)) runTiles++;
+        run = new char[(Isis::BigInt) runTiles * p_bytesPerTile];
+        for (int i=0; i<runTiles; i++) {
+          memcpy(&run[(Isis::BigInt) i * p_bytesPerTile],nullTile,
+                 p_bytesPerTile);
+        }
+      }
+
+      if (!WriteBytes(run,(Isis::BigInt) count * p_bytesPerTile,tile)) {
+        delete [] run;
+        string msg = "Error writing data to cube [" + p_dataFile + "]";
+        throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
+      }
+      tile += count;
+    }
+    delete [] run;
+  }
+
+
+  /**
+   * Writes queued tiles until told to stop. Everything queued is taken at
+   * once and runs of adjacent tiles are copied together so they are written
+   * with one call.
+   */
+  void CubeTileWriter::run() {
+    char *runBuf = NULL;
+
+    p_mutex.lock();
+    while (true) {
+      while (!p_stop && p_queue.empty()) p_queued.wait(&p_mutex);
+      if (p_queue.empty()) break;
+
+      p_writing.swap(p_queue);
+      p_written.wakeAll();
+      p_mutex.unlock();
+
+      // Only this thread changes p_writing so it can be read unlocked
+      bool ok = true;
+      map<int, char *>::iterator it = p_writing.begin();
+      while (ok && (it != p_writing.end())) {
+        map<int, char *>::iterator first = it;
+        int count = 1;
+        for (it++; (it != p_writing.end()) &&
+                   (it->first == first->first + count) &&
+                   (count < p_maxRun); it++) count++;
+
+        if (count == 1) {
+          ok = WriteBytes(first->second,p_bytesPerTile,first->first);
+          continue;
+        }
+
+        if (runBuf == NULL) {
+          runBuf = new char[(Isis::BigInt) p_maxRun * p_bytesPerTile];
+        }
+        map<int, char *>::iterator tile = first;
+        for (int i=0; i<count; i++, tile++) {
+          memcpy(&runBuf[(Isis::BigInt) i * p_bytesPerTile],tile->second,
+                 p_bytesPerTile);
+        }
+        ok = WriteBytes(runBuf,(Isis::BigInt) count * p_bytesPerTile,
+                        first->first);
+      }
+
+      p_mutex.lock();
+      if (!ok && p_error.empty()) {
+        p_error = "Error writing data to cube [" + p_dataFile + "]";
+      }
+
+      // Keep about a queue worth of buffers for reuse
+      for (it = p_writing.begin(); it != p_writing.end(); it++) {
+        if ((int) p_free.size() < p_maxQueued) {
+          p_free.push_back(it->second);
+        }
+        else {
+          delete [] it->second;
+        }
+      }
+      p_writing.clear();
+      p_written.wakeAll();
+    }
+    p_mutex.unlock();
+
+    delete [] runBuf;
+  }
+
+
+  //! Throws the error found by the writer thread, if any. Call while locked.
+  void CubeTileWriter::CheckError() {
+    if (p_error.empty()) return;
+    string msg = p_error;
+    throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
+  }
+
+
+  /**
+   * Writes bytes to the file starting at a tile, retrying short writes.
+   *
+   * @param buf Data to write
+   * @param bytes Number of bytes to write
+   * @param tile Zero based index of the first tile
+   *
+   * @return bool False if the write failed
+   */
+  bool CubeTileWriter::WriteBytes(const char *buf, Isis::BigInt bytes,
+                                  Isis::BigInt tile) {
+    Isis::BigInt offset = p_startByte + tile * p_bytesPerTile;
+    while (bytes > 0) {
+      ssize_t n = pwrite(p_fd,buf,(size_t) bytes,(off_t) offset);
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        return false;
+      }
+      buf += n;
+      bytes -= n;
+      offset += n;
+    }
+    return true;
+  }
+}
@@ -0,0 +1,95 @@
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#ifndef CubeTileWriter_h
+#define CubeTileWriter_h
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "Constants.h"
+
+namespace Isis {
+
+/**
+ * @brief Writes dirty tiles of a tiled cube in a separate thread
+ *
+ * The CubeTileHandler hands its dirty tiles to a CubeTileWriter when they
+ * leave the tile cache instead of writing them to the file itself. The
+ * writer thread takes everything queued at once, sorts it by tile index and
+ * writes runs of adjacent tiles with a single pwrite call on its own file
+ * descriptor.
+ *
+ * The queue is bounded; Enqueue blocks while it is full so the memory held
+ * by queued tiles stays limited. A tile that is read again before it reaches
+ * the file is handed back with Take. Errors found by the writer thread are
+ * reported as exceptions by the next Enqueue, Take or Flush.
+ *
+ * @ingroup LowLevelCubeIO
+ *
+ * @author 2026-10-17 Unknown
+ *
+ * @internal
+ */
+  class CubeTileWriter : private QThread {
+    public:
+      CubeTileWriter(const std::string &dataFile, Isis::BigInt startByte,
+                     int bytesPerTile, int maxQueued);
+      ~CubeTileWriter();
+
+      char *Buffer();
+      void Enqueue(int tile, char *buf);
+      bool Take(int tile, char *buf);
+      void Flush();
+      void Fill(const std::vector<bool> &allocated, const char *nullTile);
+
+    protected:
+      void run();
+
+    private:
+      std::string p_dataFile;    //!< Name of the cube data file
+      int p_fd;                  //!< File descriptor used for writing
+      Isis::BigInt p_startByte;  //!< Zero based file offset of the first tile
+      int p_bytesPerTile;        //!< Size of a tile in bytes
+      int p_maxQueued;           //!< Maximum number of queued tiles
+      int p_maxRun;              //!< Maximum number of tiles per write
+
+      std::map<int, char *> p_queue;    //!< Tiles waiting to be written
+      std::map<int, char *> p_writing;  //!< Tiles being written
+      std::vector<char *> p_free;       //!< Tile buffers ready for reuse
+      std::string p_error;              //!< First error of the thread
+      bool p_stop;                      //!< Tells the thread to quit
+
+      QMutex p_mutex;               //!< Protects everything above
+      QWaitCondition p_queued;      //!< Signaled when tiles are queued
+      QWaitCondition p_written;     //!< Signaled when a batch is written
+
+      void CheckError();
+      bool WriteBytes(const char *buf, Isis::BigInt bytes, Isis::BigInt tile);
+  };
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include "Preference.h"
 #include "Histogram.h"
 #include "Statistics.h"
+#include "SpecialPixel.h"
 
 using namespace std;
 
@@ -148,6 +149,156 @@ try {
   in3.Close();
 
 
+  // Test memory mapped output with a non-native byte order
+  cout << "Creating memory mapped 16-bit cube ... " << endl;
+  Isis::Cube out5;
+  out5.SetDimensions(150,200,2);
+  out5.SetBaseMultiplier(30000.0,-1.0);
+  out5.SetByteOrder(ISIS_LITTLE_ENDIAN ? Isis::Msb : Isis::Lsb);
+  out5.SetPixelType(Isis::SignedWord);
+  out5.SetMemoryMapped();
+  out5.Create("/tmp/IsisCube_06");
+  cout << "Mapped = " << out5.IsMemoryMapped() << endl;
+
+  // Leave the second band untouched so it gets filled with NULLs
+  j = 0;
+  Isis::LineManager oline5(out5);
+  for (oline5.begin(); !oline5.end(); oline5++) {
+    if (oline5.Band() != 1) continue;
+    for (int i=0; i<oline5.size(); i++) {
+      oline5[i] = (double) j;
+      j++;
+    }
+    out5.Write(oline5);
+  }
+  out5.Close();
+
+  cout << "Comparing memory mapped cube ... " << endl;
+  Isis::Cube in5;
+  in5.Open("/tmp/IsisCube_06");
+  j = 0;
+  Isis::LineManager inLine5(in5);
+  for (inLine5.begin(); !inLine5.end(); inLine5++) {
+    in5.Read(inLine5);
+    for (int i=0; i<inLine5.size(); i++) {
+      double expected = (inLine5.Band() == 1) ? (double) j : Isis::Null;
+      if (inLine5[i] != expected) {
+        cout << "Problem at line " << inLine5.Line() 
+             << " sample " << i + 1 << ":  "
+             << inLine5[i] << " != " << expected << endl;
+      }
+      if (inLine5.Band() == 1) j++;
+    }
+  }
+  in5.Close();
+
+  cout << "Reading cube through a memory map ... " << endl;
+  Isis::Cube in6;
+  in6.SetMemoryMapped();
+  in6.Open("/tmp/IsisCube_01");
+  cout << "Mapped = " << in6.IsMemoryMapped() << endl;
+  j = 0;
+  Isis::LineManager inLine6(in6);
+  for (inLine6.begin(); !inLine6.end(); inLine6++) {
+    in6.Read(inLine6);
+    for (int i=0; i<inLine6.size(); i++) {
+      if (inLine6[i] != (double) j) {
+        cout << "Problem at line " << inLine6.Line() 
+             << " sample " << i + 1 << ":  "
+             << inLine6[i] << " != " << double(j) << endl;
+      }
+      j++;
+    }
+    j--;
+  }
+  in6.Close();
+
+  // BandSequential cubes are never memory mapped
+  Isis::Cube out9;
+  out9.SetDimensions(10,10,1);
+  out9.SetCubeFormat(Isis::Bsq);
+  out9.SetMemoryMapped();
+  out9.Create("/tmp/IsisCube_08");
+  cout << "Mapped = " << out9.IsMemoryMapped() << endl;
+  out9.Close();
+  cout << endl;
+
+  // Test the tile cache statistics with the default and a one tile budget
+  cout << "Testing tile cache ... " << endl;
+  Isis::Cube in7;
+  in7.Open("/tmp/IsisCube_01");
+  Isis::LineManager inLine7(in7);
+  for (inLine7.begin(); !inLine7.end(); inLine7++) {
+    in7.Read(inLine7);
+  }
+  cout << "Hits   = " << in7.CacheHits() << endl;
+  cout << "Misses = " << in7.CacheMisses() << endl;
+  in7.Close();
+
+  in7.SetCacheSize(1);
+  in7.Open("/tmp/IsisCube_01");
+  for (inLine7.begin(); !inLine7.end(); inLine7++) {
+    in7.Read(inLine7);
+  }
+  cout << "Hits   = " << in7.CacheHits() << endl;
+  cout << "Misses = " << in7.CacheMisses() << endl;
+  in7.Close();
+  cout << endl;
+
+  // Test the write behind queue by reading tiles back before they are
+  // written, and leave a band of an 8-bit cube untouched so it is sparse
+  cout << "Testing write behind ... " << endl;
+  Isis::Cube out8;
+  out8.SetDimensions(150,200,2);
+  out8.SetBaseMultiplier(0.0,1.0);
+  out8.SetPixelType(Isis::UnsignedByte);
+  out8.SetCacheSize(1);
+  out8.Create("/tmp/IsisCube_07");
+
+  Isis::LineManager oline8(out8);
+  for (oline8.begin(); !oline8.end(); oline8++) {
+    if (oline8.Band() != 1) continue;
+    for (int i=0; i<oline8.size(); i++) {
+      oline8[i] = (double) ((oline8.Line() + i) % 254 + 1);
+    }
+    out8.Write(oline8);
+  }
+
+  for (oline8.begin(); !oline8.end(); oline8++) {
+    if (oline8.Band() != 1) continue;
+    out8.Read(oline8);
+    for (int i=0; i<oline8.size(); i++) {
+      double expected = (double) ((oline8.Line() + i) % 254 + 1);
+      if (oline8[i] != expected) {
+        cout << "Problem at line " << oline8.Line()
+             << " sample " << i + 1 << ":  "
+             << oline8[i] << " != " << expected << endl;
+      }
+    }
+  }
+  out8.Close();
+
+  Isis::Cube in8;
+  in8.Open("/tmp/IsisCube_07");
+  Isis::LineManager inLine8(in8);
+  for (inLine8.begin(); !inLine8.end(); inLine8++) {
+    in8.Read(inLine8);
+    for (int i=0; i<inLine8.size(); i++) {
+      double expected = Isis::Null;
+      if (inLine8.Band() == 1) {
+        expected = (double) ((inLine8.Line() + i) % 254 + 1);
+      }
+      if (inLine8[i] != expected) {
+        cout << "Problem at line " << inLine8.Line()
+             << " band " << inLine8.Band() << " sample " << i + 1 << ":  "
+             << inLine8[i] << " != " << expected << endl;
+      }
+    }
+  }
+  in8.Close();
+  cout << endl;
+
+
   in.Open("/tmp/IsisCube_01");
 
   // Test Histogram object on a single band, 1 by default
@@ -363,6 +514,9 @@ catch (Isis::iException &e) {
   remove ("/tmp/IsisCube_03.cub"); 
   remove ("/tmp/IsisCube_04.cub"); 
   remove ("/tmp/IsisCube_05.cub"); 
+  remove ("/tmp/IsisCube_06.cub"); 
+  remove ("/tmp/IsisCube_07.cub"); 
+  remove ("/tmp/IsisCube_08.cub"); 
   return 0;
 }
 
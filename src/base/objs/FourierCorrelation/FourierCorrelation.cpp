@@ -0,0 +1,356 @@
+#include <cmath>
+#include "FourierCorrelation.h"
+#include "FourierTransform.h"
+#include "Chip.h"
+#include "SpecialPixel.h"
+
+namespace Isis {
+  /**
+   * Fills the fit chip with the absolute value of the correlation between
+   * the pattern chip and the sub-search chip centered at every position from
+   * sample ss to es and line sl to el of the search chip.
+   *
+   * With x the pattern and y the search pixels, the correlation at each
+   * position needs the number of valid pairs n and the sums of x, y, x*x,
+   * y*y and x*y over those pairs.  Each of these is a cross correlation of
+   * the (masked) pattern with the (masked) search chip.  When the pattern
+   * has no special pixels the sums of y and y*y are plain box sums and come
+   * from running sum tables, and the sums of x and x*x are constant unless
+   * the search chip has special pixels.
+   *
+   * @param sChip Search chip
+   * @param pChip Pattern chip
+   * @param fChip Fit chip, the size of the search chip and filled with Null
+   * @param ss    First search chip sample to center the pattern on
+   * @param es    Last search chip sample to center the pattern on
+   * @param sl    First search chip line to center the pattern on
+   * @param el    Last search chip line to center the pattern on
+   *
+   * @return bool Always true
+   */
+  bool FourierCorrelation::MatchSurface(Chip &sChip, Chip &pChip, Chip &fChip,
+                                        int ss, int es, int sl, int el) {
+    int patternSamples = pChip.Samples();
+    int patternLines = pChip.Lines();
+    int patternPixels = patternSamples * patternLines;
+
+    // The region of the search chip covered by the pattern at all positions.
+    // Positions are relative to the pattern tack as in Chip::Extract and
+    // pixels outside of the search chip are Null.
+    int fitSamples = es - ss + 1;
+    int fitLines = el - sl + 1;
+    int searchSamples = fitSamples + patternSamples - 1;
+    int searchLines = fitLines + patternLines - 1;
+    int searchPixels = searchSamples * searchLines;
+    int firstSamp = ss - ((patternSamples - 1) / 2 + 1);
+    int firstLine = sl - ((patternLines - 1) / 2 + 1);
+
+    // Collect the valid pattern pixels.  Both chips are shifted to a zero
+    // mean to keep the sums (and their round off) small, which does not
+    // change the correlation.
+    std::vector<double> pdn(patternPixels, 0.0);
+    std::vector<double> pmask(patternPixels, 0.0);
+    int patternValid = 0;
+    double pmean = 0.0;
+    for (int line=1; line<=patternLines; line++) {
+      for (int samp=1; samp<=patternSamples; samp++) {
+        double value = pChip.GetValue(samp,line);
+        if (!IsValidPixel(value)) continue;
+        pmean += value;
+        patternValid++;
+      }
+    }
+    if (patternValid > 0) pmean /= patternValid;
+
+    std::vector<double> pdn2(patternPixels, 0.0);
+    double psum = 0.0;
+    double psum2 = 0.0;
+    double pmax2 = 0.0;
+    for (int line=1; line<=patternLines; line++) {
+      for (int samp=1; samp<=patternSamples; samp++) {
+        double value = pChip.GetValue(samp,line);
+        if (!IsValidPixel(value)) continue;
+        int i = (line - 1) * patternSamples + samp - 1;
+        pdn[i] = value - pmean;
+        pdn2[i] = pdn[i] * pdn[i];
+        pmask[i] = 1.0;
+        psum += pdn[i];
+        psum2 += pdn2[i];
+        if (pdn2[i] > pmax2) pmax2 = pdn2[i];
+      }
+    }
+
+    // Same for the search region.  Pixels outside the search chip valid
+    // range are counted separately for the sub-search chip valid test.
+    std::vector<double> sdn(searchPixels, 0.0);
+    std::vector<double> smask(searchPixels, 0.0);
+    std::vector<double> svalid(searchPixels, 0.0);
+    int searchValid = 0;
+    double smean = 0.0;
+    for (int line=0; line<searchLines; line++) {
+      int chipLine = firstLine + line + 1;
+      if ((chipLine < 1) || (chipLine > sChip.Lines())) continue;
+      for (int samp=0; samp<searchSamples; samp++) {
+        int chipSamp = firstSamp + samp + 1;
+        if ((chipSamp < 1) || (chipSamp > sChip.Samples())) continue;
+        int i = line * searchSamples + samp;
+        if (sChip.IsValid(chipSamp,chipLine)) svalid[i] = 1.0;
+        double value = sChip.GetValue(chipSamp,chipLine);
+        if (!IsValidPixel(value)) continue;
+        sdn[i] = value;
+        smask[i] = 1.0;
+        smean += value;
+        searchValid++;
+      }
+    }
+    if (searchValid > 0) smean /= searchValid;
+
+    std::vector<double> sdn2(searchPixels, 0.0);
+    double smax2 = 0.0;
+    for (int i=0; i<searchPixels; i++) {
+      if (smask[i] == 0.0) continue;
+      sdn[i] -= smean;
+      sdn2[i] = sdn[i] * sdn[i];
+      if (sdn2[i] > smax2) smax2 = sdn2[i];
+    }
+
+    // Compute the sums at every position
+    FourierTransform fft;
+    int fftSamples = fft.NextPowerOfTwo(searchSamples);
+    int fftLines = fft.NextPowerOfTwo(searchLines);
+
+    Spectrum patternDn = Transform(pdn, patternSamples, patternLines,
+                                   fftSamples, fftLines);
+    Spectrum searchDn = Transform(sdn, searchSamples, searchLines,
+                                  fftSamples, fftLines);
+    std::vector<double> sumxy = Correlate(patternDn, searchDn, fftSamples,
+                                          fftLines, fitSamples, fitLines);
+
+    std::vector<double> n, sumx, sumx2, sumy, sumy2;
+    if (patternValid == patternPixels) {
+      n = BoxSums(smask, searchSamples, searchLines,
+                  patternSamples, patternLines);
+      sumy = BoxSums(sdn, searchSamples, searchLines,
+                     patternSamples, patternLines);
+      sumy2 = BoxSums(sdn2, searchSamples, searchLines,
+                      patternSamples, patternLines);
+      if (searchValid == searchPixels) {
+        sumx.assign(fitSamples * fitLines, psum);
+        sumx2.assign(fitSamples * fitLines, psum2);
+      }
+      else {
+        Spectrum searchMask = Transform(smask, searchSamples, searchLines,
+                                        fftSamples, fftLines);
+        Spectrum patternDn2 = Transform(pdn2, patternSamples, patternLines,
+                                        fftSamples, fftLines);
+        sumx = Correlate(patternDn, searchMask, fftSamples, fftLines,
+                         fitSamples, fitLines);
+        sumx2 = Correlate(patternDn2, searchMask, fftSamples, fftLines,
+                          fitSamples, fitLines);
+      }
+    }
+    else {
+      Spectrum patternMask = Transform(pmask, patternSamples, patternLines,
+                                       fftSamples, fftLines);
+      Spectrum patternDn2 = Transform(pdn2, patternSamples, patternLines,
+                                      fftSamples, fftLines);
+      Spectrum searchMask = Transform(smask, searchSamples, searchLines,
+                                      fftSamples, fftLines);
+      Spectrum searchDn2 = Transform(sdn2, searchSamples, searchLines,
+                                     fftSamples, fftLines);
+      n = Correlate(patternMask, searchMask, fftSamples, fftLines,
+                    fitSamples, fitLines);
+      sumx = Correlate(patternDn, searchMask, fftSamples, fftLines,
+                       fitSamples, fitLines);
+      sumx2 = Correlate(patternDn2, searchMask, fftSamples, fftLines,
+                        fitSamples, fitLines);
+      sumy = Correlate(patternMask, searchDn, fftSamples, fftLines,
+                       fitSamples, fitLines);
+      sumy2 = Correlate(patternMask, searchDn2, fftSamples, fftLines,
+                        fitSamples, fitLines);
+    }
+    std::vector<double> validCount = BoxSums(svalid, searchSamples,
+                                             searchLines, patternSamples,
+                                             patternLines);
+
+    // Turn the sums into correlations.  Variances within the round off of
+    // the transforms are taken as zero, as MaximumCorrelation would find
+    // for a constant chip.
+    for (int line=0; line<fitLines; line++) {
+      for (int samp=0; samp<fitSamples; samp++) {
+        int i = line * fitSamples + samp;
+
+        // The sub-search chip valid test of AutoReg::Match
+        int count = (int) floor(validCount[i] + 0.5);
+        double validPercent = 100.0 * (double) count / (double) patternPixels;
+        if (validPercent < PatternValidPercent()) continue;
+
+        // The valid pair test of MaximumCorrelation::MatchAlgorithm
+        int pairs = (int) floor(n[i] + 0.5);
+        double percentValid = (double) pairs / patternPixels;
+        if (percentValid * 100.0 < PatternValidPercent()) continue;
+        if (pairs <= 1) continue;
+
+        double covar = pairs * sumxy[i] - sumx[i] * sumy[i];
+        double xvar = pairs * sumx2[i] - sumx[i] * sumx[i];
+        double yvar = pairs * sumy2[i] - sumy[i] * sumy[i];
+        double pairs2 = (double) pairs * (double) pairs;
+        if (xvar <= 1.0e-10 * pmax2 * pairs2) continue;
+        if (yvar <= 1.0e-10 * smax2 * pairs2) continue;
+
+        fChip.SetValue(ss + samp, sl + line, fabs(covar / sqrt(xvar * yvar)));
+      }
+    }
+
+    return true;
+  }
+
+
+  /**
+   * Returns the two dimensional Fourier transform of the data, padded with
+   * zeros to fftSamples by fftLines.
+   *
+   * @param data       Data stored line by line
+   * @param samples    Number of samples in the data
+   * @param lines      Number of lines in the data
+   * @param fftSamples Number of samples in the transform, a power of two
+   * @param fftLines   Number of lines in the transform, a power of two
+   *
+   * @return Spectrum
+   */
+  FourierCorrelation::Spectrum FourierCorrelation::Transform(
+      const std::vector<double> &data, int samples, int lines,
+      int fftSamples, int fftLines) {
+    FourierTransform fft;
+    Spectrum spectrum(fftSamples * fftLines);
+
+    // Transform the lines, the padding lines are zero either way
+    Spectrum row(fftSamples);
+    for (int line=0; line<lines; line++) {
+      for (int samp=0; samp<fftSamples; samp++) {
+        row[samp] = (samp < samples) ? data[line * samples + samp] : 0.0;
+      }
+      row = fft.Transform(row);
+      for (int samp=0; samp<fftSamples; samp++) {
+        spectrum[line * fftSamples + samp] = row[samp];
+      }
+    }
+
+    // Then the columns
+    Spectrum column(fftLines);
+    for (int samp=0; samp<fftSamples; samp++) {
+      for (int line=0; line<fftLines; line++) {
+        column[line] = spectrum[line * fftSamples + samp];
+      }
+      column = fft.Transform(column);
+      for (int line=0; line<fftLines; line++) {
+        spectrum[line * fftSamples + samp] = column[line];
+      }
+    }
+
+    return spectrum;
+  }
+
+
+  /**
+   * Returns the cross correlation of a pattern with a search area, that is
+   * the sum of pattern(x) * search(x + offset) over the pattern, for the
+   * first samples by lines offsets.  The transforms must be padded so the
+   * offsets do not wrap around.
+   *
+   * @param pattern    Transform of the pattern
+   * @param search     Transform of the search area
+   * @param fftSamples Number of samples in the transforms
+   * @param fftLines   Number of lines in the transforms
+   * @param samples    Number of sample offsets to return
+   * @param lines      Number of line offsets to return
+   *
+   * @return std::vector<double> Sums stored line by line
+   */
+  std::vector<double> FourierCorrelation::Correlate(const Spectrum &pattern,
+                                                    const Spectrum &search,
+                                                    int fftSamples,
+                                                    int fftLines,
+                                                    int samples, int lines) {
+    FourierTransform fft;
+    Spectrum product(fftSamples * fftLines);
+    for (int i=0; i<fftSamples*fftLines; i++) {
+      product[i] = conj(pattern[i]) * search[i];
+    }
+
+    // Inverse the columns, then only the lines we need
+    Spectrum column(fftLines);
+    for (int samp=0; samp<fftSamples; samp++) {
+      for (int line=0; line<fftLines; line++) {
+        column[line] = product[line * fftSamples + samp];
+      }
+      column = fft.Inverse(column);
+      for (int line=0; line<fftLines; line++) {
+        product[line * fftSamples + samp] = column[line];
+      }
+    }
+
+    std::vector<double> sums(samples * lines);
+    Spectrum row(fftSamples);
+    for (int line=0; line<lines; line++) {
+      for (int samp=0; samp<fftSamples; samp++) {
+        row[samp] = product[line * fftSamples + samp];
+      }
+      row = fft.Inverse(row);
+      for (int samp=0; samp<samples; samp++) {
+        sums[line * samples + samp] = row[samp].real();
+      }
+    }
+
+    return sums;
+  }
+
+
+  /**
+   * Returns the sums of the data over a box at every position the box fits
+   * in the data, using a running sum table.
+   *
+   * @param data        Data stored line by line
+   * @param dataSamples Number of samples in the data
+   * @param dataLines   Number of lines in the data
+   * @param boxSamples  Number of samples in the box
+   * @param boxLines    Number of lines in the box
+   *
+   * @return std::vector<double> Sums stored line by line
+   */
+  std::vector<double> FourierCorrelation::BoxSums(
+      const std::vector<double> &data, int dataSamples, int dataLines,
+      int boxSamples, int boxLines) {
+    // table[l][s] is the sum of the data above and left of line l, sample s
+    int tableSamples = dataSamples + 1;
+    std::vector<double> table(tableSamples * (dataLines + 1), 0.0);
+    for (int line=0; line<dataLines; line++) {
+      double rowSum = 0.0;
+      for (int samp=0; samp<dataSamples; samp++) {
+        rowSum += data[line * dataSamples + samp];
+        table[(line + 1) * tableSamples + samp + 1] =
+          table[line * tableSamples + samp + 1] + rowSum;
+      }
+    }
+
+    int samples = dataSamples - boxSamples + 1;
+    int lines = dataLines - boxLines + 1;
+    std::vector<double> sums(samples * lines);
+    for (int line=0; line<lines; line++) {
+      for (int samp=0; samp<samples; samp++) {
+        int top = line * tableSamples;
+        int bottom = (line + boxLines) * tableSamples;
+        sums[line * samples + samp] = table[bottom + samp + boxSamples]
+                                    - table[top + samp + boxSamples]
+                                    - table[bottom + samp]
+                                    + table[top + samp];
+      }
+    }
+
+    return sums;
+  }
+}
+
+extern "C" Isis::AutoReg *FourierCorrelationPlugin (Isis::Pvl &pvl) {
+  return new Isis::FourierCorrelation(pvl);
+}
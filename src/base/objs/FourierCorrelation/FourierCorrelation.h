@@ -0,0 +1,85 @@
+#if !defined(FourierCorrelation_h)
+#define FourierCorrelation_h
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <complex>
+#include <vector>
+#include "MaximumCorrelation.h"
+
+namespace Isis {
+  class Pvl;
+  class Chip;
+
+  /**
+   * @brief Maximum correlation pattern matching using Fourier transforms
+   *
+   * This class finds the same match as MaximumCorrelation, the position where
+   * the absolute value of the correlation between the pattern chip and the
+   * sub-search chip is largest, but computes the correlation at every search
+   * position at once instead of extracting and correlating one sub-search
+   * chip at a time.  The sums of pattern and search products over every
+   * position are cross correlations, which are computed with Fourier
+   * transforms of the two chips.  When the pattern chip has no special pixels
+   * the per position sums of the search pixels are read from running sum
+   * tables instead.  Special pixels in either chip are masked out of the
+   * sums, so the goodness of fit and the valid percent tests are those of
+   * MaximumCorrelation.
+   *
+   * The cost is independent of the pattern chip size, so this algorithm is
+   * much faster than MaximumCorrelation for large pattern and search chips.
+   * To use it, set Name = FourierCorrelation in the Algorithm group of the
+   * registration definition.
+   *
+   * @ingroup PatternMatching
+   *
+   * @see MaximumCorrelation AutoReg
+   *
+   * @author 2026-10-17 Unknown
+   *
+   * @internal
+   */
+  class FourierCorrelation : public MaximumCorrelation {
+    public:
+      FourierCorrelation (Pvl &pvl) : MaximumCorrelation(pvl) { };
+      virtual ~FourierCorrelation() {};
+
+    protected:
+      virtual bool MatchSurface(Chip &sChip, Chip &pChip, Chip &fChip,
+                                int ss, int es, int sl, int el);
+      virtual std::string AlgorithmName() const {return "FourierCorrelation";};
+
+    private:
+      //! Two dimensional spectrum stored line by line
+      typedef std::vector< std::complex<double> > Spectrum;
+
+      Spectrum Transform(const std::vector<double> &data, int samples,
+                         int lines, int fftSamples, int fftLines);
+      std::vector<double> Correlate(const Spectrum &pattern,
+                                    const Spectrum &search, int fftSamples,
+                                    int fftLines, int samples, int lines);
+      std::vector<double> BoxSums(const std::vector<double> &data,
+                                  int dataSamples, int dataLines,
+                                  int boxSamples, int boxLines);
+  };
+};
+
+#endif
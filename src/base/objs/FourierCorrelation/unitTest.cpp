@@ -0,0 +1,109 @@
+#include <iostream>
+#include <cmath>
+#include "AutoReg.h"
+#include "AutoRegFactory.h"
+#include "Chip.h"
+#include "Cube.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "Preference.h"
+#include "SpecialPixel.h"
+
+using namespace Isis;
+
+Pvl Definition(const std::string &name) {
+  PvlGroup alg("Algorithm");
+  alg += PvlKeyword("Name",name);
+  alg += PvlKeyword("Tolerance",0.1);
+  alg += PvlKeyword("SubpixelAccuracy", "True");
+
+  PvlGroup pchip("PatternChip");
+  pchip += PvlKeyword("Samples",15);
+  pchip += PvlKeyword("Lines",15);
+  pchip += PvlKeyword("Sampling",50);
+  pchip += PvlKeyword("ValidPercent", 10);
+
+  PvlGroup schip("SearchChip");
+  schip += PvlKeyword("Samples",35);
+  schip += PvlKeyword("Lines",35);
+
+  PvlObject o("AutoRegistration");
+  o.AddGroup(alg);
+  o.AddGroup(pchip);
+  o.AddGroup(schip);
+
+  Pvl pvl;
+  pvl.AddObject(o);
+  return pvl;
+}
+
+// Load the chips, knocking out a block of the search chip away from the
+// match when asked
+void Load(AutoReg *ar, Cube &c, bool holes) {
+  ar->SearchChip()->TackCube(125.0,50.0);
+  ar->SearchChip()->Load(c);
+  ar->PatternChip()->TackCube(120.0,45.0);
+  ar->PatternChip()->Load(c);
+  if (!holes) return;
+  for (int line=25; line<=29; line++) {
+    for (int samp=3; samp<=30; samp++) {
+      ar->SearchChip()->SetValue(samp,line,Isis::Null);
+    }
+  }
+}
+
+void Compare(Cube &c, bool holes) {
+  Pvl pvl = Definition("FourierCorrelation");
+  AutoReg *ar = AutoRegFactory::Create(pvl);
+  pvl = Definition("MaximumCorrelation");
+  AutoReg *mc = AutoRegFactory::Create(pvl);
+
+  Load(ar,c,holes);
+  Load(mc,c,holes);
+  std::cout << "Register = " << ar->Register() << std::endl;
+  std::cout << "Position = " << ar->CubeSample() << " " << 
+                                ar->CubeLine() << std::endl;
+  mc->Register();
+
+  int differences = 0;
+  Chip *fit = ar->FitChip();
+  Chip *mcFit = mc->FitChip();
+  for (int line=1; line<=fit->Lines(); line++) {
+    for (int samp=1; samp<=fit->Samples(); samp++) {
+      double f1 = fit->GetValue(samp,line);
+      double f2 = mcFit->GetValue(samp,line);
+      if ((f1 == Isis::Null) != (f2 == Isis::Null)) differences++;
+      else if (f1 != Isis::Null && fabs(f1 - f2) > 1.0e-10) differences++;
+    }
+  }
+  std::cout << "Same position as MaximumCorrelation: " <<
+    ((ar->CubeSample() == mc->CubeSample() &&
+      ar->CubeLine() == mc->CubeLine()) ? "yes" : "no") << std::endl;
+  std::cout << "Fit chip differences from MaximumCorrelation:  " <<
+    differences << std::endl;
+
+  delete ar;
+  delete mc;
+}
+
+int main () {
+  Isis::Preference::Preferences(true);
+
+  try {
+  Pvl pvl = Definition("FourierCorrelation");
+  std::cout << pvl << std::endl;
+
+  Cube c;
+  c.Open("$mgs/testData/ab102401.cub");
+
+  Compare(c,false);
+
+  std::cout << std::endl << "Testing special pixels ... " << std::endl;
+  Compare(c,true);
+  }
+  catch (iException &e) {
+    e.Report();
+  }
+
+  return 0;
+}
@@ -114,7 +114,12 @@ namespace Isis {
     //  pattern chip is rh image , subsearch chip is lh image
     GSLVector a(8);
     for (int line = 2 ; line <= pattern.Lines()-1; line++ ) {
+      const double *pbuf = pattern.LineBuffer(line);
+      const double *sabove = subsearch.LineBuffer(line-1);
+      const double *sbuf = subsearch.LineBuffer(line);
+      const double *sbelow = subsearch.LineBuffer(line+1);
       for (int samp = 2; samp <= pattern.Samples()-1; samp++ ) {
+        int i = samp - 1;
 
         if (!pattern.IsValid(samp,line)) continue;
         if (!subsearch.IsValid(samp,line)) continue;
@@ -128,10 +133,8 @@ namespace Isis {
         double x0 = (double) (samp - tackSamp);
         double y0 = (double) (line - tackLine);
 
-        double gxtemp = subsearch.GetValue(samp+1,line) -
-                        subsearch.GetValue(samp-1,line);
-        double gytemp = subsearch.GetValue(samp,line+1) - 
-                        subsearch.GetValue(samp,line-1);
+        double gxtemp = sbuf[i+1] - sbuf[i-1];
+        double gytemp = sbelow[i] - sabove[i];
 
         a[0] = gxtemp * x0;
         a[1] = gxtemp * y0;
@@ -140,10 +143,8 @@ namespace Isis {
         a[4] = gytemp * y0;
         a[5] = gytemp;
         a[6] = 1.0;
-        a[7] = subsearch.GetValue(samp,line);
-        double ell = pattern.GetValue(samp,line) - 
-                     (((1.0 + Gain()) * subsearch.GetValue(samp,line)) + 
-                     Shift());
+        a[7] = sbuf[i];
+        double ell = pbuf[i] - (((1.0 + Gain()) * sbuf[i]) + Shift());
 
         //  Compute residual 
         result.resid += (ell * ell);
@@ -79,6 +79,8 @@ namespace Isis {
    *            of Gruen parameters.
    *   @history 2009-09-11 Kris Becker Minor error in computation of radiometric
    *            shift
+   *   @history 2026-10-17 Unknown - Walk the chip lines directly in the
+   *            algorithm method instead of getting each pixel.
    */                                                                       
   class Gruen : public AutoReg {
     public:
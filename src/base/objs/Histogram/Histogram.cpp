@@ -62,7 +62,36 @@ namespace Isis {
   }
 
 
-  void Histogram::InitializeFromCube(Cube &cube, const int band, Progress *progress) {
+  /**
+   * Constructs a histogram object using a cube, with the given bin range. The
+   * number of bins is chosen from the pixel type of the cube, as in the
+   * constructor which finds the range, but the cube is not read.
+   *
+   * @param cube  The cube to used to determine the number of bins
+   * @param band  The band number the histogram will be collected from
+   * @param binStart The start of the bin range
+   * @param binEnd The end of the bin range
+   */
+  Histogram::Histogram (Cube &cube, const int band, const double binStart,
+                        const double binEnd) {
+    InitializeFromCube(cube, band, NULL, binStart, binEnd);
+  }
+
+
+  /**
+   * Sets the bin range and number of bins for a cube.  The range is found
+   * with a pass through the cube if it is a real cube and the range is not
+   * given.
+   *
+   * @param cube  The cube to used to determine min/max and bins
+   * @param band  The band number the histogram will be collected from
+   * @param progress  The Isis::Progress object to be used to output the
+   *                  percent processed information
+   * @param binStart The start of the bin range, or Null to choose it
+   * @param binEnd The end of the bin range, or Null to choose it
+   */
+  void Histogram::InitializeFromCube(Cube &cube, const int band, Progress *progress,
+                                     const double binStart, const double binEnd) {
     // Make sure band is valid
     if ((band < 0) || (band > cube.Bands())) {
       string msg = "Invalid band in [Histogram constructor]";
@@ -82,6 +111,12 @@ namespace Isis {
       max = 32767.0 * cube.Multiplier() + cube.Base();
       nbins = 65536;
     }
+    else if (cube.PixelType() == Isis::Real &&
+             !IsNullPixel(binStart) && !IsNullPixel(binEnd)) {
+      min = binStart;
+      max = binEnd;
+      nbins = 65536;
+    }
     else if (cube.PixelType() == Isis::Real) {
       // Determine the band for statistics
       int bandStart = band;
@@ -133,6 +168,8 @@ namespace Isis {
     }
 
     // Set the bins and range
+    if (!IsNullPixel(binStart)) min = binStart;
+    if (!IsNullPixel(binEnd)) max = binEnd;
     SetBinRange(min,max);
     SetBins(nbins);
   }
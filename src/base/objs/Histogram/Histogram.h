@@ -60,12 +60,16 @@ namespace Isis {
  *            collect statistics over all of the data and also set where the
  *            binning will start and end. Increased the default number of bins
  *            for floating point cubes.
+ *   @history 2026-10-18 Unknown - The cube constructor can be given the bin
+ *            range, which saves the pass through a real cube to find it.
  */
   class Histogram : public Isis::Statistics {
     public:
       Histogram (const double minimum, const double maximum,
                  const int bins=1024);
       Histogram (Cube &cube, const int band, Progress *progress=NULL);
+      Histogram (Cube &cube, const int band, const double binStart,
+                 const double binEnd);
 
       ~Histogram ();
 
@@ -92,7 +96,9 @@ namespace Isis {
       void SetBinRange(double binStart, double binEnd);
 
     private:
-      void InitializeFromCube(Cube &cube, const int band, Progress *progress);
+      void InitializeFromCube(Cube &cube, const int band, Progress *progress,
+                              const double binStart=Isis::Null,
+                              const double binEnd=Isis::Null);
       //! The array of counts.
       std::vector<BigInt> p_bins;
       double p_binRangeStart, p_binRangeEnd;
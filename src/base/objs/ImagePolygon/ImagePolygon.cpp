@@ -55,6 +55,11 @@ namespace Isis {
     p_incidence = 180.0;
     p_subpixelAccuracy = 50; //An accuracte and quick number
     p_ellipsoid = false;
+    p_tolerance = 0.0;
+    p_pointLatitude = Null;
+    p_pointLongitude = Null;
+    p_poleEmission = Null;
+    p_poleIncidence = Null;
   }
 
 
@@ -100,6 +105,10 @@ namespace Isis {
     p_gMap = new UniversalGroundMap(cube);
     p_gMap->SetBand(band);
 
+    // The walk tests the neighbors of each point, so recent points are
+    // tested again and again
+    if (p_gMap->Camera() != NULL) p_gMap->Camera()->SetGeometryCache(1000);
+
     p_cube = &cube;
 
     Camera *cam = NULL;
@@ -165,9 +174,6 @@ namespace Isis {
     /  If image contains 0/360 boundary, the polygon needs to be split up
     /  into multi polygons.
     /-----------------------------------------------------------------------*/
-    Pvl defaultMap;
-    cam->BasicMapping (defaultMap);
-
     // Create the polygon, fixing if needed
     Fix360Poly ();
 
@@ -577,6 +583,7 @@ std::cerr << std::endl;*/
     }
 
     FindSubpixel( points );
+    if (p_tolerance > 0.0) RefinePoints( points );
 
 // Prints out the sample/line polygon after subpixel adjustments; should be removed once the algorithm is "completed"
 /*geos::geom::CoordinateSequence * temp2 = new geos::geom::CoordinateArraySequence();
@@ -595,8 +602,8 @@ std::cerr << std::endl;*/
     for(unsigned int i = 0; i<points.size(); i++) {
       geos::geom::Coordinate *temp = &(points.at(i));
       SetImage (temp->x, temp->y);
-      lon = p_gMap->UniversalLongitude ();
-      lat = p_gMap->UniversalLatitude ();
+      lon = p_pointLongitude;
+      lat = p_pointLatitude;
       if (abs(lon - prevLon) >= 180 && i!=0 ) {
         crossingPoints->push_back(geos::geom::Coordinate(prevLon, prevLat));
       }
@@ -643,7 +650,7 @@ std::cerr << std::endl;*/
   */ 
   void ImagePolygon::FixPolePoly (std::vector<geos::geom::Coordinate> *crossingPoints) {
     // We currently do not support both poles in one image
-    if (p_gMap->SetUniversalGround (90,0) && p_gMap->SetUniversalGround (-90,0)) {
+    if (SetGround (90,0) && SetGround (-90,0)) {
       std::string msg = "Unable to create image footprint because image has both poles";
       throw iException::Message(iException::Programmer,msg,_FILEINFO_);
     } else if (crossingPoints->size() == 0) {
@@ -651,22 +658,22 @@ std::cerr << std::endl;*/
       return;
     }
 
-    if (p_gMap->SetUniversalGround (90,0)) {
+    if (SetGround (90,0)) {
       // If the (north) pole is settable but not within proper angles,
       //  then the polygon does not contain the (north) pole when the cube does
-      if (p_gMap->Camera()->EmissionAngle() > p_emission) {
+      if (p_poleEmission > p_emission) {
         return;
       }
-      if (p_gMap->Camera()->IncidenceAngle() > p_incidence) {
+      if (p_poleIncidence > p_incidence) {
         return;
       }
-    } else if (p_gMap->SetUniversalGround (-90,0)) {
+    } else if (SetGround (-90,0)) {
       // If the (south) pole is settable but not within proper angles,
       //  then the polygon does not contain the (south) pole when the cube does
-      if (p_gMap->Camera()->EmissionAngle() > p_emission) {
+      if (p_poleEmission > p_emission) {
         return;
       }
-      if (p_gMap->Camera()->IncidenceAngle() > p_incidence) {
+      if (p_poleIncidence > p_incidence) {
         return;
       }
     }
@@ -675,9 +682,9 @@ std::cerr << std::endl;*/
     geos::geom::Coordinate *pole = NULL;
 
     // Setup the right pole
-    if( p_gMap->SetUniversalGround(90,0) ){
+    if( SetGround(90,0) ){
       pole = new geos::geom::Coordinate(0,90);
-    } else if( p_gMap->SetUniversalGround(-90,0) ){
+    } else if( SetGround(-90,0) ){
       pole = new geos::geom::Coordinate(0,-90);
     } else if( crossingPoints->size() % 2 == 1 ) {
       geos::geom::Coordinate nPole( 0, 90 );
@@ -812,7 +819,10 @@ std::cerr << std::endl;*/
   /**
    * Sets the sample/line values of the cube to get lat/lon values.  This
    * method checks whether the image pixel is Null for level 2 images and
-   * if so, it is considered an invalid pixel.
+   * if so, it is considered an invalid pixel.  The latitude and longitude of
+   * the point are kept in p_pointLatitude and p_pointLongitude.  Level 1
+   * images use the camera's ImageGeometry, which answers points in its
+   * geometry cache without computing them again.
    * 
    * @param[in] sample   (const double)  Sample coordinate of the cube
    *
@@ -824,20 +834,29 @@ std::cerr << std::endl;*/
   bool ImagePolygon::SetImage (const double sample,const double line) {
     bool found = false;
     if (!p_isProjected) {
-      found = p_gMap->SetImage (sample,line);
+      Camera::Geometry geometry;
+      try {
+        found = p_gMap->Camera()->ImageGeometry (sample,line,geometry);
+      } catch (iException &error) {
+        // The angles could not be computed, so they are not checked
+        error.Clear();
+        found = p_gMap->SetImage (sample,line);
+        geometry.latitude = found ? p_gMap->UniversalLatitude () : Null;
+        geometry.longitude = found ? p_gMap->UniversalLongitude () : Null;
+        geometry.emission = Null;
+        geometry.incidence = Null;
+      }
+      p_pointLatitude = geometry.latitude;
+      p_pointLongitude = geometry.longitude;
       if (!found) {
         return false;
       } else {
         // Check for valid emission and incidence
-        try {
-          if (p_gMap->Camera()->EmissionAngle() > p_emission) {
-            return false;
-          }
-          if (p_gMap->Camera()->IncidenceAngle() > p_incidence) {
-            return false;
-          }
-        } catch (iException &error) {
-          error.Clear();
+        if (geometry.emission > p_emission) {
+          return false;
+        }
+        if (geometry.incidence > p_incidence) {
+          return false;
         }
 
         /**
@@ -867,6 +886,8 @@ std::cerr << std::endl;*/
         return false;
       } else {
         found = p_gMap->SetImage (sample,line);
+        p_pointLatitude = p_gMap->UniversalLatitude ();
+        p_pointLongitude = p_gMap->UniversalLongitude ();
         if (!found) {
           return false;
         } else {
@@ -888,6 +909,36 @@ std::cerr << std::endl;*/
   }
 
 
+  /**
+   * Sets a ground point, as UniversalGroundMap::SetUniversalGround does.  When
+   * the cube has a camera its GroundGeometry is used, so the poles, which
+   * are tested several times, are computed once.  The emission and incidence
+   * angles of the point are kept in p_poleEmission and p_poleIncidence.
+   *
+   * @param latitude Universal latitude of the point
+   * @param longitude Universal longitude of the point
+   *
+   * @return bool Returns true if the point is in the cube
+   */
+  bool ImagePolygon::SetGround (const double latitude, const double longitude) {
+    Camera *cam = p_gMap->Camera();
+    if (cam == NULL) {
+      if (!p_gMap->SetUniversalGround (latitude,longitude)) return false;
+      p_poleEmission = Null;
+      p_poleIncidence = Null;
+      return true;
+    }
+
+    Camera::Geometry geometry;
+    if (!cam->GroundGeometry (latitude,longitude,geometry)) return false;
+    p_poleEmission = geometry.emission;
+    p_poleIncidence = geometry.incidence;
+    return geometry.sample >= 0.5 && geometry.line >= 0.5 &&
+           geometry.sample <= cam->Samples() + 0.5 &&
+           geometry.line <= cam->Lines() + 0.5;
+  }
+
+
  /**
   * If the cube crosses the 0/360 boundary and does not include a pole, the 
   * polygon is separated into multiple polygons, usually one on each side of the 
@@ -1351,5 +1402,81 @@ std::cerr << std::endl;*/
   }
 
 
+  /**
+   * Adds points between the walked points where the image edge curves on the
+   * ground, see RefinementTolerance.  The points are in sample/line space and
+   * the first and last are the same.
+   *
+   * @param points The vector of Coordinate to add points to
+   */
+  void ImagePolygon::RefinePoints( std::vector<geos::geom::Coordinate> & points ) {
+    vector<geos::geom::Coordinate> ground;
+    vector<bool> valid;
+    for (unsigned int i = 0; i < points.size(); i++) {
+      valid.push_back(SetImage(points[i].x, points[i].y));
+      ground.push_back(geos::geom::Coordinate(p_pointLongitude,
+                                              p_pointLatitude));
+    }
+
+    vector<geos::geom::Coordinate> refined;
+    for (unsigned int i = 0; i < points.size(); i++) {
+      refined.push_back(points[i]);
+      if (i+1 < points.size() && valid[i] && valid[i+1]) {
+        RefineEdge(points[i], ground[i], points[i+1], ground[i+1], 0, refined);
+      }
+    }
+
+    points = refined;
+  }
+
+
+  /**
+   * Adds the point halfway between two points on the image edge, and then
+   * the points needed on either side of it, if the halfway point is further
+   * than the tolerance from the line joining the two on the ground.  Halving
+   * stops at one pixel or ten levels.
+   *
+   * @param start The first point in sample/line space
+   * @param startGround The longitude and latitude of start
+   * @param end The second point in sample/line space
+   * @param endGround The longitude and latitude of end
+   * @param depth The number of times the edge has been halved
+   * @param points The vector of Coordinate to add points to
+   */
+  void ImagePolygon::RefineEdge(const geos::geom::Coordinate &start,
+                                const geos::geom::Coordinate &startGround,
+                                const geos::geom::Coordinate &end,
+                                const geos::geom::Coordinate &endGround,
+                                int depth, vector<geos::geom::Coordinate> &points) {
+    if (depth >= 10 || DistanceSquared(&start, &end) <= 1.0) return;
+
+    geos::geom::Coordinate middle((start.x + end.x) / 2.0,
+                                  (start.y + end.y) / 2.0);
+    if (!InsideImage(middle.x, middle.y) || !SetImage(middle.x, middle.y)) {
+      return;
+    }
+    geos::geom::Coordinate middleGround(p_pointLongitude, p_pointLatitude);
+
+    // Compare the longitudes on the same side of the 0/360 boundary
+    double endLon = endGround.x;
+    if (endLon - startGround.x > 180.0) endLon -= 360.0;
+    if (endLon - startGround.x < -180.0) endLon += 360.0;
+    double middleLon = middleGround.x;
+    if (middleLon - startGround.x > 180.0) middleLon -= 360.0;
+    if (middleLon - startGround.x < -180.0) middleLon += 360.0;
+
+    geos::geom::Coordinate halfway((startGround.x + endLon) / 2.0,
+                                   (startGround.y + endGround.y) / 2.0);
+    geos::geom::Coordinate unwrapped(middleLon, middleGround.y);
+    if (DistanceSquared(&halfway, &unwrapped) <= p_tolerance * p_tolerance) {
+      return;
+    }
+
+    RefineEdge(start, startGround, middle, middleGround, depth + 1, points);
+    points.push_back(middle);
+    RefineEdge(middle, middleGround, end, endGround, depth + 1, points);
+  }
+
+
 } // end namespace isis
 
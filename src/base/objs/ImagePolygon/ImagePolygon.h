@@ -149,6 +149,19 @@ namespace Isis {
  *  @history 2010-02-17 Christopher Austin - Fixed two more infinite looping
  *           issues, including a cycle fix which occured during Emission Angle
  *           and Incidence Angle restrictions
+ *  @history 2026-10-18 Unknown - Added RefinementTolerance, which adds points
+ *           between the walked points where the footprint curves on the ground.
+ *           Create no longer computes the camera ground range, which it did not
+ *           use.
+ *  @history 2026-10-18 Unknown - Points and poles are tested with the camera's
+ *           ImageGeometry and GroundGeometry, and Create enables the camera's
+ *           geometry cache, so points the walk tests again are not computed
+ *           again.
+ *  @history 2026-10-18 Unknown - SetImage and SetGround hold NaifStatus::Mutex,
+ *           so footprints can be walked in several threads.
+ *  @history 2026-10-18 Unknown - SetImage and SetGround no longer hold
+ *           NaifStatus::Mutex. The camera holds it only around its NAIF calls,
+ *           so footprints walked in several threads overlap.
  */
 
   class ImagePolygon : public Isis::Blob {
@@ -192,6 +205,21 @@ namespace Isis {
        */
       void SubpixelAccuracy(int div) { p_subpixelAccuracy = div; }
 
+      /**
+       * Set how far, in degrees, the footprint may be from the image edge
+       * between two walked points.  Where the edge halfway between two points
+       * is further than this from the line joining them on the ground, the
+       * halfway point is added and both halves are checked again.  Points are
+       * added only where the edge curves on the ground, so a large sample
+       * and line increment can be used with an accurate result.
+       *
+       * ImagePolygon's constructor sets a default value of 0, which adds no
+       * points.
+       *
+       * @param tolerance The tolerance in degrees
+       */
+      void RefinementTolerance(double tolerance) { p_tolerance = tolerance; }
+
       //!  Return a geos Multipolygon
       geos::geom::MultiPolygon *Polys () { return p_polygons; };
 
@@ -204,6 +232,7 @@ namespace Isis {
       // Please do not add new polygon manipulation methods to this class.
       // Polygon manipulation should be done in the PolygonTools class.
       bool SetImage (const double sample, const double line);
+      bool SetGround (const double latitude, const double longitude);
 
       geos::geom::Coordinate FindFirstPoint ();
       void WalkPoly ();
@@ -226,6 +255,12 @@ namespace Isis {
 					   geos::geom::Coordinate newPoint);
 
       void FindSubpixel( std::vector<geos::geom::Coordinate> & points);
+      void RefinePoints( std::vector<geos::geom::Coordinate> & points);
+      void RefineEdge(const geos::geom::Coordinate &start,
+                      const geos::geom::Coordinate &startGround,
+                      const geos::geom::Coordinate &end,
+                      const geos::geom::Coordinate &endGround,
+                      int depth, std::vector<geos::geom::Coordinate> &points);
 
       Cube *p_cube;       //!< The cube provided
       bool p_isProjected; //!< True when the provided cube is projected
@@ -253,6 +288,12 @@ namespace Isis {
       bool p_ellipsoid;   //!< Uses an ellipsoid if a limb is detected
 
       int p_subpixelAccuracy; //!< The subpixel accuracy to use
+      double p_tolerance;     //!< Distance in degrees that adds points to an edge
+
+      double p_pointLatitude;  //!< Universal latitude of the last SetImage point
+      double p_pointLongitude; //!< Universal longitude of the last SetImage point
+      double p_poleEmission;   //!< Emission angle of the last SetGround point
+      double p_poleIncidence;  //!< Incidence angle of the last SetGround point
 
   };
 };
@@ -41,6 +41,7 @@ namespace Isis {
    * @history 2005-02-09 Jeff Anderson
    * Original version
    * @history 2009-03-07 Debbie A. Cook Removed reference to obsolute CameraDetectorMap methods
+ * @history 2026-10-17 Unknown - Added StartTime method
    *
    */
   class LineScanCameraDetectorMap : public CameraDetectorMap {
@@ -88,6 +89,9 @@ namespace Isis {
       //! Return the time in seconds between scan lines
       double LineRate () const { return p_lineRate; };
 
+      //! Return the starting ephemeris time at the top of the first line
+      double StartTime () const { return p_etStart; };
+
       virtual bool SetParent(const double sample, const double line);
 
       virtual bool SetDetector(const double sample, const double line);
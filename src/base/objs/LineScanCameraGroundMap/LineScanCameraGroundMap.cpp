@@ -56,6 +56,17 @@ namespace Isis {
    * @return conversion was successful
    */
   bool LineScanCameraGroundMap::SetGround(const double lat, const double lon, const double radius) {
+    // Points are usually converted one after another across the image, so
+    // the point was likely imaged near the last point found.  Look only in
+    // a window around that line without widening it, so a point that is not
+    // there only costs the bounding evaluations of that window before the
+    // search over the whole image.
+    if (p_lastLine >= 0) {
+      if (FindFocalPlane(p_lastLine, lat, lon, radius, false) == Success) {
+        return true;
+      }
+    }
+
     FindFocalPlaneStatus status = FindFocalPlane(-1, lat, lon, radius );
 
     if(status == Success) return true;
@@ -100,6 +111,19 @@ namespace Isis {
     return false;
   }
 
+  /** Returns the parent line imaged at the time found by FindFocalPlane
+   *
+   * @return the parent line of the last point found
+   */
+  int LineScanCameraGroundMap::SolvedLine() {
+    LineScanCameraDetectorMap *detectorMap =
+      (LineScanCameraDetectorMap *) p_camera->DetectorMap();
+    double etDiff = p_camera->EphemerisTime() - detectorMap->StartTime();
+    int line = (int) (etDiff / detectorMap->LineRate() + 0.5);
+    if (line < 0) line = 0;
+    return line;
+  }
+
   double LineScanCameraGroundMap::FindSpacecraftDistance(int line, const double lat, const double lon) {
     CameraDetectorMap *detectorMap = p_camera->DetectorMap();
     detectorMap->SetParent(p_camera->ParentSamples() / 2, line);
@@ -110,7 +134,8 @@ namespace Isis {
 
   LineScanCameraGroundMap::FindFocalPlaneStatus 
     LineScanCameraGroundMap::FindFocalPlane(const int &approxLine, const double &lat, 
-                                            const double &lon, const double &radius) {
+                                            const double &lon, const double &radius,
+                                            const bool widen) {
     // find middle time; cache time starting points vary
     double approxTime = 0.0;
     double lineRate = 0.0;
@@ -258,7 +283,7 @@ namespace Isis {
       if ((startOffset > 0.0) && (endOffset > 0.0)) bounded = false;
 
       if(!bounded) {
-        if(startTimeMaxed || endTimeMaxed) {
+        if(!widen || startTimeMaxed || endTimeMaxed) {
           return BoundingProblem;
         }
 
@@ -326,6 +351,7 @@ namespace Isis {
         if (checkHidden) {
           p_focalPlaneX = ux;
           p_focalPlaneY = uy;
+          p_lastLine = SolvedLine();
           return Success;
         }
         else {
@@ -52,6 +52,13 @@ namespace Isis {
    *            fails. The spacecraft position at the beginning and end of the
    *            image are now being used to estimate the correct line if the
    *            bounding check fails the first time through.
+   *   @history 2026-10-17 Unknown - Added a SetGround method converting a
+   *            series of ground points, each starting from the line of the
+   *            previous one
+   *   @history 2026-10-18 Unknown - Removed the series SetGround. The single
+   *            point SetGround now first searches a window around the line
+   *            of the last point found, and only searches the whole image if
+   *            the point is not in that window.
    * 
    */
   class LineScanCameraGroundMap : public CameraGroundMap {
@@ -60,7 +67,8 @@ namespace Isis {
        * 
        * @param cam pointer to camera model
        */
-      LineScanCameraGroundMap(Camera *cam) : CameraGroundMap(cam) {};
+      LineScanCameraGroundMap(Camera *cam) : CameraGroundMap(cam),
+                                             p_lastLine(-1) {};
   
       //! Destructor
       virtual ~LineScanCameraGroundMap() {};
@@ -76,8 +84,13 @@ namespace Isis {
       };
 
       FindFocalPlaneStatus FindFocalPlane(const int &approxLine, 
-                           const double &lat, const double &lon, const double &radius); 
+                           const double &lat, const double &lon, const double &radius,
+                           const bool widen = true); 
       double FindSpacecraftDistance(int line, const double lat, const double lon);
+      int SolvedLine();
+
+    private:
+      int p_lastLine; //!< Parent line of the last point found, or -1
   };
 };
 #endif
@@ -5,16 +5,9 @@
 namespace Isis {
   double MaximumCorrelation::MatchAlgorithm (Chip &pattern, Chip &subsearch) {    
     MultivariateStatistics mv;
-    std::vector <double> pdn, sdn;
-    pdn.resize(pattern.Samples());
-    sdn.resize(pattern.Samples());
-
     for (int l=1; l<=pattern.Lines(); l++) {
-      for (int s=1; s<=pattern.Samples(); s++) {
-        pdn[s-1] = pattern.GetValue(s,l);
-        sdn[s-1] = subsearch.GetValue(s,l);
-      }
-      mv.AddData(&pdn[0],&sdn[0], pattern.Samples());
+      mv.AddData(pattern.LineBuffer(l), subsearch.LineBuffer(l),
+                 pattern.Samples());
     }
     double percentValid = (double) mv.ValidPixels() / 
                      (pattern.Lines() * pattern.Samples());
@@ -46,6 +46,8 @@ namespace Isis {
    * @internal
    *   @history 2006-01-11 Jacob Danton Added idealFit value, unitTest
    *   @history 2006-03-08 Jacob Danton Added sampling options
+   *   @history 2026-10-17 Unknown - Pass the chip lines to
+   *            MultivariateStatistics directly instead of copying them
    */
   class MaximumCorrelation : public AutoReg {
     public:
@@ -49,13 +49,12 @@ namespace Isis {
 
     double diff = 0.0;
     double count = 0;
-    for (double l=1.0; l <= pattern.Lines(); l++) {
-      for (double s=1.0; s <= pattern.Samples(); s++) {
-        int line = (int)l;
-        int samp = (int)s;
-
-        double pdn = pattern.GetValue(samp,line);
-        double sdn = subsearch.GetValue(samp,line);
+    for (int line=1; line <= pattern.Lines(); line++) {
+      const double *pbuf = pattern.LineBuffer(line);
+      const double *sbuf = subsearch.LineBuffer(line);
+      for (int samp=0; samp < pattern.Samples(); samp++) {
+        double pdn = pbuf[samp];
+        double sdn = sbuf[samp];
         if (IsSpecial(pdn)) continue;
         if (IsSpecial(sdn)) continue;
         diff += fabs(pdn - sdn);
@@ -53,6 +53,8 @@ namespace Isis {
    *   @history 2006-03-08 Jacob DAnton Added sampling options
    *   @history 2006-03-20 Jacob Danton Changed to *average* minimum
    *                                     difference algorithm.
+   *   @history 2026-10-17 Unknown - Walk the chip lines directly instead of
+   *                       getting each pixel.
    */                                                                       
   class MinimumDifference : public AutoReg {
     public:
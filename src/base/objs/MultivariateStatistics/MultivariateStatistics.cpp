@@ -21,6 +21,7 @@
  *   http://www.usgs.gov/privacy.html.                                    
  */                                                                       
 
+#include <algorithm>
 #include <float.h>
 #include <string>
 #include <iostream>
@@ -61,21 +62,38 @@ namespace Isis {
  */                                                                         
   void MultivariateStatistics::AddData (const double *x, const double *y, 
                              const unsigned int count) {
-    for (unsigned int i=0; i<count; i++) {
-      double yVal = y[i];
-      double xVal = x[i];
-      p_totalPixels++;
+    // The valid pairs are gathered a block at a time and added to the x and y
+    // statistics as arrays, which Statistics::AddData vectorizes.  The sum of
+    // the products of each block is added to the total, as the sums are there.
+    const unsigned int block = 256;
+    double validX[block];
+    double validY[block];
 
-      if (Isis::IsValidPixel(xVal) && Isis::IsValidPixel(yVal)) {
-        p_x.AddData(xVal);
-        p_y.AddData(yVal);
-        p_sumxy += xVal * yVal;
-        p_validPixels++;
-      }
-      else {
-        p_invalidPixels++;
+    unsigned int i = 0;
+    while (i < count) {
+      unsigned int start = i;
+      unsigned int end = std::min(count, i + block);
+      unsigned int valid = 0;
+      double sumxy = 0.0;
+      for ( ; i<end; i++) {
+        double xVal = x[i];
+        double yVal = y[i];
+        // Stored whether or not they are valid, and kept only if they are
+        validX[valid] = xVal;
+        validY[valid] = yVal;
+        if (Isis::IsValidPixel(xVal) && Isis::IsValidPixel(yVal)) {
+          sumxy += xVal * yVal;
+          valid++;
+        }
       }
+
+      p_x.AddData(validX, valid);
+      p_y.AddData(validY, valid);
+      p_sumxy += sumxy;
+      p_validPixels += valid;
+      p_invalidPixels += (end - start) - valid;
     }
+    p_totalPixels += count;
   }
 
 /**                                                                       
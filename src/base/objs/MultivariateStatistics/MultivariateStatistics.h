@@ -50,6 +50,8 @@ namespace Isis {
  *   @history 2005-03-28 Leah Dahmer modified file to support Doxygen 
  *    documentation.
  *   @history 2005-05-23 Jeff Anderson - Added 2GB+ file support
+ *   @history 2026-10-18 Unknown - AddData adds the valid pairs to the x and y
+ *            statistics a block at a time, so they are vectorized
  * 
  *   @todo This class needs an example.
  *   @todo For the below methods we will need to compute log x, loy y, sumx3, 
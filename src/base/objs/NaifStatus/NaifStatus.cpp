@@ -27,9 +27,26 @@
 #include "PvlTranslationManager.h"
 #include <iostream>
 
+#include <QMutex>
+#include <QMutexLocker>
+
 namespace Isis {
   bool NaifStatus::initialized = false;
 
+  //! Serializes the use of the NAIF kernel pool, see NaifStatus::Mutex
+  static QMutex naifMutex(QMutex::Recursive);
+
+  /**
+   * Returns the mutex that serializes the use of the NAIF kernel pool and
+   * error state.  It is recursive, so code holding it can call other code
+   * that locks it.
+   *
+   * @return QMutex* The mutex
+   */
+  QMutex *NaifStatus::Mutex() {
+    return &naifMutex;
+  }
+
   /** 
    * This method looks for any naif errors that might have occurred. It 
    * then compares the error to a list of known naif errors and converts
@@ -38,6 +55,8 @@ namespace Isis {
    * @param resetNaif True if the NAIF error status should be reset (naif calls valid)
    */
   void NaifStatus::CheckErrors(bool resetNaif) {
+    QMutexLocker lock(&naifMutex);
+
     if(!initialized) {
       SpiceChar returnAct[32] = "RETURN";
       SpiceChar printAct[32] = "NONE";
@@ -23,6 +23,8 @@
  *   http://www.usgs.gov/privacy.html.
  */
 
+class QMutex;
+
 namespace Isis {
 /**
  * @brief Class for checking for errors in the NAIF library
@@ -30,12 +32,24 @@ namespace Isis {
  * The Naif Status class looks for errors that have occurred in NAIF calls. If 
  * an error has occurred, it will be converted to an iException.
  * 
+ * NAIF keeps its kernel pool and error state for the whole program, so only
+ * one thread can use them at a time.  Code that loads or reads kernels, or
+ * calls a NAIF routine which can signal an error (such as surfpt_c or
+ * m2eul_c), locks Mutex() around those calls.  CheckErrors locks it itself.
+ * The vector and matrix routines (vsub_c, mxv_c, rotate_c and the like) keep
+ * no state and are called without it, so threads with their own cameras
+ * only wait on each other inside NAIF.
+ *
  * @author 2008-06-13 Steven Lambright
  *
+ * @internal
+ *   @history 2026-10-18 Unknown - Added Mutex
+ *   @history 2026-10-18 Unknown - CheckErrors locks Mutex
  */
   class NaifStatus {
     public:
       static void CheckErrors(bool resetNaif = true);
+      static QMutex *Mutex();
     private:
       static bool initialized;
   };
@@ -0,0 +1,295 @@
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include "OrderFilter.h"
+
+#include <float.h>
+
+#include "Buffer.h"
+#include "iException.h"
+#include "iString.h"
+#include "SpecialPixel.h"
+
+using namespace std;
+namespace Isis {
+
+  /**
+   * Constructs an OrderFilter for boxcars of the given size
+   *
+   * @param width Width of the boxcar
+   * @param height Height of the boxcar
+   *
+   * @throws Isis::iException::Programmer
+   */
+  OrderFilter::OrderFilter(const int width, const int height) {
+    if (width < 1 || height < 1) {
+      string msg = "The boxcar size [" + iString(width) + "x" +
+                   iString(height) + "] must be at least one by one in "
+                   "OrderFilter constructor";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+
+    p_width = width;
+    p_height = height;
+    p_minimum = -DBL_MAX;
+    p_maximum = DBL_MAX;
+    p_columns.resize(width * height);
+    p_countsKept = false;
+    Reset();
+  }
+
+
+  /**
+   * Sets the minimum and maximum valid pixel values.  The filter is reset, so
+   * the next boxcar is loaded from scratch.
+   *
+   * @param minimum Minimum valid pixel value
+   * @param maximum Maximum valid pixel value
+   *
+   * @throws Isis::iException::Programmer
+   */
+  void OrderFilter::SetMinMax(const double minimum, const double maximum) {
+    if (minimum >= maximum) {
+      string msg = "Minimum must be less than maximum in "
+                   "OrderFilter::SetMinMax";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+
+    p_minimum = minimum;
+    p_maximum = maximum;
+    Reset();
+  }
+
+
+  //! Empties the filter, so the next boxcar is loaded from scratch
+  void OrderFilter::Reset() {
+    p_values.clear();
+    p_rank = -1;
+    p_counts.clear();
+    p_modes.clear();
+    p_firstColumn = 0;
+    p_loaded = false;
+  }
+
+
+  /**
+   * Loads a boxcar.  If the boxcar is on the line and band of the last one
+   * loaded and has moved right by less than the width of the boxcar, only the
+   * columns which have changed are loaded.
+   *
+   * @param box The boxcar, of the size given to the constructor
+   *
+   * @throws Isis::iException::Programmer
+   */
+  void OrderFilter::Load(const Buffer &box) {
+    if (box.SampleDimension() != p_width || box.LineDimension() != p_height) {
+      string msg = "The buffer size [" + iString(box.SampleDimension()) + "x" +
+                   iString(box.LineDimension()) + "] does not match the "
+                   "boxcar size [" + iString(p_width) + "x" +
+                   iString(p_height) + "] in OrderFilter::Load";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+
+    const double *data = box.DoubleBuffer();
+    int shift = box.Sample() - p_sample;
+    if (p_loaded && box.Line() == p_line && box.Band() == p_band &&
+        shift > 0 && shift < p_width) {
+      // Replace the columns which left the boxcar by the ones which entered it
+      for (int c=0; c<shift; c++) {
+        double *column = &p_columns[((p_firstColumn + c) % p_width) * p_height];
+        int index = p_width - shift + c;
+        for (int l=0; l<p_height; l++) {
+          RemoveValue(column[l]);
+          column[l] = data[index];
+          AddValue(column[l]);
+          index += p_width;
+        }
+      }
+      p_firstColumn = (p_firstColumn + shift) % p_width;
+    }
+    else {
+      bool countsKept = p_countsKept;
+      Reset();
+      p_countsKept = countsKept;
+      for (int c=0; c<p_width; c++) {
+        double *column = &p_columns[c * p_height];
+        int index = c;
+        for (int l=0; l<p_height; l++) {
+          column[l] = data[index];
+          AddValue(column[l]);
+          index += p_width;
+        }
+      }
+    }
+
+    p_loaded = true;
+    p_sample = box.Sample();
+    p_line = box.Line();
+    p_band = box.Band();
+  }
+
+
+  /**
+   * Returns the median of the valid pixels in the boxcar.  With an even
+   * number of valid pixels this is the lower of the middle two.
+   *
+   * @return double
+   */
+  double OrderFilter::Median() {
+    return Percentile(50.0);
+  }
+
+
+  /**
+   * Returns the value below which the given percent of the other valid
+   * pixels in the boxcar lie, which is the valid pixel of rank
+   * (int)((Count() - 1) * percent / 100).  This is quickest when the same
+   * percent is asked for as the boxcar slides, as the pixel of the last rank
+   * asked for is kept.
+   *
+   * @param percent The percent, from 0 to 100
+   *
+   * @return double
+   *
+   * @throws Isis::iException::Programmer
+   */
+  double OrderFilter::Percentile(const double percent) {
+    if (percent < 0.0 || percent > 100.0) {
+      string msg = "The percent [" + iString(percent) + "] must be between 0 "
+                   "and 100 in OrderFilter::Percentile";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+    if (p_values.empty()) return Null;
+
+    int rank = (int)((p_values.size() - 1) * percent / 100.0);
+    if (p_rank < 0) {
+      p_rankValue = p_values.begin();
+      p_rank = 0;
+    }
+    while (p_rank < rank) {
+      ++p_rankValue;
+      p_rank++;
+    }
+    while (p_rank > rank) {
+      --p_rankValue;
+      p_rank--;
+    }
+    return *p_rankValue;
+  }
+
+
+  /**
+   * Returns the most frequent valid pixel value in the boxcar, or the lowest
+   * of them if several are equally frequent.  The counts of the values are
+   * only kept once this has been called.
+   *
+   * @return double
+   */
+  double OrderFilter::Mode() {
+    if (!p_countsKept) {
+      p_countsKept = true;
+      multiset<double>::iterator value = p_values.begin();
+      while (value != p_values.end()) {
+        multiset<double>::iterator next = p_values.upper_bound(*value);
+        int count = 0;
+        for (multiset<double>::iterator i = value; i != next; ++i) count++;
+        p_counts[*value] = count;
+        p_modes.insert(make_pair(-count, *value));
+        value = next;
+      }
+    }
+
+    if (p_modes.empty()) return Null;
+    return p_modes.begin()->second;
+  }
+
+
+  /**
+   * Adds a pixel to the boxcar if it is valid
+   *
+   * @param value The pixel
+   */
+  void OrderFilter::AddValue(const double value) {
+    if (IsSpecial(value) || value < p_minimum || value > p_maximum) return;
+
+    // Equal values are inserted after those already there, so only a lower
+    // value changes the rank of p_rankValue
+    if (p_rank >= 0 && value < *p_rankValue) p_rank++;
+    p_values.insert(value);
+
+    if (p_countsKept) CountValue(value, 1);
+  }
+
+
+  /**
+   * Removes a pixel from the boxcar if it is valid
+   *
+   * @param value The pixel, which must have been added
+   */
+  void OrderFilter::RemoveValue(const double value) {
+    if (IsSpecial(value) || value < p_minimum || value > p_maximum) return;
+
+    multiset<double>::iterator pos;
+    if (p_rank >= 0 && value == *p_rankValue) {
+      // Remove the pixel p_rankValue refers to, moving it to a neighbor
+      pos = p_rankValue;
+      multiset<double>::iterator next = pos;
+      ++next;
+      if (next != p_values.end()) {
+        p_rankValue = next;
+      }
+      else if (pos != p_values.begin()) {
+        --p_rankValue;
+        p_rank--;
+      }
+      else {
+        p_rank = -1;
+      }
+    }
+    else {
+      pos = p_values.find(value);
+      if (pos == p_values.end()) return;
+      if (p_rank >= 0 && value < *p_rankValue) p_rank--;
+    }
+    p_values.erase(pos);
+
+    if (p_countsKept) CountValue(value, -1);
+  }
+
+
+  /**
+   * Changes the count of a pixel value, for Mode
+   *
+   * @param value The pixel value
+   * @param change The change in its count
+   */
+  void OrderFilter::CountValue(const double value, const int change) {
+    int &count = p_counts[value];
+    if (count > 0) p_modes.erase(make_pair(-count, value));
+    count += change;
+    if (count > 0) {
+      p_modes.insert(make_pair(-count, value));
+    }
+    else {
+      p_counts.erase(value);
+    }
+  }
+}
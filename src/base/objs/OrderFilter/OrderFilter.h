@@ -0,0 +1,127 @@
+#ifndef OrderFilter_h
+#define OrderFilter_h
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace Isis {
+  class Buffer;
+
+  /**
+   * @brief Order statistics of a sliding boxcar
+   *
+   * This class computes the median, percentiles and mode of the valid pixels
+   * in an NxM boxcar.  Where QuickFilter keeps running sums for averages,
+   * this class keeps the valid pixels of the boxcar sorted.  When the boxcar
+   * loaded has moved right along the same line by less than its width, only
+   * the columns which left the boxcar are removed and the columns which
+   * entered it are added, so each pixel costs O(M log NM) rather than the
+   * O(NM log NM) of sorting the whole boxcar.  Any other boxcar is loaded
+   * from scratch.
+   *
+   * The boxcars given to a ProcessByBoxcar function move one sample at a
+   * time, so the filter is simply loaded with each of them:
+   * @code
+   *   Isis::OrderFilter filter(5, 5);
+   *
+   *   void Median(Isis::Buffer &in, double &v) {
+   *     filter.Load(in);
+   *     v = filter.Median();
+   *   }
+   * @endcode
+   *
+   * A valid pixel is one which is not special and is inside the range given
+   * to SetMinMax.  Median, Percentile and Mode return Null when there are no
+   * valid pixels.
+   *
+   * @ingroup Statistics
+   *
+   * @see QuickFilter
+   * @see ProcessByBoxcar
+   *
+   * @author 2026-10-18 Unknown
+   *
+   * @internal
+   */
+  class OrderFilter {
+    public:
+      OrderFilter(const int width, const int height);
+      ~OrderFilter() {};
+
+      void SetMinMax(const double minimum, const double maximum);
+      void Load(const Buffer &box);
+      void Reset();
+
+      //! Returns the width of the boxcar
+      int Width() const { return p_width; };
+      //! Returns the height of the boxcar
+      int Height() const { return p_height; };
+      //! Returns the number of valid pixels in the boxcar
+      int Count() const { return (int)p_values.size(); };
+
+      double Median();
+      double Percentile(const double percent);
+      double Mode();
+
+    private:
+      void AddValue(const double value);
+      void RemoveValue(const double value);
+      void CountValue(const double value, const int change);
+
+      int p_width;        //!< Width of the boxcar
+      int p_height;       //!< Height of the boxcar
+      double p_minimum;   //!< Minimum valid pixel value
+      double p_maximum;   //!< Maximum valid pixel value
+
+      //! Sorted valid pixels of the boxcar
+      std::multiset<double> p_values;
+      //! The value of rank p_rank in p_values, kept as values come and go
+      std::multiset<double>::iterator p_rankValue;
+      int p_rank;         //!< Rank of p_rankValue, or -1 if it is not set
+
+      /**
+       * The pixels of the boxcar, a column of p_height pixels at a time.
+       * Column c of the boxcar is column (p_firstColumn + c) % p_width here,
+       * so a column leaving the boxcar is replaced by the one entering it.
+       */
+      std::vector<double> p_columns;
+      int p_firstColumn;  //!< Column of p_columns holding the left column
+      bool p_loaded;      //!< Has a boxcar been loaded since the last reset
+      int p_sample;       //!< Sample of the last boxcar loaded
+      int p_line;         //!< Line of the last boxcar loaded
+      int p_band;         //!< Band of the last boxcar loaded
+
+      bool p_countsKept;  //!< Are p_counts and p_modes kept up to date
+      //! Number of times each valid pixel value occurs in the boxcar
+      std::map<double, int> p_counts;
+      /**
+       * The (negated count, value) pairs of p_counts, so the first is the
+       * most frequent value, the lowest of them if several are
+       */
+      std::set< std::pair<int, double> > p_modes;
+  };
+};
+
+#endif
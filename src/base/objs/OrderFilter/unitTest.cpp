@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <float.h>
+#include <iostream>
+#include <vector>
+
+#include "Buffer.h"
+#include "iException.h"
+#include "iString.h"
+#include "OrderFilter.h"
+#include "Preference.h"
+#include "SpecialPixel.h"
+
+using namespace Isis;
+using namespace std;
+
+// A boxcar which can be moved over the test image
+class TestBox : public Buffer {
+  public:
+    TestBox(const int width, const int height) :
+      Buffer(width, height, 1, Real) {
+    }
+
+    void Move(const int sample, const int line) {
+      SetBasePosition(sample, line, 1);
+    }
+};
+
+const int samples = 15;
+const int lines = 6;
+double image[lines][samples];
+
+// Loads the boxcar with its upper left corner at sample s, line l
+void Fill(TestBox &box, const int s, const int l) {
+  box.Move(s, l);
+  for (int i=0; i<box.size(); i++) {
+    int is = s + i % box.SampleDimension();
+    int il = l + i / box.SampleDimension();
+    if (is < 1 || is > samples || il < 1 || il > lines) {
+      box[i] = Null;
+    }
+    else {
+      box[i] = image[il-1][is-1];
+    }
+  }
+}
+
+// The statistics computed by sorting the boxcar
+void Sorted(TestBox &box, double low, double high, double percent,
+            double &median, double &percentile, double &mode) {
+  vector<double> values;
+  for (int i=0; i<box.size(); i++) {
+    if (!IsSpecial(box[i]) && box[i] >= low && box[i] <= high) {
+      values.push_back(box[i]);
+    }
+  }
+  median = percentile = mode = Null;
+  if (values.empty()) return;
+
+  sort(values.begin(), values.end());
+  median = values[(values.size()-1)/2];
+  percentile = values[(int)((values.size()-1) * percent / 100.0)];
+  int best = 0;
+  for (unsigned int i=0; i<values.size(); ) {
+    unsigned int j = i;
+    while (j < values.size() && values[j] == values[i]) j++;
+    if ((int)(j - i) > best) {
+      best = j - i;
+      mode = values[i];
+    }
+    i = j;
+  }
+}
+
+// Slides the boxcar over every line, moving it by step samples, and returns
+// the number of statistics which differ from sorting
+int Compare(OrderFilter &filter, double low, double high, double percent,
+            int step) {
+  TestBox box(filter.Width(), filter.Height());
+  int differences = 0;
+  for (int l=1-filter.Height()/2; l<=lines-filter.Height()/2; l++) {
+    for (int s=1-filter.Width()/2; s<=samples-filter.Width()/2; s+=step) {
+      Fill(box, s, l);
+      filter.Load(box);
+      double median, percentile, mode;
+      Sorted(box, low, high, percent, median, percentile, mode);
+      if (filter.Median() != median) differences++;
+      if (filter.Percentile(percent) != percentile) differences++;
+      if (filter.Mode() != mode) differences++;
+    }
+  }
+  return differences;
+}
+
+string Show(double value) {
+  if (IsNullPixel(value)) return "Null";
+  return iString(value);
+}
+
+int main () {
+  Preference::Preferences(true);
+
+  // An image of small integers, so values repeat, with some special pixels
+  unsigned int seed = 12345;
+  for (int l=0; l<lines; l++) {
+    for (int s=0; s<samples; s++) {
+      seed = seed * 1103515245 + 12345;
+      image[l][s] = (double)((seed / 65536) % 10);
+    }
+  }
+  image[1][3] = Null;
+  image[2][7] = Hrs;
+  image[4][0] = Lis;
+  for (int l=3; l<6; l++) {
+    for (int s=10; s<13; s++) image[l][s] = Null;
+  }
+
+  cout << "Unit Test for OrderFilter Object" << endl;
+  cout << "--------------------------------" << endl;
+
+  OrderFilter filter(3, 3);
+  cout << "Boxcar Width:  " << filter.Width() << endl;
+  cout << "Boxcar Height: " << filter.Height() << endl;
+  cout << endl;
+
+  cout << "Sliding a 3x3 boxcar along line 3" << endl;
+  TestBox box(3, 3);
+  for (int s=1; s<=samples; s++) {
+    Fill(box, s - 1, 2);
+    filter.Load(box);
+    cout << "  Sample " << s << ": Count = " << filter.Count()
+         << ", Median = " << Show(filter.Median())
+         << ", Percentile(25) = " << Show(filter.Percentile(25.0))
+         << ", Mode = " << Show(filter.Mode()) << endl;
+  }
+  cout << endl;
+
+  cout << "Comparing to sorting each boxcar" << endl;
+  OrderFilter small(3, 3);
+  cout << "  3x3 boxcar:                  "
+       << Compare(small, -DBL_MAX, DBL_MAX, 50.0, 1) << endl;
+  OrderFilter wide(7, 3);
+  cout << "  7x3 boxcar, 90 percent:      "
+       << Compare(wide, -DBL_MAX, DBL_MAX, 90.0, 1) << endl;
+  cout << "  7x3 boxcar, every 3 samples: "
+       << Compare(wide, -DBL_MAX, DBL_MAX, 10.0, 3) << endl;
+  cout << "  7x3 boxcar, every 8 samples: "
+       << Compare(wide, -DBL_MAX, DBL_MAX, 75.0, 8) << endl;
+  OrderFilter tall(5, 5);
+  tall.SetMinMax(2.0, 7.0);
+  cout << "  5x5 boxcar, from 2 to 7:     "
+       << Compare(tall, 2.0, 7.0, 0.0, 1) << endl;
+  OrderFilter one(1, 1);
+  cout << "  1x1 boxcar:                  "
+       << Compare(one, -DBL_MAX, DBL_MAX, 100.0, 1) << endl;
+  cout << endl;
+
+  cout << "Testing errors" << endl;
+  try {
+    OrderFilter bad(0, 3);
+  }
+  catch (iException &e) {
+    e.Report(false);
+  }
+  try {
+    TestBox wrong(5, 3);
+    filter.Load(wrong);
+  }
+  catch (iException &e) {
+    e.Report(false);
+  }
+  try {
+    filter.Percentile(101.0);
+  }
+  catch (iException &e) {
+    e.Report(false);
+  }
+  try {
+    filter.SetMinMax(5.0, 1.0);
+  }
+  catch (iException &e) {
+    e.Report(false);
+  }
+
+  return 0;
+}
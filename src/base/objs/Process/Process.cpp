@@ -621,7 +621,8 @@ namespace Isis {
    * vector where each entry is a single Statistics object for 
    * every band of a particular input cube, and as a vector where 
    * each entry is a vector of Statistics objects, for each band 
-   * separately, of a particular input cube. 
+   * separately, of a particular input cube.  The statistics of a cube are
+   * the sum of those of its bands, so each line is only added once.
    */
   void Process::CalculateStatistics() {
     for (unsigned cubeNum = 0; cubeNum < InputCubes.size(); cubeNum++) {
@@ -653,10 +654,10 @@ namespace Isis {
           line.SetLine(i, useBand);
           cube->Read(line);
           bandStats->AddData(line.DoubleBuffer(), line.size());
-          cubeStats->AddData(line.DoubleBuffer(), line.size());
           progress.CheckStatus();
         }
 
+        cubeStats->AddStatistics(*bandStats);
         allBandStats.push_back(bandStats);
       }
   
@@ -133,6 +133,8 @@ namespace Isis {
  *           calculating statistics to store off its results in
  *           both p_bandStats and p_cubeStats, and added methods
  *           to access those results
+ *  @history 2026-10-18 Unknown - CalculateStatistics adds the statistics of
+ *           each band to those of the cube instead of adding every line to both
  * 
  *  @todo 2005-02-08 Jeff Anderson - add an example to the class documentation.
  */ 
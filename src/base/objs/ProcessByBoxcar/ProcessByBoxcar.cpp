@@ -20,11 +20,15 @@
  *   http://www.usgs.gov/privacy.html.                                    
  */                                                                                                                                             
 
+#include <algorithm>
+#include <vector>
+
 #include "Process.h"
 #include "Buffer.h"
 #include "LineManager.h"
 #include "ProcessByBoxcar.h"
 #include "BoxcarManager.h"
+#include "SpecialPixel.h"
                               
 using namespace std;
 namespace Isis {
@@ -48,7 +52,8 @@ namespace Isis {
   * p_boxSamples by p_boxLines, through the cube one pixel at a time. The input 
   * and output buffers contain a Boxcar of the size indicated in p_boxSamples 
   * and p_boxLines. The input and output cube must be initialized prior to 
-  * calling this method.
+  * calling this method. Each input line is read once per band, the boxcar
+  * is copied from the lines in memory.
   * 
   * @param funct (Isis::Buffer &in, double &out) Name of your processing function
   * 
@@ -95,16 +100,54 @@ namespace Isis {
     // Construct boxcar buffer and line buffer managers
     Isis::BoxcarManager box(*InputCubes[0],p_boxSamples,p_boxLines);
     Isis::LineManager line(*OutputCubes[0]);
+    Isis::LineManager inLine(*InputCubes[0]);
     double out;
-  
+
+    // The boxcar is filled from the last p_boxLines input lines, which are
+    // kept in memory with Null pixels on either side for the part of the
+    // boxcar that is off the cube.  Each input line is read once per band
+    // rather than once for every boxcar it is in.
+    int samples = InputCubes[0]->Samples();
+    int lines = InputCubes[0]->Lines();
+    int lineOffset = -((p_boxLines - 1) / 2);
+    int sampleOffset = -((p_boxSamples - 1) / 2);
+    int width = samples + p_boxSamples - 1;
+    vector< vector<double> > window(p_boxLines, vector<double>(width, Isis::Null));
+    int windowBand = 0;
+    int nextLine = 0;
+
     // Loop and let the app programmer use the boxcar to change output pixel
     p_progress->SetMaximumSteps(InputCubes[0]->Lines()*InputCubes[0]->Bands());
     p_progress->CheckStatus();
   
     box.begin();
     for (line.begin(); !line.end(); line.next()) {
+      // Read the input lines that have come into the boxcar
+      if (line.Band() != windowBand) {
+        windowBand = line.Band();
+        nextLine = line.Line() + lineOffset;
+      }
+      int lastLine = line.Line() + lineOffset + p_boxLines - 1;
+      for ( ; nextLine <= lastLine; nextLine++) {
+        vector<double> &row = window[(nextLine - lineOffset) % p_boxLines];
+        if (nextLine < 1 || nextLine > lines) {
+          fill(row.begin(), row.end(), Isis::Null);
+          continue;
+        }
+        inLine.SetLine(nextLine, windowBand);
+        InputCubes[0]->Read(inLine);
+        copy(inLine.DoubleBuffer(), inLine.DoubleBuffer() + samples,
+             row.begin() - sampleOffset);
+      }
+
       for (int i=0; i<line.size(); i++) {
-        InputCubes[0]->Read(box);
+        int firstLine = line.Line() + lineOffset;
+        for (int l=0; l<p_boxLines; l++) {
+          const vector<double> &row =
+            window[(firstLine + l - lineOffset) % p_boxLines];
+          copy(row.begin() + i, row.begin() + i + p_boxSamples,
+               box.DoubleBuffer() + l * p_boxSamples);
+        }
         funct (box,out);
         line[i] = out;
         box++;
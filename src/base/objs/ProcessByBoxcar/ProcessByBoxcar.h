@@ -42,6 +42,9 @@ namespace Isis {
  *                                     isis.astrogeology...
  *  @history 2005-02-08 Elizabeth Ribelin - Modified file to support Doxygen 
  *                                          documentation
+ *  @history 2026-10-18 Unknown - StartProcess keeps the input lines the boxcar
+ *           covers in memory and fills the boxcar from them, instead of reading
+ *           the boxcar from the cube at every pixel
  * 
  *  @todo 2005-02-08 Tracie Sucharski - add code example and implementation 
  *                                      example to class documentation                                               
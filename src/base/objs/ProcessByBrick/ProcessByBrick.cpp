@@ -20,12 +20,404 @@
  *   http://www.usgs.gov/privacy.html.
  */                                                                      
 
+#include <deque>
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
 #include "ProcessByBrick.h"
 #include "Brick.h"
+#include "BrickPrefetcher.h"
 #include "Cube.h"
+#include "iException.h"
+#include "Preference.h"
+#include "Progress.h"
+#include "Pvl.h"
 
 using namespace std;
 namespace Isis {
+  class BrickThreads;
+
+  /**
+   * One of the threads processing bricks for ProcessByBrick. Each thread has
+   * its own bricks for every input and output cube. It takes the position of
+   * the next brick from the shared queue, reads the input bricks, passes
+   * them to the application function and writes the output bricks.
+   */
+  class BrickWorker : public QThread {
+    public:
+      BrickWorker(BrickThreads &threads);
+      ~BrickWorker();
+
+      void (*funct1)(Isis::Buffer &inout);
+      void (*funct2)(Isis::Buffer &in, Isis::Buffer &out);
+      void (*functN)(std::vector<Isis::Buffer *> &in,
+                     std::vector<Isis::Buffer *> &out);
+
+      std::vector<Isis::Cube *> inCubes;
+      std::vector<Isis::Cube *> outCubes;
+      std::vector<Isis::Brick *> ibricks;
+      std::vector<Isis::Brick *> obricks;
+      std::vector<Isis::Brick *> owned;
+
+    protected:
+      void run();
+
+    private:
+      BrickThreads *p_threads;
+  };
+
+
+  /**
+   * Runs the bricks of a ProcessByBrick::StartProcess in several threads.
+   * The caller moves its buffer managers through the cubes exactly as it
+   * does when processing serially and hands each position to Add. The
+   * threads finish the bricks in any order, so the application function
+   * must not depend on the order or on data shared between calls. Progress
+   * is reported from the calling thread.
+   */
+  class BrickThreads {
+    public:
+      BrickThreads(int threads, Isis::Progress *progress);
+      ~BrickThreads();
+
+      void Start(void funct(Isis::Buffer &inout), Isis::Cube *cube,
+                 Isis::Brick &shape, bool read, bool write);
+      void Start(void funct(Isis::Buffer &in, Isis::Buffer &out),
+                 Isis::Cube *in, Isis::Brick &ishape,
+                 Isis::Cube *out, Isis::Brick &oshape);
+      void Start(void funct(std::vector<Isis::Buffer *> &in,
+                            std::vector<Isis::Buffer *> &out),
+                 std::vector<Isis::Cube *> &in,
+                 std::vector<Isis::Brick *> &ishapes,
+                 std::vector<Isis::Cube *> &out,
+                 std::vector<Isis::Brick *> &oshapes);
+
+      void Add(const std::vector<Isis::Brick *> &imgrs,
+               const std::vector<Isis::Brick *> &omgrs);
+      void Finish();
+
+      QMutex mutex;             //!< Protects the members below
+      QWaitCondition queued;    //!< Signaled when a brick is queued or on stop
+      QWaitCondition done;      //!< Signaled when a brick is taken or done
+      std::deque< std::vector<int> > jobs;  //!< Queued brick positions
+      int finished;             //!< Number of bricks done
+      bool stop;                //!< Tells the threads to quit
+      bool failed;              //!< A thread ran into an error
+      Isis::Pvl errors;         //!< PvlErrors of the first error
+
+    private:
+      std::vector<BrickWorker *> p_workers;
+      Isis::Progress *p_progress;
+      int p_added;              //!< Number of bricks queued so far
+      int p_reported;           //!< Number of bricks reported to p_progress
+
+      void Wait(int pending);
+      void Stop();
+      void StartWorkers();
+  };
+
+
+  //! Constructs a worker without bricks, BrickThreads::Start sets it up
+  BrickWorker::BrickWorker(BrickThreads &threads) {
+    p_threads = &threads;
+    funct1 = NULL;
+    funct2 = NULL;
+    functN = NULL;
+  }
+
+
+  //! Deletes the bricks of the worker
+  BrickWorker::~BrickWorker() {
+    for (unsigned int i=0; i<owned.size(); i++) {
+      delete owned[i];
+    }
+  }
+
+
+  //! Processes queued bricks until told to stop
+  void BrickWorker::run() {
+    std::vector<Isis::Buffer *> ibufs(ibricks.begin(),ibricks.end());
+    std::vector<Isis::Buffer *> obufs(obricks.begin(),obricks.end());
+    Isis::Pvl errors;
+
+    while (true) {
+      p_threads->mutex.lock();
+      while (!p_threads->stop && p_threads->jobs.empty()) {
+        p_threads->queued.wait(&p_threads->mutex);
+      }
+      if (p_threads->stop) {
+        p_threads->mutex.unlock();
+        break;
+      }
+      std::vector<int> pos = p_threads->jobs.front();
+      p_threads->jobs.pop_front();
+      p_threads->done.wakeAll();
+      p_threads->mutex.unlock();
+
+      bool ok = true;
+      try {
+        int p = 0;
+        for (unsigned int i=0; i<ibricks.size(); i++, p+=3) {
+          ibricks[i]->SetBasePosition(pos[p],pos[p+1],pos[p+2]);
+          inCubes[i]->Read(*ibricks[i]);
+        }
+        for (unsigned int i=0; i<obricks.size(); i++, p+=3) {
+          obricks[i]->SetBasePosition(pos[p],pos[p+1],pos[p+2]);
+        }
+
+        if (funct1 != NULL) {
+          funct1(ibricks.size() > 0 ? *ibricks[0] : *obricks[0]);
+        }
+        else if (funct2 != NULL) {
+          funct2(*ibricks[0],*obricks[0]);
+        }
+        else {
+          functN(ibufs,obufs);
+        }
+
+        for (unsigned int i=0; i<obricks.size(); i++) {
+          outCubes[i]->Write(*obricks[i]);
+        }
+      }
+      catch (Isis::iException &e) {
+        // The errors of this thread are passed on and cleared
+        ok = false;
+        errors = e.PvlErrors();
+        e.Clear();
+      }
+      catch (std::exception &e) {
+        ok = false;
+        errors = Isis::iException::Message(Isis::iException::Programmer,
+                                           e.what(),_FILEINFO_).PvlErrors();
+        Isis::iException::Clear();
+      }
+
+      p_threads->mutex.lock();
+      if (!ok && !p_threads->failed) {
+        p_threads->failed = true;
+        p_threads->errors = errors;
+      }
+      p_threads->finished++;
+      p_threads->done.wakeAll();
+      p_threads->mutex.unlock();
+    }
+  }
+
+
+  /**
+   * Creates the worker threads. They are started by one of the Start
+   * methods.
+   *
+   * @param threads Number of threads
+   * @param progress Progress reported as bricks are finished
+   */
+  BrickThreads::BrickThreads(int threads, Isis::Progress *progress) {
+    p_progress = progress;
+    p_added = 0;
+    p_reported = 0;
+    finished = 0;
+    stop = false;
+    failed = false;
+
+    for (int i=0; i<threads; i++) {
+      p_workers.push_back(new BrickWorker(*this));
+    }
+  }
+
+
+  //! Stops the threads, dropping any bricks still queued
+  BrickThreads::~BrickThreads() {
+    Stop();
+    for (unsigned int i=0; i<p_workers.size(); i++) {
+      delete p_workers[i];
+    }
+  }
+
+
+  /**
+   * Starts processing a single cube with a brick which is optionally read
+   * before and written after the application function.
+   */
+  void BrickThreads::Start(void funct(Isis::Buffer &inout), Isis::Cube *cube,
+                           Isis::Brick &shape, bool read, bool write) {
+    for (unsigned int t=0; t<p_workers.size(); t++) {
+      BrickWorker *w = p_workers[t];
+      Isis::Brick *brick = new Isis::Brick(*cube,shape.SampleDimension(),
+                                           shape.LineDimension(),
+                                           shape.BandDimension());
+      w->owned.push_back(brick);
+      w->funct1 = funct;
+      if (read) {
+        w->inCubes.push_back(cube);
+        w->ibricks.push_back(brick);
+      }
+      if (write) {
+        w->outCubes.push_back(cube);
+        w->obricks.push_back(brick);
+      }
+    }
+    StartWorkers();
+  }
+
+
+  //! Starts processing one input cube into one output cube
+  void BrickThreads::Start(void funct(Isis::Buffer &in, Isis::Buffer &out),
+                           Isis::Cube *in, Isis::Brick &ishape,
+                           Isis::Cube *out, Isis::Brick &oshape) {
+    std::vector<Isis::Cube *> icubes(1,in);
+    std::vector<Isis::Cube *> ocubes(1,out);
+    std::vector<Isis::Brick *> ishapes(1,&ishape);
+    std::vector<Isis::Brick *> oshapes(1,&oshape);
+    Start(NULL,icubes,ishapes,ocubes,oshapes);
+
+    for (unsigned int t=0; t<p_workers.size(); t++) {
+      p_workers[t]->funct2 = funct;
+    }
+    StartWorkers();
+  }
+
+
+  /**
+   * Starts processing any number of input and output cubes. Called with a
+   * NULL function to only create the bricks.
+   */
+  void BrickThreads::Start(void funct(std::vector<Isis::Buffer *> &in,
+                                      std::vector<Isis::Buffer *> &out),
+                           std::vector<Isis::Cube *> &in,
+                           std::vector<Isis::Brick *> &ishapes,
+                           std::vector<Isis::Cube *> &out,
+                           std::vector<Isis::Brick *> &oshapes) {
+    for (unsigned int t=0; t<p_workers.size(); t++) {
+      BrickWorker *w = p_workers[t];
+      for (unsigned int i=0; i<in.size(); i++) {
+        Isis::Brick *brick = new Isis::Brick(*in[i],
+                                             ishapes[i]->SampleDimension(),
+                                             ishapes[i]->LineDimension(),
+                                             ishapes[i]->BandDimension());
+        w->owned.push_back(brick);
+        w->inCubes.push_back(in[i]);
+        w->ibricks.push_back(brick);
+      }
+      for (unsigned int i=0; i<out.size(); i++) {
+        Isis::Brick *brick = new Isis::Brick(*out[i],
+                                             oshapes[i]->SampleDimension(),
+                                             oshapes[i]->LineDimension(),
+                                             oshapes[i]->BandDimension());
+        w->owned.push_back(brick);
+        w->outCubes.push_back(out[i]);
+        w->obricks.push_back(brick);
+      }
+      w->functN = funct;
+    }
+    if (funct != NULL) StartWorkers();
+  }
+
+
+  /**
+   * Queues the current positions of the buffer managers. Waits while the
+   * threads have two bricks each to work on.
+   *
+   * @param imgrs Input buffer managers
+   * @param omgrs Output buffer managers
+   */
+  void BrickThreads::Add(const std::vector<Isis::Brick *> &imgrs,
+                         const std::vector<Isis::Brick *> &omgrs) {
+    std::vector<int> pos;
+    for (unsigned int i=0; i<imgrs.size(); i++) {
+      pos.push_back(imgrs[i]->Sample());
+      pos.push_back(imgrs[i]->Line());
+      pos.push_back(imgrs[i]->Band());
+    }
+    for (unsigned int i=0; i<omgrs.size(); i++) {
+      pos.push_back(omgrs[i]->Sample());
+      pos.push_back(omgrs[i]->Line());
+      pos.push_back(omgrs[i]->Band());
+    }
+
+    Wait(2 * p_workers.size() - 1);
+
+    mutex.lock();
+    jobs.push_back(pos);
+    p_added++;
+    queued.wakeOne();
+    mutex.unlock();
+  }
+
+
+  //! Waits for all queued bricks to be processed
+  void BrickThreads::Finish() {
+    Wait(0);
+    Stop();
+  }
+
+
+  /**
+   * Reports the progress of finished bricks until no more than pending
+   * bricks are left to process. Throws if one of the threads failed.
+   *
+   * @param pending Number of unfinished bricks to wait for
+   */
+  void BrickThreads::Wait(int pending) {
+    mutex.lock();
+    while (true) {
+      int newlyFinished = finished - p_reported;
+      if (newlyFinished > 0) {
+        p_reported += newlyFinished;
+        mutex.unlock();
+        for (int i=0; i<newlyFinished; i++) p_progress->CheckStatus();
+        mutex.lock();
+        continue;
+      }
+      if (failed || (p_added - finished <= pending)) break;
+      done.wait(&mutex);
+    }
+    bool error = failed;
+    mutex.unlock();
+
+    if (error) {
+      Stop();
+      throw Isis::iException::Message(errors);
+    }
+  }
+
+
+  //! Tells the threads to quit and waits for them
+  void BrickThreads::Stop() {
+    mutex.lock();
+    stop = true;
+    jobs.clear();
+    queued.wakeAll();
+    mutex.unlock();
+
+    for (unsigned int i=0; i<p_workers.size(); i++) {
+      p_workers[i]->wait();
+    }
+  }
+
+
+  //! Starts the worker threads
+  void BrickThreads::StartWorkers() {
+    for (unsigned int i=0; i<p_workers.size(); i++) {
+      p_workers[i]->start();
+    }
+  }
+
+
+  /**
+   * The prefetchers of the input cubes of a StartProcess. Deleting them
+   * stops and waits for their threads, so they are deleted when the list
+   * goes out of scope, also when the application function throws.
+   */
+  class BrickPrefetchers : public std::vector<Isis::BrickPrefetcher *> {
+    public:
+      ~BrickPrefetchers() {
+        for (unsigned int i=0; i<size(); i++) {
+          delete (*this)[i];
+        }
+      }
+  };
 
   ProcessByBrick::ProcessByBrick () {
     p_inputBrickSamples.clear();
@@ -39,6 +431,12 @@ namespace Isis {
     p_inputBrickSizeSet=false;
     p_outputBrickSizeSet=false;
     p_wrapOption = false;
+    p_threads = 1;
+
+    // Read ahead is optional in the preferences
+    p_readAhead = 0;
+    Isis::PvlGroup &pref = Isis::Preference::Preferences().FindGroup("CubeCustomization");
+    if (pref.HasKeyword("ReadAhead")) p_readAhead = pref["ReadAhead"];
   }
 
   /**
@@ -288,16 +686,37 @@ namespace Isis {
     p_progress->SetMaximumSteps(numBricks);
     p_progress->CheckStatus();
 
+    // Hand the bricks to several threads if requested
+    bool threaded = (p_threads > 1);
+    Isis::BrickThreads threads(threaded ? p_threads : 0,p_progress);
+    if (threaded) {
+      threads.Start(funct,InputCubes[0],ibrick,OutputCubes[0],obrick);
+    }
+    std::vector<Isis::Brick *> imgrs(1,&ibrick);
+    std::vector<Isis::Brick *> omgrs(1,&obrick);
+
+    // Load upcoming input bricks while the current one is processed
+    Isis::BrickPrefetcher prefetch(*InputCubes[0],p_inputBrickSamples[1],
+                                   p_inputBrickLines[1],p_inputBrickBands[1],
+                                   threaded ? 0 : p_readAhead);
+
     ibrick.begin();
     obrick.begin();
     for (int i=0; i<numBricks; i++) {
-      InputCubes[0]->Read(ibrick);
-      funct (ibrick,obrick);
-      OutputCubes[0]->Write(obrick);
-      p_progress->CheckStatus();
+      if (threaded) {
+        threads.Add(imgrs,omgrs);
+      }
+      else {
+        InputCubes[0]->Read(ibrick);
+        prefetch.Advance();
+        funct (ibrick,obrick);
+        OutputCubes[0]->Write(obrick);
+        p_progress->CheckStatus();
+      }
       ibrick++;
       obrick++;
     }
+    threads.Finish();
   }
 
   /** 
@@ -355,16 +774,40 @@ namespace Isis {
       bricks = new Isis::Brick(*cube,p_outputBrickSamples[1],p_outputBrickLines[1], p_outputBrickBands[1]);
     }
 
+    // Hand the bricks to several threads if requested
+    bool threaded = (p_threads > 1);
+    bool write = (!haveInput) || (cube->IsReadWrite());
+    Isis::BrickThreads threads(threaded ? p_threads : 0,p_progress);
+    if (threaded) threads.Start(funct,cube,*bricks,haveInput,write);
+    std::vector<Isis::Brick *> imgrs;
+    std::vector<Isis::Brick *> omgrs;
+    if (haveInput) imgrs.push_back(bricks);
+    if (write) omgrs.push_back(bricks);
+
+    // Load upcoming input bricks while the current one is processed
+    Isis::BrickPrefetcher prefetch(*cube,bricks->SampleDimension(),
+                                   bricks->LineDimension(),
+                                   bricks->BandDimension(),
+                                   (haveInput && !threaded) ? p_readAhead : 0);
+
     // Loop and let the app programmer work with the bricks
     p_progress->SetMaximumSteps(bricks->Bricks());
     p_progress->CheckStatus();
 
     for (bricks->begin(); !bricks->end(); (*bricks)++) {
-      if (haveInput) cube->Read(*bricks); // input only
+      if (threaded) {
+        threads.Add(imgrs,omgrs);
+        continue;
+      }
+      if (haveInput) {
+        cube->Read(*bricks); // input only
+        prefetch.Advance();
+      }
       funct (*bricks);
-      if ((!haveInput) || (cube->IsReadWrite())) cube->Write(*bricks); // output only or input/output
+      if (write) cube->Write(*bricks); // output only or input/output
       p_progress->CheckStatus();
     }
+    threads.Finish();
 
     delete bricks;
   }
@@ -410,17 +853,26 @@ namespace Isis {
     // this parameter holds the number of bricks to be used in processing
     //      which is the maximum number of bricks of all the cubes.
     int numBricks = 0;
+    bool threaded = (p_threads > 1);
 
     // Construct two vectors of brick buffer managers
     // The input buffer managers
     std::vector<Isis::Brick *> imgrs;
     vector<Isis::Buffer *> ibufs;
+    BrickPrefetchers prefetch;
     for (unsigned int i=1; i<=InputCubes.size(); i++) {
       Isis::Brick *ibrick = new Isis::Brick(*InputCubes[i-1],p_inputBrickSamples[i],p_inputBrickLines[i], p_inputBrickBands[i]);
       ibrick->begin();
       ibufs.push_back(ibrick);
       imgrs.push_back(ibrick);
       if ( numBricks < ibrick->Bricks() ) numBricks = ibrick->Bricks();
+
+      // Read ahead unless the brick is moved to other bands below
+      int depth = threaded ? 0 : p_readAhead;
+      if (InputCubes[i-1]->Bands() != InputCubes[0]->Bands()) depth = 0;
+      prefetch.push_back(new Isis::BrickPrefetcher(*InputCubes[i-1],
+                         p_inputBrickSamples[i],p_inputBrickLines[i],
+                         p_inputBrickBands[i],depth));
     }
 
     // And the output buffer managers
@@ -434,22 +886,37 @@ namespace Isis {
       if ( numBricks < obrick->Bricks() ) numBricks = obrick->Bricks();
     }
 
+    // Hand the bricks to several threads if requested
+    Isis::BrickThreads threads(threaded ? p_threads : 0,p_progress);
+    if (threaded) {
+      threads.Start(funct,InputCubes,imgrs,OutputCubes,omgrs);
+    }
+
     // Loop and let the app programmer process the bricks
     p_progress->SetMaximumSteps(numBricks);
     p_progress->CheckStatus();
 
     for (int t=0; t<numBricks; t++) {
-      // Read the input buffers
-      for (unsigned int i=0; i<InputCubes.size(); i++) {
-        InputCubes[i]->Read(*ibufs[i]);
+      if (threaded) {
+        threads.Add(imgrs,omgrs);
       }
+      else {
+        // Read the input buffers
+        for (unsigned int i=0; i<InputCubes.size(); i++) {
+          InputCubes[i]->Read(*ibufs[i]);
+          prefetch[i]->Advance();
+        }
 
-      // Pass them to the application function
-      funct (ibufs,obufs);
+        // Pass them to the application function
+        funct (ibufs,obufs);
+
+        // And copy them into the output cubes
+        for (unsigned int i=0; i<OutputCubes.size(); i++) {
+          OutputCubes[i]->Write(*obufs[i]);
+        }
+      }
 
-      // And copy them into the output cubes
       for (unsigned int i=0; i<OutputCubes.size(); i++) {
-        OutputCubes[i]->Write(*obufs[i]);
         omgrs[i]->next();
       }
 
@@ -465,8 +932,9 @@ namespace Isis {
         }
       }
 
-      p_progress->CheckStatus();
+      if (!threaded) p_progress->CheckStatus();
     }
+    threads.Finish();
 
     for(unsigned int i = 0; i < ibufs.size(); i++) {
       delete ibufs[i];
@@ -481,6 +949,34 @@ namespace Isis {
     omgrs.clear();
   }
 
+  /**
+   * Sets the number of input bricks to read ahead of the brick being
+   * processed. The reading is done in a separate thread so the i/o overlaps
+   * the processing function. If not invoked, the ReadAhead keyword in the
+   * CubeCustomization preference group is used (zero if it is missing).
+   *
+   * @param bricks Number of bricks to read ahead, zero disables read ahead
+   */
+  void ProcessByBrick::SetReadAhead (const int bricks) {
+    p_readAhead = bricks;
+  }
+
+  /**
+   * Sets the number of threads StartProcess uses to process bricks. Each
+   * thread reads, processes and writes its own bricks, so the application
+   * function is called for several bricks at once and in no particular
+   * order. Only use more than one thread if the function works on nothing
+   * but the buffers it is given (no global state such as running
+   * statistics). The default is one thread.
+   *
+   * @param threads Number of threads, zero or less uses one per processor
+   */
+  void ProcessByBrick::SetThreads (const int threads) {
+    p_threads = threads;
+    if (p_threads <= 0) p_threads = QThread::idealThreadCount();
+    if (p_threads < 1) p_threads = 1;
+  }
+
   /**
    * End the processing sequence and cleans up by closing cubes, freeing memory, 
    * etc.
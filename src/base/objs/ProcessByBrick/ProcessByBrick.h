@@ -47,6 +47,10 @@ namespace Isis {
  *           on input cubes when there are multiple input cubes
  *  @history 2008-01-09 Steven Lambright - Fixed a memory leak
  *  @history 2008-06-18 Steven Koechle - Fixed Documentation
+ *  @history 2026-10-17 Unknown - Input bricks are read ahead in a separate
+ *           thread (see SetReadAhead and BrickPrefetcher)
+ *  @history 2026-10-17 Unknown - Added SetThreads to process bricks in several
+ *           threads at once
  */                                                                       
   class ProcessByBrick : public Isis::Process {
   
@@ -60,6 +64,8 @@ namespace Isis {
     std::vector<int> p_outputBrickSamples;   //!<Number of samples in the output bricks
     std::vector<int> p_outputBrickLines;     //!<Number of lines in the output bricks
     std::vector<int> p_outputBrickBands;     //!<Number of bands in the output bricks
+    int p_readAhead;      //!<Number of input bricks to read ahead
+    int p_threads;        //!<Number of threads processing bricks
   
     public:
 
@@ -103,6 +109,25 @@ namespace Isis {
        * @return bool
        */
       bool Wraps() {return p_wrapOption;};
+
+      void SetReadAhead (const int bricks);
+
+      /**
+       * Returns the number of input bricks read ahead of the brick being
+       * processed
+       *
+       * @return int
+       */
+      int ReadAhead() const {return p_readAhead;};
+
+      void SetThreads (const int threads);
+
+      /**
+       * Returns the number of threads used to process bricks
+       *
+       * @return int
+       */
+      int Threads() const {return p_threads;};
   
       void StartProcess (void funct(Isis::Buffer &in));
       void StartProcess (void funct(Isis::Buffer &in, Isis::Buffer &out));
@@ -1,10 +1,12 @@
 #include "Isis.h"
 #include "ProcessByBrick.h"
 #include "Cube.h"
+#include "LineManager.h"
 #include <string>
 
 using namespace std;
 void twoInAndOut (vector<Isis::Buffer *> &ib, vector<Isis::Buffer *> &ob);
+void copyIt (Isis::Buffer &in, Isis::Buffer &out);
 
 void IsisMain()
 {
@@ -19,6 +21,38 @@ void IsisMain()
   p.StartProcess(twoInAndOut);
   p.EndProcess();
 
+  // Process in several threads and compare with the input
+  cout << "Testing threads ... " << endl;
+  Isis::ProcessByBrick p2;
+  icube = p2.SetInputCube("FROM");
+  p2.SetBrickSize(10, 10, 1);
+  Isis::CubeAttributeOutput att;
+  p2.SetOutputCube("/tmp/isisProcessByBrick_03", att, icube->Samples(),
+                   icube->Lines(), icube->Bands());
+  p2.SetThreads(4);
+  cout << "Threads:  " << p2.Threads() << endl;
+  p2.StartProcess(copyIt);
+  p2.EndProcess();
+
+  Isis::Cube in, out;
+  in.Open(Isis::Application::GetUserInterface().GetFilename("FROM"));
+  out.Open("/tmp/isisProcessByBrick_03");
+  Isis::LineManager inLine(in);
+  Isis::LineManager outLine(out);
+  for (inLine.begin(), outLine.begin(); !inLine.end(); inLine++, outLine++) {
+    in.Read(inLine);
+    out.Read(outLine);
+    for (int i=0; i<inLine.size(); i++) {
+      if (outLine[i] != inLine[i]) {
+        cout << "Problem at line " << inLine.Line() << " sample " << i + 1
+             << " band " << inLine.Band() << endl;
+      }
+    }
+  }
+  in.Close();
+  out.Close(true);
+  cout << endl;
+
   Isis::Cube cube;
   cube.Open("/tmp/isisProcessByBrick_01");
   cube.Close(true);
@@ -63,3 +97,8 @@ void twoInAndOut (vector<Isis::Buffer *> &ib, vector<Isis::Buffer *> &ob)
     cout << "Bogus error #3" << endl;
   }
 }
+
+void copyIt (Isis::Buffer &in, Isis::Buffer &out)
+{
+  out.Copy(in);
+}
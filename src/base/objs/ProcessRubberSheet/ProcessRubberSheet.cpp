@@ -23,15 +23,58 @@
 #include <iostream>
 #include <iomanip>
 
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
 #include "Portal.h"
 #include "Transform.h"
 #include "Interpolator.h"
 #include "TileManager.h"
 #include "ProcessRubberSheet.h"
 #include "Portal.h"
+#include "Pvl.h"
 
 using namespace std;
 namespace Isis {
+
+  /**
+   * The output tiles shared by the threads of a parallel
+   * ProcessRubberSheet::StartProcess. Tiles are handed out in order, a whole
+   * tile (all bands) at a time.
+   */
+  class RubberSheetTiles {
+    public:
+      QMutex mutex;             //!< Protects the members below
+      QWaitCondition done;      //!< Signaled when a tile is done or fails
+      int next;                 //!< Next tile to process
+      int last;                 //!< Last tile of a band
+      int finished;             //!< Number of tiles (times bands) done
+      int running;              //!< Number of threads still working
+      bool failed;              //!< A thread ran into an error
+      Isis::Pvl errors;         //!< PvlErrors of the first error
+  };
+
+
+  //! One of the threads of a parallel ProcessRubberSheet::StartProcess
+  class RubberSheetWorker : public QThread {
+    public:
+      RubberSheetWorker(ProcessRubberSheet &process, RubberSheetTiles &tiles,
+                        Isis::Transform &trans, Isis::Interpolator &interp) :
+        p_process(process), p_tiles(tiles), p_trans(trans), p_interp(interp) {};
+
+    protected:
+      void run() {
+        p_process.TransformTiles(p_tiles,p_trans,p_interp);
+      }
+
+    private:
+      ProcessRubberSheet &p_process;
+      RubberSheetTiles &p_tiles;
+      Isis::Transform &p_trans;
+      Isis::Interpolator &p_interp;
+  };
+
  /** 
   * Applies a Transform and an Interpolator to every pixel in the output cube.
   * The output cube is written using an Tile and the input cube is read using 
@@ -60,17 +103,19 @@ namespace Isis {
       throw Isis::iException::Message(Isis::iException::Programmer,m,_FILEINFO_);
     }
 
+    int tileSize = TileSize();
+
     // allocate the sampMap/lineMap vectors
-    p_lineMap.resize(p_startQuadSize);
-    p_sampMap.resize(p_startQuadSize);
+    p_lineMap.resize(tileSize);
+    p_sampMap.resize(tileSize);
 
     for(unsigned int pos = 0; pos < p_lineMap.size(); pos++) {
-      p_lineMap[pos].resize(p_startQuadSize);
-      p_sampMap[pos].resize(p_startQuadSize);
+      p_lineMap[pos].resize(tileSize);
+      p_sampMap[pos].resize(tileSize);
     }
 
     // Create a tile manager for the output file
-    Isis::TileManager otile (*OutputCubes[0], p_startQuadSize, p_startQuadSize);
+    Isis::TileManager otile (*OutputCubes[0], tileSize, tileSize);
 
     // Create a portal buffer for the input file
     Isis::Portal iportal (interp.Samples(), interp.Lines(),
@@ -89,11 +134,12 @@ namespace Isis {
         for (int band=1; band<=OutputCubes[0]->Bands(); band++) {
           otile.SetTile(tile,band);
 
-          if(p_startQuadSize == 2) {
+          if(tileSize == 2) {
             SlowGeom (otile,iportal,trans,interp);  
           }
           else {
-            QuadTree (otile,iportal,trans,interp,useLastTileMap);
+            QuadTree (otile,iportal,trans,interp,useLastTileMap,
+                      p_lineMap,p_sampMap);
           }
 
           useLastTileMap = true;
@@ -114,11 +160,11 @@ namespace Isis {
           p_bandChangeFunct (lastOutputBand);
         }
 
-        if(p_startQuadSize == 2) {
+        if(tileSize == 2) {
           SlowGeom (otile,iportal,trans,interp);  
         }
         else {
-          QuadTree (otile,iportal,trans,interp,false);
+          QuadTree (otile,iportal,trans,interp,false,p_lineMap,p_sampMap);
         }
 
         OutputCubes[0]->Write(otile);
@@ -129,6 +175,183 @@ namespace Isis {
     p_sampMap.clear();
     p_lineMap.clear();
   }
+
+ /** 
+  * Applies the transforms and an Interpolator to every pixel in the output
+  * cube like the single transform StartProcess, but processes output tiles
+  * in parallel with one thread per transform. Each transform must be
+  * independent of the others, for example with its own Camera and
+  * Projection, since they are used at the same time. The interpolator is
+  * shared.
+  *
+  * The tiles are processed serially with the first transform if only one
+  * transform is given or if a BandChange function has been registered,
+  * since that function must be called as the bands are processed in order.
+  * 
+  * @param trans One fully initialized Transform for each thread
+  * 
+  * @param interp A fully initialized Interpolator object.
+  * 
+  * @throws Isis::iException::Message 
+  */
+  void ProcessRubberSheet::StartProcess (std::vector<Isis::Transform *> &trans,
+                                         Isis::Interpolator &interp) {
+    if (trans.size() == 0) {
+      string m = "You must specify at least one transform";
+      throw Isis::iException::Message(Isis::iException::Programmer,m,_FILEINFO_);
+    }
+
+    if ((trans.size() == 1) || (p_bandChangeFunct != NULL)) {
+      StartProcess(*trans[0],interp);
+      return;
+    }
+
+    // Error checks ... there must be one input and one output
+    if (InputCubes.size() != 1) {
+      string m = "You must specify exactly one input cube";
+      throw Isis::iException::Message(Isis::iException::Programmer,m,_FILEINFO_);
+    }
+    else if (OutputCubes.size() != 1) {
+      string m = "You must specify exactly one output cube";
+      throw Isis::iException::Message(Isis::iException::Programmer,m,_FILEINFO_);
+    }
+
+    int tileSize = TileSize();
+    Isis::TileManager otile (*OutputCubes[0], tileSize, tileSize);
+
+    // Start the progress meter
+    p_progress->SetMaximumSteps (otile.Tiles());
+    p_progress->CheckStatus();
+
+    RubberSheetTiles tiles;
+    tiles.next = 1;
+    tiles.last = otile.Tiles() / OutputCubes[0]->Bands();
+    tiles.finished = 0;
+    tiles.running = trans.size();
+    tiles.failed = false;
+
+    vector<RubberSheetWorker *> workers;
+    for (unsigned int i=0; i<trans.size(); i++) {
+      workers.push_back(new RubberSheetWorker(*this,tiles,*trans[i],interp));
+      workers[i]->start();
+    }
+
+    // Report progress as the threads finish tiles
+    try {
+      int reported = 0;
+      tiles.mutex.lock();
+      while (true) {
+        int newlyFinished = tiles.finished - reported;
+        if (newlyFinished > 0) {
+          reported += newlyFinished;
+          tiles.mutex.unlock();
+          for (int i=0; i<newlyFinished; i++) p_progress->CheckStatus();
+          tiles.mutex.lock();
+          continue;
+        }
+        if (tiles.running == 0) break;
+        tiles.done.wait(&tiles.mutex);
+      }
+      tiles.mutex.unlock();
+    }
+    catch (...) {
+      // Stop the threads before letting the error go
+      tiles.mutex.lock();
+      tiles.failed = true;
+      tiles.mutex.unlock();
+      for (unsigned int i=0; i<workers.size(); i++) {
+        workers[i]->wait();
+        delete workers[i];
+      }
+      throw;
+    }
+
+    for (unsigned int i=0; i<workers.size(); i++) {
+      workers[i]->wait();
+      delete workers[i];
+    }
+
+    if (tiles.failed) {
+      throw Isis::iException::Message(tiles.errors);
+    }
+  }
+
+ /**
+  * Processes tiles for one of the threads of the parallel StartProcess until
+  * all tiles are done or a thread fails. Each thread has its own output
+  * tile, input portal and tile maps.
+  *
+  * @param tiles The tiles shared by the threads
+  * @param trans The transform of this thread
+  * @param interp The interpolator
+  */
+  void ProcessRubberSheet::TransformTiles (RubberSheetTiles &tiles,
+                                           Isis::Transform &trans,
+                                           Isis::Interpolator &interp) {
+    int tileSize = TileSize();
+    vector< vector<double> > lineMap(tileSize, vector<double>(tileSize));
+    vector< vector<double> > sampMap(tileSize, vector<double>(tileSize));
+
+    Isis::TileManager otile (*OutputCubes[0], tileSize, tileSize);
+    Isis::Portal iportal (interp.Samples(), interp.Lines(),
+                        InputCubes[0]->PixelType() ,
+                        interp.HotSample(), interp.HotLine());
+    int bands = OutputCubes[0]->Bands();
+    Isis::Pvl errors;
+
+    while (true) {
+      tiles.mutex.lock();
+      int tile = tiles.next++;
+      bool stop = tiles.failed || (tile > tiles.last);
+      tiles.mutex.unlock();
+      if (stop) break;
+
+      bool ok = true;
+      try {
+        for (int band=1; band<=bands; band++) {
+          otile.SetTile(tile,band);
+
+          if(tileSize == 2) {
+            SlowGeom (otile,iportal,trans,interp);
+          }
+          else {
+            QuadTree (otile,iportal,trans,interp,band > 1,lineMap,sampMap);
+          }
+
+          OutputCubes[0]->Write(otile);
+        }
+      }
+      catch (Isis::iException &e) {
+        // The errors of this thread are passed on and cleared
+        ok = false;
+        errors = e.PvlErrors();
+        e.Clear();
+      }
+      catch (std::exception &e) {
+        ok = false;
+        errors = Isis::iException::Message(Isis::iException::Programmer,
+                                           e.what(),_FILEINFO_).PvlErrors();
+        Isis::iException::Clear();
+      }
+
+      tiles.mutex.lock();
+      if (ok) {
+        tiles.finished += bands;
+      }
+      else if (!tiles.failed) {
+        tiles.failed = true;
+        tiles.errors = errors;
+      }
+      tiles.done.wakeAll();
+      tiles.mutex.unlock();
+      if (!ok) break;
+    }
+
+    tiles.mutex.lock();
+    tiles.running--;
+    tiles.done.wakeAll();
+    tiles.mutex.unlock();
+  }
  /** 
   * Registers a function to be called when the current output cube band number 
   * changes. This includes the first time. If and application does NOT need to 
@@ -175,11 +398,16 @@ namespace Isis {
   
   void ProcessRubberSheet::QuadTree(Isis::TileManager &otile, Isis::Portal &iportal, 
                                     Isis::Transform &trans, Isis::Interpolator &interp,
-                                    bool useLastTileMap) {
+                                    bool useLastTileMap,
+                                    std::vector< std::vector<double> > &lineMap,
+                                    std::vector< std::vector<double> > &sampMap) {
     // Initializations
     vector<Quad *> quadTree;
 
-    if (!useLastTileMap) {
+    if (!useLastTileMap && (p_gridSpacing > 0)) {
+      GridMap(otile,trans,lineMap,sampMap);
+    }
+    else if (!useLastTileMap) {
       // Set up the boundaries of the full tile
       Quad *quad = new Quad;
       quad->sline = otile.Line();
@@ -195,16 +423,16 @@ namespace Isis {
       // Loop and compute the input coordinates filling the maps
       // until the quad tree is empty
       while (quadTree.size() > 0) {
-        ProcessQuad(quadTree,trans,p_lineMap,p_sampMap);
+        ProcessQuad(quadTree,trans,lineMap,sampMap);
       }
     }
   
     // Apply the map to the output tile
     int outputBand = otile.Band();
-    for (int i=0, line=0; line<p_startQuadSize; line++) {
-      for (int samp=0; samp<p_startQuadSize; samp++, i++) {
-        double inputLine = p_lineMap[line][samp];
-        double inputSamp = p_sampMap[line][samp];
+    for (int i=0, line=0; line<otile.LineDimension(); line++) {
+      for (int samp=0; samp<otile.SampleDimension(); samp++, i++) {
+        double inputLine = lineMap[line][samp];
+        double inputSamp = sampMap[line][samp];
         if (inputLine != Isis::NULL8) {
           iportal.SetPosition (inputSamp, inputLine, outputBand);
           InputCubes[0]->Read(iportal);
@@ -243,6 +471,256 @@ namespace Isis {
     
     return false;
   }
+
+  /**
+   * Fills the tile maps from the transform evaluated on a grid with points
+   * every p_gridSpacing output pixels (plus the last line and sample of the
+   * tile). Each cell of the grid is filled by GridCell.
+   *
+   * @param otile The output tile
+   * @param trans The transform
+   * @param lineMap Receives the input line of each pixel of the tile
+   * @param sampMap Receives the input sample of each pixel of the tile
+   */
+  void ProcessRubberSheet::GridMap(Isis::TileManager &otile, Isis::Transform &trans,
+                                   std::vector< std::vector<double> > &lineMap,
+                                   std::vector< std::vector<double> > &sampMap) {
+    vector<int> lines;
+    for (int line=0; line<otile.LineDimension()-1; line+=p_gridSpacing) {
+      lines.push_back(line);
+    }
+    lines.push_back(otile.LineDimension()-1);
+
+    vector<int> samps;
+    for (int samp=0; samp<otile.SampleDimension()-1; samp+=p_gridSpacing) {
+      samps.push_back(samp);
+    }
+    samps.push_back(otile.SampleDimension()-1);
+
+    // Evaluate the transform at the grid points, each of which is shared by
+    // up to four cells
+    vector<GridPoint> grid(lines.size() * samps.size());
+    for (unsigned int j=0; j<lines.size(); j++) {
+      for (unsigned int i=0; i<samps.size(); i++) {
+        grid[j*samps.size()+i] = GridXform(trans,otile,lines[j],samps[i]);
+      }
+    }
+
+    for (unsigned int j=0; j+1<lines.size(); j++) {
+      for (unsigned int i=0; i+1<samps.size(); i++) {
+        GridPoint corner[4];
+        corner[0] = grid[j*samps.size()+i];
+        corner[1] = grid[j*samps.size()+i+1];
+        corner[2] = grid[(j+1)*samps.size()+i];
+        corner[3] = grid[(j+1)*samps.size()+i+1];
+        GridCell(trans,otile,lines[j],lines[j+1],samps[i],samps[i+1],corner,
+                 lineMap,sampMap);
+      }
+    }
+  }
+
+
+  /**
+   * Fills one cell of the grid in the tile maps. The transform is evaluated
+   * at the middle of the edges and at the center of the cell. If these points
+   * are within p_gridTolerance input pixels of the bilinear interpolation of
+   * the corners, the cell is filled by the interpolation. Otherwise the cell
+   * is split into four (two for cells one pixel thick) which are filled the
+   * same way, reusing the points already evaluated as their corners. A cell
+   * where none of the points transform is filled with nulls, so features
+   * smaller than half the grid spacing may be missed.
+   *
+   * @param trans The transform
+   * @param otile The output tile
+   * @param top First line of the cell in the tile, starting at zero
+   * @param bottom Last line of the cell in the tile
+   * @param left First sample of the cell in the tile, starting at zero
+   * @param right Last sample of the cell in the tile
+   * @param corner The upper left, upper right, lower left and lower right
+   *               corners of the cell
+   * @param lineMap Receives the input line of each pixel of the cell
+   * @param sampMap Receives the input sample of each pixel of the cell
+   */
+  void ProcessRubberSheet::GridCell(Isis::Transform &trans, Isis::TileManager &otile,
+                                    int top, int bottom, int left, int right,
+                                    GridPoint corner[4],
+                                    std::vector< std::vector<double> > &lineMap,
+                                    std::vector< std::vector<double> > &sampMap) {
+    bool splitLines = (bottom - top) > 1;
+    bool splitSamps = (right - left) > 1;
+
+    // A cell without interior pixels is made of its corners
+    if (!splitLines && !splitSamps) {
+      int lines[4] = {top, top, bottom, bottom};
+      int samps[4] = {left, right, left, right};
+      for (int i=0; i<4; i++) {
+        lineMap[lines[i]][samps[i]] = corner[i].valid ? corner[i].line : Isis::NULL8;
+        sampMap[lines[i]][samps[i]] = corner[i].samp;
+      }
+      return;
+    }
+
+    int midLine = (top + bottom) / 2;
+    int midSamp = (left + right) / 2;
+
+    GridPoint upper, lower, leftMid, rightMid, center;
+    vector<GridPoint> checks;
+    vector<int> checkLines, checkSamps;
+    if (splitSamps) {
+      upper = GridXform(trans,otile,top,midSamp);
+      lower = GridXform(trans,otile,bottom,midSamp);
+      checks.push_back(upper);
+      checkLines.push_back(top);
+      checkSamps.push_back(midSamp);
+      checks.push_back(lower);
+      checkLines.push_back(bottom);
+      checkSamps.push_back(midSamp);
+    }
+    if (splitLines) {
+      leftMid = GridXform(trans,otile,midLine,left);
+      rightMid = GridXform(trans,otile,midLine,right);
+      checks.push_back(leftMid);
+      checkLines.push_back(midLine);
+      checkSamps.push_back(left);
+      checks.push_back(rightMid);
+      checkLines.push_back(midLine);
+      checkSamps.push_back(right);
+    }
+    if (splitLines && splitSamps) {
+      center = GridXform(trans,otile,midLine,midSamp);
+      checks.push_back(center);
+      checkLines.push_back(midLine);
+      checkSamps.push_back(midSamp);
+    }
+
+    int valid = 0;
+    for (int i=0; i<4; i++) {
+      if (corner[i].valid) valid++;
+    }
+    for (unsigned int i=0; i<checks.size(); i++) {
+      if (checks[i].valid) valid++;
+    }
+
+    // Nothing in the cell, fill with nulls
+    if (valid == 0) {
+      for (int line=top; line<=bottom; line++) {
+        for (int samp=left; samp<=right; samp++) {
+          lineMap[line][samp] = Isis::NULL8;
+        }
+      }
+      return;
+    }
+
+    // See if the bilinear interpolation of the corners is good enough
+    bool interpolate = (valid == 4 + (int)checks.size());
+    for (unsigned int i=0; interpolate && (i<checks.size()); i++) {
+      double u = (double)(checkSamps[i] - left) / (double)(right - left);
+      double v = (double)(checkLines[i] - top) / (double)(bottom - top);
+      GridPoint estimate = GridBilinear(corner,u,v);
+      if ((abs(estimate.line - checks[i].line) > p_gridTolerance) ||
+          (abs(estimate.samp - checks[i].samp) > p_gridTolerance)) {
+        interpolate = false;
+      }
+    }
+
+    if (interpolate) {
+      for (int line=top; line<=bottom; line++) {
+        double v = (double)(line - top) / (double)(bottom - top);
+        std::vector<double> &lineVect = lineMap[line];
+        std::vector<double> &sampleVect = sampMap[line];
+        for (int samp=left; samp<=right; samp++) {
+          double u = (double)(samp - left) / (double)(right - left);
+          GridPoint estimate = GridBilinear(corner,u,v);
+          lineVect[samp] = estimate.line;
+          sampleVect[samp] = estimate.samp;
+        }
+      }
+      return;
+    }
+
+    // Split the cell reusing the points evaluated as the new corners
+    GridPoint sub[4];
+    if (splitLines && splitSamps) {
+      sub[0] = corner[0]; sub[1] = upper; sub[2] = leftMid; sub[3] = center;
+      GridCell(trans,otile,top,midLine,left,midSamp,sub,lineMap,sampMap);
+      sub[0] = upper; sub[1] = corner[1]; sub[2] = center; sub[3] = rightMid;
+      GridCell(trans,otile,top,midLine,midSamp,right,sub,lineMap,sampMap);
+      sub[0] = leftMid; sub[1] = center; sub[2] = corner[2]; sub[3] = lower;
+      GridCell(trans,otile,midLine,bottom,left,midSamp,sub,lineMap,sampMap);
+      sub[0] = center; sub[1] = rightMid; sub[2] = lower; sub[3] = corner[3];
+      GridCell(trans,otile,midLine,bottom,midSamp,right,sub,lineMap,sampMap);
+    }
+    else if (splitSamps) {
+      sub[0] = corner[0]; sub[1] = upper; sub[2] = corner[2]; sub[3] = lower;
+      GridCell(trans,otile,top,bottom,left,midSamp,sub,lineMap,sampMap);
+      sub[0] = upper; sub[1] = corner[1]; sub[2] = lower; sub[3] = corner[3];
+      GridCell(trans,otile,top,bottom,midSamp,right,sub,lineMap,sampMap);
+    }
+    else {
+      sub[0] = corner[0]; sub[1] = corner[1]; sub[2] = leftMid; sub[3] = rightMid;
+      GridCell(trans,otile,top,midLine,left,right,sub,lineMap,sampMap);
+      sub[0] = leftMid; sub[1] = rightMid; sub[2] = corner[2]; sub[3] = corner[3];
+      GridCell(trans,otile,midLine,bottom,left,right,sub,lineMap,sampMap);
+    }
+  }
+
+
+  /**
+   * Transforms a pixel of the output tile to the input cube.
+   *
+   * @param trans The transform
+   * @param otile The output tile
+   * @param line Line of the pixel in the tile, starting at zero
+   * @param samp Sample of the pixel in the tile, starting at zero
+   *
+   * @return ProcessRubberSheet::GridPoint The input position
+   */
+  ProcessRubberSheet::GridPoint ProcessRubberSheet::GridXform(Isis::Transform &trans,
+                                                              Isis::TileManager &otile,
+                                                              int line, int samp) {
+    GridPoint point;
+    point.line = 0.0;
+    point.samp = 0.0;
+    point.valid = trans.Xform(point.samp,point.line,otile.Sample()+samp,
+                              otile.Line()+line);
+    return point;
+  }
+
+
+  /**
+   * Bilinearly interpolates the input position within a cell of the grid.
+   *
+   * @param corner The upper left, upper right, lower left and lower right
+   *               corners of the cell
+   * @param u Fraction of the way across the cell
+   * @param v Fraction of the way down the cell
+   *
+   * @return ProcessRubberSheet::GridPoint The interpolated input position
+   */
+  ProcessRubberSheet::GridPoint ProcessRubberSheet::GridBilinear(GridPoint corner[4],
+                                                                 double u, double v) {
+    GridPoint point;
+    point.line = (1.0 - v) * ((1.0 - u) * corner[0].line + u * corner[1].line) +
+                 v * ((1.0 - u) * corner[2].line + u * corner[3].line);
+    point.samp = (1.0 - v) * ((1.0 - u) * corner[0].samp + u * corner[1].samp) +
+                 v * ((1.0 - u) * corner[2].samp + u * corner[3].samp);
+    point.valid = true;
+    return point;
+  }
+
+
+  /**
+   * Returns the size of the output tiles. The grid does not depend on the
+   * quad tree tiling, so it uses tiles of at least 128 pixels even for
+   * cameras hinting that the quad tree should not be used.
+   *
+   * @return int The number of lines and samples in a tile
+   */
+  int ProcessRubberSheet::TileSize() const {
+    if ((p_gridSpacing > 0) && (p_startQuadSize < 128)) return 128;
+    return p_startQuadSize;
+  }
+
   
   // Process a quad trying to find input positions for output positions
   void ProcessRubberSheet::ProcessQuad (std::vector<Quad *> &quadTree, Isis::Transform &trans,
@@ -30,6 +30,8 @@
 #include "TileManager.h"
 
 namespace Isis {
+  class RubberSheetTiles;
+
 /**                                                                       
  * @brief Derivative of Process, designed for geometric transformations                
  *                                                                        
@@ -89,6 +91,10 @@ namespace Isis {
  *  @history 2009-06-05 Steven Lambright - Added TestLine(...) method and made the checking
  *             for inserting a null tile more strict (checks the outline of a 2x2 box instead 
  *             of just the outline of the quad).
+ *  @history 2026-10-17 Unknown - Added a StartProcess method taking one
+ *             transform per thread which processes output tiles in parallel
+ *  @history 2026-10-17 Unknown - Added SetGrid to fill the tiles from the
+ *             transform evaluated on a refined grid instead of the quad tree
  */                                                                       
 
   class ProcessRubberSheet : public Isis::Process {
@@ -100,6 +106,8 @@ namespace Isis {
         p_forceLine = Isis::Null;
         p_startQuadSize = startSize;
         p_endQuadSize = endSize;
+        p_gridSpacing = 0;
+        p_gridTolerance = 0.5;
       };
 
       //! Destroys the RubberSheet object.
@@ -107,6 +115,10 @@ namespace Isis {
   
       // Line Processing method for one input and output cube
       void StartProcess (Isis::Transform &trans, Isis::Interpolator &interp);
+
+      // Process tiles in parallel with one thread per transform
+      void StartProcess (std::vector<Isis::Transform *> &trans,
+                         Isis::Interpolator &interp);
   
       // Register a function to be called when the band number changes
       void BandChange (void (*funct)(const int band));
@@ -128,7 +140,26 @@ namespace Isis {
          p_endQuadSize = end;
       }
 
+      /**
+       * Evaluates the transform on a grid instead of using the quad tree.
+       * The transform is evaluated every spacing output pixels and the
+       * positions in between are interpolated where the interpolation is
+       * within tolerance of the transform, refining the grid elsewhere. The
+       * cost then depends on how nonlinear the geometry is rather than on
+       * the number of pixels, for any camera.
+       *
+       * @param spacing Output pixels between grid points; 0 (the default)
+       *                uses the quad tree
+       * @param tolerance Largest interpolation error allowed in input pixels
+       */
+      void SetGrid(int spacing, double tolerance = 0.5) {
+        p_gridSpacing = spacing;
+        p_gridTolerance = tolerance;
+      }
+
     private:
+      friend class RubberSheetWorker;
+
       class Quad {
         public:
           int slineTile;
@@ -138,6 +169,13 @@ namespace Isis {
           int eline;
           int esamp;
       };
+
+      class GridPoint {
+        public:
+          double line;
+          double samp;
+          bool valid;
+      };
       
       void ProcessQuad (std::vector<Quad *> &quadTree, Isis::Transform &trans,
                         std::vector< std::vector<double> > &lineMap, 
@@ -154,7 +192,23 @@ namespace Isis {
                      Isis::Transform &trans, Isis::Interpolator &interp);
       void QuadTree (Isis::TileManager &otile, Isis::Portal &iportal, 
                      Isis::Transform &trans, Isis::Interpolator &interp,
-                     bool useLastTileMap);
+                     bool useLastTileMap,
+                     std::vector< std::vector<double> > &lineMap,
+                     std::vector< std::vector<double> > &sampMap);
+      void TransformTiles (RubberSheetTiles &tiles, Isis::Transform &trans,
+                           Isis::Interpolator &interp);
+      void GridMap (Isis::TileManager &otile, Isis::Transform &trans,
+                    std::vector< std::vector<double> > &lineMap,
+                    std::vector< std::vector<double> > &sampMap);
+      void GridCell (Isis::Transform &trans, Isis::TileManager &otile,
+                     int top, int bottom, int left, int right,
+                     GridPoint corner[4],
+                     std::vector< std::vector<double> > &lineMap,
+                     std::vector< std::vector<double> > &sampMap);
+      GridPoint GridXform (Isis::Transform &trans, Isis::TileManager &otile,
+                           int line, int samp);
+      GridPoint GridBilinear (GridPoint corner[4], double u, double v);
+      int TileSize () const;
                      
       bool TestLine(Isis::Transform &trans, int ssamp, int esamp, int sline, int eline, int increment);
 
@@ -168,6 +222,9 @@ namespace Isis {
 
       int p_startQuadSize;
       int p_endQuadSize;
+
+      int p_gridSpacing;        //!< Output pixels between grid points
+      double p_gridTolerance;   //!< Largest grid interpolation error
   };
 };
 
@@ -2,6 +2,8 @@
 #include "Transform.h"
 #include "Interpolator.h"
 #include "ProcessRubberSheet.h"
+#include "Cube.h"
+#include "LineManager.h"
 
 using namespace std;
 class UnitTestTrans : public Isis::Transform {
@@ -47,6 +49,34 @@ class UnitTestTrans : public Isis::Transform {
     };
 };
 
+// The same mirror as UnitTestTrans without the output, for use in threads
+class QuietTrans : public Isis::Transform {
+  private:
+    int p_outSamps;
+    int p_outLines;
+
+  public:
+    QuietTrans (const int inSamps, const int inLines) {
+      p_outSamps = inSamps;
+      p_outLines = inLines;
+    };
+
+    ~QuietTrans () {};
+
+    int OutputSamples () const {return p_outSamps;};
+    int OutputLines () const {return p_outLines;};
+    bool Xform (double &inSample, double &inLine,
+                    const double outSample,
+                    const double outLine) {
+      inSample = outSample;
+      if (outSample > 64) {
+        inSample = 127 - (outSample - 64);
+      }
+      inLine = outLine;
+      return true;
+    };
+};
+
 void IsisMain() {
 
   Isis::Preference::Preferences(true);
@@ -89,6 +119,71 @@ void IsisMain() {
     cout << endl;
   }
 
+  cout << "Testing threads ... " << endl;
+  Isis::CubeAttributeOutput att;
+  Isis::ProcessRubberSheet serial;
+  serial.SetTiling(32, 4);
+  serial.SetInputCube("FROM");
+  serial.SetOutputCube("/tmp/isisRubberSheet_02", att, 126, 126, 2);
+  QuietTrans quiet(126, 126);
+  serial.StartProcess(quiet, *interp);
+  serial.EndProcess();
+
+  Isis::ProcessRubberSheet threaded;
+  threaded.SetTiling(32, 4);
+  threaded.SetInputCube("FROM");
+  threaded.SetOutputCube("/tmp/isisRubberSheet_03", att, 126, 126, 2);
+  vector<Isis::Transform *> transforms;
+  for (int i=0; i<4; i++) {
+    transforms.push_back(new QuietTrans(126, 126));
+  }
+  threaded.StartProcess(transforms, *interp);
+  threaded.EndProcess();
+  for (unsigned int i=0; i<transforms.size(); i++) {
+    delete transforms[i];
+  }
+
+  Isis::Cube one, two;
+  one.Open("/tmp/isisRubberSheet_02");
+  two.Open("/tmp/isisRubberSheet_03");
+  Isis::LineManager oneLine(one);
+  Isis::LineManager twoLine(two);
+  int differences = 0;
+  for (oneLine.begin(), twoLine.begin(); !oneLine.end(); oneLine++, twoLine++) {
+    one.Read(oneLine);
+    two.Read(twoLine);
+    for (int i=0; i<oneLine.size(); i++) {
+      if (oneLine[i] != twoLine[i]) differences++;
+    }
+  }
+  cout << "Differences from serial:  " << differences << endl;
+  two.Close(true);
+  cout << endl;
+
+  cout << "Testing grid ... " << endl;
+  Isis::ProcessRubberSheet grid;
+  grid.SetGrid(8, 0.1);
+  grid.SetInputCube("FROM");
+  grid.SetOutputCube("/tmp/isisRubberSheet_04", att, 126, 126, 2);
+  grid.StartProcess(quiet, *interp);
+  grid.EndProcess();
+
+  Isis::Cube three;
+  three.Open("/tmp/isisRubberSheet_04");
+  Isis::LineManager threeLine(three);
+  differences = 0;
+  for (oneLine.begin(), threeLine.begin(); !oneLine.end(); oneLine++, threeLine++) {
+    one.Read(oneLine);
+    three.Read(threeLine);
+    for (int i=0; i<oneLine.size(); i++) {
+      if (oneLine[i] != threeLine[i]) differences++;
+    }
+  }
+  cout << "Differences from quad tree:  " << differences << endl;
+  one.Close(true);
+  three.Close(true);
+  cout << endl;
+
   delete trans;
   delete interp;
   remove("/tmp/isisRubberSheet_01.cub");
@@ -24,12 +24,14 @@
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <QMutexLocker>
 #include "naif/SpiceUsr.h"
 
 #include "Projection.h"
 #include "iException.h"
 #include "Constants.h"
 #include "Filename.h"
+#include "NaifStatus.h"
 
 using namespace std;
 namespace Isis {
@@ -1108,6 +1110,8 @@ namespace Isis {
    */
 
   PvlGroup Projection::TargetRadii (std::string target) {
+    QMutexLocker lock(NaifStatus::Mutex());
+
     // Convert the target name to a NAIF code
     SpiceInt code;
     SpiceBoolean found;
@@ -105,6 +105,8 @@ namespace Isis {
    *           method for convenience.  TargetRadii, which takes
    *           a Pvl, the cube label, and a PvlGroup, a mapping
    *           group.
+   *  @history 2026-10-18 Unknown - TargetRadii holds NaifStatus::Mutex while it
+   *           loads the planetary constants kernel.
    *
    */
   class Projection {
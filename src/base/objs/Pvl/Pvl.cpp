@@ -24,7 +24,7 @@
 #include "Filename.h"
 #include "iException.h"
 #include "Message.h"
-#include "PvlTokenizer.h"
+#include "PvlParser.h"
 #include "PvlFormat.h"
 
 using namespace std;
@@ -75,7 +75,25 @@ namespace Isis {
       throw Isis::iException::Message(Isis::iException::Io,message,_FILEINFO_);
     }
   
-    // Read it
+    // Read it in one pass.  If that fails remove what was read and read it
+    // again with the stream operator, which reports where and why it failed.
+    int keywords = Keywords();
+    int groups = Groups();
+    int objects = Objects();
+    try {
+      PvlParser::Read(istm, *this);
+      istm.close();
+      return;
+    }
+    catch (iException &e) {
+      e.Clear();
+      while (Keywords() > keywords) DeleteKeyword(Keywords() - 1);
+      while (Groups() > groups) DeleteGroup(Groups() - 1);
+      while (Objects() > objects) DeleteObject(Objects() - 1);
+      istm.clear();
+      istm.seekg(0, ios::beg);
+    }
+
     try {
       istm >> *this;
     }
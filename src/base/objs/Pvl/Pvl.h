@@ -121,6 +121,8 @@ namespace Isis {
   *  @history 2008-10-2 Christopher Austin - Replaced all std::endl in the <<
   *           operator, Write() and Append() with PvlFormat.FormatEOL()
   *  @history 2009-12-17 Steven Lambright - Rewrote read (istream operator)
+  *  @history 2026-10-17 Unknown - Read now reads files in one pass with
+  *           PvlParser, and only uses the istream operator to report errors
   *
   *  @todo 2005-02-14 add coded example to class documentation.                                                      
   */                                                                         
@@ -0,0 +1,489 @@
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+#include "PvlParser.h"
+
+#include <cctype>
+
+#include "iException.h"
+#include "iString.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+#include "PvlObject.h"
+
+using namespace std;
+
+namespace Isis {
+
+  //! Size of the buffer the stream is read through
+  static const int bufferSize = 65536;
+
+  //! Builds a PvlObject for PvlParser::Read
+  class PvlBuilder : public PvlParser {
+    public:
+      PvlBuilder(PvlObject &result) : p_group(NULL) {
+        p_objects.push_back(&result);
+      };
+
+    protected:
+      bool StartObject(const PvlKeyword &object) {
+        PvlObject &parent = *p_objects.back();
+        parent.AddObject(PvlObject(object[0]));
+        PvlObject &child = parent.Object(parent.Objects() - 1);
+        for (int i = 0; i < object.Comments(); i++) {
+          child.AddComment(object.Comment(i));
+        }
+        p_objects.push_back(&child);
+        return true;
+      }
+
+      void EndObject() {
+        p_objects.pop_back();
+      }
+
+      bool StartGroup(const PvlKeyword &group) {
+        PvlObject &parent = *p_objects.back();
+        parent.AddGroup(PvlGroup(group[0]));
+        p_group = &parent.Group(parent.Groups() - 1);
+        for (int i = 0; i < group.Comments(); i++) {
+          p_group->AddComment(group.Comment(i));
+        }
+        return true;
+      }
+
+      void EndGroup() {
+        p_group = NULL;
+      }
+
+      void Keyword(const PvlKeyword &keyword) {
+        if (p_group != NULL) {
+          p_group->AddKeyword(keyword);
+        }
+        else {
+          p_objects.back()->AddKeyword(keyword);
+        }
+      }
+
+    private:
+      //! Objects being read into, innermost last
+      std::vector<PvlObject *> p_objects;
+      PvlGroup *p_group; //!< Group being read into, if any
+  };
+
+
+  //! Constructs a PvlParser
+  PvlParser::PvlParser() {
+    p_stream = NULL;
+    p_pos = 0;
+    p_size = 0;
+    p_end = true;
+    p_line = 0;
+    p_keywordLine = 0;
+  }
+
+
+  /**
+   * Parses Pvl from a stream, calling the virtual methods for each object,
+   * group and keyword read.  Parsing stops at an End keyword outside of any
+   * object, at the end of the stream, or at a character which is not
+   * printable ascii following a keyword outside of any object, as it does for
+   * an attached cube label.
+   *
+   * The stream is read through a buffer, so it will be positioned past the
+   * end of the Pvl afterwards.
+   *
+   * @param is The stream to parse
+   *
+   * @throws Isis::iException::Programmer - The stream has an error state
+   * @throws Isis::iException::Pvl - The stream is not valid Pvl
+   */
+  void PvlParser::Parse(std::istream &is) {
+    if (!is.good()) {
+      string msg = "Tried to parse an input stream with an error state";
+      throw iException::Message(iException::Programmer, msg, _FILEINFO_);
+    }
+
+    p_stream = &is;
+    p_buffer.resize(bufferSize);
+    p_pos = 0;
+    p_size = 0;
+    p_end = false;
+    p_line = 1;
+    p_keywordLine = 1;
+
+    // Name of each open object or group, and whether it is an object
+    vector< pair<string, bool> > open;
+
+    // Number of open objects and groups which are being skipped
+    int skip = 0;
+
+    bool first = true;
+    while (first || !open.empty() || !AtEnd()) {
+      first = false;
+
+      if (!ReadKeyword()) {
+        if (open.empty()) return;
+
+        string msg;
+        if (open.back().second) {
+          msg = "Object [" + open.back().first +
+                "] EndObject not found before end of file";
+        }
+        else {
+          msg = "Group [" + open.back().first +
+                "] EndGroup not found before end of file";
+        }
+        Error(msg);
+      }
+
+      // Only compare names which could be Object, Group, End, EndObject or
+      // EndGroup, as most keywords are none of these
+      string::size_type start = p_name.find_first_not_of(" _\t\n\r\v\f");
+      char initial = (start == string::npos) ? ' ' : toupper(p_name[start]);
+      bool special = (initial == 'O' || initial == 'G' || initial == 'E');
+
+      bool object = special && PvlKeyword::StringEqual(p_name, "Object");
+      bool group = special && PvlKeyword::StringEqual(p_name, "Group");
+      bool endObject = special && PvlKeyword::StringEqual(p_name, "EndObject");
+      bool endGroup = special && PvlKeyword::StringEqual(p_name, "EndGroup");
+
+      if (object || group) {
+        if (!open.empty() && !open.back().second) {
+          Error("Unexpected [" + p_name + "] in Group [" +
+                open.back().first + "]");
+        }
+
+        if (p_values.size() != 1) {
+          string msg = "Expected a single value for ";
+          msg += (object ? "object" : "group");
+          msg += " name, found [(";
+          for (unsigned int i = 0; i < p_values.size(); i++) {
+            if (i != 0) msg += ", ";
+            msg += p_values[i].first;
+          }
+          msg += ")]";
+          Error(msg);
+        }
+
+        open.push_back(pair<string, bool>(p_values[0].first, object));
+        if (skip > 0) {
+          skip++;
+        }
+        else {
+          PvlKeyword header = BuildKeyword();
+          if (!(object ? StartObject(header) : StartGroup(header))) skip = 1;
+        }
+      }
+      else if (endObject || endGroup) {
+        if (open.empty()) {
+          Error("Unexpected [" + p_name + "] in Object [ROOT]");
+        }
+        if (open.back().second != endObject) {
+          string container = open.back().second ? "Object" : "Group";
+          Error("Unexpected [" + p_name + "] in " + container + " [" +
+                open.back().first + "]");
+        }
+
+        open.pop_back();
+        if (skip > 0) {
+          skip--;
+        }
+        else if (endObject) {
+          EndObject();
+        }
+        else {
+          EndGroup();
+        }
+      }
+      else if (special && open.empty() &&
+               PvlKeyword::StringEqual(p_name, "End")) {
+        return;
+      }
+      else if (skip == 0) {
+        Keyword(BuildKeyword());
+      }
+    }
+  }
+
+
+  /**
+   * Reads Pvl from a stream into a PvlObject.  Objects, groups and keywords
+   * read are added to those already in the object.
+   *
+   * @param is The stream to read
+   * @param result The object to add what is read to
+   *
+   * @throws Isis::iException::Pvl - The stream is not valid Pvl
+   */
+  void PvlParser::Read(std::istream &is, PvlObject &result) {
+    PvlBuilder builder(result);
+    builder.Parse(is);
+  }
+
+
+  /**
+   * Called when an object is read.  The default does nothing.
+   *
+   * @param object The Object keyword, with the object name as its value and
+   *               the object comments as its comments
+   *
+   * @return bool False to skip the object
+   */
+  bool PvlParser::StartObject(const PvlKeyword &object) {
+    return true;
+  }
+
+
+  //! Called when the end of an object which was not skipped is read
+  void PvlParser::EndObject() {
+  }
+
+
+  /**
+   * Called when a group is read.  The default does nothing.
+   *
+   * @param group The Group keyword, with the group name as its value and the
+   *              group comments as its comments
+   *
+   * @return bool False to skip the group
+   */
+  bool PvlParser::StartGroup(const PvlKeyword &group) {
+    return true;
+  }
+
+
+  //! Called when the end of a group which was not skipped is read
+  void PvlParser::EndGroup() {
+  }
+
+
+  /**
+   * Called for each keyword which is not in a skipped object or group.  The
+   * default does nothing.
+   *
+   * @param keyword The keyword read
+   */
+  void PvlParser::Keyword(const PvlKeyword &keyword) {
+  }
+
+
+  /**
+   * Reads the next keyword, with its comments, into p_name, p_comments and
+   * p_values.  Lines are joined the same way the PvlKeyword stream operator
+   * joins them.
+   *
+   * @return bool False if the end of the Pvl was reached before a keyword
+   */
+  bool PvlParser::ReadKeyword() {
+    string keyword;
+    string line;
+
+    while (true) {
+      int lineNumber = p_line;
+      if (!ReadLine(line)) {
+        if (keyword.empty() || keyword[keyword.size() - 1] == '\n') {
+          return false;
+        }
+
+        // Skip the comments
+        keyword = keyword.substr(keyword.rfind('\n') + 1);
+        Error("The keyword [" + keyword + "] does not appear to be a valid "
+              "Pvl Keyword");
+      }
+
+      bool comment = (line[0] == '#') ||
+                     (line.size() > 1 && line[0] == '/' &&
+                      (line[1] == '*' || line[1] == '/'));
+
+      if (!comment &&
+          (keyword.empty() || keyword[keyword.size() - 1] == '\n')) {
+        p_keywordLine = lineNumber;
+      }
+
+      if (comment) {
+        keyword += line;
+        keyword += '\n';
+        continue;
+      }
+      else if (keyword.empty()) {
+        keyword = line;
+      }
+      else if (keyword[keyword.size() - 1] == '-') {
+        keyword.erase(keyword.size() - 1);
+        keyword += line;
+      }
+      else {
+        keyword += ' ';
+        keyword += line;
+      }
+
+      // Continued on the next line, or units on the next line
+      if (line[line.size() - 1] == '-') continue;
+      if (Peek() == '<') continue;
+
+      p_name.clear();
+      p_comments.clear();
+      p_values.clear();
+
+      bool complete = false;
+      try {
+        complete = PvlKeyword::ReadCleanKeyword(keyword, p_comments, p_name,
+                                                p_values);
+      }
+      catch (iException &e) {
+        Error("Unable to read keyword [" + keyword + "]");
+      }
+
+      if (complete) return true;
+    }
+  }
+
+
+  /**
+   * Reads the next line which is not blank, without leading and trailing
+   * white space, and skips the spaces and blank lines which follow it.  A
+   * character which is not ascii ends the Pvl.
+   *
+   * @param line Returns the line read
+   *
+   * @return bool False if the end of the Pvl was reached before a line
+   */
+  bool PvlParser::ReadLine(std::string &line) {
+    line.clear();
+
+    while (line.empty()) {
+      bool newline = false;
+      while (!newline) {
+        int next = Get();
+        if (next < 0) break;
+
+        if (next > 127) {
+          p_end = true;
+          return !line.empty();
+        }
+
+        if (next == '\n') {
+          p_line++;
+          newline = true;
+        }
+        line += (char)next;
+      }
+
+      if (!newline && line.empty()) return false;
+
+      string::size_type start = line.find_first_not_of(" \r\n\t");
+      if (start == string::npos) {
+        line.clear();
+      }
+      else {
+        line = line.substr(start, line.find_last_not_of(" \r\n\t") - start + 1);
+      }
+
+      int next = Peek();
+      while (next == ' ' || next == '\r' || next == '\n') {
+        Get();
+        if (next == '\n') p_line++;
+        next = Peek();
+      }
+    }
+
+    return true;
+  }
+
+
+  /**
+   * Returns the next character of the stream, filling the buffer when it is
+   * empty.
+   *
+   * @return int The character, or -1 at the end of the Pvl
+   */
+  int PvlParser::Get() {
+    if (p_end) return -1;
+
+    if (p_pos == p_size) {
+      if (!p_stream->good()) return -1;
+
+      p_stream->read(&p_buffer[0], p_buffer.size());
+      p_size = p_stream->gcount();
+      p_pos = 0;
+      if (p_size == 0) return -1;
+    }
+
+    return (unsigned char)p_buffer[p_pos++];
+  }
+
+
+  /**
+   * Returns the next character of the stream without reading it
+   *
+   * @return int The character, or -1 at the end of the Pvl
+   */
+  int PvlParser::Peek() {
+    int next = Get();
+    if (next >= 0) p_pos--;
+    return next;
+  }
+
+
+  /**
+   * Tests whether the next character ends the Pvl outside of any object,
+   * either because there are none left or because it is not printable ascii
+   * (the data following an attached label)
+   *
+   * @return bool True if the Pvl has ended
+   */
+  bool PvlParser::AtEnd() {
+    int next = Peek();
+    return next < 32 || next > 126;
+  }
+
+
+  /**
+   * Builds a PvlKeyword from the last keyword read
+   *
+   * @return PvlKeyword The keyword
+   */
+  PvlKeyword PvlParser::BuildKeyword() const {
+    PvlKeyword keyword(p_name);
+    keyword.AddComments(p_comments);
+    for (unsigned int i = 0; i < p_values.size(); i++) {
+      keyword.AddValue(p_values[i].first, p_values[i].second);
+    }
+    return keyword;
+  }
+
+
+  /**
+   * Throws an error in the Pvl, giving the line of the last keyword read
+   *
+   * @param message The error
+   *
+   * @throws Isis::iException::Pvl - Always
+   */
+  void PvlParser::Error(const std::string &message) const {
+    try {
+      throw iException::Message(iException::Pvl, message, _FILEINFO_);
+    }
+    catch (iException &e) {
+      string msg = "Error in pvl on line [" + iString(p_keywordLine) + "]";
+      throw iException::Message(iException::Pvl, msg, _FILEINFO_);
+    }
+  }
+}
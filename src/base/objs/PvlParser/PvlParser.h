@@ -0,0 +1,117 @@
+#ifndef PvlParser_h
+#define PvlParser_h
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Isis {
+  class PvlKeyword;
+  class PvlObject;
+
+  /**
+   * @brief Single pass Pvl parser
+   *
+   * This class parses Pvl from a stream in one pass.  The stream is read
+   * through a large buffer rather than a character at a time, and is never
+   * repositioned, so each line is read exactly once.  Keywords are assembled
+   * with the same rules as the PvlKeyword stream operator: comments,
+   * continuation lines ending in '-', unit lines starting with '<' and
+   * values spanning several lines.
+   *
+   * Parse reports what it reads to a set of virtual methods, in the order it
+   * is read.  The default methods do nothing, so a class derived from this one
+   * only overrides the ones it needs.  Returning false from StartObject or
+   * StartGroup skips that object or group: nothing inside it is reported,
+   * including its EndObject or EndGroup, and no keywords are built for it.
+   * @code
+   *   class ImageCounter : public Isis::PvlParser {
+   *     public:
+   *       ImageCounter() : images(0) {};
+   *       int images;
+   *     protected:
+   *       bool StartObject(const PvlKeyword &object) {
+   *         if (object[0] == "Image") images++;
+   *         return false;
+   *       }
+   *   };
+   * @endcode
+   *
+   * Read uses this class to build a PvlObject, adding each object and group
+   * to its parent before it is filled in rather than copying it in once it
+   * has been read.  Pvl::Read reads files this way.
+   *
+   * @ingroup Parsing
+   *
+   * @see Pvl
+   * @see PvlKeyword
+   *
+   * @author 2026-10-17 Unknown
+   *
+   * @internal
+   */
+  class PvlParser {
+    public:
+      PvlParser();
+      virtual ~PvlParser() {};
+
+      void Parse(std::istream &is);
+
+      static void Read(std::istream &is, PvlObject &result);
+
+    protected:
+      virtual bool StartObject(const PvlKeyword &object);
+      virtual void EndObject();
+      virtual bool StartGroup(const PvlKeyword &group);
+      virtual void EndGroup();
+      virtual void Keyword(const PvlKeyword &keyword);
+
+      //! Returns the line the last keyword read started on
+      int Line() const { return p_keywordLine; };
+
+    private:
+      bool ReadKeyword();
+      bool ReadLine(std::string &line);
+      int Get();
+      int Peek();
+      bool AtEnd();
+      PvlKeyword BuildKeyword() const;
+      void Error(const std::string &message) const;
+
+      std::istream *p_stream;      //!< Stream being parsed
+      std::vector<char> p_buffer;  //!< Characters read from the stream
+      int p_pos;                   //!< Next character in p_buffer
+      int p_size;                  //!< Characters in p_buffer
+      bool p_end;                  //!< Has the end of the Pvl been reached
+      int p_line;                  //!< Line of the next character
+      int p_keywordLine;           //!< Line the last keyword started on
+
+      std::string p_name;                      //!< Name of the last keyword
+      std::vector<std::string> p_comments;     //!< Comments of the last keyword
+      //! Values and units of the last keyword
+      std::vector< std::pair<std::string, std::string> > p_values;
+  };
+};
+
+#endif
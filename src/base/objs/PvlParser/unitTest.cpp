@@ -0,0 +1,143 @@
+#include <iostream>
+#include <sstream>
+
+#include "iException.h"
+#include "Preference.h"
+#include "Pvl.h"
+#include "PvlParser.h"
+
+using namespace Isis;
+using namespace std;
+
+/**
+ * Reports what it parses, skipping objects named Skip and groups named
+ * Skipped
+ */
+class Reporter : public PvlParser {
+  protected:
+    bool StartObject(const PvlKeyword &object) {
+      cout << "  Line " << Line() << ": Object " << object[0] << endl;
+      return object[0] != "Skip";
+    }
+
+    void EndObject() {
+      cout << "  Line " << Line() << ": EndObject" << endl;
+    }
+
+    bool StartGroup(const PvlKeyword &group) {
+      cout << "  Line " << Line() << ": Group " << group[0] << endl;
+      return group[0] != "Skipped";
+    }
+
+    void EndGroup() {
+      cout << "  Line " << Line() << ": EndGroup" << endl;
+    }
+
+    void Keyword(const PvlKeyword &keyword) {
+      cout << "  Line " << Line() << ": Keyword " << keyword.Name() << " = ";
+      for (int i = 0; i < keyword.Size(); i++) {
+        if (i != 0) cout << ", ";
+        cout << keyword[i];
+      }
+      cout << endl;
+    }
+};
+
+
+void ReadTest(const string &pvl) {
+  stringstream in(pvl);
+  Pvl result;
+  try {
+    PvlParser::Read(in, result);
+    cout << result << endl;
+  }
+  catch (iException &e) {
+    e.Report(false);
+  }
+  cout << endl;
+}
+
+
+int main () {
+  Preference::Preferences(true);
+
+  string label =
+    "# Comment on the object\n"
+    "Object = IsisCube\n"
+    "  Object = Core\n"
+    "    StartByte = 65537\n"
+    "    Format    = Tile\n"
+    "\n"
+    "    /* Comment on the group */\n"
+    "    Group = Dimensions\n"
+    "      Samples = 126\n"
+    "      Lines   = 126\n"
+    "    End_Group\n"
+    "  End_Object\n"
+    "\n"
+    "  Group = Instrument\n"
+    "    Temperatures = (12.5, 13.0,\n"
+    "                    13.5) <C>\n"
+    "    ExposureDuration = 1.5\n"
+    "                       <seconds>\n"
+    "    LongName = \"This is a long name which is contin-\n"
+    "               ued on the next line\"\n"
+    "  End_Group\n"
+    "End_Object\n"
+    "\n"
+    "Object = Skip\n"
+    "  Group = Inside\n"
+    "    Value = 1\n"
+    "  End_Group\n"
+    "  Object = Nested\n"
+    "    Value = 2\n"
+    "  End_Object\n"
+    "End_Object\n"
+    "\n"
+    "Group = Skipped\n"
+    "  Value = 3\n"
+    "End_Group\n"
+    "\n"
+    "Object = Label\n"
+    "  Bytes = 65536\n"
+    "End_Object\n"
+    "End\n"
+    "Value = 4\n";
+
+  cout << "Reading a label" << endl;
+  ReadTest(label);
+
+  cout << "Reading a label followed by binary data" << endl;
+  string attached = "Object = IsisCube\n  Bytes = 1\nEnd_Object\n";
+  attached += (char)0;
+  attached += "Value = 5\n";
+  ReadTest(attached);
+
+  cout << "Reading a label without an End" << endl;
+  ReadTest("Group = Dimensions\n  Samples = 126\nEnd_Group\nLines = 126");
+
+  cout << "Reporting a label" << endl;
+  stringstream in(label);
+  Reporter reporter;
+  reporter.Parse(in);
+  cout << endl;
+
+  cout << "Testing errors" << endl;
+  ReadTest("Object = A\n  Group = B\n    Value = 1\n  EndObject\n");
+  ReadTest("Object = A\n  Group = B\n    Value = 1\n  EndGroup\n");
+  ReadTest("Group = (A, B)\nEndGroup\n");
+  ReadTest("Value = 1\nEndGroup\n");
+  ReadTest("Value = (1,\n  2\n");
+  ReadTest("Value = \"1\" 2\n");
+
+  stringstream bad;
+  bad.setstate(ios::badbit);
+  try {
+    reporter.Parse(bad);
+  }
+  catch (iException &e) {
+    e.Report(false);
+  }
+
+  return 0;
+}
@@ -22,6 +22,7 @@
 
 #include "Sensor.h"
 #include "CubeManager.h"
+#include "NaifStatus.h"
 #include "iString.h"
 #include "iException.h"
 #include "iException.h"
@@ -29,6 +30,8 @@
 #include "SpecialPixel.h"
 #include <iomanip>
 
+#include <QMutexLocker>
+
 using namespace std;
 namespace Isis {
 
@@ -170,7 +173,10 @@ namespace Isis {
     // See if it intersects the planet
     SpiceBoolean found;
     std::vector<double> sB = BodyRotation()->ReferenceVector(InstrumentPosition()->Coordinate());
-    surfpt_c ((SpiceDouble *) &sB[0],p_lookB,a,b,c,p_pB,&found);
+    {
+      QMutexLocker lock(NaifStatus::Mutex());
+      surfpt_c ((SpiceDouble *) &sB[0],p_lookB,a,b,c,p_pB,&found);
+    }
     if (!found) {
       p_hasIntersection = false;
       return p_hasIntersection;
@@ -211,8 +217,11 @@ namespace Isis {
         pB[0] = p_pB[0];
         pB[1] = p_pB[1];
         pB[2] = p_pB[2];
-        surfpt_c ((SpiceDouble *)&sB[0], p_lookB, p_radius, p_radius, p_radius,
-                  p_pB, &found);
+        {
+          QMutexLocker lock(NaifStatus::Mutex());
+          surfpt_c ((SpiceDouble *)&sB[0], p_lookB, p_radius, p_radius, p_radius,
+                    p_pB, &found);
+        }
         if (!found) {
           p_hasIntersection = false;
           return p_hasIntersection;
@@ -119,6 +119,9 @@ namespace Isis {
  *  @history 2009-07-09 Debbie A. Cook - Corrected documentation on Resolution method
  *  @history 2009-09-23  Tracie Sucharski - Convert negative longitudes 
  *                         returned by reclat in SetLookDirection.
+ *  @history 2026-10-18 Unknown - SetLookDirection holds NaifStatus::Mutex
+ *                         around surfpt_c only, so cameras in different
+ *                         threads can intersect the surface together.
  *  
  */
   class Sensor : public Isis::Spice {
@@ -0,0 +1,341 @@
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <cmath>
+#include <set>
+
+#include "SparseBlockCholesky.h"
+#include "iException.h"
+#include "iString.h"
+
+namespace Isis {
+  /**
+   * Constructs an empty (all zero) matrix
+   *
+   * @param blocks Number of block rows and columns in the matrix
+   * @param blockSize Number of rows and columns in each block
+   */
+  SparseBlockCholesky::SparseBlockCholesky(int blocks, int blockSize) {
+    if (blocks < 1 || blockSize < 1) {
+      std::string msg = "A sparse block matrix must have at least one block ";
+      msg += "of at least one row";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+
+    p_blocks = blocks;
+    p_blockSize = blockSize;
+    p_factored = false;
+    p_factorBlocks = 0;
+    p_columns.resize(blocks);
+  }
+
+
+  /**
+   * Adds a block to the matrix.  As the matrix is symmetric, adding a block
+   * to (row,col) also adds its transpose to (col,row).  Diagonal blocks must
+   * be symmetric.
+   *
+   * @param row Block row, from 0 to Blocks()-1
+   * @param col Block column, from 0 to Blocks()-1
+   * @param block The BlockSize() by BlockSize() values to add, stored row by
+   *              row
+   */
+  void SparseBlockCholesky::Add(int row, int col,
+                                const std::vector<double> &block) {
+    if (p_factored) {
+      std::string msg = "Unable to add to a matrix which has been factored";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+    if (row < 0 || row >= p_blocks || col < 0 || col >= p_blocks) {
+      std::string msg = "Block [" + iString(row) + "," + iString(col) +
+                        "] is outside the matrix";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+    if ((int)block.size() != p_blockSize * p_blockSize) {
+      std::string msg = "Block size does not match the matrix block size";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+
+    int b = p_blockSize;
+    if (row >= col) {
+      std::vector<double> &dest = Block(row,col);
+      for (int i=0; i<b*b; i++) dest[i] += block[i];
+    }
+    else {
+      std::vector<double> &dest = Block(col,row);
+      for (int r=0; r<b; r++) {
+        for (int c=0; c<b; c++) dest[c*b+r] += block[r*b+c];
+      }
+    }
+  }
+
+
+  /**
+   * Adds all the blocks of another matrix to this matrix
+   *
+   * @param matrix An unfactored matrix with the same number and size of
+   *               blocks
+   */
+  void SparseBlockCholesky::Add(const SparseBlockCholesky &matrix) {
+    if (p_factored || matrix.p_factored) {
+      std::string msg = "Unable to add matrices which have been factored";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+    if (matrix.p_blocks != p_blocks || matrix.p_blockSize != p_blockSize) {
+      std::string msg = "Unable to add matrices of different sizes";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+
+    for (int col=0; col<p_blocks; col++) {
+      std::map<int, std::vector<double> >::const_iterator it;
+      for (it = matrix.p_columns[col].begin();
+           it != matrix.p_columns[col].end(); it++) {
+        std::vector<double> &dest = Block(it->first,col);
+        for (unsigned int i=0; i<dest.size(); i++) dest[i] += it->second[i];
+      }
+    }
+  }
+
+
+  /**
+   * Returns the stored block at (row,col), creating a zero block if there is
+   * none.  Row must be greater than or equal to col.
+   */
+  std::vector<double> &SparseBlockCholesky::Block(int row, int col) {
+    std::map<int, std::vector<double> > &column = p_columns[col];
+    std::map<int, std::vector<double> >::iterator it = column.find(row);
+    if (it == column.end()) {
+      it = column.insert(std::make_pair(row,
+                    std::vector<double>(p_blockSize*p_blockSize,0.0))).first;
+    }
+    return it->second;
+  }
+
+
+  /**
+   * Computes a minimum degree ordering of the blocks.  Each step eliminates
+   * the block with the fewest neighbors in the elimination graph and joins
+   * its neighbors, which are exactly the blocks it fills in.
+   */
+  void SparseBlockCholesky::Order() {
+    std::vector< std::set<int> > adjacent(p_blocks);
+    for (int col=0; col<p_blocks; col++) {
+      std::map<int, std::vector<double> >::iterator it;
+      for (it = p_columns[col].begin(); it != p_columns[col].end(); it++) {
+        if (it->first == col) continue;
+        adjacent[it->first].insert(col);
+        adjacent[col].insert(it->first);
+      }
+    }
+
+    std::vector<bool> eliminated(p_blocks,false);
+    p_perm.clear();
+    p_iperm.assign(p_blocks,0);
+    for (int k=0; k<p_blocks; k++) {
+      int next = -1;
+      for (int i=0; i<p_blocks; i++) {
+        if (eliminated[i]) continue;
+        if (next < 0 || adjacent[i].size() < adjacent[next].size()) next = i;
+      }
+
+      std::set<int> &neighbors = adjacent[next];
+      std::set<int>::iterator a,b;
+      for (a = neighbors.begin(); a != neighbors.end(); a++) {
+        adjacent[*a].erase(next);
+        for (b = neighbors.begin(); b != neighbors.end(); b++) {
+          if (*a != *b) adjacent[*a].insert(*b);
+        }
+      }
+      neighbors.clear();
+
+      eliminated[next] = true;
+      p_iperm[next] = k;
+      p_perm.push_back(next);
+    }
+  }
+
+
+  /**
+   * Factors the matrix into L L', where L is lower triangular.  Once the
+   * matrix is factored no more blocks can be added.
+   *
+   * @return int Zero if the factorization succeeded.  Otherwise the matrix is
+   *             not positive definite, and the number (starting at 1) of the
+   *             first block row in which a pivot was found to be zero or
+   *             negative is returned.  The matrix is left in an undefined
+   *             state.
+   */
+  int SparseBlockCholesky::Factor() {
+    if (p_factored) return 0;
+    int b = p_blockSize;
+
+    // Save the diagonal so pivots can be tested relative to it, then move
+    // the blocks to their positions in the permuted matrix
+    Order();
+    std::vector<double> diagonal(p_blocks*b,0.0);
+    std::vector< std::map<int, std::vector<double> > > original;
+    original.swap(p_columns);
+    p_columns.resize(p_blocks);
+    for (int col=0; col<p_blocks; col++) {
+      std::map<int, std::vector<double> >::iterator it;
+      for (it = original[col].begin(); it != original[col].end(); it++) {
+        int pr = p_iperm[it->first];
+        int pc = p_iperm[col];
+        if (it->first == col) {
+          for (int i=0; i<b; i++) {
+            diagonal[pc*b+i] = std::fabs(it->second[i*b+i]);
+          }
+        }
+        if (pr >= pc) {
+          Block(pr,pc).swap(it->second);
+        }
+        else {
+          std::vector<double> &dest = Block(pc,pr);
+          for (int r=0; r<b; r++) {
+            for (int c=0; c<b; c++) dest[c*b+r] = it->second[r*b+c];
+          }
+        }
+      }
+      original[col].clear();
+    }
+
+    for (int k=0; k<p_blocks; k++) {
+      std::map<int, std::vector<double> > &column = p_columns[k];
+
+      // Factor the diagonal block
+      std::vector<double> &d = Block(k,k);
+      for (int c=0; c<b; c++) {
+        double sum = d[c*b+c];
+        for (int t=0; t<c; t++) sum -= d[c*b+t] * d[c*b+t];
+        if (sum <= 1.0e-12 * diagonal[k*b+c]) return p_perm[k] + 1;
+        d[c*b+c] = sqrt(sum);
+        for (int r=c+1; r<b; r++) {
+          double v = d[r*b+c];
+          for (int t=0; t<c; t++) v -= d[r*b+t] * d[c*b+t];
+          d[r*b+c] = v / d[c*b+c];
+        }
+        for (int r=0; r<c; r++) d[r*b+c] = 0.0;
+      }
+
+      // Solve for the blocks below the diagonal, L(i,k) = A(i,k) L(k,k)'^-1
+      std::map<int, std::vector<double> >::iterator it,jt;
+      for (it = column.upper_bound(k); it != column.end(); it++) {
+        std::vector<double> &l = it->second;
+        for (int r=0; r<b; r++) {
+          for (int c=0; c<b; c++) {
+            double v = l[r*b+c];
+            for (int t=0; t<c; t++) v -= l[r*b+t] * d[c*b+t];
+            l[r*b+c] = v / d[c*b+c];
+          }
+        }
+      }
+
+      // Update the rest of the matrix, A(i,j) -= L(i,k) L(j,k)'
+      for (jt = column.upper_bound(k); jt != column.end(); jt++) {
+        const std::vector<double> &lj = jt->second;
+        for (it = jt; it != column.end(); it++) {
+          const std::vector<double> &li = it->second;
+          std::vector<double> &a = Block(it->first,jt->first);
+          for (int r=0; r<b; r++) {
+            for (int c=0; c<b; c++) {
+              double v = 0.0;
+              for (int t=0; t<b; t++) v += li[r*b+t] * lj[c*b+t];
+              a[r*b+c] -= v;
+            }
+          }
+        }
+      }
+      p_factorBlocks += column.size();
+    }
+
+    p_factored = true;
+    return 0;
+  }
+
+
+  /**
+   * Solves A x = rhs using the factored matrix
+   *
+   * @param rhs The Blocks()*BlockSize() right hand side values on input, and
+   *            the solution on output
+   */
+  void SparseBlockCholesky::Solve(std::vector<double> &rhs) const {
+    if (!p_factored) {
+      std::string msg = "The matrix must be factored before it can be solved";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+    int b = p_blockSize;
+    if ((int)rhs.size() != p_blocks * b) {
+      std::string msg = "Right hand side size does not match the matrix size";
+      throw iException::Message(iException::Programmer,msg,_FILEINFO_);
+    }
+
+    std::vector<double> y(p_blocks*b);
+    for (int k=0; k<p_blocks; k++) {
+      for (int t=0; t<b; t++) y[k*b+t] = rhs[p_perm[k]*b+t];
+    }
+
+    // Forward substitution, L z = y
+    std::map<int, std::vector<double> >::const_iterator it;
+    for (int k=0; k<p_blocks; k++) {
+      const std::map<int, std::vector<double> > &column = p_columns[k];
+      const std::vector<double> &d = column.find(k)->second;
+      for (int r=0; r<b; r++) {
+        double v = y[k*b+r];
+        for (int t=0; t<r; t++) v -= d[r*b+t] * y[k*b+t];
+        y[k*b+r] = v / d[r*b+r];
+      }
+      for (it = column.upper_bound(k); it != column.end(); it++) {
+        const std::vector<double> &l = it->second;
+        int i = it->first;
+        for (int r=0; r<b; r++) {
+          double v = 0.0;
+          for (int t=0; t<b; t++) v += l[r*b+t] * y[k*b+t];
+          y[i*b+r] -= v;
+        }
+      }
+    }
+
+    // Back substitution, L' x = z
+    for (int k=p_blocks-1; k>=0; k--) {
+      const std::map<int, std::vector<double> > &column = p_columns[k];
+      for (it = column.upper_bound(k); it != column.end(); it++) {
+        const std::vector<double> &l = it->second;
+        int i = it->first;
+        for (int c=0; c<b; c++) {
+          double v = 0.0;
+          for (int t=0; t<b; t++) v += l[t*b+c] * y[i*b+t];
+          y[k*b+c] -= v;
+        }
+      }
+      const std::vector<double> &d = column.find(k)->second;
+      for (int r=b-1; r>=0; r--) {
+        double v = y[k*b+r];
+        for (int t=r+1; t<b; t++) v -= d[t*b+r] * y[k*b+t];
+        y[k*b+r] = v / d[r*b+r];
+      }
+    }
+
+    for (int k=0; k<p_blocks; k++) {
+      for (int t=0; t<b; t++) rhs[p_perm[k]*b+t] = y[k*b+t];
+    }
+  }
+}
@@ -0,0 +1,100 @@
+#ifndef SparseBlockCholesky_h
+#define SparseBlockCholesky_h
+/**
+ * @file
+ *
+ *   Unless noted otherwise, the portions of Isis written by the USGS are
+ *   public domain. See individual third-party library and package descriptions
+ *   for intellectual property information, user agreements, and related
+ *   information.
+ *
+ *   Although Isis has been used by the USGS, no warranty, expressed or
+ *   implied, is made by the USGS as to the accuracy and functioning of such
+ *   software and related material nor shall the fact of distribution
+ *   constitute any such warranty, and no responsibility is assumed by the
+ *   USGS in connection therewith.
+ *
+ *   For additional information, launch
+ *   $ISISROOT/doc//documents/Disclaimers/Disclaimers.html
+ *   in a browser or see the Privacy &amp; Disclaimers page on the Isis website,
+ *   http://isis.astrogeology.usgs.gov, and the USGS privacy and disclaimers on
+ *   http://www.usgs.gov/privacy.html.
+ */
+
+#include <map>
+#include <vector>
+
+namespace Isis {
+  /**
+   * @brief Cholesky solver for sparse symmetric block matrices
+   *
+   * This class solves A x = b for a symmetric positive definite matrix A
+   * made of square blocks of equal size, most of which are zero.  Blocks are
+   * summed into the matrix with Add, the matrix is factored into L L' with
+   * Factor, and Solve then solves for any number of right hand sides.
+   *
+   * The blocks are reordered with a minimum degree ordering before the
+   * factorization to limit the fill in L.  Only the blocks of L which are
+   * not zero are stored, and all arithmetic is done on whole blocks, so the
+   * cost depends on the number of nonzero blocks rather than on the size of
+   * the matrix.  It is used by BundleAdjust to solve the reduced camera
+   * system, where there is one block per image and a block is nonzero when
+   * two images share a control point.
+   * @code
+   *   Isis::SparseBlockCholesky chol(3,2);
+   *   chol.Add(0,0,block00);
+   *   chol.Add(1,0,block10);
+   *   ...
+   *   if (chol.Factor() == 0) chol.Solve(rhs);
+   * @endcode
+   *
+   * @ingroup Math
+   *
+   * @see BundleAdjust
+   *
+   * @author 2026-10-17 Unknown
+   *
+   * @internal
+   *   @history 2026-10-17 Unknown - Added Add of a whole matrix, to sum
+   *                           matrices assembled by several threads
+   */
+  class SparseBlockCholesky {
+    public:
+      SparseBlockCholesky(int blocks, int blockSize);
+      ~SparseBlockCholesky() {};
+
+      void Add(int row, int col, const std::vector<double> &block);
+      void Add(const SparseBlockCholesky &matrix);
+      int Factor();
+      void Solve(std::vector<double> &rhs) const;
+
+      //! Returns the number of block rows (and columns) in the matrix
+      int Blocks() const { return p_blocks; };
+
+      //! Returns the number of rows (and columns) in each block
+      int BlockSize() const { return p_blockSize; };
+
+      //! Returns the number of nonzero blocks in the lower triangle of L
+      int FactorBlocks() const { return p_factorBlocks; };
+
+    private:
+      std::vector<double> &Block(int row, int col);
+      void Order();
+
+      int p_blocks;     //!< Number of block rows and columns
+      int p_blockSize;  //!< Rows and columns in each block
+      bool p_factored;  //!< Has Factor succeeded
+      int p_factorBlocks; //!< Nonzero blocks in the lower triangle of L
+
+      /**
+       * Lower triangle of the matrix, or of L once factored, by block column.
+       * Before factoring blocks are indexed by the original block numbers;
+       * afterwards by the permuted block numbers.
+       */
+      std::vector< std::map<int, std::vector<double> > > p_columns;
+      std::vector<int> p_perm;  //!< Original block number of each permuted block
+      std::vector<int> p_iperm; //!< Permuted block number of each original block
+  };
+};
+
+#endif
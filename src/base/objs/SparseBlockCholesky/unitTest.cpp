@@ -0,0 +1,150 @@
+#include <iostream>
+#include <iomanip>
+#include "SparseBlockCholesky.h"
+#include "iException.h"
+#include "Preference.h"
+
+using namespace std;
+
+//! Adds a 2x2 block to the sparse matrix and to a dense copy of it
+void AddBlock(Isis::SparseBlockCholesky &chol, vector<double> &dense,
+              int row, int col, double a, double b, double c, double d) {
+  vector<double> block(4);
+  block[0] = a; block[1] = b; block[2] = c; block[3] = d;
+  chol.Add(row,col,block);
+
+  int n = chol.Blocks() * 2;
+  for (int r=0; r<2; r++) {
+    for (int s=0; s<2; s++) {
+      dense[(row*2+r)*n + col*2+s] += block[r*2+s];
+      if (row != col) dense[(col*2+s)*n + row*2+r] += block[r*2+s];
+    }
+  }
+}
+
+int main () {
+  Isis::Preference::Preferences(true);
+  cout << "Unit test for SparseBlockCholesky" << endl << endl;
+
+  // A chain of blocks, 0-1-2-3-4, plus a link from 0 to 4, given in the
+  // natural order and partly as upper triangle blocks
+  Isis::SparseBlockCholesky chol(5,2);
+  vector<double> dense(100,0.0);
+  for (int i=0; i<5; i++) {
+    AddBlock(chol,dense,i,i,6.0,1.0,1.0,5.0+i);
+  }
+  AddBlock(chol,dense,1,0,1.0,0.5,-0.5,2.0);
+  AddBlock(chol,dense,1,2,0.3,1.0,0.0,-1.0);
+  AddBlock(chol,dense,3,2,1.5,0.2,0.4,0.5);
+  AddBlock(chol,dense,3,4,-1.0,0.0,0.7,1.2);
+  AddBlock(chol,dense,0,4,0.1,0.2,0.3,0.4);
+  AddBlock(chol,dense,1,0,0.5,0.0,0.0,0.5);
+
+  cout << "Blocks:    " << chol.Blocks() << endl;
+  cout << "BlockSize: " << chol.BlockSize() << endl;
+
+  try {
+    vector<double> rhs(10);
+    chol.Solve(rhs);
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+
+  // Right hand side for the solution 1,2,...,10
+  vector<double> rhs(10,0.0);
+  for (int r=0; r<10; r++) {
+    for (int c=0; c<10; c++) rhs[r] += dense[r*10+c] * (c + 1);
+  }
+
+  cout << "Factor:    " << chol.Factor() << endl;
+  chol.Solve(rhs);
+  cout << "Solution: ";
+  for (int i=0; i<10; i++) {
+    cout << " " << setprecision(10) << rhs[i];
+  }
+  cout << endl;
+
+  try {
+    vector<double> block(4,1.0);
+    chol.Add(0,0,block);
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+  cout << endl;
+
+  // Block 1 has nothing on its diagonal
+  cout << "Testing a matrix which is not positive definite" << endl;
+  Isis::SparseBlockCholesky singular(3,2);
+  vector<double> sdense(36,0.0);
+  AddBlock(singular,sdense,0,0,2.0,0.0,0.0,2.0);
+  AddBlock(singular,sdense,2,2,2.0,0.0,0.0,2.0);
+  AddBlock(singular,sdense,2,0,1.0,0.0,0.0,1.0);
+  cout << "Factor:    " << singular.Factor() << endl;
+  cout << endl;
+
+  try {
+    vector<double> block(4,1.0);
+    singular.Add(5,0,block);
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+
+  // The same matrix assembled in two parts, as BundleAdjust does in threads
+  cout << "Testing the sum of two matrices" << endl;
+  Isis::SparseBlockCholesky sum(3,2);
+  Isis::SparseBlockCholesky part(3,2);
+  vector<double> pdense(36,0.0);
+  AddBlock(sum,pdense,0,0,4.0,1.0,1.0,3.0);
+  AddBlock(sum,pdense,1,0,0.5,-1.0,0.2,0.3);
+  AddBlock(part,pdense,1,1,5.0,0.0,0.0,4.0);
+  AddBlock(part,pdense,2,1,1.0,0.0,0.5,1.0);
+  AddBlock(part,pdense,2,2,3.0,0.5,0.5,6.0);
+  AddBlock(part,pdense,0,0,1.0,0.0,0.0,1.0);
+  sum.Add(part);
+  vector<double> prhs(6,0.0);
+  for (int r=0; r<6; r++) {
+    for (int c=0; c<6; c++) prhs[r] += pdense[r*6+c] * (c + 1);
+  }
+  cout << "Factor:    " << sum.Factor() << endl;
+  sum.Solve(prhs);
+  cout << "Solution: ";
+  for (int i=0; i<6; i++) {
+    cout << " " << setprecision(10) << prhs[i];
+  }
+  cout << endl;
+
+  try {
+    sum.Add(part);
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+
+  try {
+    part.Add(chol);
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+
+  try {
+    Isis::SparseBlockCholesky other(4,2);
+    part.Add(other);
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+  cout << endl;
+
+  try {
+    Isis::SparseBlockCholesky empty(0,2);
+  }
+  catch (Isis::iException &e) {
+    e.Report(false);
+  }
+
+  return 0;
+}
@@ -28,8 +28,16 @@
 #include "Constants.h"
 #include "NaifStatus.h"
 
+#include <QMutexLocker>
+
 using namespace std;
 namespace Isis {
+  //! Are kernels kept loaded between Spice objects, see KeepKernelsLoaded
+  static bool keepKernels = false;
+
+  //! Expanded names of the kernels kept loaded, in the order they were loaded
+  static vector<string> keptKernels;
+
  /**
   * Constructs a Spice object and loads SPICE kernels using information from the
   * label object. The constructor expects an Instrument and Kernels group to be
@@ -100,6 +108,7 @@ namespace Isis {
     Load(kernels["InstrumentAddendum"]);  // Always load after instrument
     Load(kernels["LeapSecond"]);
     Load(kernels["SpacecraftClock"]);
+    LoadKernels();
 
     // Get NAIF ik, spk, sclk, and ck codes
     //
@@ -234,10 +243,8 @@ namespace Isis {
   }
 
 
-  //! Load/furnish NAIF kernel(s)
+  //! Adds NAIF kernel(s) to the kernels furnished by LoadKernels
   void Spice::Load(Isis::PvlKeyword &key) {
-    NaifStatus::CheckErrors();
-
     for (int i=0; i<key.Size(); i++) {
       if (key[i] == "") continue;
       if (iString(key[i]).UpCase() == "NULL") break;
@@ -248,14 +255,92 @@ namespace Isis {
         string msg = "Spice file does not exist [" + file.Expanded() + "]";
         throw Isis::iException::Message(Isis::iException::Io,msg,_FILEINFO_);
       }
-      string fileName(file.Expanded());
-      furnsh_c(fileName.c_str());
       p_kernels.push_back((string)key[i]);
     }
+  }
+
+ /**
+  * Furnishes the kernels added by Load, in the order they were added. While
+  * kernels are kept loaded (see KeepKernelsLoaded), the kernels are left to
+  * the kept kernels rather than unloaded by this object, and they are not
+  * furnished at all if they are exactly the kernels already kept loaded.
+  */
+  void Spice::LoadKernels() {
+    NaifStatus::CheckErrors();
+
+    vector<string> files;
+    for (unsigned int i=0; i<p_kernels.size(); i++) {
+      Isis::Filename file(p_kernels[i]);
+      files.push_back(file.Expanded());
+    }
+
+    if (keepKernels) {
+      p_kernels.clear();
+      if (files.size() == 0) return;
+      if (files == keptKernels && KeptKernelsLoaded()) return;
+      UnloadKeptKernels();
+    }
+
+    if (keepKernels) keptKernels = files;
+    for (unsigned int i=0; i<files.size(); i++) {
+      furnsh_c(files[i].c_str());
+    }
+
+    NaifStatus::CheckErrors();
+  }
+
+ /**
+  * Keeps the kernels loaded by Spice objects loaded after the objects are
+  * done with them, or unloads the kernels kept loaded. A program that creates
+  * many cameras one after another, such as spiceinit with a list of cubes,
+  * then furnishes the kernels only when the kernels of a camera differ from
+  * the ones of the camera before it. A camera whose kernels differ unloads
+  * the kept kernels first, so each camera still sees only its own kernels.
+  *
+  * This is only safe while a single Spice object reads the kernels at a time,
+  * which holds for cameras since they cache their SPICE when created.
+  *
+  * @param keep Keep kernels loaded from now on, or unload the kept kernels
+  */
+  void Spice::KeepKernelsLoaded(bool keep) {
+    QMutexLocker lock(NaifStatus::Mutex());
+
+    keepKernels = keep;
+    if (!keep) UnloadKeptKernels();
+  }
+
+  //! Unloads the kernels kept loaded
+  void Spice::UnloadKeptKernels() {
+    NaifStatus::CheckErrors();
+
+    for (unsigned int i=0; i<keptKernels.size(); i++) {
+      unload_c(keptKernels[i].c_str());
+    }
+    keptKernels.clear();
 
     NaifStatus::CheckErrors();
   }
 
+ /**
+  * Returns whether all the kernels kept loaded are still loaded. Other code
+  * which furnishes and then unloads one of the same files takes it out of the
+  * kernel pool.
+  *
+  * @return bool
+  */
+  bool Spice::KeptKernelsLoaded() {
+    for (unsigned int i=0; i<keptKernels.size(); i++) {
+      SpiceChar type[32];
+      SpiceChar source[1024];
+      SpiceInt handle;
+      SpiceBoolean found;
+      kinfo_c(keptKernels[i].c_str(), sizeof(type), sizeof(source),
+              type, source, &handle, &found);
+      if (!found) return false;
+    }
+    return true;
+  }
+
  /**
   * Destroys the Spice object
   */
@@ -704,6 +789,9 @@ namespace Isis {
 
     if (p_bodyRotation->IsCached()) return;
 
+    // The kernel pool and error state are shared by all threads
+    QMutexLocker lock(NaifStatus::Mutex());
+
     double tipm[3][3], npole[3];
     char frameName[32];
     SpiceInt frameCode;
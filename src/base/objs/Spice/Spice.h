@@ -147,6 +147,11 @@ namespace Isis {
  *                                    scope.
  *  @history 2010-01-29 Debbie A. Cook - Redid Tracie's change to make sure the table is loaded instead of the kernels if
  *                                        the kernel keyword value lists "Table" before the kernel files.
+ *  @history 2026-10-18 Unknown - Added KeepKernelsLoaded. The kernels of an
+ *                      object are now furnished together once all of them are
+ *                      found.
+ *  @history 2026-10-18 Unknown - ComputeSolarLongitude holds NaifStatus::Mutex
+ *                      while it reads the kernels.
  *                                    
  *                                    
  */
@@ -208,6 +213,8 @@ namespace Isis {
 
       bool HasKernels(Isis::Pvl &lab);
 
+      static void KeepKernelsLoaded(bool keep);
+
       SpiceInt NaifBodyCode () const;
       SpiceInt NaifSpkCode () const;
       SpiceInt NaifCkCode () const;
@@ -236,6 +243,9 @@ namespace Isis {
 
     private:
       void Load(Isis::PvlKeyword &key);
+      void LoadKernels();
+      static void UnloadKeptKernels();
+      static bool KeptKernelsLoaded();
       void ComputeSolarLongitude(double et);
 
       SpiceDouble p_solarLongitude;
@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <cfloat>
 
+#include <QMutexLocker>
+
 #include "SpicePosition.h"
 #include "BasisFunction.h"
 #include "LeastSquares.h"
@@ -30,6 +32,7 @@ namespace Isis {
     p_et = -DBL_MAX;
     p_noOverride = true;
     p_hasVelocity = false;
+    p_changes = 0;
   }
 
   /** Apply a time bias when invoking SetEphemerisTime method.
@@ -44,6 +47,7 @@ namespace Isis {
    * @param timeBias time bias in seconds
    */
   void SpicePosition::SetTimeBias (double timeBias) {
+    ClearLineTable();
     p_timeBias = timeBias;
   }
 
@@ -57,6 +61,7 @@ namespace Isis {
    * "LT+S".
    */
   void SpicePosition::SetAberrationCorrection(const std::string &correction) {
+    ClearLineTable();
     if (correction == "NONE" || correction == "LT" || correction == "LT+S") {
       p_aberrationCorrection = correction;
     }
@@ -88,8 +93,11 @@ namespace Isis {
     if (et == p_et) return p_coordinate;
     p_et = et;
 
-    // Read from the cache
-    if (p_source == Memcache) { 
+    // Read from the line table or the cache
+    if (InLineTable(et)) {
+      SetEphemerisTimeLineTable();
+    }
+    else if (p_source == Memcache) { 
       SetEphemerisTimeMemcache();
     }
     else if(p_source == HermiteCache) {
@@ -103,6 +111,49 @@ namespace Isis {
     NaifStatus::CheckErrors();
   }
 
+  /** Tabulate J2000 position at every line of a line scan image.
+   *
+   * SetEphemerisTime interpolates the cache for every time, which for a
+   * Hermite cache means fitting a spline to the whole cache. For line scan
+   * images most times requested fall within the image, so this method
+   * evaluates the position (and velocity) once per line at times
+   * startTime, startTime + lineRate, ... and SetEphemerisTime then
+   * interpolates between the two neighbouring lines for times in the table,
+   * with a cubic Hermite when the velocity is available and linearly
+   * otherwise. The table is dropped whenever the cache or the way it is
+   * evaluated changes.
+   *
+   * @param startTime Ephemeris time of the first line in seconds
+   * @param lineRate Time between lines in seconds
+   * @param lines Number of lines in the table
+   */
+  void SpicePosition::LoadLineTable (double startTime, double lineRate, int lines) {
+    ClearLineTable();
+    if ((lineRate <= 0.0) || (lines < 2)) return;
+
+    std::vector<double> table;
+    table.reserve(6 * lines);
+    for (int i=0; i<lines; i++) {
+      SetEphemerisTime(startTime + i * lineRate);
+      table.insert(table.end(),p_coordinate.begin(),p_coordinate.end());
+      table.insert(table.end(),p_velocity.begin(),p_velocity.end());
+    }
+
+    p_lineTable.swap(table);
+    p_lineTableStart = startTime;
+    p_lineTableRate = lineRate;
+    p_et = -DBL_MAX;
+  }
+
+  /**
+   * Drop the table loaded by LoadLineTable.  Every method that changes the
+   * position data calls this, so it also counts the change (see Changes).
+   */
+  void SpicePosition::ClearLineTable () {
+    p_lineTable.clear();
+    p_changes++;
+  }
+
   /** Cache J2000 position over a time range.
    *
    * This method will load an internal cache with coordinates over a time
@@ -118,6 +169,7 @@ namespace Isis {
    *
    */
   void SpicePosition::LoadCache (double startTime, double endTime, int size) {
+    ClearLineTable();
     // Make sure cache isn't alread loaded
     if (p_source == Memcache || p_source == HermiteCache) {
       std::string msg = "A SpicePosition cache has already been created";
@@ -163,6 +215,7 @@ namespace Isis {
    *
    */
   void SpicePosition::LoadCache (double time) {
+    ClearLineTable();
     LoadCache(time,time,1);
   }
 
@@ -186,6 +239,7 @@ namespace Isis {
    *  
    */
   void SpicePosition::LoadCache(Table &table) {
+    ClearLineTable();
 
     // Make sure cache isn't alread loaded
     if (p_source == Memcache || p_source == HermiteCache) {
@@ -340,6 +394,7 @@ namespace Isis {
   void SpicePosition::ReloadCache (Isis::PolynomialUnivariate &function1,
                                  Isis::PolynomialUnivariate &function2,
                                  Isis::PolynomialUnivariate &function3){
+    ClearLineTable();
    // Make sure cache is already loaded
     if ( p_source != Memcache && p_source != HermiteCache ) {
       std::string msg = "A SpicePosition cache has not been created yet";
@@ -479,6 +534,7 @@ namespace Isis {
    *
    */
   void SpicePosition::SetPolynomial () {
+    ClearLineTable();
     int degree=2;
     Isis::PolynomialUnivariate function1(degree);       //!< Basis function fit to X
     Isis::PolynomialUnivariate function2(degree);       //!< Basis function fit to Y
@@ -591,6 +647,7 @@ namespace Isis {
   void SpicePosition::SetPolynomial ( const std::vector<double>& XC,
                                       const std::vector<double>& YC,
                                       const std::vector<double>& ZC ) {
+    ClearLineTable();
     Isis::PolynomialUnivariate function1( 2 );
     Isis::PolynomialUnivariate function2( 2 );
     Isis::PolynomialUnivariate function3( 2 );
@@ -667,6 +724,7 @@ namespace Isis {
    * @param [in] baseTime The baseTime to use and override the computed base time
    */
   void SpicePosition::SetOverrideBaseTime( double baseTime ) {
+    ClearLineTable();
     p_overrideBaseTime = baseTime;
     p_noOverride = false;
     return;
@@ -920,6 +978,9 @@ namespace Isis {
    *            method)
    */
   void SpicePosition::SetEphemerisTimeSpice() {
+    // The kernel pool and error state are shared by all threads
+    QMutexLocker lock(NaifStatus::Mutex());
+
     // Read from the kernel
     SpiceDouble j[6], lt;
     // First try getting the entire state (including the velocity vector)
@@ -956,6 +1017,41 @@ namespace Isis {
   }
 
 
+  /**
+   * This is a protected method that is called by SetEphemerisTime() for
+   * times within the table loaded by LoadLineTable. It interpolates the
+   * position and velocity between the two neighbouring lines.
+   */
+  void SpicePosition::SetEphemerisTimeLineTable() {
+    int lines = p_lineTable.size() / 6;
+    double line = (p_et - p_lineTableStart) / p_lineTableRate;
+    int index = (int) line;
+    if (index > lines - 2) index = lines - 2;
+    double t = line - index;
+
+    const double *p1 = &p_lineTable[6*index];
+    const double *p2 = p1 + 6;
+    if (p_hasVelocity) {
+      // Cubic Hermite basis with the velocities scaled to the line interval
+      double t2 = t * t;
+      double t3 = t2 * t;
+      double h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+      double h10 = (t3 - 2.0 * t2 + t) * p_lineTableRate;
+      double h01 = 3.0 * t2 - 2.0 * t3;
+      double h11 = (t3 - t2) * p_lineTableRate;
+      for (int i=0; i<3; i++) {
+        p_coordinate[i] = h00 * p1[i] + h10 * p1[i+3] + h01 * p2[i] + h11 * p2[i+3];
+        p_velocity[i] = (1.0 - t) * p1[i+3] + t * p2[i+3];
+      }
+    }
+    else {
+      for (int i=0; i<3; i++) {
+        p_coordinate[i] = (1.0 - t) * p1[i] + t * p2[i];
+      }
+    }
+  }
+
+
   /**
    * This method reduces the cache for position, time and velocity 
    * to the minimum number of values needed to interpolate the 
@@ -969,6 +1065,7 @@ namespace Isis {
    *   @history 2009-08-03 Jeannie Walldren - Original version.
    */
   void SpicePosition::Memcache2HermiteCache(double tolerance){
+    ClearLineTable();
     if (p_source == HermiteCache) {
       return;
     }
@@ -1101,6 +1198,7 @@ namespace Isis {
    *   @history 2009-08-03 Jeannie Walldren - Original version. 
    */  
   void SpicePosition::ReloadCache(Table &table) {
+    ClearLineTable();
     p_source = Spice;
     p_cacheTime.clear();
     p_cache.clear();
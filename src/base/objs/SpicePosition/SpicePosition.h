@@ -93,6 +93,12 @@ namespace Isis {
    *  @history 2009-08-27 Jeannie Walldren - Added documentation.
    *  @history 2009-10-20 Debbie A. Cook - Corrected calculation of extremum in ReloadCache
    *  @history 2009-11-06 Debbie A. Cook - Added velocity partial derivative method
+   *  @history 2026-10-17 Unknown - Added LoadLineTable to tabulate the position
+   *                      at every line of line scan images
+   *  @history 2026-10-18 Unknown - Added Changes, which counts the changes to
+   *                      the position data
+   *  @history 2026-10-18 Unknown - SetEphemerisTime holds NaifStatus::Mutex
+   *                      only while it reads the kernels
    */
   class SpicePosition {
     public:
@@ -138,6 +144,12 @@ namespace Isis {
       //! Is this position cached
       bool IsCached() const { return (p_cache.size() > 0); };
 
+      void LoadLineTable (double startTime, double lineRate, int lines);
+      void ClearLineTable ();
+
+      //! Returns the number of times the position data was changed
+      int Changes() const { return p_changes; };
+
       void SetPolynomial ();
 
       void SetPolynomial ( const std::vector<double>& XC,
@@ -175,6 +187,14 @@ namespace Isis {
       void SetEphemerisTimeMemcache();
       void SetEphemerisTimeHermiteCache();
       void SetEphemerisTimeSpice();
+      void SetEphemerisTimeLineTable();
+
+      //! Is the time within the table loaded by LoadLineTable
+      bool InLineTable(double et) const {
+        if (p_lineTable.empty()) return false;
+        double line = (et - p_lineTableStart) / p_lineTableRate;
+        return (line >= 0.0) && (line <= p_lineTable.size() / 6 - 1);
+      };
       std::vector<int> HermiteIndices(double tol, std::vector <int> indexList);
 
     private:
@@ -197,6 +217,11 @@ namespace Isis {
       bool p_noOverride;                  //!< Flag to compute base time;
       double p_overrideBaseTime;          //!< Value set by caller to override computed base time
       bool p_hasVelocity;                 //!< Flag to indicate velocity is available
+
+      std::vector<double> p_lineTable;    //!< Position and velocity at each line
+      double p_lineTableStart;            //!< Time of the first line of the table
+      double p_lineTableRate;             //!< Time between lines of the table
+      int p_changes;                      //!< Changes to the position data
   };
 };
 
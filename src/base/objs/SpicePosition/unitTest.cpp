@@ -1,5 +1,6 @@
 #include <iostream>
 #include <iomanip>
+#include <cmath>
 #include "SpicePosition.h"
 #include "Filename.h"
 #include "Preference.h"
@@ -69,4 +70,21 @@ int main (int argc, char *argv[]) {
     cout << "Velocity (J) = " << v[0] << " " << v[1] << " " << v[2] << endl;
   }
   cout << endl;
+
+  // Test the line table against the kernels
+  cout << "Testing line table ... " << endl;
+  Isis::SpicePosition pos3(-94,499);
+  Isis::SpicePosition exact(-94,499);
+  pos3.LoadLineTable(startTime,1.0,(int)(endTime - startTime) + 2);
+  double maxDiff = 0.0;
+  for (int i=0; i<100; i++) {
+    double t = startTime + 0.37 + 3.0 * i;
+    vector<double> p = pos3.SetEphemerisTime(t);
+    vector<double> e = exact.SetEphemerisTime(t);
+    for (int j=0; j<3; j++) {
+      if (fabs(p[j] - e[j]) > maxDiff) maxDiff = fabs(p[j] - e[j]);
+    }
+  }
+  cout << "Within 1 mm of the kernels: " << (maxDiff < 1.0e-6 ? "yes" : "no") << endl;
+  cout << endl;
 }
@@ -6,6 +6,8 @@
 #include <cmath>
 #include <iomanip>
 
+#include <QMutexLocker>
+
 #include "SpiceRotation.h"
 #include "Quaternion.h"
 #include "LineEquation.h"
@@ -56,6 +58,7 @@ namespace Isis {
     p_minimizeCache = No;
     p_hasAngularVelocity = false;
     p_av.resize(3);
+    p_changes = 0;
   }
 
   /**
@@ -86,6 +89,7 @@ namespace Isis {
     p_minimizeCache = No;
     p_hasAngularVelocity = false;
     p_av.resize(3);
+    p_changes = 0;
 
     // Determine the axis for the velocity vector
     std::string key = "INS" + Isis::iString(frameCode) + "_TRANSX";
@@ -119,6 +123,7 @@ namespace Isis {
    * @param timeBias time bias in seconds
    */
   void SpiceRotation::SetTimeBias (double timeBias) {
+    ClearLineTable();
     p_timeBias = timeBias;
   }
 
@@ -143,8 +148,13 @@ namespace Isis {
 
     SpiceInt j2000 = J2000Code;
 
+    // Read from the line table
+    if (InLineTable(et)) {
+      SetEphemerisTimeLineTable();
+    }
+
     // Read from the cache
-    if (p_source == Memcache) {
+    else if (p_source == Memcache) {
       // If the cache has only one position set it
       if (p_cache.size() == 1) {
 /*        p_quaternion = p_cache[0];*/
@@ -181,7 +191,11 @@ namespace Isis {
         mtxm_c ((SpiceDouble (*)[3]) &CJ2[0], (SpiceDouble (*)[3]) &CJ1[0], J2J1);
         SpiceDouble axis[3];
         SpiceDouble angle;
-        raxisa_c (J2J1, axis, &angle);
+        {
+          // raxisa_c can signal an error, and NAIF's error state is shared
+          QMutexLocker lock(NaifStatus::Mutex());
+          raxisa_c (J2J1, axis, &angle);
+        }
         SpiceDouble delta[3][3];
         axisar_c (axis, angle*(SpiceDouble)mult, delta);
         mxmt_c ( (SpiceDouble *) &CJ1[0], delta, (SpiceDouble (*) [3]) &p_CJ[0] );
@@ -221,9 +235,12 @@ namespace Isis {
         angle1 -= twopi_c();
       }
 
-      eul2m_c ( (SpiceDouble) angle3, (SpiceDouble) angle2, (SpiceDouble) angle1,
-                 p_axis3,             p_axis2,              p_axis1,
-                 (SpiceDouble (*)[3]) &p_CJ[0]);
+      {
+        QMutexLocker lock(NaifStatus::Mutex());
+        eul2m_c ( (SpiceDouble) angle3, (SpiceDouble) angle2, (SpiceDouble) angle1,
+                   p_axis3,             p_axis2,              p_axis1,
+                   (SpiceDouble (*)[3]) &p_CJ[0]);
+      }
 
       if (p_hasAngularVelocity) {
         ComputeAv();
@@ -231,6 +248,9 @@ namespace Isis {
     }
     // Read from the kernel
     else if (p_source == Spice) {
+      // The kernel pool and error state are shared by all threads
+      QMutexLocker lock(NaifStatus::Mutex());
+
       // Retrieve the J2000 (code=1) to reference rotation matrix
       SpiceDouble time = p_et + p_timeBias;
 
@@ -286,6 +306,9 @@ namespace Isis {
       //      is not available to this class, but probably should be applied to the
       //      spkez call.
 
+      // The kernel pool and error state are shared by all threads
+      QMutexLocker lock(NaifStatus::Mutex());
+
       // Make sure the constant frame is loaded.  This method also does the frame trace.
       if (p_timeFrames.size() == 0) InitConstantRotation ( et );
 
@@ -312,6 +335,73 @@ namespace Isis {
     NaifStatus::CheckErrors();
   }
 
+  /** Tabulate the J2000 rotation at every line of a line scan image.
+   *
+   * Interpolating the cache takes an axis and angle decomposition (or a
+   * polynomial evaluation) for every time. For line scan images most times
+   * requested fall within the image, so this method evaluates the rotation
+   * (and angular velocity) once per line at times startTime,
+   * startTime + lineRate, ... and SetEphemerisTime then interpolates the
+   * matrices of the two neighbouring lines for times in the table. Over a
+   * line the rotation is small enough that the interpolated matrix stays
+   * orthonormal to well below the precision of the pointing. The table is
+   * dropped whenever the cache or the way it is evaluated changes.
+   *
+   * @param startTime Ephemeris time of the first line in seconds
+   * @param lineRate Time between lines in seconds
+   * @param lines Number of lines in the table
+   */
+  void SpiceRotation::LoadLineTable (double startTime, double lineRate, int lines) {
+    ClearLineTable();
+    if ((lineRate <= 0.0) || (lines < 2)) return;
+
+    std::vector<double> table;
+    table.reserve(12 * lines);
+    for (int i=0; i<lines; i++) {
+      SetEphemerisTime(startTime + i * lineRate);
+      table.insert(table.end(),p_CJ.begin(),p_CJ.end());
+      table.insert(table.end(),p_av.begin(),p_av.end());
+    }
+
+    p_lineTable.swap(table);
+    p_lineTableStart = startTime;
+    p_lineTableRate = lineRate;
+    p_et = -DBL_MAX;
+  }
+
+  /**
+   * Drop the table loaded by LoadLineTable.  Every method that changes the
+   * rotation data calls this, so it also counts the change (see Changes).
+   */
+  void SpiceRotation::ClearLineTable () {
+    p_lineTable.clear();
+    p_changes++;
+  }
+
+  /**
+   * Called by SetEphemerisTime() for times within the table loaded by
+   * LoadLineTable. It interpolates the rotation and angular velocity
+   * between the two neighbouring lines.
+   */
+  void SpiceRotation::SetEphemerisTimeLineTable() {
+    int lines = p_lineTable.size() / 12;
+    double line = (p_et - p_lineTableStart) / p_lineTableRate;
+    int index = (int) line;
+    if (index > lines - 2) index = lines - 2;
+    double t = line - index;
+
+    const double *r1 = &p_lineTable[12*index];
+    const double *r2 = r1 + 12;
+    for (int i=0; i<9; i++) {
+      p_CJ[i] = (1.0 - t) * r1[i] + t * r2[i];
+    }
+    if (p_hasAngularVelocity) {
+      for (int i=0; i<3; i++) {
+        p_av[i] = (1.0 - t) * r1[i+9] + t * r2[i+9];
+      }
+    }
+  }
+
   /** Cache J2000 rotation quaternion over a time range.
    *
    * This method will load an internal cache with frames over a time
@@ -326,6 +416,7 @@ namespace Isis {
    *
    */
   void SpiceRotation::LoadCache (double startTime, double endTime, int size) {
+    ClearLineTable();
 
     // Check for valid arguments
     if (size <= 0) {
@@ -390,6 +481,7 @@ namespace Isis {
    *
    */
   void SpiceRotation::LoadCache (double time) {
+    ClearLineTable();
     LoadCache(time,time,1);
   }
 
@@ -414,6 +506,7 @@ namespace Isis {
    *                quaternion/time values
    */
   void SpiceRotation::LoadCache(Table &table) {
+    ClearLineTable();
     // Make sure cache isn't already loaded
     if (p_source == Memcache  ||  p_source == Function) {
       std::string msg = "A SpiceRotation cache has already been created";
@@ -560,6 +653,7 @@ namespace Isis {
   void SpiceRotation::ReloadCache (Isis::PolynomialUnivariate &function1,
                                  Isis::PolynomialUnivariate &function2,
                                  Isis::PolynomialUnivariate &function3){
+    ClearLineTable();
     NaifStatus::CheckErrors();
 
     // Save current et
@@ -596,9 +690,12 @@ namespace Isis {
         angle1 -= twopi_c();
       }
 
-      eul2m_c ( (SpiceDouble) angle3, (SpiceDouble) angle2, (SpiceDouble) angle1,
-                 p_axis3,             p_axis2,              p_axis1,
-                 (SpiceDouble (*)[3]) &p_CJ[0]);
+      {
+        QMutexLocker lock(NaifStatus::Mutex());
+        eul2m_c ( (SpiceDouble) angle3, (SpiceDouble) angle2, (SpiceDouble) angle1,
+                   p_axis3,             p_axis2,              p_axis1,
+                   (SpiceDouble (*)[3]) &p_CJ[0]);
+      }
       p_cache.push_back( p_CJ );
       ComputeAv();
       p_cacheAv.push_back( p_av );
@@ -762,7 +859,10 @@ namespace Isis {
     NaifStatus::CheckErrors();
 
     SpiceDouble ang1,ang2,ang3;
-    m2eul_c ((SpiceDouble *) &p_CJ[0],axis3, axis2, axis1, &ang3,&ang2, &ang1 );
+    {
+      QMutexLocker lock(NaifStatus::Mutex());
+      m2eul_c ((SpiceDouble *) &p_CJ[0],axis3, axis2, axis1, &ang3,&ang2, &ang1 );
+    }
 
     std::vector<double> angles;
     angles.push_back(ang1);
@@ -907,6 +1007,7 @@ namespace Isis {
    *
    */
   void SpiceRotation::SetPolynomial () {
+    ClearLineTable();
 
     // Rotation is already stored as a polynomial -- throw an error
     if (p_source == Function) {
@@ -1048,6 +1149,7 @@ namespace Isis {
   void SpiceRotation::SetPolynomial ( const std::vector<double>& coeffAng1,
                                       const std::vector<double>& coeffAng2,
                                       const std::vector<double>& coeffAng3 ) {
+    ClearLineTable();
 
     Isis::PolynomialUnivariate function1( p_degree );
     Isis::PolynomialUnivariate function2( p_degree );
@@ -1129,6 +1231,7 @@ namespace Isis {
    * @param [in] baseTime The baseTime to use and override the computed base time
    */
   void SpiceRotation::SetOverrideBaseTime( double baseTime, double timeScale ) {
+    ClearLineTable();
     p_overrideBaseTime = baseTime;
     p_overrideTimeScale = timeScale;
     p_noOverride = false;
@@ -1193,7 +1296,10 @@ namespace Isis {
     double angle = angles.at(angleIndex);
 
     double dmatrix[3][3];
-    drotat_ (&angle, (integer *) axes+angleIndex, (doublereal *) dmatrix);
+    {
+      QMutexLocker lock(NaifStatus::Mutex());
+      drotat_ (&angle, (integer *) axes+angleIndex, (doublereal *) dmatrix);
+    }
     // Transpose to obtain row-major order
     xpose_c ( dmatrix, dmatrix);
 
@@ -1272,6 +1378,7 @@ namespace Isis {
    *
    */
   void SpiceRotation::SetPolynomialDegree( int degree) {
+    ClearLineTable();
 
     // If polynomials have not been applied yet then simply set the degree and return
     if (!p_degreeApplied) {
@@ -1319,6 +1426,7 @@ namespace Isis {
    *
    */
   void SpiceRotation::SetAxes(int axis1, int axis2, int axis3) {
+    ClearLineTable();
     if (axis1 < 1  ||  axis2 < 1  || axis3 < 1  || axis1 > 3  || axis2 > 3  || axis3 > 3) {
       std::string msg = "A rotation axis is outside the valid range of 1 to 3";
       throw Isis::iException::Message(Isis::iException::Programmer,msg,_FILEINFO_);
@@ -1333,6 +1441,7 @@ namespace Isis {
    *  
    */
   void SpiceRotation::LoadTimeCache() {
+    ClearLineTable();
     int count=0;
 
     double observStart  =  p_fullCacheStartTime + p_timeBias;
@@ -1764,7 +1873,10 @@ namespace Isis {
     dCJ.assign(9, 0.);
 
     for (int angleIndex=0; angleIndex<3; angleIndex++) {
-      drotat_ (&(angles[angleIndex]), (integer *) axes+angleIndex, (doublereal *) dmatrix);
+      {
+        QMutexLocker lock(NaifStatus::Mutex());
+        drotat_ (&(angles[angleIndex]), (integer *) axes+angleIndex, (doublereal *) dmatrix);
+      }
       // Transpose to obtain row-major order
       xpose_c ( dmatrix, dmatrix);
 
@@ -100,6 +100,14 @@ namespace Isis {
    *                        or lenght 6 vectors (position and velocity) and added private method StateTJ()
    *  @history 2009-12-03  Debbie A. Cook Modified tests in LoadTimeCache to allow observation to cross segment boundary
    *                        for LRO
+   *  @history 2026-10-17 Unknown - Added LoadLineTable to tabulate the rotation
+   *                        at every line of line scan images
+   *  @history 2026-10-18 Unknown - Added Changes, which counts the changes to
+   *                        the rotation data
+   *  @history 2026-10-18 Unknown - Holds NaifStatus::Mutex only around the
+   *                        NAIF routines that read kernels or can signal an
+   *                        error, so rotations in different threads are
+   *                        evaluated together
    *  @todo Downsize using Hermite cubic spline and allow Nadir tables to be downsized again.
    */
   class SpiceRotation {
@@ -115,7 +123,10 @@ not have refchg_c, but only the f2c'd refchg.c.*/
       virtual ~SpiceRotation() { }
 
       //! Change the frame (has no effect if cached)
-      void SetFrame( int frameCode ) { p_constantFrames[0] = frameCode; };
+      void SetFrame( int frameCode ) {
+        ClearLineTable();
+        p_constantFrames[0] = frameCode;
+      };
       int Frame() { return p_constantFrames[0]; };
 
       void SetTimeBias (double timeBias);
@@ -166,6 +177,12 @@ not have refchg_c, but only the f2c'd refchg.c.*/
       //! Is this rotation cached
       bool IsCached() const { return (p_cache.size() > 0); };
 
+      void LoadLineTable (double startTime, double lineRate, int lines);
+      void ClearLineTable ();
+
+      //! Returns the number of times the rotation data was changed
+      int Changes() const { return p_changes; };
+
       void SetPolynomial ();
 
       void SetPolynomial ( const std::vector<double>& abcAng1,
@@ -183,7 +200,7 @@ not have refchg_c, but only the f2c'd refchg.c.*/
       Source GetSource () {  return p_source; };
 
       //! Resets the source of the rotation
-      void SetSource ( Source source ){ p_source = source; return; };
+      void SetSource ( Source source ){ ClearLineTable(); p_source = source; return; };
 
       void ComputeBaseTime ();
 
@@ -275,6 +292,20 @@ not have refchg_c, but only the f2c'd refchg.c.*/
       std::vector<double> p_av;           //!< Angular velocity for rotation at time p_et
       bool p_hasAngularVelocity;          //!< Flag indicating whether the rotation includes angular velocity
       std::vector<double> StateTJ();      //!< State matrix (6x6) for rotating state vectors from J2000 to target frame
+
+      std::vector<double> p_lineTable;    //!< Rotation and angular velocity at each line
+      double p_lineTableStart;            //!< Time of the first line of the table
+      double p_lineTableRate;             //!< Time between lines of the table
+      int p_changes;                      //!< Changes to the rotation data
+
+      void SetEphemerisTimeLineTable();
+
+      //! Is the time within the table loaded by LoadLineTable
+      bool InLineTable(double et) const {
+        if (p_lineTable.empty()) return false;
+        double line = (et - p_lineTableStart) / p_lineTableRate;
+        return (line >= 0.0) && (line <= p_lineTable.size() / 12 - 1);
+      };
   };
 };
 
@@ -266,6 +266,25 @@ int main (int argc, char *argv[]) {
   cout << "   Using anchor angle of 30, -180 changes to " << newangle*180./pi_c() << endl;
   newangle = naRot.WrapAngle( 0.5235987756, 1.570796327);
   cout << "   Using anchor angle of 30, 90 changes to " << newangle*180./pi_c() << endl;
+  cout << endl;
+
+  // Test the line table against the kernels
+  cout << "Testing line table ... " << endl;
+  Isis::SpiceRotation lineRot( -94031 );
+  Isis::SpiceRotation exactRot( -94031 );
+  lineRot.LoadLineTable(startTime,1.0,(int)(endTime - startTime) + 2);
+  double maxDiff = 0.0;
+  for (int i=0; i<100; i++) {
+    double t = startTime + 0.37 + 3.0 * i;
+    lineRot.SetEphemerisTime(t);
+    exactRot.SetEphemerisTime(t);
+    std::vector<double> CJ = lineRot.TimeBasedMatrix();
+    std::vector<double> exactCJ = exactRot.TimeBasedMatrix();
+    for (int j=0; j<9; j++) {
+      if (fabs(CJ[j] - exactCJ[j]) > maxDiff) maxDiff = fabs(CJ[j] - exactCJ[j]);
+    }
+  }
+  cout << "Within 1e-5 of the kernels: " << (maxDiff < 1.0e-5 ? "yes" : "no") << endl;
 
 
 }
@@ -68,6 +68,12 @@ namespace Isis {
     * @history 2007-01-18 Robert Sucharski - Added AddData method
     *                       for a single double value
     * @history 2008-05-06 Steven Lambright - Added AboveRange, BelowRange methods
+    * @history 2026-10-18 Unknown - Added AddStatistics, so statistics gathered
+    *                       separately, such as by tile, band or thread, can be
+    *                       combined without reading the data again
+    * @history 2026-10-18 Unknown - AddData for arrays classifies pixels with
+    *                       SSE2 where it is available, and sums them in lanes a
+    *                       block at a time, which is also more accurate
     *
     * @todo 2005-02-07 Deborah Lee Soltesz - add example using cube data to the 
     * class documentation
@@ -116,6 +122,7 @@ namespace Isis {
 
       void RemoveData (const double *data, const unsigned int count);
       void RemoveData (const double data);
+      void AddStatistics (const Statistics &stats);
       void SetValidRange(const double minimum=Isis::ValidMinimum, const double maximum=Isis::ValidMaximum);
 
       double ValidMinimum() const {return p_validMinimum;}
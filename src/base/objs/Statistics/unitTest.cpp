@@ -111,6 +111,39 @@ int main (int argc, char *argv[])
   cout << "SumSquare:      " << s.SumSquare() << endl;
   cout << endl;
 
+  Isis::Statistics first, second;
+  first.SetValidRange(1.0, 6.0);
+  second.SetValidRange(1.0, 6.0);
+  first.AddData (a,5);
+  second.AddData (&a[5],5);
+  second.AddData (5.0);
+  first.AddStatistics (second);
+  cout << "Adding statistics" << endl;
+  cout << "Average:        " << first.Average() << endl;
+  cout << "Variance:       " << first.Variance() << endl;
+  cout << "Minimum:        " << first.Minimum() << endl;
+  cout << "Maximum:        " << first.Maximum() << endl;
+  cout << "Total Pixels:   " << first.TotalPixels() << endl;
+  cout << "Valid Pixels:   " << first.ValidPixels() << endl;
+  cout << "Over Range:     " << first.OverRangePixels() << endl;
+  cout << "Under Range:    " << first.UnderRangePixels() << endl;
+  cout << "Null Pixels:    " << first.NullPixels() << endl;
+  cout << "Lis Pixels:     " << first.LisPixels() << endl;
+  cout << "Lrs Pixels:     " << first.LrsPixels() << endl;
+  cout << "His Pixels:     " << first.HisPixels() << endl;
+  cout << "Hrs Pixels:     " << first.HrsPixels() << endl;
+  cout << "Sum:            " << first.Sum() << endl;
+  cout << "SumSquare:      " << first.SumSquare() << endl;
+  cout << endl;
+
+  try {
+    Isis::Statistics other;
+    first.AddStatistics (other);
+  }
+  catch (Isis::iException &e) {
+    e.Report (false);
+  }
+
   try {
     s.RemoveData (a,8);
   }
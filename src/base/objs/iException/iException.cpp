@@ -32,6 +32,8 @@
 #include "Application.h"
 #include "TextFile.h"
 
+#include <QThreadStorage>
+
 using namespace std;
 namespace Isis {
   /**
@@ -48,13 +50,44 @@ namespace Isis {
     p_pvlFormat = false;
     Isis::iString pvlForm = (std::string) ef["Format"];
     p_pvlFormat = (pvlForm.UpCase() == "PVL");
-    atexit(Shutdown);
+
+    static bool registered = false;
+    if (!registered) {
+      registered = true;
+      atexit(Shutdown);
+    }
   }
 
-  //! Exception object pointer (Default is NULL)
-  iException *iException::p_exception = NULL;
-  //! The list of exception information (From Info class)
-  QList<iException::Info> iException::p_list;
+  //! The exception objects of the threads, see Current
+  static QThreadStorage<iException *> exceptions;
+
+  /**
+   * Returns the exception object of the calling thread, creating it if
+   * needed. Message returns it and it is what gets thrown.
+   *
+   * @return The exception object of the calling thread
+   */
+  iException &iException::Current() {
+    if (!exceptions.hasLocalData()) {
+      exceptions.setLocalData(new iException());
+    }
+    return *exceptions.localData();
+  }
+
+  /**
+   * Returns the list of exception information of the calling thread. Each
+   * thread has its own list, so an error thrown and cleared by one thread
+   * never shows up in, or clears, the errors of another.
+   *
+   * @return The list of exception information (From Info class)
+   */
+  QList<iException::Info> &iException::List() {
+    static QThreadStorage< QList<Info> * > lists;
+    if (!lists.hasLocalData()) {
+      lists.setLocalData(new QList<Info>);
+    }
+    return *lists.localData();
+  }
 
   /**
    * Adds a message to an existing iException object (or creates a new one if
@@ -67,9 +100,7 @@ namespace Isis {
    */
   iException &iException::Message(iException::errType t, const std::string &m, 
                                   const char *f, int l) {
-    if (p_exception == NULL) {
-      p_exception = new iException();
-    }
+    iException &exception = Current();
 
     PvlGroup &errPref = Preference::Preferences().FindGroup("ErrorFacility");
     bool printTrace = false;
@@ -78,7 +109,7 @@ namespace Isis {
       printTrace = (((iString)errPref["StackTrace"][0]).UpCase() == "ON");
     }
 
-    if (printTrace && p_list.empty()) {
+    if (printTrace && List().empty()) {
       createStackTrace();
     }
 
@@ -88,11 +119,39 @@ namespace Isis {
     i.filename = f;
     i.lineNumber = l;
 
-    p_list.push_back(i);
+    List().push_back(i);
+
+    exception.describe();
+
+    return exception;
+  }
+
+  /**
+   * Adds the messages of errors returned by PvlErrors, possibly in another
+   * thread, to the iException object of this thread. A thread which caught
+   * an error can hand the PvlErrors to the thread that started it, which
+   * throws them again with their original messages.
+   *
+   * @param errors The errors, as returned by PvlErrors
+   * @return The modified exception object.
+   */
+  iException &iException::Message(Isis::Pvl &errors) {
+    iException &exception = Current();
+
+    // PvlErrors lists the last error first
+    for (int g=errors.Groups()-1; g>=0; g--) {
+      PvlGroup &err = errors.Group(g);
+      Info i;
+      i.type = (errType)(int)err["Code"];
+      i.message = (std::string)err["Message"];
+      i.filename = (std::string)err["File"];
+      i.lineNumber = (int)err["Line"];
+      List().push_back(i);
+    }
 
-    p_exception->describe();
+    exception.describe();
 
-    return *p_exception;
+    return exception;
   }
 
   //! Throws and destroys the iException object.
@@ -103,14 +162,15 @@ namespace Isis {
    * Stores what happened in a member std::string.
    */
   void iException::describe() {
-    if (p_list.size() > 0) {
+    QList<Info> &list = List();
+    if (list.size() > 0) {
       std::string message;
-      for (int i=p_list.size()-1; i>=0; i--) {
-        message += "**" + enumString(p_list[i].type) + "** " + 
-                   p_list[i].message;
+      for (int i=list.size()-1; i>=0; i--) {
+        message += "**" + enumString(list[i].type) + "** " + 
+                   list[i].message;
         if (p_reportFileLine) {
-          message += " in " + p_list[i].filename + 
-                     " at " + Isis::iString(p_list[i].lineNumber);
+          message += " in " + list[i].filename + 
+                     " at " + Isis::iString(list[i].lineNumber);
         }
         if (i != 0) message += "\n";
       }
@@ -143,9 +203,10 @@ namespace Isis {
    * @return The type of exception (None if no type).
    */
   iException::errType iException::Type() const {
-    if (p_list.size() > 0) {
-      int i = p_list.size() - 1;
-      return p_list[i].type;
+    QList<Info> &list = List();
+    if (list.size() > 0) {
+      int i = list.size() - 1;
+      return list[i].type;
     }
     else {
       return iException::None;
@@ -162,10 +223,9 @@ namespace Isis {
   }
 
   void iException::Shutdown() {
-    if(p_exception) {
-      ASSERT_PTR(p_exception);
-      delete p_exception;
-      p_exception = NULL;
+    // Threads other than this one delete their objects when they finish
+    if (exceptions.hasLocalData()) {
+      exceptions.setLocalData(NULL);
     }
   }
 
@@ -199,17 +259,18 @@ namespace Isis {
    * format output is enabled)
    */
   Pvl iException::PvlErrors() {
+    QList<Info> &list = List();
     Isis::Pvl errors;
 
-    for (int i=p_list.size()-1; i>=0; i--) {
+    for (int i=list.size()-1; i>=0; i--) {
       PvlGroup errGroup("Error");
 
       errGroup += Isis::PvlKeyword ("Program",Isis::Application::Name());
-      errGroup += Isis::PvlKeyword ("Class",enumString(p_list[i].type));
-      errGroup += Isis::PvlKeyword ("Code",(int)p_list[i].type);
-      errGroup += Isis::PvlKeyword ("Message",p_list[i].message);
-      errGroup += Isis::PvlKeyword ("File",p_list[i].filename);
-      errGroup += Isis::PvlKeyword ("Line",p_list[i].lineNumber);
+      errGroup += Isis::PvlKeyword ("Class",enumString(list[i].type));
+      errGroup += Isis::PvlKeyword ("Code",(int)list[i].type);
+      errGroup += Isis::PvlKeyword ("Message",list[i].message);
+      errGroup += Isis::PvlKeyword ("File",list[i].filename);
+      errGroup += Isis::PvlKeyword ("Line",list[i].lineNumber);
 
       errors.AddGroup(errGroup);
     }
@@ -221,14 +282,15 @@ namespace Isis {
    * Returns the Exception message to be output (non-PVL)
    */
   std::string iException::Errors() {
+    QList<Info> &list = List();
     std::string message;
-    for (int i=p_list.size()-1; i>=0; i--) {
+    for (int i=list.size()-1; i>=0; i--) {
       // Construct the line-based message
-      message += "**" + enumString(p_list[i].type) + "** " + 
-                 p_list[i].message;
+      message += "**" + enumString(list[i].type) + "** " + 
+                 list[i].message;
       if (p_reportFileLine) {
-        message += " in " + p_list[i].filename + 
-                   " at " + Isis::iString(p_list[i].lineNumber);
+        message += " in " + list[i].filename + 
+                   " at " + Isis::iString(list[i].lineNumber);
       }
       if (i != 0) message += "\n";
     }
@@ -237,7 +299,7 @@ namespace Isis {
 
   //! Clears the list of exceptions
   void iException::Clear () {
-    p_list.clear();
+    List().clear();
   }
 
   /**
@@ -317,7 +379,7 @@ namespace Isis {
     }
 
     if(theStack.size() != 0) {
-      p_list.push_back(stackTraceInfo);
+      List().push_back(stackTraceInfo);
     }
   }
 }
@@ -59,6 +59,11 @@ namespace Isis {
    *            deleted memory.
    *   @history 2009-07-29 Steven Lambright - Stack trace calculations moved to
    *            IsisDebug.h
+   *   @history 2026-10-18 Unknown - Each thread now has its own list of
+   *            messages, so threads can throw, report and clear errors without
+   *            mixing them up with the errors of other threads.
+   *   @history 2026-10-18 Unknown - Added Message(Pvl &) to throw the errors
+   *            caught by another thread again.
    */
   class iException : public std::exception {
     public:
@@ -79,6 +84,7 @@ namespace Isis {
       };
 
       static iException &Message(errType t, const std::string &m, const char *f, int l);
+      static iException &Message(Isis::Pvl &errors);
 
       const char *what() const throw();
       errType Type() const;
@@ -90,7 +96,7 @@ namespace Isis {
       ~iException() throw ();
 
     private:
-      static iException *p_exception;
+      static iException &Current();
       iException ();
 
       static void Shutdown();
@@ -116,8 +122,7 @@ namespace Isis {
           int lineNumber;
       };
 
-      //! List of iExceptions
-      static QList<Info> p_list;
+      static QList<Info> &List();
 
 	  static void createStackTrace();
       std::string enumString(errType t) const;
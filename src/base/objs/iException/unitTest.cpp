@@ -2,6 +2,7 @@
 #include "Preference.h"
 
 #include "iException.h"
+#include "Pvl.h"
 
 using namespace std;
 using namespace Isis;
@@ -42,6 +43,14 @@ int main (void) {
 
   e.Report (false);
 
+  cout << "Testing errors passed as Pvl ..." << endl;
+  iException::Message(iException::Io,"Testing first error",_FILEINFO_);
+  Pvl errors = iException::Message(iException::User,
+                                   "Testing second error",
+                                   _FILEINFO_).PvlErrors();
+  iException::Clear();
+  iException::Message(errors).Report(false);
+
   e = iException::Message(iException::Cancel,"",_FILEINFO_);
   cout << "Testing cancel option ..." << endl;
   e.Report (false);
@@ -7,6 +7,7 @@ using namespace std;
 #include "Preference.h"
 
 void TestLineSamp(Isis::Camera *cam, double samp, double line);
+void TestGroundSeries(Isis::Camera *cam);
 
 int main (int argc, char *argv[]) {
   Isis::Preference::Preferences(true);
@@ -67,6 +68,9 @@ int main (int argc, char *argv[]) {
       }
 
       cout << endl;
+      cout << "For a series of ground points ..." << endl;
+      TestGroundSeries(cam);
+      cout << endl;
     }
   }
   catch (Isis::iException &e) {
@@ -94,3 +98,26 @@ void TestLineSamp(Isis::Camera *cam, double samp, double line) {
     cout << "DeltaLine = ERROR" << endl << endl;
   }
 }
+
+void TestGroundSeries(Isis::Camera *cam) {
+  std::vector<double> lat, lon, line;
+  for (int i=0; i<10; i++) {
+    double l = 1.0 + i * (cam->Lines() - 1.0) / 9.0;
+    if (cam->SetImage(cam->Samples() / 2.0, l)) {
+      lat.push_back(cam->UniversalLatitude());
+      lon.push_back(cam->UniversalLongitude());
+      line.push_back(l);
+    }
+  }
+
+  // Each point is searched for first around the line of the one before it
+  int matches = 0;
+  for (unsigned int i=0; i<lat.size(); i++) {
+    if (cam->SetUniversalGround(lat[i], lon[i]) &&
+        (fabs(cam->Sample() - cam->Samples() / 2.0) < 0.01) &&
+        (fabs(cam->Line() - line[i]) < 0.01)) {
+      matches++;
+    }
+  }
+  cout << "Series matches: " << matches << " of " << lat.size() << endl;
+}
@@ -87,6 +87,8 @@ namespace Isis {
      * @param vband
      */
     void ThemisIrCamera::SetBand (const int vband) {
+      Camera::SetBand(vband);
+
       // Lookup the original band from the band bin group.  Unless there is
       // a reference band which means the data has all been aligned in the
       // band dimension
@@ -27,6 +27,8 @@ namespace Isis {
      *            1/20th of a pixel
      *   @history 2009-08-28 Steven Lambright - Changed inheritance to no longer
      *            inherit directly from Camera
+     *   @history 2026-10-18 Unknown - SetBand now sets the band of the Camera,
+     *            so Band returns the band set
      */
     class ThemisIrCamera : public Isis::LineScanCamera {
       public:
@@ -124,6 +124,7 @@ namespace Qisis {
 
     QApplication::restoreOverrideCursor();
     filter = "Control net (*.net);;";
+    filter += "Binary control net (*.bin);;";
     filter += "Text file (*.txt);;";
     filter += "All (*)";
     cNetFilename = QFileDialog::getOpenFileName((QWidget*)parent(),
@@ -181,15 +182,19 @@ namespace Qisis {
   }
 
   void QnetFileTool::saveAs() {
+    QString binaryFilter = "Binary control net (*.bin)";
     QString filter = "Control net (*.net);;";
+    filter += binaryFilter + ";;";
     filter += "Text file (*.txt);;";
     filter += "All (*)";
+    QString selectedFilter;
     QString fn=QFileDialog::getSaveFileName((QWidget*)parent(),
                                             "Choose filename to save under",
-                                            ".", filter);
+                                            ".", filter, &selectedFilter);
     if ( !fn.isEmpty() ) {
       try {
-        g_controlNetwork->Write(fn.toStdString());
+        g_controlNetwork->Write(fn.toStdString(),
+                                selectedFilter == binaryFilter);
       } 
       catch (Isis::iException &e) {
         QString message = "Error saving control network.  \n";
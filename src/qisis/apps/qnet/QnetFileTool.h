@@ -60,6 +60,9 @@ namespace Qisis {
  *            this?" description for saveAs action. Changed
  *            "Save As" action text to match QnetTool's "Save
  *            As" action
+ *  @history 2026-10-17 Unknown - Added binary control networks to the open and
+ *            save as filters.  Saving with the binary filter writes a binary
+ *            control network.
  *
  */
 